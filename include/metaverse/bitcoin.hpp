@@ -32,9 +32,11 @@
 #include <metaverse/bitcoin/chain/spend.hpp>
 #include <metaverse/bitcoin/chain/stealth.hpp>
 #include <metaverse/bitcoin/chain/transaction.hpp>
+#include <metaverse/bitcoin/chain/transaction_view.hpp>
 #include <metaverse/bitcoin/chain/script/opcode.hpp>
 #include <metaverse/bitcoin/chain/script/operation.hpp>
 #include <metaverse/bitcoin/chain/script/script.hpp>
+#include <metaverse/bitcoin/chain/script/sighash_context.hpp>
 #include <metaverse/bitcoin/config/authority.hpp>
 #include <metaverse/bitcoin/config/base16.hpp>
 #include <metaverse/bitcoin/config/base2.hpp>
@@ -60,6 +62,7 @@
 #include <metaverse/bitcoin/math/hash.hpp>
 #include <metaverse/bitcoin/math/hash_number.hpp>
 #include <metaverse/bitcoin/math/script_number.hpp>
+#include <metaverse/bitcoin/math/siphash.hpp>
 #include <metaverse/bitcoin/math/stealth.hpp>
 #include <metaverse/bitcoin/math/uint256.hpp>
 #include <metaverse/bitcoin/message/address.hpp>
@@ -124,6 +127,7 @@
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/log.hpp>
 #include <metaverse/bitcoin/utility/logging.hpp>
+#include <metaverse/bitcoin/utility/metrics.hpp>
 #include <metaverse/bitcoin/utility/monitor.hpp>
 #include <metaverse/bitcoin/utility/notifier.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
@@ -132,14 +136,17 @@
 #include <metaverse/bitcoin/utility/reader.hpp>
 #include <metaverse/bitcoin/utility/resource_lock.hpp>
 #include <metaverse/bitcoin/utility/resubscriber.hpp>
+#include <metaverse/bitcoin/utility/scheduler.hpp>
 #include <metaverse/bitcoin/utility/scope_lock.hpp>
 #include <metaverse/bitcoin/utility/serializer.hpp>
+#include <metaverse/bitcoin/utility/slice_reader.hpp>
 #include <metaverse/bitcoin/utility/string.hpp>
 #include <metaverse/bitcoin/utility/subscriber.hpp>
 #include <metaverse/bitcoin/utility/synchronizer.hpp>
 #include <metaverse/bitcoin/utility/thread.hpp>
 #include <metaverse/bitcoin/utility/threadpool.hpp>
 #include <metaverse/bitcoin/utility/timer.hpp>
+#include <metaverse/bitcoin/utility/trace.hpp>
 #include <metaverse/bitcoin/utility/track.hpp>
 #include <metaverse/bitcoin/utility/variable_uint_size.hpp>
 #include <metaverse/bitcoin/utility/work.hpp>
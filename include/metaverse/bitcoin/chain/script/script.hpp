@@ -36,6 +36,7 @@ namespace libbitcoin {
 namespace chain {
 
 class BC_API transaction;
+class BC_API sighash_context;
 
 /// Signature hash types.
 /// Comments from: bitcoin.org/en/developer-guide#standard-transactions
@@ -107,6 +108,11 @@ public:
         const script& output_script, const transaction& parent_tx,
         uint32_t input_index, uint32_t flags);
 
+    /// Verify an input, sharing signature hashing state across inputs.
+    static bool verify(const script& input_script,
+        const script& output_script, const sighash_context& context,
+        uint32_t input_index, uint32_t flags);
+
     static hash_digest generate_signature_hash(const transaction& parent_tx,
         uint32_t input_index, const script& script_code, uint8_t sighash_type);
 
@@ -114,6 +120,10 @@ public:
         const script& prevout_script, const transaction& new_tx,
         uint32_t input_index, uint8_t sighash_type);
 
+    static bool create_endorsement(endorsement& out, const ec_secret& secret,
+        const script& prevout_script, const sighash_context& context,
+        uint32_t input_index, uint8_t sighash_type);
+
     static bool is_active(uint32_t flags, script_context flag);
 
     static bool check_signature(const ec_signature& signature,
@@ -121,6 +131,11 @@ public:
         const script& script_code, const transaction& parent_tx,
         uint32_t input_index);
 
+    static bool check_signature(const ec_signature& signature,
+        uint8_t sighash_type, const data_chunk& public_key,
+        const script& script_code, const sighash_context& context,
+        uint32_t input_index);
+
     script_pattern pattern() const;
     bool is_raw_data() const;
     bool from_data(const data_chunk& data, bool prefix, parse_mode mode);
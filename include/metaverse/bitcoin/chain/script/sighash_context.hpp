@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_CHAIN_SIGHASH_CONTEXT_HPP
+#define MVS_CHAIN_SIGHASH_CONTEXT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/chain/transaction.hpp>
+#include <metaverse/bitcoin/chain/script/script.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/**
+ * Signature hashing state shared by all inputs of one transaction.
+ * The transaction is serialized once with blanked input scripts and the
+ * hash midstate preceding each input is kept, so a signature hash only
+ * hashes its own input and the suffix, without copying the transaction.
+ * Construct once per transaction and reuse for every input signature.
+ *
+ * The transaction is referenced, not copied, and must outlive the context.
+ * Input scripts may change (as when signing), nothing else may.
+ * The lazily computed state is thread safe.
+ */
+class BC_API sighash_context
+{
+public:
+    explicit sighash_context(const transaction& tx);
+    ~sighash_context();
+
+    /// This class is not copyable.
+    sighash_context(const sighash_context&) = delete;
+    void operator=(const sighash_context&) = delete;
+
+    const chain::transaction& transaction() const;
+
+    /// The transaction serialization, computed once on first use.
+    const data_chunk& serialized() const;
+
+    /// Same result as script::generate_signature_hash on the transaction.
+    hash_digest signature_hash(uint32_t input_index,
+        const script& script_code, uint8_t sighash_type) const;
+
+private:
+    class midstates;
+
+    const midstates& prefix() const;
+
+    const chain::transaction& tx_;
+    mutable std::once_flag serialized_once_;
+    mutable data_chunk serialized_;
+    mutable std::once_flag midstates_once_;
+    mutable std::unique_ptr<midstates> midstates_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
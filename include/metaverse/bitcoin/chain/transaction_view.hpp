@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_CHAIN_TRANSACTION_VIEW_HPP
+#define MVS_CHAIN_TRANSACTION_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/chain/input.hpp>
+#include <metaverse/bitcoin/chain/output.hpp>
+#include <metaverse/bitcoin/chain/point.hpp>
+#include <metaverse/bitcoin/chain/script/script.hpp>
+#include <metaverse/bitcoin/chain/transaction.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// Read-only transaction over its own wire serialization.
+/// The serialization is held once in a shared buffer alongside the offsets
+/// of each input and output and the transaction hash, so copies are shallow
+/// and nothing beyond the fixed fields is decoded until asked for.
+/// Scripts, points and attachments are decoded from the buffer on each
+/// access, which keeps the view immutable and safe to share across threads.
+class BC_API transaction_view
+{
+public:
+    typedef std::vector<transaction_view> list;
+
+    /// Parse the serialization, taking ownership of the buffer.
+    /// Returns an invalid view if the data is not exactly one transaction.
+    static transaction_view factory_from_data(data_chunk&& data);
+    static transaction_view factory_from_data(const data_chunk& data);
+
+    /// Parse a transaction of unknown length from trusted memory (the
+    /// database), copying exactly its serialized bytes.
+    static transaction_view factory_from_memory(const uint8_t* memory);
+
+    /// Serialize a decoded transaction into a view.
+    static transaction_view factory_from_transaction(const transaction& tx);
+
+    /// An invalid (empty) view.
+    transaction_view();
+
+    bool is_valid() const;
+    bool is_coinbase() const;
+
+    /// The serialization and its precomputed hash.
+    const data_chunk& data() const;
+    const hash_digest& hash() const;
+    uint64_t serialized_size() const;
+
+    uint32_t version() const;
+    uint32_t locktime() const;
+    size_t inputs_size() const;
+    size_t outputs_size() const;
+
+    /// Input fields, decoded from the buffer on demand.
+    output_point previous_output(size_t index) const;
+    uint32_t sequence(size_t index) const;
+    data_slice input_script_data(size_t index) const;
+    chain::script input_script(size_t index) const;
+
+    /// Throws std::out_of_range like vector::at.
+    chain::input input(size_t index) const;
+
+    /// Output fields, decoded from the buffer on demand.
+    uint64_t value(size_t index) const;
+    data_slice output_script_data(size_t index) const;
+    chain::script output_script(size_t index) const;
+
+    /// Throws std::out_of_range like vector::at.
+    chain::output output(size_t index) const;
+
+    /// Decode the complete transaction.
+    chain::transaction to_transaction() const;
+
+private:
+    struct layout;
+    typedef std::shared_ptr<const layout> layout_ptr;
+
+    explicit transaction_view(layout_ptr layout);
+
+    static layout_ptr parse(data_chunk&& data);
+    const uint8_t* input_at(size_t index) const;
+    const uint8_t* output_at(size_t index) const;
+
+    layout_ptr layout_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
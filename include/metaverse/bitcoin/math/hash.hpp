@@ -182,6 +182,20 @@ BC_API long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
  */
 BC_API hash_digest bitcoin_hash(data_slice data);
 
+/**
+ * Generate bitcoin hashes of count consecutive 64 byte inputs, such as
+ * concatenated merkle tree node pairs, into count consecutive digests.
+ * Inputs are hashed in parallel SIMD lanes where the CPU supports it.
+ * The output may alias the input, allowing a tree level to be reduced
+ * in place.
+ */
+BC_API void bitcoin_hash64(uint8_t* out, const uint8_t* in, size_t count);
+
+/**
+ * The name of the sha256 implementation selected for this CPU.
+ */
+BC_API std::string sha256_implementation();
+
 /**
  * Generate a bitcoin short hash. This hash function is used in a
  * few specific cases where short hashes are desired.
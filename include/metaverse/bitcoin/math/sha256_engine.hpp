@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SHA256_ENGINE_HPP
+#define MVS_SHA256_ENGINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+    #define MVS_SHA256_X86
+#endif
+
+namespace libbitcoin {
+namespace sha256 {
+
+static constexpr size_t block_size = 64;
+static constexpr size_t digest_size = 32;
+
+/// Compress count consecutive blocks into the state.
+typedef void (*transform_function)(uint32_t* state, const uint8_t* blocks,
+    size_t count);
+
+/// Double hash a fixed number of consecutive 64 byte inputs, one per lane.
+typedef void (*double64_function)(uint8_t* out, const uint8_t* in);
+
+/**
+ * The sha256 implementation selected once for the running CPU.
+ * Lane functions are null where the CPU does not support them.
+ */
+struct engine
+{
+    std::string name;
+    transform_function transform;
+    double64_function double64_4way;
+    double64_function double64_8way;
+};
+
+BC_API const engine& selected();
+
+/// Every implementation the running CPU supports, each using one backend
+/// alone so they can be checked against each other, the portable one first.
+BC_API std::vector<engine> supported();
+
+/// Streaming sha256 over the transform of an engine, the selected one by
+/// default.
+class BC_API context
+{
+public:
+    context();
+    context(const engine& instance);
+
+    void update(const uint8_t* data, size_t size);
+    void finalize(uint8_t* digest);
+
+private:
+    transform_function transform_;
+    uint32_t state_[8];
+    uint8_t buffer_[block_size];
+    uint64_t size_;
+};
+
+/// Double hash count consecutive 64 byte inputs, out may alias in.
+BC_API void double64(uint8_t* out, const uint8_t* in, size_t count);
+BC_API void double64(const engine& instance, uint8_t* out, const uint8_t* in,
+    size_t count);
+
+#ifdef MVS_SHA256_X86
+bool shani_supported();
+void transform_shani(uint32_t* state, const uint8_t* blocks, size_t count);
+void double64_sse41_4way(uint8_t* out, const uint8_t* in);
+void double64_avx2_8way(uint8_t* out, const uint8_t* in);
+#endif
+
+} // namespace sha256
+} // namespace libbitcoin
+
+#endif
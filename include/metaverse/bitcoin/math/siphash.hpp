@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SIPHASH_HPP
+#define MVS_SIPHASH_HPP
+
+#include <cstdint>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+
+/**
+ * SipHash-2-4 of a message under the 128 bit key (k0, k1).
+ * This is the keyed short hash used for BIP152 short transaction ids.
+ */
+BC_API uint64_t siphash(uint64_t k0, uint64_t k1, data_slice message);
+
+} // namespace libbitcoin
+
+#endif
@@ -23,7 +23,9 @@
 
 #include <istream>
 #include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/chain/block.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
 #include <metaverse/bitcoin/message/prefilled_transaction.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
 #include <metaverse/bitcoin/utility/reader.hpp>
@@ -46,6 +48,14 @@ public:
     static compact_block factory_from_data(uint32_t version,
         reader& source);
 
+    /// Announce the block, prefilling only the coinbase transaction.
+    static compact_block factory_from_block(const chain::block& block,
+        uint64_t nonce);
+
+    /// The short id of a transaction hash under the given siphash key.
+    static short_id to_short_id(uint64_t k0, uint64_t k1,
+        const hash_digest& tx_hash);
+
     bool from_data(uint32_t version, const data_chunk& data);
     bool from_data(uint32_t version, std::istream& stream);
     bool from_data(uint32_t version, reader& source);
@@ -56,6 +66,9 @@ public:
     void reset();
     uint64_t serialized_size(uint32_t version) const;
 
+    /// The siphash key derived from the header and nonce (BIP152).
+    void short_id_key(uint64_t& k0, uint64_t& k1) const;
+
     static const std::string command;
     static const uint32_t version_minimum;
     static const uint32_t version_maximum;
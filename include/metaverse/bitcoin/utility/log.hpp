@@ -21,8 +21,11 @@
 #ifndef MVS_LOG_HPP
 #define MVS_LOG_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <metaverse/bitcoin/define.hpp>
@@ -45,6 +48,7 @@ public:
 
     typedef std::function<void(level, const std::string&, const std::string&)>
         functor;
+    typedef std::function<void()> flusher;
 
     log(level value, const std::string& domain);
     log(log&& other);
@@ -53,6 +57,24 @@ public:
     /// Clear all log configuration.
     static void clear();
 
+    /// True if the level has an output function. Nothing streamed to a log
+    /// of a disabled level is formatted.
+    static bool enabled(level value);
+
+    /// Call the output functions on a background thread, the calling thread
+    /// only queues the line. The flush function is called on that thread
+    /// whenever the queue runs empty. A line that finds the queue full waits
+    /// for room, so lines are written in the order they were queued. Error
+    /// and fatal lines are written and flushed before their logger returns.
+    static void start_async(size_t capacity, flusher flush);
+
+    /// Write out the queued lines and join the background thread, must be
+    /// called before the process exits if started.
+    static void stop_async();
+
+    /// True while the background thread is writing.
+    static bool async();
+
     /// Convert the log level value to English text.
     static std::string to_text(level value);
 
@@ -67,11 +89,14 @@ public:
     template <typename Type>
     log& operator<<(Type const& value)
     {
-        stream_ << value;
+        if (stream_)
+            *stream_ << value;
+
         return *this;
     }
 
-    /// Set the output functor for this log instance.
+    /// Set the output functor for the level of this log instance, an empty
+    /// functor disables the level.
     void set_output_function(functor value);
 
 private:
@@ -87,13 +112,37 @@ private:
     static void to_stream(std::ostream& out, level value,
         const std::string& domain, const std::string& body);
 
+    static uint32_t to_flag(level value);
+    static void write(level value, const std::string& domain,
+        const std::string& body);
+
     static destinations destinations_;
 
     level level_;
     std::string domain_;
-    std::ostringstream stream_;
+
+    // Not allocated when the level is disabled.
+    std::unique_ptr<std::ostringstream> stream_;
 };
 
+/// Helper for the macros below, lowers a log statement to void.
+struct BC_API log_voidify
+{
+    void operator&(const log&) const
+    {
+    }
+};
+
+/// Log statements whose streamed arguments are not evaluated at all while
+/// the level is disabled, for use in loops and on the network path:
+/// BC_LOG_TRACE(LOG_NETWORK) << "Sending " << command;
+#define BC_LOG_IF(value, domain) \
+    !libbitcoin::log::enabled(libbitcoin::log::level::value) ? (void)0 : \
+        libbitcoin::log_voidify() & libbitcoin::log::value(domain)
+
+#define BC_LOG_TRACE(domain) BC_LOG_IF(trace, domain)
+#define BC_LOG_DEBUG(domain) BC_LOG_IF(debug, domain)
+
 } // namespace libbitcoin
 
 #endif
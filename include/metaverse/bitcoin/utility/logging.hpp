@@ -32,6 +32,14 @@ namespace libbitcoin {
 BCT_API void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
     std::ostream& output_stream, std::ostream& error_stream, std::string level = "DEBUG");
 
+/// Write the log lines on a background thread until stop_async_logging,
+/// flushing the files whenever no line is waiting.
+BCT_API void start_async_logging(bc::ofstream& debug, bc::ofstream& error,
+    size_t capacity=65536);
+
+/// Write out the waiting lines and join the background thread.
+BCT_API void stop_async_logging();
+
 /// Class Logger
 class Logger{
 #define self Logger
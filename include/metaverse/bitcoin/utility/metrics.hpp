@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_METRICS_HPP
+#define MVS_METRICS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// A process wide registry of counters, gauges and histograms, rendered in
+/// the Prometheus text exposition format. A series is registered under a
+/// mutex on first use and lives for the process, so callers keep the
+/// reference and then update it with atomic operations only.
+class BC_API metrics
+{
+public:
+    /// A value that only goes up.
+    class BC_API counter
+    {
+    public:
+        counter();
+
+        void increment(uint64_t amount=1);
+        uint64_t value() const;
+
+    private:
+        std::atomic<uint64_t> value_;
+    };
+
+    /// A value that goes up and down.
+    class BC_API gauge
+    {
+    public:
+        gauge();
+
+        void set(double value);
+        void add(double amount);
+        double value() const;
+
+    private:
+        std::atomic<double> value_;
+    };
+
+    /// Observations counted into buckets by upper bound.
+    class BC_API histogram
+    {
+    public:
+        struct snapshot
+        {
+            std::vector<double> bounds;
+
+            /// Cumulative, one per bound.
+            std::vector<uint64_t> buckets;
+            uint64_t count;
+            double sum;
+        };
+
+        histogram(const std::vector<double>& bounds);
+
+        void observe(double value);
+        snapshot collect() const;
+
+    private:
+        const std::vector<double> bounds_;
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+        std::atomic<uint64_t> count_;
+        std::atomic<double> sum_;
+    };
+
+    /// Bounds in seconds, from a millisecond to ten seconds.
+    static const std::vector<double>& latency_buckets();
+
+    /// Get the series of the name and labels, registering it on first use.
+    /// Labels are given in the exposition form, e.g. lane="rpc", and the
+    /// help text of the first registration of a name is kept.
+    static counter& get_counter(const std::string& name,
+        const std::string& help, const std::string& labels="");
+    static gauge& get_gauge(const std::string& name, const std::string& help,
+        const std::string& labels="");
+    static histogram& get_histogram(const std::string& name,
+        const std::string& help, const std::vector<double>& bounds,
+        const std::string& labels="");
+
+    /// Write every registered series, by name.
+    static std::string render();
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SCHEDULER_HPP
+#define MVS_SCHEDULER_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/utility/asio.hpp>
+#include <metaverse/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// Runs jobs on a set of workers by priority lane. A worker takes the job
+/// of the highest lane that is under its concurrency limit, from its own
+/// queue first and then from the back of the other workers' queues. Jobs
+/// posted by a worker stay with that worker unless stolen, others are dealt
+/// out in turn. While not started jobs run on the posting thread.
+class BC_API scheduler
+{
+public:
+    typedef std::function<void()> job;
+
+    /// Lanes in priority order. Block organization stays on the calling
+    /// network thread, only its script checks are posted to consensus.
+    /// Storage is for jobs that block on chain reads, which wait out writes.
+    enum class lane : uint8_t
+    {
+        consensus,
+        network,
+        storage,
+        rpc,
+        background
+    };
+
+    static constexpr size_t lanes = 5;
+
+    struct lane_stats
+    {
+        /// The most jobs of the lane running at once.
+        size_t limit;
+        size_t queued;
+        size_t running;
+        uint64_t completed;
+
+        /// Jobs taken from the queue of another worker.
+        uint64_t stolen;
+
+        /// The time jobs waited in the queue.
+        uint64_t total_wait_microseconds;
+        uint64_t max_wait_microseconds;
+    };
+
+    static const char* to_string(lane value);
+
+    scheduler();
+
+    /// Stops and joins the workers.
+    ~scheduler();
+
+    /// This class is not copyable.
+    scheduler(const scheduler&) = delete;
+    void operator=(const scheduler&) = delete;
+
+    /// Start the workers, zero starts one per core. Consensus may take every
+    /// worker, the other lanes share all but one of them, so that one is kept
+    /// for consensus. Network may take the shared workers, storage and rpc
+    /// half of the workers and background one. A single worker is shared by
+    /// all lanes, consensus jobs are then only taken first.
+    void start(size_t threads);
+
+    /// Run the queued jobs and join the workers, can be restarted.
+    void stop();
+
+    void post(lane lane, job job);
+
+    /// The number of workers, zero when not started.
+    size_t threads() const;
+
+    lane_stats stats(lane lane) const;
+
+private:
+    struct task
+    {
+        job run;
+        asio::time_point queued;
+    };
+
+    typedef std::array<std::deque<task>, lanes> queues;
+
+    struct shard
+    {
+        std::mutex mutex;
+        queues lanes;
+    };
+
+    struct counters
+    {
+        std::atomic<size_t> limit;
+        std::atomic<size_t> queued;
+        std::atomic<size_t> running;
+        std::atomic<uint64_t> completed;
+        std::atomic<uint64_t> stolen;
+        std::atomic<uint64_t> wait;
+        std::atomic<uint64_t> max_wait;
+    };
+
+    void work(size_t index);
+    bool take(size_t index, task& out_task, size_t& out_lane);
+    bool claim(size_t lane);
+    bool claim_shared();
+    void release(size_t lane);
+    void execute(task& task, size_t lane);
+    void notify();
+
+    static bool pop(shard& shard, size_t lane, bool back, task& out_task);
+
+    // These are protected by mutex.
+    std::vector<std::unique_ptr<shard>> shards_;
+    std::vector<asio::thread> threads_;
+    mutable shared_mutex mutex_;
+
+    // These are thread safe.
+    std::array<counters, lanes> counters_;
+    std::atomic<bool> started_;
+    std::atomic<bool> stopping_;
+    std::atomic<size_t> next_;
+    std::atomic<size_t> pending_;
+
+    // The jobs of the lanes below consensus running at once, and their limit.
+    std::atomic<size_t> shared_running_;
+    std::atomic<size_t> shared_limit_;
+
+    // Changes whenever a job is posted or finished, so that an idle worker
+    // sleeps until it may find something new to take.
+    std::atomic<uint64_t> events_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_TRACE_HPP
+#define MVS_TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/utility/asio.hpp>
+
+namespace libbitcoin {
+
+/// This class is thread safe.
+/// A process wide ring buffer of timed spans, off until enabled. While off
+/// a span costs one atomic load, once the buffer is full the oldest spans
+/// are overwritten.
+class BC_API tracer
+{
+public:
+    struct event
+    {
+        const char* name;
+        const char* category;
+        std::string detail;
+        uint32_t thread;
+
+        /// Microseconds since the process started.
+        uint64_t start;
+        uint64_t duration;
+    };
+
+    typedef std::vector<event> list;
+
+    /// The number of spans kept.
+    static constexpr size_t capacity = 65536;
+
+    static bool enabled();
+
+    /// The buffer is allocated on first enable and kept when disabled.
+    static void enable(bool value);
+    static void clear();
+
+    /// Record a span from the start until now, the names must be literals.
+    static void record(const char* name, const char* category,
+        asio::time_point start, std::string detail="");
+
+    /// The spans kept, oldest first.
+    static list events();
+
+    /// The spans kept, oldest first, emptying the buffer in the same step so
+    /// no span is lost between reading and clearing.
+    static list take(uint64_t& dropped);
+
+    /// The number of spans overwritten since the last clear.
+    static uint64_t dropped();
+};
+
+/// Records the scope as a span if tracing was enabled on entry.
+class BC_API trace_span
+{
+public:
+    trace_span(const char* name, const char* category);
+    ~trace_span();
+
+    /// This class is not copyable.
+    trace_span(const trace_span&) = delete;
+    void operator=(const trace_span&) = delete;
+
+    /// True if the span is being recorded, test before building a detail.
+    explicit operator bool() const;
+
+    void set_detail(std::string detail);
+
+private:
+    const char* name_;
+    const char* category_;
+    const bool active_;
+    asio::time_point start_;
+    std::string detail_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -20,18 +20,25 @@
 #include <metaverse/consensus.hpp>
 #endif
 
+#include <metaverse/blockchain/account_balances.hpp>
+#include <metaverse/blockchain/account_history.hpp>
+#include <metaverse/blockchain/account_sessions.hpp>
+#include <metaverse/blockchain/address_owners.hpp>
 #include <metaverse/blockchain/block.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
 #include <metaverse/blockchain/block_chain_impl.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
 #include <metaverse/blockchain/block_fetcher.hpp>
+#include <metaverse/blockchain/coin_cache.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/orphan_pool.hpp>
+#include <metaverse/blockchain/script_verifier.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/blockchain/transaction_pool_index.hpp>
+#include <metaverse/blockchain/utxo_views.hpp>
 #include <metaverse/blockchain/validate_block.hpp>
 #include <metaverse/blockchain/validate_block_impl.hpp>
 #include <metaverse/blockchain/validate_transaction.hpp>
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_ACCOUNT_BALANCES_HPP
+#define MVS_BLOCKCHAIN_ACCOUNT_BALANCES_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/chain/attachment/account/account_address.hpp>
+#include <metaverse/database.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// Running balance totals of the local accounts and of each of their
+/// addresses. An account is indexed from the stored history on first use,
+/// then kept up to date as blocks are connected and disconnected and as
+/// transactions enter and leave the pool, so a balance query no longer
+/// depends on the number of addresses of the account.
+class BCB_API account_balances
+{
+public:
+    /// The figures of an account or an address, with the meaning the
+    /// per-address history scan gives them.
+    struct balance
+    {
+        uint64_t total_received;
+        uint64_t confirmed_balance;
+        uint64_t unspent_balance;
+        uint64_t frozen_balance;
+
+        /// Unspent asset amounts by symbol.
+        std::map<std::string, uint64_t> assets;
+    };
+
+    typedef std::vector<std::pair<std::string, balance>> address_list;
+    typedef std::function<std::vector<chain::account_address>()>
+        address_reader;
+    typedef std::function<message::transaction_message::ptr_list()>
+        pool_reader;
+
+    account_balances(database::data_base& database);
+
+    /// Get the totals of the account at the given height. The addresses are
+    /// read only when their revision differs from the one indexed. The pool
+    /// is read only when its revision differs from the last one applied,
+    /// and before locking, since the reader waits on the pool.
+    void get(const std::string& name, uint64_t address_revision,
+        address_reader read_addresses, uint64_t height,
+        uint64_t pool_revision, pool_reader read_pool, balance& out_balance);
+
+    /// Get the totals of each address of the account, in address order.
+    void get(const std::string& name, uint64_t address_revision,
+        address_reader read_addresses, uint64_t height,
+        uint64_t pool_revision, pool_reader read_pool,
+        address_list& out_balances);
+
+    /// Apply a block stored at the height.
+    void connect(const chain::block& block, uint64_t height);
+
+    /// Revert a block removed from the height.
+    void disconnect(const chain::block& block, uint64_t height);
+
+    /// Stop tracking the account.
+    void remove(const std::string& name);
+
+    /// Stop tracking every account, they are indexed again on next use.
+    void clear();
+
+private:
+    struct coin
+    {
+        std::string address;
+        uint64_t value;
+
+        // Zero while in the pool.
+        uint64_t height;
+
+        // The first height the coin is spendable at, zero if not locked.
+        uint64_t unlock;
+
+        std::string symbol;
+        uint64_t asset_amount;
+        bool pool_spent;
+    };
+
+    struct totals
+    {
+        uint64_t received;
+        uint64_t confirmed;
+        uint64_t unspent;
+
+        // Unspent value by unlock height, the frozen part of any height is
+        // the sum above it.
+        std::map<uint64_t, uint64_t> locks;
+        std::map<std::string, uint64_t> assets;
+    };
+
+    // The coins a pool transaction added and the points it spent.
+    struct pool_effect
+    {
+        chain::point::list outputs;
+        chain::point::list spends;
+    };
+
+    struct account_state
+    {
+        uint64_t address_revision;
+
+        // The addresses indexed, in address order.
+        std::vector<std::string> addresses;
+
+        // The height of the last block applied.
+        uint64_t height;
+        uint64_t pool_revision;
+
+        totals total;
+        std::unordered_map<std::string, totals> by_address;
+        std::unordered_map<chain::output_point, coin> coins;
+        std::unordered_map<hash_digest, pool_effect> pool;
+
+        // The pool transaction spending each point.
+        std::unordered_map<chain::output_point, hash_digest> pool_spends;
+    };
+
+    typedef std::unordered_map<std::string, account_state> account_map;
+    typedef message::transaction_message::ptr_list pool_list;
+
+    // Read the pool unless the account is indexed at the revisions.
+    bool read_if_stale(const std::string& name, uint64_t address_revision,
+        uint64_t pool_revision, pool_reader read_pool, pool_list& out_pool);
+
+    // These are protected by mutex.
+    account_state& refresh(const std::string& name,
+        uint64_t address_revision, address_reader read_addresses,
+        uint64_t pool_revision, const pool_list* pool);
+    void build(const std::string& name, account_state& state,
+        const std::vector<chain::account_address>& addresses);
+    void reconcile(account_state& state, uint64_t pool_revision,
+        const pool_list* pool);
+    void add_pool(account_state& state, const chain::transaction& tx,
+        const hash_digest& tx_hash);
+    void remove_pool(account_state& state, const hash_digest& tx_hash);
+    void add_coin(account_state& state, const chain::output_point& point,
+        const coin& coin, bool received);
+    void remove_coin(account_state& state, const chain::output_point& point,
+        bool received);
+    void set_pool_spent(account_state& state, const chain::output_point& point,
+        bool spent);
+    void erase_account(const std::string& name);
+
+    static bool to_address(const chain::output& output,
+        std::string& out_address);
+    static coin to_coin(chain::output output, bool coinbase, uint64_t height);
+    static void apply(totals& totals, const coin& coin, bool add,
+        bool received);
+    static balance to_balance(const totals& totals, uint64_t height);
+
+    database::data_base& database_;
+
+    // These are protected by mutex.
+    account_map accounts_;
+    std::unordered_map<std::string, std::vector<std::string>> owners_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
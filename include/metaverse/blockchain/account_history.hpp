@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_ACCOUNT_HISTORY_HPP
+#define MVS_BLOCKCHAIN_ACCOUNT_HISTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/chain/attachment/account/account_address.hpp>
+#include <metaverse/database.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The confirmed transactions of the local accounts in height order, each
+/// digested once into the fields a listing shows. An account is indexed
+/// from the address business records on first use, then blocks append to
+/// and remove from the end of its list as they are connected and
+/// disconnected, so a page no longer decodes any transaction.
+class BCB_API account_history
+{
+public:
+    struct input_summary
+    {
+        /// Empty if the script carries no address.
+        std::string address;
+        std::string script;
+    };
+
+    struct output_summary
+    {
+        /// Empty if the script carries no address.
+        std::string address;
+        bool own;
+        std::string script;
+        uint64_t lock_height;
+        uint64_t value;
+        chain::attachment attach;
+    };
+
+    struct entry
+    {
+        hash_digest hash;
+        uint64_t height;
+        uint32_t timestamp;
+
+        /// True if an input spends from the account.
+        bool sent;
+
+        std::vector<input_summary> inputs;
+        std::vector<output_summary> outputs;
+
+        /// The address business records of the account the transaction
+        /// has, as the address and the asset symbol of the record, which is
+        /// empty unless the record is an asset output.
+        std::vector<std::pair<std::string, std::string>> records;
+    };
+
+    typedef std::shared_ptr<const entry> entry_ptr;
+    typedef std::vector<entry_ptr> entry_list;
+    typedef std::function<bool(const std::string&)> owner_test;
+    typedef std::function<std::vector<chain::account_address>()>
+        address_reader;
+
+    /// Empty fields match any record, the height range matches all heights
+    /// if both ends are zero.
+    struct filter
+    {
+        std::string address;
+        std::string symbol;
+        uint64_t start_height;
+        uint64_t end_height;
+    };
+
+    struct page
+    {
+        /// Newest first.
+        entry_list entries;
+
+        /// The number of entries matching the filter.
+        uint64_t total;
+
+        /// Pass to continue with the next page, zero after the last one.
+        uint64_t next_cursor;
+    };
+
+    account_history(database::data_base& database);
+
+    /// Get a page of the history of the account. The addresses are read
+    /// only when their revision differs from the one indexed.
+    void get(const std::string& name, uint64_t address_revision,
+        address_reader read_addresses, const filter& filter, uint64_t cursor,
+        uint64_t offset, size_t limit, page& out_page);
+
+    /// Apply a block stored at the height.
+    void connect(const chain::block& block, uint64_t height);
+
+    /// Revert a block removed from the height.
+    void disconnect(const chain::block& block, uint64_t height);
+
+    /// Stop tracking the account.
+    void remove(const std::string& name);
+
+    /// Stop tracking every account, they are indexed again on next use.
+    void clear();
+
+    /// Digest a transaction, the records are left empty.
+    static entry digest(const chain::transaction& tx, uint64_t height,
+        uint32_t timestamp, owner_test is_own);
+
+    /// Page through entries in height order. A nonzero cursor continues
+    /// below the entries returned with it, otherwise the first offset
+    /// matching entries are skipped.
+    static void select(const entry_list& entries, const filter& filter,
+        uint64_t cursor, uint64_t offset, size_t limit, page& out_page);
+
+private:
+    struct account_state
+    {
+        uint64_t address_revision;
+
+        // The height of the last block applied.
+        uint64_t height;
+
+        std::unordered_set<std::string> owned;
+        entry_list entries;
+    };
+
+    typedef std::unordered_map<std::string, account_state> account_map;
+
+    // These are protected by mutex.
+    bool is_current(const std::string& name,
+        uint64_t address_revision) const;
+    void build(const std::string& name, account_state& state,
+        const std::vector<chain::account_address>& addresses);
+    void erase_account(const std::string& name);
+
+    static bool matches(const entry& entry, const filter& filter);
+
+    database::data_base& database_;
+
+    // These are protected by mutex.
+    account_map accounts_;
+    std::unordered_map<std::string, std::vector<std::string>> owners_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
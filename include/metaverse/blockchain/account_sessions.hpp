@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_ACCOUNT_SESSIONS_HPP
+#define MVS_BLOCKCHAIN_ACCOUNT_SESSIONS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/chain/attachment/account/account_address.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// Time limited unlock sessions for accounts. Unlocking decrypts the private
+/// keys of every account address once and holds the decoded secrets, with
+/// their public points, in memory that is locked against paging and wiped
+/// when the session is locked, replaced or found expired.
+class BCB_API account_sessions
+{
+public:
+    /// Decrypt and hold the keys of the addresses for the given seconds,
+    /// replacing any session of the account. Returns the number of keys.
+    size_t unlock(const std::string& name,
+        const chain::account_address::list& addresses, std::string& passphrase,
+        uint32_t seconds);
+
+    /// End the session of the account, returns false if there was none.
+    bool lock(const std::string& name);
+
+    /// Seconds left in the session of the account, zero if locked.
+    uint32_t remaining(const std::string& name);
+
+    /// True if the key of the address is held by a live session.
+    bool contains(const std::string& name, const std::string& address);
+
+    /// Get the key of an address of an unlocked account.
+    bool find(const std::string& name, const std::string& address,
+        ec_secret& out_secret, ec_compressed& out_point);
+
+private:
+    struct session;
+    typedef std::shared_ptr<session> session_ptr;
+
+    // Returns the live session of the account, dropping it if expired.
+    session_ptr find(const std::string& name);
+
+    // This is protected by mutex.
+    std::unordered_map<std::string, session_ptr> sessions_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
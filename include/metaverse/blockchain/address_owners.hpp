@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_ADDRESS_OWNERS_HPP
+#define MVS_BLOCKCHAIN_ADDRESS_OWNERS_HPP
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/chain/attachment/account/account_address.hpp>
+#include <metaverse/database.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The account owning each address of the account address database, keyed
+/// by address hash. It is filled from the database on first use and then
+/// follows every store and removal, so an ownership check costs one lookup
+/// instead of a scan of the addresses of the account.
+class BCB_API address_owners
+{
+public:
+    typedef std::vector<std::string> name_list;
+
+    address_owners(database::data_base& database);
+
+    /// Get the accounts owning the address, a multisig address may be
+    /// stored to more than one. Returns false if no account does.
+    bool find(const wallet::payment_address& address,
+        name_list& out_names);
+    bool find(const std::string& address, name_list& out_names);
+
+    /// Test whether the account owns the address.
+    bool owns(const std::string& name, const std::string& address);
+
+    /// A number that changes whenever addresses are stored to the account
+    /// or removed from it, zero if the account has none. Indexes of the
+    /// account compare it to tell they are stale without reading its rows.
+    uint64_t revision(const std::string& name);
+
+    /// The accounts owning an output or the spender of an input of the
+    /// transaction. Only inputs whose script carries the address are seen.
+    std::set<std::string> owners(const chain::transaction& tx);
+
+    /// Follow addresses stored to the account.
+    void store(const std::string& name,
+        const std::vector<chain::account_address>& addresses);
+
+    /// Follow the removal of all addresses of the account.
+    void remove(const std::string& name);
+
+private:
+    typedef std::vector<wallet::payment_address> address_list;
+
+    // These are protected by mutex.
+    void load();
+    void add(const std::string& name,
+        const std::vector<chain::account_address>& addresses);
+
+    database::data_base& database_;
+
+    // These are protected by mutex.
+    bool loaded_;
+    uint64_t revision_;
+    std::unordered_map<std::string, uint64_t> revisions_;
+    std::unordered_map<wallet::payment_address, name_list> owners_;
+    std::unordered_map<std::string, address_list> addresses_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
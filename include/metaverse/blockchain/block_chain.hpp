@@ -57,6 +57,21 @@ public:
     typedef handle1<chain::stealth_compact::list> stealth_fetch_handler;
     typedef handle2<uint64_t, uint64_t> transaction_index_fetch_handler;
 
+    /// The previous output of an input, the block height and coinbase state
+    /// of its transaction and whether the chain already spends it. A prevout
+    /// that is not found may be in the transaction pool.
+    struct prevout
+    {
+        bool found;
+        bool spent;
+        bool coinbase;
+        uint64_t height;
+        chain::output output;
+    };
+
+    typedef std::vector<prevout> prevout_list;
+    typedef handle1<prevout_list> prevouts_fetch_handler;
+
     typedef std::function<bool(const code&, uint64_t,
         const message::block_message::ptr_list&,
         const message::block_message::ptr_list&)> reorganize_handler;
@@ -112,6 +127,9 @@ public:
     virtual void fetch_spend(const chain::output_point& outpoint,
         spend_fetch_handler handler) = 0;
 
+    virtual void fetch_prevouts(const chain::transaction& tx,
+        prevouts_fetch_handler handler) = 0;
+
     virtual void fetch_history(const wallet::payment_address& address,
         uint64_t limit, uint64_t from_height,
         history_fetch_handler handler) = 0;
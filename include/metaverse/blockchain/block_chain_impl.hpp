@@ -24,16 +24,24 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <set>
+#include <string>
 #include <vector>
 #include <functional>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database.hpp>
+#include <metaverse/blockchain/account_balances.hpp>
+#include <metaverse/blockchain/account_history.hpp>
+#include <metaverse/blockchain/account_sessions.hpp>
+#include <metaverse/blockchain/address_owners.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
+#include <metaverse/blockchain/coin_cache.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
+#include <metaverse/blockchain/utxo_views.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
 
@@ -50,7 +58,7 @@ class BCB_API block_chain_impl
   : public block_chain, public simple_chain
 {
 public:
-    block_chain_impl(threadpool& pool, 
+    block_chain_impl(threadpool& pool, scheduler& scheduler,
         const blockchain::settings& chain_settings,
         const database::settings& database_settings);
 
@@ -70,6 +78,9 @@ public:
     // Get a reference to the blockchain configuration settings.
     const settings& chain_settings() const;
 
+    // Get the hit and size figures of the unspent output cache.
+    coin_cache::statistics coin_cache_stats() const;
+
     // block_chain start/stop (thread safe).
     // ------------------------------------------------------------------------
 
@@ -111,11 +122,16 @@ public:
     bool get_transaction(chain::transaction& out_transaction,
         uint64_t& out_block_height, const hash_digest& transaction_hash) const;
 
+    /// Get an output of the chain known to be unspent, if it is cached.
+    bool get_cached_coin(coin_cache::coin& out_coin,
+        const chain::output_point& outpoint) const;
+
     /// Import a block to the blockchain.
     bool import(chain::block::ptr block, uint64_t height);
 
     /// Append the block to the top of the chain.
     bool push(block_detail::ptr block);
+    bool push(const block_detail::list& blocks);
 
     /// Remove blocks at or above the given height, returning them in order.
     bool pop_from(block_detail::list& out_blocks, uint64_t height);
@@ -189,6 +205,10 @@ public:
     void fetch_spend(const chain::output_point& outpoint,
         spend_fetch_handler handler);
 
+    /// fetch the previous transaction and spend of each input, in one read.
+    void fetch_prevouts(const chain::transaction& tx,
+        prevouts_fetch_handler handler);
+
     /// fetch outputs, values and spends for an address.
     void fetch_history(const wallet::payment_address& address,
         uint64_t limit, uint64_t from_height, history_fetch_handler handler);
@@ -272,6 +292,11 @@ public:
 	// account adress related api
 	operation_result store_account_address(std::shared_ptr<account_address> address);
 	std::shared_ptr<account_address> get_account_address(const std::string& name, const std::string& address);
+
+	/// Ownership checks answered by the address owner index.
+	bool is_account_address(const std::string& name, const std::string& address);
+	bool get_address_owners(const std::string& address, address_owners::name_list& out_names);
+	std::set<std::string> get_transaction_owners(const chain::transaction& tx);
 	std::shared_ptr<std::vector<account_address>> get_account_addresses(const std::string& name);
 	void uppercase_symbol(std::string& symbol);
 
@@ -288,6 +313,8 @@ public:
 	organizer& get_organizer();
 	bool get_transaction(const hash_digest& hash,
 		chain::transaction& tx, uint64_t& tx_height);
+	bool get_transaction_view(const hash_digest& hash,
+		chain::transaction_view& view, uint64_t& tx_height);
 	bool get_transaction_callback(const hash_digest& hash,
     std::function<void(const code&, const chain::transaction&)> handler);
 	bool get_history_callback(const payment_address& address,
@@ -298,7 +325,31 @@ public:
 	code validate_transaction(const chain::transaction& tx);
 	code broadcast_transaction(const chain::transaction& tx);
     bool get_tx_inputs_etp_value (chain::transaction& tx, uint64_t& etp_val);
-    void safe_store_account(account& acc, std::vector<std::shared_ptr<account_address>>& addresses);
+    void safe_store_account(account& acc, const account_address::list& addresses);
+
+    /// Unlocked account keys, held for signing without the passphrase.
+    blockchain::account_sessions& account_sessions();
+
+    /// Balance totals of the account, or of each of its addresses, from the
+    /// account balance index.
+    bool get_account_balance(const std::string& name,
+        account_balances::balance& out_balance);
+    bool get_account_balance(const std::string& name,
+        account_balances::address_list& out_balances);
+
+    /// A page of the confirmed transactions of the account, newest first,
+    /// from the account history index.
+    bool get_account_history(const std::string& name,
+        const account_history::filter& filter, uint64_t cursor,
+        uint64_t offset, size_t limit, account_history::page& out_page);
+
+    /// The outputs of the address no transaction spends, from the utxo
+    /// views. Pool outputs are at height zero.
+    void get_address_utxos(const std::string& address,
+        utxo_views::coin_list& out_coins);
+
+    /// The transactions of the pool, in pool order.
+    message::transaction_message::ptr_list get_pool_transactions();
 
 private:
     typedef std::function<bool(database::handle)> perform_read_functor;
@@ -329,6 +380,7 @@ private:
     ////void fetch_parallel(perform_read_functor perform_read);
     void fetch_serial(perform_read_functor perform_read);
     bool stopped() const;
+    utxo_views::coin_list read_address_utxos(const std::string& address);
 	
     std::atomic<bool> stopped_;
     const settings& settings_;
@@ -338,10 +390,26 @@ private:
     ////dispatcher read_dispatch_;
     ////dispatcher write_dispatch_;
     blockchain::transaction_pool transaction_pool_;
+    blockchain::account_sessions account_sessions_;
 
     // This is protected by mutex.
     database::data_base database_;
     mutable shared_mutex mutex_;
+
+    // This is thread safe, it follows the blocks stored in the database.
+    blockchain::account_balances account_balances_;
+
+    // This is thread safe, it follows the blocks stored in the database.
+    blockchain::account_history account_history_;
+
+    // This is thread safe, it follows the account address database.
+    blockchain::address_owners address_owners_;
+
+    // This is thread safe, it follows the blocks stored in the database.
+    blockchain::coin_cache coin_cache_;
+
+    // This is thread safe, it follows the stored blocks and the pool.
+    blockchain::utxo_views utxo_views_;
 };
 
 } // namespace blockchain
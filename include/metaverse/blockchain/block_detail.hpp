@@ -23,6 +23,8 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
@@ -63,12 +65,18 @@ public:
     const bool get_is_checked_work_proof() const{return is_checked_work_proof_;}
     void set_is_checked_work_proof(bool is_checked_work_proof) {is_checked_work_proof_ = is_checked_work_proof;}
 
+    /// The symbols of the assets the block issues, in block order, read from
+    /// the outputs on first use.
+    const std::vector<std::string>& issued_assets() const;
+
 private:
     bc::atomic<code> code_;
     std::atomic<bool> processed_;
     std::atomic<uint64_t> height_;
     const block_ptr actual_block_;
     bool is_checked_work_proof_;
+    mutable std::vector<std::string> issued_assets_;
+    mutable std::once_flag issued_assets_once_;
 };
 
 } // namespace blockchain
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_COIN_CACHE_HPP
+#define MVS_BLOCKCHAIN_COIN_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The unspent outputs of recently stored blocks, so that input validation
+/// finds most prevouts without reading and deserializing their transaction
+/// or looking up their spend. An output is cached when its block is stored
+/// and dropped once spent or popped. The oldest are evicted to stay within
+/// the memory limit. A miss says nothing, the caller reads the database.
+class BCB_API coin_cache
+{
+public:
+    struct coin
+    {
+        chain::output output;
+        uint64_t height;
+        bool coinbase;
+    };
+
+    struct statistics
+    {
+        size_t coins;
+        uint64_t bytes;
+        uint64_t capacity;
+        uint64_t hits;
+        uint64_t misses;
+    };
+
+    /// A zero capacity disables the cache.
+    explicit coin_cache(uint64_t capacity_bytes);
+
+    /// Get the output of the point if it is cached, and so unspent.
+    bool get(coin& out_coin, const chain::output_point& point) const;
+
+    /// Apply a block stored at the height.
+    void connect(const chain::block& block, uint64_t height);
+
+    /// Revert a block removed from the chain.
+    void disconnect(const chain::block& block);
+
+    /// Drop every coin, the statistics are kept.
+    void clear();
+
+    statistics stats() const;
+
+private:
+    typedef std::unordered_map<chain::output_point, coin> coin_map;
+
+    static uint64_t footprint(const coin& coin);
+
+    // These are protected by mutex.
+    void add(const chain::output_point& point, coin&& coin);
+    void remove(const chain::output_point& point);
+    void evict();
+
+    const uint64_t capacity_;
+
+    // These are protected by mutex.
+    coin_map coins_;
+    std::deque<chain::output_point> order_;
+    uint64_t bytes_;
+    mutable shared_mutex mutex_;
+
+    // These are thread safe.
+    mutable std::atomic<uint64_t> hits_;
+    mutable std::atomic<uint64_t> misses_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -29,6 +29,7 @@
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
 #include <metaverse/blockchain/orphan_pool.hpp>
+#include <metaverse/blockchain/script_verifier.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
 #include <metaverse/bitcoin/math/hash.hpp>
@@ -53,7 +54,8 @@ public:
         reorganize_handler;
 
     /// Construct an instance.
-    organizer(threadpool& pool, simple_chain& chain, const settings& settings);
+    organizer(threadpool& pool, scheduler& scheduler, simple_chain& chain,
+        const settings& settings);
 
     /// This method is NOT thread safe.
     virtual void organize();
@@ -104,6 +106,7 @@ private:
 
     // These are thread safe.
     orphan_pool orphan_pool_;
+    script_verifier verifier_;
     reorganize_subscriber::ptr subscriber_;
     std::unordered_map<hash_digest, uint64_t> fork_chain_last_block_hashes_;
     boost::mutex mutex_fork_chain_last_block_hashes_;
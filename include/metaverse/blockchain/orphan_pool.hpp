@@ -22,8 +22,12 @@
 #define MVS_BLOCKCHAIN_orphan_pool_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
-#include <boost/circular_buffer.hpp>
+#include <set>
+#include <unordered_map>
+#include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
@@ -32,13 +36,15 @@ namespace libbitcoin {
 namespace blockchain {
 
 /// This class is thread safe.
-/// An unordered memory pool for orphan blocks.
+/// A memory pool for orphan blocks, indexed by block hash and by parent.
+/// The oldest blocks are evicted once the count or the byte capacity would
+/// be exceeded.
 class BCB_API orphan_pool
 {
 public:
     typedef std::shared_ptr<orphan_pool> ptr;
 
-    orphan_pool(size_t capacity);
+    orphan_pool(size_t capacity, uint64_t byte_capacity=0);
 
     /// Add a block to the pool.
     bool add(block_detail::ptr block);
@@ -52,6 +58,10 @@ public:
     /// Get the longest connected chain of orphans after 'end'.
     block_detail::list trace(block_detail::ptr end) const;
 
+    /// Get the orphans building on the block of the hash, at any depth,
+    /// parents before their children.
+    block_detail::list descendants(const hash_digest& hash) const;
+
     /// Get the set of unprocessed orphans.
     block_detail::list unprocessed() const;
 
@@ -59,18 +69,30 @@ public:
     block_detail::ptr delete_pending_block(const hash_digest& needed_block);
 
 private:
-//    typedef boost::circular_buffer<block_detail::ptr> buffer;
-    typedef std::vector<block_detail::ptr> buffer;
-    typedef buffer::const_iterator const_iterator;
-    typedef buffer::const_reverse_iterator const_reverse_iterator;
-
-    bool exists(const hash_digest& hash) const;
-    bool exists(const chain::header& header) const;
-    const_iterator find(buffer::const_iterator begin, const hash_digest& hash) const;
-    const_reverse_iterator rfind(buffer::const_reverse_iterator begin, const hash_digest& hash) const;
-
-    // The buffer is protected by mutex.
-    buffer buffer_;
+    struct entry
+    {
+        block_detail::ptr block;
+        uint64_t sequence;
+        uint64_t size;
+    };
+
+    typedef std::unordered_map<hash_digest, entry> entry_map;
+    typedef std::unordered_map<hash_digest, std::vector<hash_digest>>
+        children_map;
+
+    // These are protected by mutex.
+    void erase(entry_map::iterator it);
+    void evict(uint64_t size);
+
+    const size_t capacity_;
+    const uint64_t byte_capacity_;
+
+    // These are protected by mutex.
+    entry_map entries_;
+    children_map children_;
+    std::map<uint64_t, hash_digest> arrivals_;
+    uint64_t sequence_;
+    uint64_t bytes_;
     mutable upgrade_mutex mutex_;
 
     std::multimap<hash_digest, block_detail::ptr> pending_blocks_;
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_SCRIPT_VERIFIER_HPP
+#define MVS_BLOCKCHAIN_SCRIPT_VERIFIER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// Verifies a batch of input scripts, and so their signatures, with helper
+/// jobs on the consensus lane of the scheduler. The calling thread takes part
+/// in the work, so verify may be called from any thread, including those of
+/// the scheduler, and completes even if no helper gets to run.
+class BCB_API script_verifier
+{
+public:
+    /// A deferred script check for one input.
+    struct check
+    {
+        typedef std::vector<check> list;
+        typedef std::shared_ptr<const chain::sighash_context> context_ptr;
+
+        /// Shared by all checks of the same transaction.
+        context_ptr context;
+        chain::script prevout_script;
+        uint32_t input_index;
+        uint32_t flags;
+    };
+
+    enum class result : uint8_t
+    {
+        /// Not run because an earlier failure stopped the batch.
+        unchecked,
+        valid,
+        invalid
+    };
+
+    typedef std::vector<result> results;
+
+    /// Use the given number of helper jobs, zero runs on the caller only.
+    script_verifier(scheduler& scheduler, size_t helpers);
+    ~script_verifier();
+
+    /// Returns one result per check. Once any check fails the remaining
+    /// checks are abandoned, and are reported as unchecked.
+    results verify(const check::list& checks);
+
+    /// Run one check on the calling thread.
+    static bool verify(const check& check);
+
+    /// Stop posting helpers, subsequent batches run on the caller.
+    void stop();
+
+private:
+    struct batch;
+
+    static void drain(batch& work);
+
+    const size_t helpers_;
+    std::atomic<bool> stopped_;
+    scheduler& scheduler_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
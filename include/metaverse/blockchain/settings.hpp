@@ -38,8 +38,13 @@ public:
 
     /// Properties.
     uint32_t block_pool_capacity;
+    uint32_t block_pool_megabytes;
+    uint32_t coin_cache_megabytes;
+    uint32_t utxo_view_megabytes;
     uint32_t transaction_pool_capacity;
     bool transaction_pool_consistency;
+    uint32_t transaction_pool_backlog;
+    uint32_t verify_threads;
     bool use_testnet_rules;
     config::checkpoint::list checkpoints;
 };
@@ -25,6 +25,7 @@
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
+#include <metaverse/blockchain/coin_cache.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -68,12 +69,19 @@ public:
         uint64_t& out_block_height,
         const hash_digest& transaction_hash) const = 0;
 
+    /// Get an output of the chain known to be unspent, if it is cached.
+    virtual bool get_cached_coin(coin_cache::coin& out_coin,
+        const chain::output_point& outpoint) const = 0;
+
     /// Import a block for the given height.
     virtual bool import(chain::block::ptr block, uint64_t height) = 0;
 
     /// Append the block to the top of the chain.
     virtual bool push(block_detail::ptr block) = 0;
 
+    /// Append the blocks to the top of the chain, in order, as one batch.
+    virtual bool push(const block_detail::list& blocks) = 0;
+
     /// Remove blocks at or above the given height, returning them in order.
     virtual bool pop_from(block_detail::list& out_blocks,
         uint64_t height) = 0;
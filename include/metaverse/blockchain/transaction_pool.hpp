@@ -23,6 +23,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <deque>
 #include <functional>
 #include <boost/circular_buffer.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -35,6 +36,11 @@ namespace libbitcoin {
 namespace blockchain {
 
 /// This class is thread safe.
+/// Validation is staged, the chain lookup of each transaction runs on the
+/// storage lane of the scheduler and its consensus checks on the network
+/// lane, while pool access and acceptance stay on the pool dispatcher. A bounded number of
+/// transactions is in the stages at once, the others wait in a bounded
+/// backlog.
 class BCB_API transaction_pool
 {
 public:
@@ -44,6 +50,7 @@ public:
 
     typedef handle0 result_handler;
     typedef handle1<transaction_ptr> fetch_handler;
+    typedef handle1<chain::transaction_view> fetch_view_handler;
     typedef handle1<std::vector<transaction_ptr>> fetch_all_handler;
     typedef handle1<transaction_ptr> confirm_handler;
     typedef handle2<transaction_ptr, indexes> validate_handler;
@@ -51,13 +58,15 @@ public:
         transaction_handler;
     typedef resubscriber<const code&, const indexes&, transaction_ptr>
         transaction_subscriber;
+    typedef std::function<void(const chain::transaction&, bool)>
+        change_handler;
 
     static bool is_spent_by_tx(const chain::output_point& outpoint,
         const transaction_ptr tx);
 
     /// Construct a transaction memory pool.
-    transaction_pool(threadpool& pool, block_chain& chain,
-        const settings& settings);
+    transaction_pool(threadpool& pool, scheduler& scheduler,
+        block_chain& chain, const settings& settings);
 
     /// Clear the pool, threads must be joined.
     ~transaction_pool();
@@ -76,6 +85,9 @@ public:
 
     void inventory(message::inventory::ptr inventory);
     void fetch(const hash_digest& tx_hash, fetch_handler handler);
+
+    /// Fetch a view of a pool transaction, serialized from the pooled object.
+    void fetch_view(const hash_digest& tx_hash, fetch_view_handler handler);
     void fetch(fetch_all_handler handler);
     void delete_tx(const hash_digest& tx_hash);
     void fetch_history(const wallet::payment_address& address, size_t limit,
@@ -89,6 +101,14 @@ public:
     /// Subscribe to transaction acceptance into the mempool.
     void subscribe_transaction(transaction_handler handler);
 
+    /// Changes whenever a transaction enters or leaves the mempool.
+    uint64_t revision() const;
+
+    /// Set before start, called on the pool dispatcher with true as each
+    /// transaction enters the mempool and with false as it leaves, so the
+    /// handler must not wait on the pool.
+    void set_change_handler(change_handler handler);
+
 protected:
     /// This is analogous to the orphan pool's block_detail.
     struct entry
@@ -100,6 +120,13 @@ protected:
     typedef boost::circular_buffer<entry> buffer;
     typedef buffer::const_iterator const_iterator;
 
+    /// A transaction waiting for a validation slot.
+    struct pending
+    {
+        transaction_ptr tx;
+        validate_handler handler;
+    };
+
     typedef std::function<bool(const chain::input&)> input_compare;
     typedef message::block_message::ptr_list block_list;
 
@@ -113,6 +140,9 @@ protected:
         const indexes& unconfirmed, validate_handler handler);
 
     void do_validate(transaction_ptr tx, validate_handler handler);
+    void begin_validate(transaction_ptr tx, validate_handler handler);
+    void next_validate();
+    size_t validate_limit() const;
     void do_store(const code& ec, transaction_ptr tx,
         const indexes& unconfirmed, confirm_handler handle_confirm,
         validate_handler handle_validate);
@@ -123,6 +153,8 @@ protected:
     void add(transaction_ptr tx, confirm_handler handler);
     void remove(const block_list& blocks);
     void clear(const code& ec);
+    void changed();
+    void changed(const chain::transaction& tx, bool entered);
 
     // These would be private but for test access.
     void delete_spent_in_blocks(const block_list& blocks);
@@ -134,9 +166,13 @@ protected:
     void delete_package(transaction_ptr tx, const code& ec);
     bool delete_single(const hash_digest& tx_hash, const code& ec);
 
-    // The buffer is protected by non-concurrent dispatch.
+    // The buffer and backlog are protected by non-concurrent dispatch.
     buffer buffer_;
+    std::deque<pending> backlog_;
+    size_t validating_;
     std::atomic<bool> stopped_;
+    std::atomic<uint64_t> revision_;
+    change_handler handle_change_;
 
 private:
     // Unsafe methods limited to friend caller.
@@ -157,6 +193,8 @@ private:
     transaction_pool_index index_;
     transaction_subscriber::ptr subscriber_;
     const bool maintain_consistency_;
+    const size_t backlog_limit_;
+    scheduler& scheduler_;
 };
 
 } // namespace blockchain
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_UTXO_VIEWS_HPP
+#define MVS_BLOCKCHAIN_UTXO_VIEWS_HPP
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The unspent outputs of recently queried addresses, so that a repeated
+/// send from an account reads neither the address history nor the output
+/// transactions. An address is read through the caller on a miss, then kept
+/// up to date as blocks are connected and disconnected and as transactions
+/// enter and leave the pool. The least recently queried addresses are
+/// evicted to stay within the memory limit.
+class BCB_API utxo_views
+{
+public:
+    struct coin
+    {
+        chain::output_point point;
+        chain::output output;
+
+        // Zero while in the pool.
+        uint64_t height;
+        bool coinbase;
+    };
+
+    typedef std::vector<coin> coin_list;
+
+    /// Read the unspent outputs of the address, including those spent only
+    /// in the pool. It is called without locking, since it waits on the
+    /// pool.
+    typedef std::function<coin_list(const std::string&)> coin_reader;
+
+    /// A zero capacity disables the cache, every query then reads.
+    utxo_views(database::data_base& database, uint64_t capacity_bytes);
+
+    /// Get the outputs of the address no pool transaction spends.
+    void get(const std::string& address, coin_reader read_coins,
+        coin_list& out_coins);
+
+    /// Apply a block stored at the height.
+    void connect(const chain::block& block, uint64_t height);
+
+    /// Revert a block removed from the height.
+    void disconnect(const chain::block& block, uint64_t height);
+
+    /// Follow a transaction entering the pool.
+    void add_pool(const chain::transaction& tx);
+
+    /// Follow a transaction leaving the pool, confirmed or not.
+    void remove_pool(const chain::transaction& tx);
+
+    /// Drop every address, they are read again on next use.
+    void clear();
+
+private:
+    typedef std::unordered_map<chain::output_point, coin> coin_map;
+    typedef std::list<std::string> address_order;
+
+    struct address_state
+    {
+        coin_map coins;
+        uint64_t bytes;
+
+        // The place of the address in the query order.
+        address_order::iterator recent;
+    };
+
+    static bool to_address(const chain::output& output,
+        std::string& out_address);
+    static uint64_t footprint(const coin& coin, const std::string& address);
+
+    // These are protected by mutex.
+    bool select(const std::string& address, coin_list& out_coins);
+    void select(const coin_list& coins, coin_list& out_coins) const;
+    void store(const std::string& address, const coin_list& coins);
+    void add(const std::string& address, const coin& coin);
+    void remove(const chain::output_point& point, bool pool_only);
+    void evict();
+
+    database::data_base& database_;
+    const uint64_t capacity_;
+
+    // These are protected by mutex.
+    std::unordered_map<std::string, address_state> addresses_;
+    address_order recent_;
+    uint64_t bytes_;
+
+    // The address of each cached coin.
+    std::unordered_map<chain::output_point, std::string> owners_;
+
+    // The pool transaction spending each point, of any address.
+    std::unordered_map<chain::output_point, hash_digest> pool_spends_;
+
+    // Changes whenever a block or pool transaction is applied.
+    uint64_t revision_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
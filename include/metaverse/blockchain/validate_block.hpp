@@ -28,6 +28,8 @@
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_chain_impl.hpp>
+#include <metaverse/blockchain/coin_cache.hpp>
+#include <metaverse/blockchain/script_verifier.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -46,7 +48,10 @@ class BCB_API validate_block
 public:
     code check_block(blockchain::block_chain_impl& chain) const;
     code accept_block() const;
-    code connect_block(hash_digest& err_tx) const;
+
+    /// Input scripts are collected across the block and verified together
+    /// by the verifier once all other input checks have passed.
+    code connect_block(hash_digest& err_tx, script_verifier& verifier) const;
 
     /// Required to call before calling accept_block or connect_block.
     void initialize_context();
@@ -73,14 +78,19 @@ protected:
     virtual bool is_output_spent(const chain::output_point& outpoint) const = 0;
     virtual bool is_output_spent(const chain::output_point& previous_output,
         size_t index_in_parent, size_t input_index) const = 0;
+    virtual bool fetch_cached_coin(coin_cache::coin& out_coin,
+        const chain::output_point& outpoint) const = 0;
+    virtual bool orphan_is_spent(const chain::output_point& previous_output,
+        size_t skip_tx, size_t skip_input) const = 0;
 
     // These have default implementations that can be overriden.
     virtual bool connect_input(size_t index_in_parent,
-        const chain::transaction& current_tx, size_t input_index,
-        uint64_t& value_in, size_t& total_sigops) const;
+        const script_verifier::check::context_ptr& context,
+        size_t input_index, uint64_t& value_in, size_t& total_sigops,
+        script_verifier::check::list& checks) const;
     virtual bool validate_inputs(const chain::transaction& tx,
-        size_t index_in_parent, uint64_t& value_in,
-        size_t& total_sigops) const;
+        size_t index_in_parent, uint64_t& value_in, size_t& total_sigops,
+        script_verifier::check::list& checks) const;
 
     // These are protected virtual for testability.
     bool stopped() const;
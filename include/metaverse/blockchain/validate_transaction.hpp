@@ -44,24 +44,36 @@ public:
     typedef std::function<void(const code&, transaction_ptr,
         chain::point::indexes)> validate_handler;
 
+    /// The pool checks run on dispatch, the chain reads on the storage lane
+    /// and the script checks on the network lane of the scheduler.
     validate_transaction(block_chain& chain, transaction_ptr tx,
-        const transaction_pool& pool, dispatcher& dispatch);
+        const transaction_pool& pool, dispatcher& dispatch,
+        scheduler& scheduler);
 
     validate_transaction(block_chain& chain, const chain::transaction& tx,
-        const transaction_pool& pool, dispatcher& dispatch);
+        const transaction_pool& pool, dispatcher& dispatch,
+        scheduler& scheduler);
 
+    /// Call from dispatch, the handler is invoked from any stage.
     void start(validate_handler handler);
 
     static bool check_consensus(const chain::script& prevout_script,
         const chain::transaction& current_tx, size_t input_index,
         uint32_t flags);
 
+    /// Check an input, sharing serialization and signature hashing state
+    /// with the other inputs of the transaction.
+    static bool check_consensus(const chain::script& prevout_script,
+        const chain::sighash_context& context, size_t input_index,
+        uint32_t flags);
+
     static code check_transaction(const chain::transaction& tx, blockchain::block_chain_impl& chain);
     static code check_transaction_basic(const chain::transaction& tx, blockchain::block_chain_impl& chain);
 
-    static bool connect_input(const chain::transaction& tx,
-        size_t current_input, const chain::transaction& previous_tx,
-        size_t parent_height, size_t last_block_height, uint64_t& value_in,
+    static bool connect_input(const chain::sighash_context& context,
+        size_t current_input, const chain::output& previous_output,
+        bool coinbase, size_t parent_height, size_t last_block_height,
+        uint64_t& value_in,
         uint32_t flags, uint64_t& asset_amount_in, std::string& old_symbol_in,
     std::string& new_symbol_in, uint32_t& business_tp_in);
 
@@ -73,30 +85,30 @@ public:
 private:
     code basic_checks(blockchain::block_chain_impl& chain) const;
     bool is_standard() const;
-    void handle_duplicate_check(const code& ec);
 
-    // Last height used for checking coinbase maturity.
+    // Chain lookup stage, reads the duplicate, the last height used for
+    // checking coinbase maturity and every prevout.
+    void lookup();
+    void handle_duplicate_check(const code& ec);
     void set_last_height(const code& ec, size_t last_height);
+    void handle_prevouts(const code& ec,
+        const block_chain::prevout_list& prevouts);
 
-    // Begin looping through the inputs, fetching the previous tx
-    void next_previous_transaction();
-    void previous_tx_index(const code& ec, size_t parent_height);
-
-    // If previous_tx_index didn't find it then check in pool instead
-    void search_pool_previous_tx();
-    void handle_previous_tx(const code& ec,
-        const chain::transaction& previous_tx, size_t parent_height);
+    // Pool stage, finds the prevouts the chain doesn't have in the pool.
+    void search_pool_prevouts();
 
-    // After running connect_input, we check whether this validated previous
-    // output was not already spent by another input in the blockchain.
-    // is_spent() earlier already checked in the pool.
-    void check_double_spend(const code& ec, const chain::input_point& point);
+    // Consensus stage, connects each input to its prevout and checks that
+    // the chain doesn't already spend it, is_spent_in_pool() checked the
+    // pool.
+    void connect_inputs();
     void check_fees();
 
     block_chain& blockchain_;
     const transaction_ptr tx_;
+    const chain::sighash_context sighash_;
     const transaction_pool& pool_;
     dispatcher& dispatch_;
+    scheduler& scheduler_;
 
     const hash_digest tx_hash_;
     size_t last_block_height_;
@@ -106,6 +118,7 @@ private:
 	std::string new_symbol_in_;
 	uint32_t business_tp_in_; // 1 -- asset issue  2 -- asset transfer
     uint32_t current_input_;
+    block_chain::prevout_list prevouts_;
     chain::point::indexes unconfirmed_;
     validate_handler handle_validate_;
 };
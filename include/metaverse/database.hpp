@@ -20,6 +20,7 @@
 #include <metaverse/database/settings.hpp>
 #include <metaverse/database/version.hpp>
 #include <metaverse/database/databases/block_database.hpp>
+#include <metaverse/database/databases/block_undo_database.hpp>
 #include <metaverse/database/databases/history_database.hpp>
 #include <metaverse/database/databases/spend_database.hpp>
 #include <metaverse/database/databases/stealth_database.hpp>
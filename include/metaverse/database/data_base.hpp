@@ -28,6 +28,7 @@
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database/databases/block_database.hpp>
+#include <metaverse/database/databases/block_undo_database.hpp>
 #include <metaverse/database/databases/spend_database.hpp>
 #include <metaverse/database/databases/transaction_database.hpp>
 #include <metaverse/database/databases/history_database.hpp>
@@ -75,6 +76,7 @@ public:
         path database_lock;
         path blocks_lookup;
         path blocks_index;
+        path block_undos_lookup;
         path history_lookup;
         path history_rows;
         path stealth_rows;
@@ -102,6 +104,7 @@ public:
         path database_lock;
         path blocks_lookup;
         path blocks_index;
+        path block_undos_lookup;
         path history_lookup;
         path history_rows;
         path stealth_rows;
@@ -150,6 +153,9 @@ public:
 
     /// Create a new database file with a given path prefix and default paths.
     static bool initialize(const path& prefix, const chain::block& genesis);
+
+    /// Create the undo file of a database created before block undo rows.
+    static bool initialize_undo(const path& prefix);
     static bool touch_file(const path& file_path);
 	static void write_metadata(const path& metadata_path, data_base::db_metadata& metadata);
 	static void read_metadata(const path& metadata_path, data_base::db_metadata& metadata);
@@ -200,13 +206,17 @@ public:
     /// If height is not count + 1 then the count will not equal top height.
     void push(const chain::block& block, uint64_t height);
 
+    /// Commit blocks at the next heights, synchronizing once for all.
+    void push(const chain::block::ptr_list& blocks);
+
     /// Throws if the chain is empty.
     chain::block pop();
 
     /* begin store asset info into  database */
 
 	void push_attachemnt(const attachment& attach, const payment_address& address,
-			const output_point& outpoint, uint32_t output_height, uint64_t value);
+			const output_point& outpoint, uint32_t output_height, uint64_t value,
+			block_undo& undo);
 
 	void push_etp(const etp& etp, const short_hash& key,
 			const output_point& outpoint, uint32_t output_height, uint64_t value);
@@ -218,10 +228,12 @@ public:
 			const output_point& outpoint, uint32_t output_height, uint64_t value);
 	
 	void push_asset(const asset& sp, const short_hash& key,
-				const output_point& outpoint, uint32_t output_height, uint64_t value);
+				const output_point& outpoint, uint32_t output_height, uint64_t value,
+				block_undo& undo);
 	
 	void push_asset_detail(const asset_detail& sp_detail, const short_hash& key,
-				const output_point& outpoint, uint32_t output_height, uint64_t value);
+				const output_point& outpoint, uint32_t output_height, uint64_t value,
+				block_undo& undo);
 	
 	void push_asset_transfer(const asset_transfer& sp_transfer, const short_hash& key,
 				const output_point& outpoint, uint32_t output_height, uint64_t value);
@@ -230,14 +242,15 @@ public:
 	{
 	public:
 		attachment_visitor(data_base* db, const short_hash& sh_hash,  const output_point& outpoint, 
-			uint32_t output_height, uint64_t value):
-			db_(db), sh_hash_(sh_hash), outpoint_(outpoint), output_height_(output_height), value_(value)
+			uint32_t output_height, uint64_t value, block_undo& undo):
+			db_(db), sh_hash_(sh_hash), outpoint_(outpoint), output_height_(output_height), value_(value),
+			undo_(undo)
 		{
 
 		}
 		void operator()(const asset &t) const
 		{
-			return db_->push_asset(t, sh_hash_, outpoint_, output_height_, value_);
+			return db_->push_asset(t, sh_hash_, outpoint_, output_height_, value_, undo_);
 		}
 		void operator()(const etp &t) const
 		{
@@ -257,20 +270,23 @@ public:
 		output_point outpoint_;
 		uint32_t output_height_;
 		uint64_t value_;
+		block_undo& undo_;
 	};
 
 	class asset_visitor : public boost::static_visitor<void>
 	{
 	public:
 		asset_visitor(data_base* db, const short_hash& key,
-			const output_point& outpoint, uint32_t output_height, uint64_t value):
-			db_(db), key_(key), outpoint_(outpoint), output_height_(output_height), value_(value)
+			const output_point& outpoint, uint32_t output_height, uint64_t value,
+			block_undo& undo):
+			db_(db), key_(key), outpoint_(outpoint), output_height_(output_height), value_(value),
+			undo_(undo)
 		{
 
 		}
 		void operator()(const asset_detail &t) const
 		{
-			return db_->push_asset_detail(t, key_, outpoint_, output_height_, value_);
+			return db_->push_asset_detail(t, key_, outpoint_, output_height_, value_, undo_);
 		}
 		void operator()(const asset_transfer &t) const
 		{
@@ -282,13 +298,16 @@ public:
 		output_point outpoint_;
 		uint32_t output_height_;
 		uint64_t value_;
+		block_undo& undo_;
 	};
 	void set_admin(const std::string& name, const std::string& passwd);
    /* begin store asset info into  database */
 
 protected:
-    data_base(const store& paths, size_t history_height, size_t stealth_height);
-    data_base(const path& prefix, size_t history_height, size_t stealth_height);
+    data_base(const store& paths, size_t history_height, size_t stealth_height,
+        size_t undo_depth);
+    data_base(const path& prefix, size_t history_height, size_t stealth_height,
+        size_t undo_depth);
 
 private:
     typedef chain::input::list inputs;
@@ -300,18 +319,23 @@ private:
     static file_lock initialize_lock(const path& lock);
 
     void synchronize();
+    void push_block(const chain::block& block, uint64_t height);
     void push_inputs(const hash_digest& tx_hash, size_t height,
-        const inputs& inputs);
+        const inputs& inputs, block_undo& undo);
     void push_outputs(const hash_digest& tx_hash, size_t height,
-        const outputs& outputs);
+        const outputs& outputs, block_undo& undo);
     void push_stealth(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
     void pop_inputs(const inputs& inputs, size_t height);
     void pop_outputs(const outputs& outputs, size_t height);
+    void pop_undo(const block_undo& undo);
+    void prune_undo(uint64_t height);
+    bool compact_undo();
 
     const path lock_file_path_;
     const size_t history_height_;
     const size_t stealth_height_;
+    const size_t undo_depth_;
 
     // Atomic counter for implementing the sequential lock pattern.
     sequential_lock sequential_lock_;
@@ -329,6 +353,7 @@ public:
 
     /// Individual database query engines.
     block_database blocks;
+    block_undo_database block_undos;
     history_database history;
     spend_database spends;
     stealth_database stealth;
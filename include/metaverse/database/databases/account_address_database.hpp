@@ -86,6 +86,10 @@ public:
 
     void safe_store(const short_hash& key, const account_address& address);
 
+    /// Append many rows under one key without the duplicate scan of store.
+    void safe_store(const short_hash& key,
+        const account_address::list& addresses);
+
     /// Synchonise with disk.
     void sync();
 
@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_BLOCK_UNDO_DATABASE_HPP
+#define MVS_DATABASE_BLOCK_UNDO_DATABASE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/slab_hash_table.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// The index rows a block added when it was pushed, in the order they were
+/// added, so that the block can be popped by removing them in reverse
+/// without reading addresses back out of its scripts.
+class BCD_API block_undo
+{
+public:
+    enum class row_kind : uint8_t
+    {
+        transaction,
+        spend,
+        history,
+        address_asset,
+        asset
+    };
+
+    struct row
+    {
+        row_kind kind;
+
+        // The transaction or the asset symbol hash.
+        hash_digest hash;
+
+        // The history or the address asset key.
+        short_hash key;
+
+        // The previous output of a spend.
+        chain::output_point point;
+    };
+
+    typedef std::vector<row> list;
+
+    void clear();
+    bool empty() const;
+
+    void add_transaction(const hash_digest& tx_hash);
+    void add_spend(const chain::output_point& previous);
+    void add_history(const short_hash& key);
+    void add_address_asset(const short_hash& key);
+    void add_asset(const hash_digest& symbol_hash);
+
+    /// The rows in the order they were added.
+    list rows() const;
+
+    const data_chunk& data() const;
+    void set_data(data_chunk&& data);
+
+private:
+    data_chunk data_;
+};
+
+/// This enables lookups of the undo rows of a block by block hash.
+class BCD_API block_undo_database
+{
+public:
+    /// Construct the database.
+    block_undo_database(const boost::filesystem::path& map_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~block_undo_database();
+
+    /// Initialize a new block undo database.
+    bool create();
+
+    /// Call before using the database, a file that was only touched by an
+    /// upgrade is initialized here.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Fetch the undo rows of a block, false if none were stored.
+    bool get(const hash_digest& block_hash, block_undo& out_undo) const;
+
+    /// Store the undo rows of a block.
+    void store(const hash_digest& block_hash, const block_undo& undo);
+
+    /// Delete the undo rows of a block, false if none were stored.
+    /// The space of the rows is only reused after compact.
+    bool remove(const hash_digest& block_hash);
+
+    /// Drop the undo rows of every block but the given ones, reusing the
+    /// space of all rows. Call only while nothing else uses the database.
+    bool compact(const hash_list& keep);
+
+    /// Synchronise storage with disk so things are consistent.
+    /// Should be done at the end of every block write.
+    void sync();
+
+private:
+    typedef slab_hash_table<hash_digest> slab_map;
+
+    // Hash table used for looking up undo rows by block hash.
+    memory_map lookup_file_;
+    slab_hash_table_header lookup_header_;
+    slab_manager lookup_manager_;
+    slab_map lookup_map_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -84,6 +84,53 @@ void record_multimap<KeyType>::add_row(const KeyType& key,
     add_to_list(start_info, write);
 }
 
+template <typename KeyType>
+void record_multimap<KeyType>::add_rows(const KeyType& key, size_t count,
+    indexed_write_function write)
+{
+    if (count == 0)
+        return;
+
+    size_t row = 0;
+    auto start_info = map_.find(key);
+
+    if (!start_info)
+    {
+        const auto write_first = [&write](memory_ptr data)
+        {
+            write(0, data);
+        };
+
+        create_new(key, write_first);
+        start_info = map_.find(key);
+        ++row;
+    }
+
+    const auto address = REMAP_ADDRESS(start_info);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    auto begin = from_little_endian_unsafe<array_index>(address);
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The records_ and start_info remap safe pointers are in distinct files.
+    for (; row < count; ++row)
+    {
+        begin = records_.insert(begin);
+        write(row, records_.get(begin));
+    }
+
+    auto serial = make_serializer(address);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    serial.template write_little_endian<array_index>(begin);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 template <typename KeyType>
 void record_multimap<KeyType>::add_to_list(memory_ptr start_info,
     write_function write)
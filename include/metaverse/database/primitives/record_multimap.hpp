@@ -52,6 +52,7 @@ class record_multimap
 public:
     typedef record_hash_table<KeyType> record_hash_table_type;
     typedef std::function<void(memory_ptr)> write_function;
+    typedef std::function<void(size_t, memory_ptr)> indexed_write_function;
 
     record_multimap(record_hash_table_type& map, record_list& records);
 
@@ -62,6 +63,11 @@ public:
     /// If it does exist, the value will be added at the start of the chain.
     void add_row(const KeyType& key, write_function write);
 
+    /// Add count rows for a key with a single lookup and start update.
+    /// The rows are chained as if added in order by add_row.
+    void add_rows(const KeyType& key, size_t count,
+        indexed_write_function write);
+
     /// Delete the last row entry that was added. This means when deleting
     /// blocks we must walk backwards and delete in reverse order.
     void delete_last_row(const KeyType& key);
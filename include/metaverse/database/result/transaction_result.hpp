@@ -48,6 +48,10 @@ public:
     /// The transaction.
     chain::transaction transaction() const;
 
+    /// The transaction as a compact view over a copy of its stored bytes,
+    /// with the hash precomputed and scripts left undecoded.
+    chain::transaction_view view() const;
+
 private:
     const memory_ptr slab_;
 };
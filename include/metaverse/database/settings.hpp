@@ -38,6 +38,7 @@ public:
     /// Properties.
     uint32_t history_start_height;
     uint32_t stealth_start_height;
+    uint32_t block_undo_depth;
     boost::filesystem::path directory;
 };
 
@@ -22,8 +22,10 @@
 #define BX_DISPATCH_HPP
 
 #include <iostream>
+#include <string>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/explorer/define.hpp>
+#include <metaverse/explorer/parser.hpp>
 #include <metaverse/server/server_node.hpp>
 
 /* NOTE: don't declare 'using namespace foo' in headers. */
@@ -69,6 +71,31 @@ BCX_API console_result dispatch_command(int argc, const char* argv[],
     Json::Value& jv_output, 
     bc::server::server_node& node, uint8_t api_version = 1);
 
+/**
+ * Split the params of a JSON-RPC request as dispatch_command binds them.
+ * The first object in the params holds options by name, its other objects
+ * are ignored. The other params are command line tokens, so they may hold
+ * options such as "-n" "10" as well as the arguments in order.
+ * @param[in]   params      The params array of the request.
+ * @param[out]  out_named   The options of the first object.
+ * @param[out]  out_tokens  The other params as command line tokens.
+ */
+BCX_API void split_params(const Json::Value& params,
+    parser::named_values& out_named, parser::token_values& out_tokens);
+
+/**
+ * Invoke the command named by a JSON-RPC method, binding its params to the
+ * command as split by split_params.
+ * @param[in]  method  The command symbolic name.
+ * @param[in]  params  The params array of the request.
+ * @param[in]  node server_node instance.
+ * @param[in]  command version, defaults to v2.
+ * @return            The appropriate console return code { -1, 0, 1 }.
+ */
+BCX_API console_result dispatch_command(const std::string& method,
+    const Json::Value& params, Json::Value& jv_output,
+    bc::server::server_node& node, uint8_t api_version = 2);
+
 } // namespace explorer
 } // namespace libbitcoin
 
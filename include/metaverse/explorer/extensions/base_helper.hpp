@@ -41,6 +41,14 @@ enum utxo_attach_type : uint32_t
 	digital_identity
 };
 
+// how the inputs of a transfer are chosen from the account utxo
+enum class coin_selection : uint32_t
+{
+	branch_and_bound, // least change, falls back to minimize_inputs
+	largest_first,
+	minimize_inputs
+};
+
 struct address_asset_record{
 	std::string prikey;
 	std::string addr;
@@ -114,7 +122,6 @@ public:
 	static const uint64_t attach_version{1};
 	
 	virtual void sum_payment_amount();
-	virtual void sync_fetchutxo (const std::string& prikey, const std::string& addr);
 	virtual void populate_unspent_list();
 	virtual void populate_change() = 0; 
 
@@ -132,8 +139,17 @@ public:
 	virtual void exec();
 	tx_type& get_transaction();
 	std::vector<unsigned char> satoshi_to_chunk(const int64_t& value);
+	void set_coin_selection(coin_selection strategy){ selection_ = strategy; };
 			
 protected:
+	// Fill from_list_ from the plain or the script addresses of the account.
+	void select_unspent(bool script_addresses);
+
+	// An unlocked account session makes these skip key decryption/parsing.
+	std::string get_private_key(const account_address& address);
+	void get_signing_key(const address_asset_record& record,
+		ec_secret& secret, ec_compressed& point);
+
 	command&                          cmd_;
 	tx_type                           tx_; // target transaction
 	bc::blockchain::block_chain_impl& blockchain_;
@@ -146,6 +162,7 @@ protected:
 	uint64_t                          unspent_etp_{0};
 	uint64_t                          unspent_asset_{0};
 	uint64_t                          tx_item_idx_{0};
+	coin_selection                    selection_{coin_selection::branch_and_bound};
     // to
     std::vector<receiver_record>      receiver_list_;
     // from
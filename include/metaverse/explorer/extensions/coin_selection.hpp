@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/explorer/define.hpp>
+#include <metaverse/explorer/extensions/base_helper.hpp>
+#include <metaverse/blockchain/block_chain_impl.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+
+typedef std::vector<address_asset_record> utxo_list;
+
+/// The spendable outputs of the given addresses, leaving out unexpired
+/// deposits and immature coinbase outputs. The records carry no private key.
+/// The outputs come from the utxo views of the chain, which follow blocks
+/// and the pool, so only the height rules are applied on each call.
+class BCX_API utxo_view
+{
+public:
+    typedef std::shared_ptr<const utxo_list> ptr;
+
+    /// Build the view over the addresses at the current height.
+    static ptr fetch(bc::blockchain::block_chain_impl& blockchain,
+        const std::vector<std::string>& addresses);
+};
+
+/// Parse a strategy name, one of branch-and-bound, largest-first and
+/// minimize-inputs.
+BCX_API bool parse_coin_selection(const std::string& text,
+    coin_selection& out_strategy);
+
+/// Choose the coins covering the etp and the asset amounts, the asset coins
+/// are those of the symbol and their etp counts toward the etp amount.
+/// Returns false if an amount cannot be covered, every coin of that kind is
+/// then selected.
+BCX_API bool select_coins(coin_selection strategy, const utxo_list& coins,
+    const std::string& symbol, uint64_t etp_amount, uint64_t asset_amount,
+    size_t max_inputs, utxo_list& out_selected);
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
@@ -31,6 +31,8 @@ namespace libbitcoin {
 namespace explorer {
 
 
+typedef std::function<std::shared_ptr<command>()> command_factory;
+
 std::string formerly_extension(const std::string& former);
 
 std::shared_ptr<command> find_extension(const std::string& symbol);
@@ -63,6 +63,11 @@ public:
             BX_HELP_VARIABLE ",h",
             value<bool>()->zero_tokens(),
             "Get a description and instructions for this command."
+        )
+        (
+            "traffic,t",
+            value<bool>(&option_.traffic)->default_value(false)->zero_tokens(),
+            "List peers with their traffic counters, default is false."
         )
 	    (
             "ADMINNAME",
@@ -91,6 +96,7 @@ public:
 
     struct option
     {
+        bool traffic;
     } option_;
 
 };
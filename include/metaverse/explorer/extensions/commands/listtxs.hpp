@@ -99,6 +99,11 @@ public:
             value<uint64_t>(&argument_.index)->default_value(1),
             "Page index."
         )
+        (
+            "cursor,c",
+            value<uint64_t>(&argument_.cursor)->default_value(0),
+            "Continue after the page that returned this next_cursor, the page index is then ignored."
+        )
         ;
 
 
@@ -114,12 +119,13 @@ public:
 
     struct argument
     {
-    	argument():address(""), symbol(""), limit(100), index(0)
+    	argument():address(""), symbol(""), limit(100), index(0), cursor(0)
 		{};
     	std::string address;
 		std::string symbol;
         uint64_t limit;
         uint64_t index;
+        uint64_t cursor;
     } argument_;
 
     struct option
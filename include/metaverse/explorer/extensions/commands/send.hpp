@@ -95,7 +95,12 @@ public:
             "fee,f",
             value<uint64_t>(&argument_.fee)->default_value(10000),
             "Transaction fee. defaults to 10000 etp bits"
-	    );
+	    )
+        (
+            "selection,s",
+            value<std::string>(&argument_.selection)->default_value("branch-and-bound"),
+            "Coin selection strategy: branch-and-bound, largest-first or minimize-inputs. defaults to branch-and-bound"
+        );
 
         return options;
     }
@@ -114,6 +119,7 @@ public:
         std::string address;
         uint64_t amount;
         uint64_t fee;
+        std::string selection;
         std::string memo;
     } argument_;
 
@@ -37,6 +37,8 @@ uint64_t get_last_height(bc::server::server_node& node);
 
 uint32_t get_connections_count(bc::server::server_node& node);
 
+Json::Value get_traffic_json(const bc::network::traffic::counters& counters);
+
 } // namespace commands
 } // namespace explorer
 } // namespace libbitcoin
@@ -21,8 +21,11 @@
 #ifndef BX_PARSER_HPP
 #define BX_PARSER_HPP
 
+#include <functional>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/explorer/command.hpp>
@@ -39,6 +42,13 @@ class BCX_API parser
   : public bc::config::parser
 {
 public:
+    /// Named option values, an option without a value is a switch.
+    typedef std::vector<std::pair<std::string, std::vector<std::string>>>
+        named_values;
+
+    /// Command line tokens, without the command name.
+    typedef std::vector<std::string> token_values;
+
     /// Construct the parser for the given command.
     parser(command& instance);
 
@@ -46,6 +56,12 @@ public:
     virtual bool parse(std::string& out_error, std::istream& input,
         int argc, const char* argv[]);
 
+    /// Parse the values of a JSON-RPC request. The tokens are parsed as a
+    /// command line, so "-n 10" or "--fee 100" bind as options and the rest
+    /// as arguments. The named values bind as options without tokenizing.
+    virtual bool parse(std::string& out_error, std::istream& input,
+        const named_values& named, const token_values& tokens);
+
     virtual bool help() const;
 
     /// Load command line options (named).
@@ -64,7 +80,14 @@ protected:
     virtual void load_command_variables(variables_map& variables,
         std::istream& input, int argc, const char* argv[]);
 
+    virtual void load_command_variables(variables_map& variables,
+        std::istream& input, const named_values& named,
+        const token_values& tokens);
+
 private:
+    bool parse(std::string& out_error,
+        std::function<void(variables_map&)> load_command);
+
     static std::string system_config_directory();
     static boost::filesystem::path default_config_path();
 
@@ -42,6 +42,9 @@ public:
     void rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version = 1);
     void ws_request(mg_connection& nc, WebsocketMessage ws);
 
+    /// Serve the node metrics in the Prometheus text format.
+    void metrics_request(mg_connection& nc);
+
 public:
     void reset(HttpMessage& data) noexcept;
 
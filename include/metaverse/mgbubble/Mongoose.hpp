@@ -90,11 +90,16 @@ public:
 
     const int64_t jsonrpc_id() const noexcept { return jsonrpc_id_; }
 
+    /// The request params, read by data_to_arg.
+    const Json::Value& params() const noexcept { return params_; }
+
+    /// Read the method and the params, no argv is built.
     void data_to_arg(uint8_t rpc_version) override;
     
 private:
     int64_t jsonrpc_id_;
     http_message* impl_;
+    Json::Value params_;
 };
 
 class WebsocketMessage:public ToCommandArg { // connect to bx command-tool
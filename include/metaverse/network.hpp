@@ -30,6 +30,7 @@
 #include <metaverse/network/proxy.hpp>
 #include <metaverse/network/settings.hpp>
 #include <metaverse/network/socket.hpp>
+#include <metaverse/network/traffic.hpp>
 #include <metaverse/network/version.hpp>
 #include <metaverse/network/protocols/protocol.hpp>
 #include <metaverse/network/protocols/protocol_address.hpp>
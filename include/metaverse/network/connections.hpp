@@ -101,6 +101,7 @@ public:
     virtual void exists(const config::authority& authority,
         truth_handler handler) const;
     config::authority::list authority_list();
+    std::vector<channel::ptr> channel_list();
 
 private:
     typedef std::vector<channel::ptr> list;
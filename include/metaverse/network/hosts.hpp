@@ -27,6 +27,8 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/define.hpp>
@@ -37,17 +39,14 @@ namespace network {
 
 /// This class is thread safe.
 /// The hosts class manages a thread-safe dynamic store of network addresses.
-/// The store can be loaded and saved from/to the specified file path.
+/// Addresses are kept in two bucketed tables, "new" for gossiped addresses
+/// and "tried" for addresses we have connected to, bucketed by network group
+/// so that a single group cannot crowd out the table. Each address carries a
+/// success/failure score which biases selection and eviction.
+/// The store is incrementally appended to the specified file path and is
+/// compacted on stop or once the appended lines outgrow the table.
 /// The file is a line-oriented set of config::authority serializations.
 /// Duplicate addresses and those with zero-valued ports are disacarded.
-
-struct address_compare{
-	bool operator()(const libbitcoin::message::network_address& lhs, const libbitcoin::message::network_address& rhs) const
-	{
-		return lhs.ip < rhs.ip ? true : (lhs.ip > rhs.ip ? false : lhs.port < rhs.port);
-	}
-};
-
 class BCT_API hosts
   : public enable_shared_from_base<hosts>
 {
@@ -70,23 +69,74 @@ public:
     virtual code stop();
 
     virtual size_t count() const;
+
+    /// Select a random address, preferring well scored ones, not excluded.
     virtual code fetch(address& out, const config::authority::list& excluded_list);
+
+    /// Record a failed connection attempt to the address.
     virtual code remove(const address& host);
+
+    /// Record a successful connection to the address (or learn it).
     virtual code store(const address& host);
+
+    /// Learn gossiped addresses, without affecting scores.
     virtual void store(const address::list& hosts, result_handler handler);
+
     address::list copy();
-private:
-//    typedef boost::circular_buffer<address> list;
-    using list = std::set<address, address_compare >;
-    typedef list::iterator iterator;
 
-    iterator find(const address& host);
+private:
+    struct entry
+    {
+        address host;
+        uint32_t attempts;
+        uint32_t successes;
+    };
+
+    struct slot
+    {
+        bool tried;
+        uint32_t bucket;
+        uint32_t position;
+    };
+
+    struct address_hash
+    {
+        size_t operator()(const address& host) const;
+    };
+
+    struct address_equal
+    {
+        bool operator()(const address& lhs, const address& rhs) const;
+    };
+
+    typedef std::vector<entry> bucket;
+    typedef std::vector<bucket> table;
+    typedef std::unordered_map<address, slot, address_hash, address_equal>
+        index;
+    typedef std::unordered_set<address, address_hash, address_equal>
+        exclusions;
+
+    code learn(const address& host);
     void do_store(const address& host, result_handler handler);
     void handle_timer(const code& ec);
 
+    // These require the mutex to be held by the caller.
+    uint32_t bucket_of(const address& host, bool tried) const;
+    void insert(const entry& value, bool tried);
+    entry erase(index::iterator it);
+    bool select(address& out, bool tried, const exclusions& excluded) const;
+    bool scan(address& out, const exclusions& excluded) const;
+    void append();
+    bool compact();
+
     // These are protected by a mutex.
-    list buffer_;
-    list inactive_;
+    table new_;
+    table tried_;
+    index index_;
+    size_t new_count_;
+    size_t tried_count_;
+    address::list unsaved_;
+    size_t appended_;
     std::atomic<bool> stopped_;
     mutable upgrade_mutex mutex_;
 
@@ -95,6 +145,9 @@ private:
 
     // HACK: we use this because the buffer capacity cannot be set to zero.
     const bool disabled_;
+    const size_t bucket_size_;
+    const uint64_t key0_;
+    const uint64_t key1_;
     const boost::filesystem::path file_path_;
     threadpool& pool_;
     deadline::ptr snap_timer_;
@@ -106,39 +106,60 @@ public:
         subscribe(Message(), std::forward<Handler>(handler));
     }
         
+    /// Verification applied to a parsed message before it is delivered.
+    typedef std::function<code()> payload_check;
+
     /**
-     * Load a stream into a message instance and notify subscribers.
-     * @param[in]  stream      The stream from which to load the message.
-     * @param[in]  version  The peer protocol version.
+     * Load a reader into a message instance and notify subscribers.
+     * @param[in]  source      The reader from which to load the message.
+     * @param[in]  version     The peer protocol version.
      * @param[in]  subscriber  The subscriber for the message type.
+     * @param[in]  check       Optional verification of the parsed payload,
+     *                         subscribers are not notified if it fails.
      * @return                 Returns error::bad_stream if failed.
      */
     template <class Message, class Subscriber>
-    code relay(std::istream& stream, uint32_t version,
-        Subscriber subscriber) const
+    code relay(reader& source, uint32_t version, Subscriber subscriber,
+        const payload_check& check) const
     {
         const auto message_ptr = std::make_shared<Message>();
-        const bool parsed = message_ptr->from_data(version, stream);
-        const code ec(parsed ? error::success : error::bad_stream);
-        subscriber->relay(ec, message_ptr);
+        if (!message_ptr->from_data(version, source))
+        {
+            subscriber->relay(error::bad_stream, message_ptr);
+            return error::bad_stream;
+        }
+
+        const auto ec = check ? check() : code(error::success);
+        if (!ec)
+            subscriber->relay(ec, message_ptr);
+
         return ec;
     }
 
     /**
-     * Load a stream into a message instance and invoke subscribers.
-     * @param[in]  stream      The stream from which to load the message.
-     * @param[in]  version  The peer protocol version.
+     * Load a reader into a message instance and invoke subscribers.
+     * @param[in]  source      The reader from which to load the message.
+     * @param[in]  version     The peer protocol version.
      * @param[in]  subscriber  The subscriber for the message type.
+     * @param[in]  check       Optional verification of the parsed payload,
+     *                         subscribers are not invoked if it fails.
      * @return                 Returns error::bad_stream if failed.
      */
     template <class Message, class Subscriber>
-    code handle(std::istream& stream, uint32_t version,
-        Subscriber subscriber) const
+    code handle(reader& source, uint32_t version, Subscriber subscriber,
+        const payload_check& check) const
     {
         const auto message_ptr = std::make_shared<Message>();
-        const bool parsed = message_ptr->from_data(version, stream);
-        const code ec(parsed ? error::success : error::bad_stream);
-        subscriber->invoke(ec, message_ptr);
+        if (!message_ptr->from_data(version, source))
+        {
+            subscriber->invoke(error::bad_stream, message_ptr);
+            return error::bad_stream;
+        }
+
+        const auto ec = check ? check() : code(error::success);
+        if (!ec)
+            subscriber->invoke(ec, message_ptr);
+
         return ec;
     }
 
@@ -160,6 +181,20 @@ public:
     virtual code load(message::message_type type, uint32_t version,
         std::istream& stream) const;
 
+    /*
+     * Load a message of the specified command type directly from a reader.
+     * The message is parsed in place, without an intermediate buffer copy.
+     * Sends the message instance to each subscriber of the type, provided
+     * that the parse and the optional check both succeed.
+     * @param[in]  type     The message type identifier.
+     * @param[in]  version  The peer protocol version.
+     * @param[in]  source   The reader from which to load the message.
+     * @param[in]  check    Optional verification of the parsed payload.
+     * @return              Returns error::bad_stream if failed.
+     */
+    virtual code load(message::message_type type, uint32_t version,
+        reader& source, const payload_check& check=nullptr) const;
+
     /**
      * Start all subscribers so that they accept subscription.
      */
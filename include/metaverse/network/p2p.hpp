@@ -131,6 +131,9 @@ public:
     /// Return a reference to the network threadpool.
     virtual threadpool& thread_pool();
 
+    /// Return a reference to the prioritized work scheduler.
+    virtual scheduler& job_scheduler();
+
     // Subscriptions.
     // ------------------------------------------------------------------------
 
@@ -228,6 +231,7 @@ private:
     std::atomic<size_t> height_;
     bc::atomic<session_manual::ptr> manual_;
     threadpool threadpool_;
+    scheduler scheduler_;
     hosts::ptr hosts_;
     connections::ptr connections_;
     stop_subscriber::ptr stop_subscriber_;
@@ -34,6 +34,7 @@
 #include <metaverse/network/define.hpp>
 #include <metaverse/network/message_subscriber.hpp>
 #include <metaverse/network/socket.hpp>
+#include <metaverse/network/traffic.hpp>
 #include <metaverse/bitcoin/utility/dispatcher.hpp>
 #include <boost/thread.hpp>
 
@@ -87,6 +88,9 @@ public:
     /// Get the authority of the far end of this socket.
     virtual const config::authority& authority() const;
 
+    /// Get the traffic counters of this socket.
+    virtual const traffic& counters() const;
+
     /// Get the p2p protocol version object of the peer.
     virtual message::version version() const;
 
@@ -113,9 +117,6 @@ protected:
     virtual void handle_stopping() = 0;
 
 private:
-    typedef byte_source<data_chunk> payload_source;
-    typedef boost::iostreams::stream<payload_source> payload_stream;
-
     static config::authority authority_factory(socket::ptr socket);
 
     void do_close();
@@ -131,9 +132,10 @@ private:
     void do_send(const std::string& command, const_buffer buffer,
         result_handler handler);
     void handle_send(const boost_code& ec, const_buffer buffer,
-        result_handler handler);
+        message::message_type type, result_handler handler);
 
-    void handle_request(data_chunk payload_buffer, uint32_t protocol_version_, message::heading head, size_t payload_size);
+    bool handle_request(const message::heading& head,
+        uint32_t peer_protocol_version);
 
     const uint32_t protocol_magic_;
     const uint32_t protocol_version_;
@@ -151,6 +153,7 @@ private:
     std::atomic<uint32_t> peer_protocol_version_;
     bc::atomic<message::version::ptr> peer_version_message_;
     message_subscriber message_subscriber_;
+    traffic traffic_;
     stop_subscriber::ptr stop_subscriber_;
     std::queue<request_callback> outbound_queue_;
     std::atomic_bool has_sent_;
@@ -38,6 +38,7 @@ public:
 
     /// Properties.
     uint32_t threads;
+    uint32_t scheduler_threads;
     uint32_t protocol;
     uint32_t identifier;
     uint16_t inbound_port;
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NETWORK_TRAFFIC_HPP
+#define MVS_NETWORK_TRAFFIC_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// Lock free byte, message and latency counters, by message type.
+/// Each channel owns an instance and also feeds the process wide instance.
+class BCT_API traffic
+{
+public:
+    typedef message::message_type message_type;
+
+    /// A consistent-enough copy of the counters for reporting.
+    struct counters
+    {
+        uint64_t bytes_in;
+        uint64_t bytes_out;
+        uint64_t messages_in;
+        uint64_t messages_out;
+
+        /// Time spent parsing and handling received messages.
+        uint64_t handle_microseconds;
+    };
+
+    static constexpr size_t message_types =
+        static_cast<size_t>(message_type::version) + 1;
+
+    /// The instance accumulating the traffic of all channels.
+    static traffic& global();
+
+    /// The command name of a message type, empty for unknown.
+    static std::string command(message_type type);
+
+    traffic();
+
+    /// This class is not copyable.
+    traffic(const traffic&) = delete;
+    void operator=(const traffic&) = delete;
+
+    void received(message_type type, uint64_t bytes, uint64_t microseconds);
+    void sent(message_type type, uint64_t bytes);
+
+    counters total() const;
+    counters by_type(message_type type) const;
+
+private:
+    struct cell
+    {
+        std::atomic<uint64_t> bytes_in;
+        std::atomic<uint64_t> bytes_out;
+        std::atomic<uint64_t> messages_in;
+        std::atomic<uint64_t> messages_out;
+        std::atomic<uint64_t> handle_microseconds;
+    };
+
+    std::array<cell, message_types> cells_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
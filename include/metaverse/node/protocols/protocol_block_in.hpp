@@ -24,6 +24,7 @@
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/define.hpp>
@@ -39,7 +40,8 @@ public:
 
     /// Construct a block protocol instance.
     protocol_block_in(network::p2p& network, network::channel::ptr channel,
-        blockchain::block_chain& blockchain);
+        blockchain::block_chain& blockchain,
+        blockchain::transaction_pool& pool);
 
     ptr do_subscribe();
 
@@ -54,6 +56,20 @@ private:
     typedef message::inventory::ptr inventory_ptr;
     typedef message::not_found::ptr not_found_ptr;
     typedef message::block_message::ptr_list block_ptr_list;
+    typedef message::compact_block::ptr compact_block_ptr;
+    typedef message::block_transactions::ptr block_transactions_ptr;
+    typedef blockchain::transaction_pool::transaction_ptr transaction_ptr;
+
+    // A compact block awaiting transactions requested from the peer.
+    struct compact_state
+    {
+        typedef std::shared_ptr<compact_state> ptr;
+
+        hash_digest hash;
+        chain::header header;
+        chain::transaction::list transactions;
+        std::vector<uint64_t> missing;
+    };
 
     void get_block_inventory(const code& ec);
     void send_get_blocks(const hash_digest& stop_hash);
@@ -71,11 +87,28 @@ private:
     bool handle_reorganized(const code& ec, size_t fork_point,
         const block_ptr_list& incoming, const block_ptr_list& outgoing);
 
+    // BIP152 compact block reconstruction.
+    bool handle_receive_compact_block(const code& ec,
+        compact_block_ptr message);
+    void handle_fetch_pool(const code& ec,
+        const std::vector<transaction_ptr>& pool, compact_block_ptr message);
+    bool handle_receive_block_transactions(const code& ec,
+        block_transactions_ptr message);
+    void send_get_block_transactions(compact_state::ptr state);
+    void send_get_full_block(const hash_digest& hash);
+    void complete_compact_block(compact_state::ptr state);
+
     blockchain::block_chain& blockchain_;
+    blockchain::transaction_pool& pool_;
     bc::atomic<hash_digest> last_locator_top_;
     bc::atomic<hash_digest> current_chain_top_;
     const bool headers_from_peer_;
+    const bool compact_from_peer_;
     std::atomic_int headers_batch_size_;
+
+    // This is protected by mutex.
+    compact_state::ptr pending_compact_;
+    mutable shared_mutex compact_mutex_;
 };
 
 } // namespace node
@@ -71,13 +71,9 @@ private:
         result_handler handler);
     void handle_channel_stop(const code& ec, network::connector::ptr connect, reservation::ptr row, result_handler handler);
 
-    void reset_timer(network::connector::ptr connect);
-    void handle_timer(const code& ec, network::connector::ptr connect);
-
     // These are thread safe.
     blockchain::simple_chain& blockchain_;
     reservations reservations_;
-    deadline::ptr timer_;
     unique_mutex mutex_;
     int32_t reservations_count_;
 
@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <vector>
 #include <boost/bimap.hpp>
 #include <boost/bimap/set_of.hpp>
@@ -61,6 +62,12 @@ public:
     /// The number of outstanding blocks.
     size_t size() const;
 
+    /// The number of outstanding blocks that have been requested.
+    size_t in_flight() const;
+
+    /// The number of blocks to keep in flight, sized from the current rate.
+    size_t window() const;
+
     /// The reservation is empty and will remain so.
     bool stopped() const;
 
@@ -79,8 +86,9 @@ public:
     /// The current cached average block import rate excluding import time.
     void set_rate(const performance& rate);
 
-    /// The block data request message for the outstanding block hashes.
-    /// Set new if the preceding request was unsuccessful or discarded.
+    /// The block data request message for the lowest outstanding hashes not
+    /// yet in flight, up to the window size. Empty until the window is half
+    /// drained. Set new if the preceding request was unsuccessful or discarded.
     message::get_data request(bool new_channel);
 
     /// Add the block hash to the reservation.
@@ -92,10 +100,8 @@ public:
     /// Add to the blockchain, with height determined by the reservation.
     void import(chain::block::ptr block);
 
-    /// Determine if the reservation was partitioned and reset partition flag.
-    bool toggle_partitioned();
-
-    /// Move half of the reservation to the specified reservation.
+    /// Move half of the unrequested hashes to the specified reservation, or
+    /// if all are in flight and minimal is faster, move the stragglers.
     bool partition(reservation::ptr minimal);
 
     /// If not stopped and if empty try to get more hashes.
@@ -155,11 +161,12 @@ private:
 
     // Protected by hash mutex.
     bool pending_;
-    bool partitioned_;
     hash_heights heights_;
+    std::set<uint32_t> requested_;
     mutable upgrade_mutex hash_mutex_;
 
     const size_t slot_;
+    const uint32_t block_timeout_seconds_;
     const std::chrono::microseconds rate_window_;
 };
 
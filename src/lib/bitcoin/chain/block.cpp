@@ -189,32 +189,13 @@ hash_digest build_merkle_tree(hash_list& merkle)
 
         // List size is now even.
         BITCOIN_ASSERT(merkle.size() % 2 == 0);
+        const auto pairs = merkle.size() / 2;
 
-        // New hash list.
-        hash_list new_merkle;
-
-        // Loop through hashes 2 at a time.
-        for (auto it = merkle.begin(); it != merkle.end(); it += 2)
-        {
-            // Join both current hashes together (concatenate).
-            data_chunk concat_data;
-            data_sink concat_stream(concat_data);
-            ostream_writer concat_sink(concat_stream);
-            concat_sink.write_hash(*it);
-            concat_sink.write_hash(*(it + 1));
-            concat_stream.flush();
-
-            BITCOIN_ASSERT(concat_data.size() == (2 * hash_size));
-
-            // Hash both of the hashes.
-            const auto new_root = bitcoin_hash(concat_data);
-
-            // Add this to the new list.
-            new_merkle.push_back(new_root);
-        }
-
-        // This is the new list.
-        merkle = new_merkle;
+        // Adjacent hashes are contiguous, so each pair is a 64 byte input.
+        static_assert(sizeof(hash_digest) == hash_size, "unpadded hash");
+        // Hash the whole level at once, each pair replaced by its parent.
+        bitcoin_hash64(merkle.front().data(), merkle.front().data(), pairs);
+        merkle.resize(pairs);
     }
 
     // Finally we end up with a single item.
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <metaverse/bitcoin/chain/script/operation.hpp>
+#include <metaverse/bitcoin/chain/script/sighash_context.hpp>
 #include <metaverse/bitcoin/define.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
 #include "conditional_stack.hpp"
@@ -42,6 +43,9 @@ public:
     data_stack alternate;
     conditional_stack conditional;
     uint32_t flags;
+
+    // Shared signature hashing state of the parent transaction, if any.
+    const sighash_context* sighash = nullptr;
 };
 
 } // namspace chain
@@ -1191,10 +1191,19 @@ bool op_hash256(evaluation_context& context)
 bool script::create_endorsement(endorsement& out, const ec_secret& secret,
     const script& prevout_script, const transaction& new_tx,
     uint32_t input_index, uint8_t sighash_type)
+{
+    const sighash_context context(new_tx);
+    return create_endorsement(out, secret, prevout_script, context,
+        input_index, sighash_type);
+}
+
+bool script::create_endorsement(endorsement& out, const ec_secret& secret,
+    const script& prevout_script, const sighash_context& context,
+    uint32_t input_index, uint8_t sighash_type)
 {
     // This always produces a valid signature hash.
-    const auto sighash = script::generate_signature_hash(new_tx, input_index,
-        prevout_script, sighash_type);
+    const auto sighash = context.signature_hash(input_index, prevout_script,
+        sighash_type);
 
     // Create the EC signature and encode as DER.
     ec_signature signature;
@@ -1222,6 +1231,36 @@ bool script::check_signature(const ec_signature& signature,
     return verify_signature(public_key, sighash, signature);
 }
 
+bool script::check_signature(const ec_signature& signature,
+    uint8_t sighash_type, const data_chunk& public_key,
+    const script& script_code, const sighash_context& context,
+    uint32_t input_index)
+{
+    if (public_key.empty())
+        return false;
+
+    // This always produces a valid signature hash.
+    const auto sighash = context.signature_hash(input_index, script_code,
+        sighash_type);
+
+    // Validate the EC signature.
+    return verify_signature(public_key, sighash, signature);
+}
+
+// Use the shared signature hashing state when the evaluation has one.
+bool verify_endorsement(const evaluation_context& context,
+    const ec_signature& signature, uint8_t sighash_type,
+    const data_chunk& public_key, const script& script_code,
+    const transaction& parent_tx, uint32_t input_index)
+{
+    if (context.sighash != nullptr)
+        return script::check_signature(signature, sighash_type, public_key,
+            script_code, *context.sighash, input_index);
+
+    return script::check_signature(signature, sighash_type, public_key,
+        script_code, parent_tx, input_index);
+}
+
 signature_parse_result op_checksigverify(evaluation_context& context,
     const script& script, const transaction& parent_tx, uint32_t input_index,
     bool strict)
@@ -1249,7 +1288,7 @@ signature_parse_result op_checksigverify(evaluation_context& context,
     if (!strict && !parse_signature(signature, distinguished, false))
         return signature_parse_result::invalid;
 
-    return script::check_signature(signature, sighash_type, pubkey,
+    return verify_endorsement(context, signature, sighash_type, pubkey,
         script_code, parent_tx, input_index) ?
         signature_parse_result::valid :
         signature_parse_result::invalid;
@@ -1360,7 +1399,7 @@ signature_parse_result op_checkmultisigverify(evaluation_context& context,
         {
             const auto& point = *pubkey_iterator;
 
-            if (script::check_signature(signature, sighash_type, point,
+            if (verify_endorsement(context, signature, sighash_type, point,
                 script_code, parent_tx, input_index))
                 break;
 
@@ -1865,11 +1904,13 @@ bool evaluate(const transaction& parent_tx, uint32_t input_index,
     return context.conditional.closed();
 }
 
-bool script::verify(const script& input_script, const script& output_script,
-    const transaction& parent_tx, uint32_t input_index, uint32_t flags)
+bool verify_input(const script& input_script, const script& output_script,
+    const transaction& parent_tx, const sighash_context* sighash,
+    uint32_t input_index, uint32_t flags)
 {
     evaluation_context input_context;
     input_context.flags = flags;
+    input_context.sighash = sighash;
 
     if (!evaluate(parent_tx, input_index, input_script, input_context, flags))
         return false;
@@ -1877,6 +1918,7 @@ bool script::verify(const script& input_script, const script& output_script,
     evaluation_context output_context;
     output_context.flags = flags;
     output_context.stack = input_context.stack;
+    output_context.sighash = sighash;
 
     if (!evaluate(parent_tx, input_index, output_script, output_context,
         flags))
@@ -1887,7 +1929,7 @@ bool script::verify(const script& input_script, const script& output_script,
         return false;
 
     // Additional validation for pay-to-script-hash transactions
-    if (is_active(flags, script_context::bip16_enabled) &&
+    if (script::is_active(flags, script_context::bip16_enabled) &&
         (output_script.pattern() == script_pattern::pay_script_hash))
     {
         if (!operation::is_push_only(input_script.operations))
@@ -1897,13 +1939,14 @@ bool script::verify(const script& input_script, const script& output_script,
         evaluation_context eval_context;
         eval_context.flags = flags;
         eval_context.stack = input_context.stack;
+        eval_context.sighash = sighash;
 
         // TODO: shouldn't this be parse_mode::strict?
         // Invalid script - parsable only as raw_data
         script eval_script;
 
         if (!eval_script.from_data(input_context.stack.back(), false,
-            parse_mode::raw_data_fallback))
+            script::parse_mode::raw_data_fallback))
             return false;
 
         // Pop last item and copy as starting stack to eval script
@@ -1923,5 +1966,19 @@ bool script::verify(const script& input_script, const script& output_script,
     return true;
 }
 
+bool script::verify(const script& input_script, const script& output_script,
+    const transaction& parent_tx, uint32_t input_index, uint32_t flags)
+{
+    return verify_input(input_script, output_script, parent_tx, nullptr,
+        input_index, flags);
+}
+
+bool script::verify(const script& input_script, const script& output_script,
+    const sighash_context& context, uint32_t input_index, uint32_t flags)
+{
+    return verify_input(input_script, output_script, context.transaction(),
+        &context, input_index, flags);
+}
+
 } // namspace chain
 } // namspace libbitcoin
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/chain/script/sighash_context.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <metaverse/bitcoin/constants.hpp>
+#include <metaverse/bitcoin/math/sha256_engine.hpp>
+#include <metaverse/bitcoin/utility/assert.hpp>
+#include <metaverse/bitcoin/utility/endian.hpp>
+#include <metaverse/bitcoin/utility/serializer.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// A blanked input is its point, an empty script and its sequence.
+static const size_t sequence_size = sizeof(uint32_t);
+static const size_t blank_input_size = 36 + 1 + sequence_size;
+
+inline bool is_sighash_all(uint8_t sighash_type)
+{
+    const auto algorithm = sighash_type & signature_hash_algorithm::mask;
+    return algorithm != signature_hash_algorithm::none
+        && algorithm != signature_hash_algorithm::single
+        && (sighash_type & signature_hash_algorithm::anyone_can_pay) == 0;
+}
+
+class sighash_context::midstates
+{
+public:
+    midstates(const chain::transaction& tx)
+    {
+        uint64_t size = 4 + variable_uint_size(tx.inputs.size()) +
+            tx.inputs.size() * blank_input_size +
+            variable_uint_size(tx.outputs.size()) + 4;
+
+        for (const auto& output: tx.outputs)
+            size += output.serialized_size();
+
+        // The transaction with all input scripts blanked.
+        blanked.resize(size);
+        auto serial = make_serializer(blanked.begin());
+        serial.write_4_bytes_little_endian(tx.version);
+        serial.write_variable_uint_little_endian(tx.inputs.size());
+        header_size = serial.iterator() - blanked.begin();
+
+        for (const auto& input: tx.inputs)
+        {
+            BITCOIN_ASSERT(input.previous_output.serialized_size() == 36);
+            input.previous_output.to_data(serial);
+            serial.write_byte(0);
+            serial.write_4_bytes_little_endian(input.sequence);
+        }
+
+        serial.write_variable_uint_little_endian(tx.outputs.size());
+
+        for (const auto& output: tx.outputs)
+            output.to_data(serial);
+
+        serial.write_4_bytes_little_endian(tx.locktime);
+        BITCOIN_ASSERT(serial.iterator() == blanked.end());
+
+        // The hash state preceding each input.
+        sha256::context context;
+        context.update(blanked.data(), header_size);
+        prefixes.reserve(tx.inputs.size());
+
+        for (size_t index = 0; index < tx.inputs.size(); ++index)
+        {
+            prefixes.push_back(context);
+            context.update(blanked.data() + offset(index), blank_input_size);
+        }
+    }
+
+    size_t offset(size_t input_index) const
+    {
+        return header_size + input_index * blank_input_size;
+    }
+
+    data_chunk blanked;
+    size_t header_size = 0;
+    std::vector<sha256::context> prefixes;
+};
+
+sighash_context::sighash_context(const chain::transaction& tx)
+  : tx_(tx)
+{
+}
+
+// Defined here so that midstates is complete at destruction.
+sighash_context::~sighash_context()
+{
+}
+
+const chain::transaction& sighash_context::transaction() const
+{
+    return tx_;
+}
+
+const data_chunk& sighash_context::serialized() const
+{
+    std::call_once(serialized_once_, [this]()
+    {
+        serialized_ = tx_.to_data();
+    });
+
+    return serialized_;
+}
+
+const sighash_context::midstates& sighash_context::prefix() const
+{
+    std::call_once(midstates_once_, [this]()
+    {
+        midstates_.reset(new midstates(tx_));
+    });
+
+    return *midstates_;
+}
+
+hash_digest sighash_context::signature_hash(uint32_t input_index,
+    const script& script_code, uint8_t sighash_type) const
+{
+    // Only the common sighash all form is shared, the others blank or drop
+    // the outputs or other inputs and are hashed as before.
+    if (input_index >= tx_.inputs.size() || !is_sighash_all(sighash_type))
+        return script::generate_signature_hash(tx_, input_index, script_code,
+            sighash_type);
+
+    const auto& state = prefix();
+    const auto input = state.blanked.data() + state.offset(input_index);
+    const auto suffix = state.offset(input_index + 1);
+    const auto code = script_code.to_data(true);
+    const auto type = to_little_endian<uint32_t>(sighash_type);
+
+    // The current input carries the script code, all others are blank.
+    auto context = state.prefixes[input_index];
+    context.update(input, 36);
+    context.update(code.data(), code.size());
+    context.update(input + 37, sequence_size);
+    context.update(state.blanked.data() + suffix,
+        state.blanked.size() - suffix);
+    context.update(type.data(), type.size());
+
+    hash_digest first;
+    context.finalize(first.data());
+    return sha256_hash(first);
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -0,0 +1,335 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/chain/transaction_view.hpp>
+
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <metaverse/bitcoin/chain/attachment/attachment.hpp>
+#include <metaverse/bitcoin/constants.hpp>
+#include <metaverse/bitcoin/utility/assert.hpp>
+#include <metaverse/bitcoin/utility/deserializer.hpp>
+#include <metaverse/bitcoin/utility/exceptions.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+// Smallest possible input: point, empty script prefix and sequence.
+static constexpr uint64_t min_input_size = 36 + 1 + 4;
+
+// Smallest possible output: value, empty script prefix and attachment.
+static constexpr uint64_t min_output_size = 8 + 1 + 8;
+
+struct transaction_view::layout
+{
+    data_chunk data;
+    hash_digest hash;
+    uint32_t version;
+    uint32_t locktime;
+
+    // Byte offsets of each input and output within data.
+    std::vector<uint32_t> inputs;
+    std::vector<uint32_t> outputs;
+};
+
+template <typename Iterator, bool SafeCheckLast>
+static void skip(deserializer<Iterator, SafeCheckLast>& source, uint64_t size)
+{
+    const auto it = source.iterator();
+
+    if (SafeCheckLast &&
+        size > static_cast<uint64_t>(std::distance(it, source.end())))
+        throw end_of_stream();
+
+    source.set_iterator(it + size);
+}
+
+template <typename Iterator, bool SafeCheckLast>
+static void check_count(deserializer<Iterator, SafeCheckLast>& source,
+    uint64_t count, uint64_t min_size)
+{
+    // Reject counts the remaining data cannot possibly hold before reserving.
+    const auto remaining = std::distance(source.iterator(), source.end());
+
+    if (SafeCheckLast && count > static_cast<uint64_t>(remaining) / min_size)
+        throw end_of_stream();
+}
+
+// Walk the serialization once, recording where each input and output begins
+// without decoding scripts. Attachments carry no length prefix so they are
+// decoded into a scratch object to find their end.
+template <typename Iterator, bool SafeCheckLast>
+static bool scan(deserializer<Iterator, SafeCheckLast>& source,
+    const Iterator begin, uint32_t& version, uint32_t& locktime,
+    std::vector<uint32_t>& inputs, std::vector<uint32_t>& outputs)
+{
+    const auto offset = [&source, begin]()
+    {
+        return static_cast<uint32_t>(std::distance(begin, source.iterator()));
+    };
+
+    version = source.read_4_bytes_little_endian();
+
+    const auto input_count = source.read_variable_uint_little_endian();
+    check_count(source, input_count, min_input_size);
+    inputs.reserve(input_count);
+
+    for (uint64_t input = 0; input < input_count; ++input)
+    {
+        inputs.push_back(offset());
+        skip(source, hash_size + sizeof(uint32_t));
+        skip(source, source.read_variable_uint_little_endian());
+        skip(source, sizeof(uint32_t));
+    }
+
+    const auto output_count = source.read_variable_uint_little_endian();
+    check_count(source, output_count, min_output_size);
+    outputs.reserve(output_count);
+
+    attachment scratch;
+    for (uint64_t output = 0; output < output_count; ++output)
+    {
+        outputs.push_back(offset());
+        skip(source, sizeof(uint64_t));
+        skip(source, source.read_variable_uint_little_endian());
+
+        if (!scratch.from_data(source))
+            return false;
+    }
+
+    locktime = source.read_4_bytes_little_endian();
+    return static_cast<bool>(source);
+}
+
+transaction_view transaction_view::factory_from_data(data_chunk&& data)
+{
+    return transaction_view(parse(std::move(data)));
+}
+
+transaction_view transaction_view::factory_from_data(const data_chunk& data)
+{
+    return transaction_view(parse(data_chunk(data)));
+}
+
+transaction_view transaction_view::factory_from_memory(const uint8_t* memory)
+{
+    auto value = std::make_shared<layout>();
+    auto source = make_deserializer_unsafe(memory);
+
+    if (!scan(source, memory, value->version, value->locktime,
+        value->inputs, value->outputs))
+        return{};
+
+    value->data.assign(memory, source.iterator());
+    value->hash = bitcoin_hash(value->data);
+    return transaction_view(value);
+}
+
+transaction_view transaction_view::factory_from_transaction(
+    const transaction& tx)
+{
+    return factory_from_data(tx.to_data());
+}
+
+transaction_view::layout_ptr transaction_view::parse(data_chunk&& data)
+{
+    auto value = std::make_shared<layout>();
+    auto source = make_deserializer(data.cbegin(), data.cend());
+
+    try
+    {
+        if (!scan(source, data.cbegin(), value->version, value->locktime,
+            value->inputs, value->outputs) || !source.is_exhausted())
+            return nullptr;
+    }
+    catch (const end_of_stream&)
+    {
+        return nullptr;
+    }
+
+    value->data = std::move(data);
+    value->hash = bitcoin_hash(value->data);
+    return value;
+}
+
+transaction_view::transaction_view()
+  : layout_(nullptr)
+{
+}
+
+transaction_view::transaction_view(layout_ptr layout)
+  : layout_(layout)
+{
+}
+
+bool transaction_view::is_valid() const
+{
+    return layout_ != nullptr;
+}
+
+bool transaction_view::is_coinbase() const
+{
+    return inputs_size() == 1 && previous_output(0).is_null();
+}
+
+const data_chunk& transaction_view::data() const
+{
+    BITCOIN_ASSERT(layout_);
+    return layout_->data;
+}
+
+const hash_digest& transaction_view::hash() const
+{
+    BITCOIN_ASSERT(layout_);
+    return layout_->hash;
+}
+
+uint64_t transaction_view::serialized_size() const
+{
+    return layout_ ? layout_->data.size() : 0;
+}
+
+uint32_t transaction_view::version() const
+{
+    BITCOIN_ASSERT(layout_);
+    return layout_->version;
+}
+
+uint32_t transaction_view::locktime() const
+{
+    BITCOIN_ASSERT(layout_);
+    return layout_->locktime;
+}
+
+size_t transaction_view::inputs_size() const
+{
+    return layout_ ? layout_->inputs.size() : 0;
+}
+
+size_t transaction_view::outputs_size() const
+{
+    return layout_ ? layout_->outputs.size() : 0;
+}
+
+const uint8_t* transaction_view::input_at(size_t index) const
+{
+    BITCOIN_ASSERT(index < inputs_size());
+    return layout_->data.data() + layout_->inputs[index];
+}
+
+const uint8_t* transaction_view::output_at(size_t index) const
+{
+    BITCOIN_ASSERT(index < outputs_size());
+    return layout_->data.data() + layout_->outputs[index];
+}
+
+// Inputs.
+// ----------------------------------------------------------------------------
+
+output_point transaction_view::previous_output(size_t index) const
+{
+    auto source = make_deserializer_unsafe(input_at(index));
+    return output_point::factory_from_data(source);
+}
+
+uint32_t transaction_view::sequence(size_t index) const
+{
+    auto source = make_deserializer_unsafe(input_at(index));
+    skip(source, hash_size + sizeof(uint32_t));
+    skip(source, source.read_variable_uint_little_endian());
+    return source.read_4_bytes_little_endian();
+}
+
+data_slice transaction_view::input_script_data(size_t index) const
+{
+    auto source = make_deserializer_unsafe(input_at(index));
+    skip(source, hash_size + sizeof(uint32_t));
+    const auto size = source.read_variable_uint_little_endian();
+    const auto begin = source.iterator();
+    return{ begin, begin + size };
+}
+
+chain::script transaction_view::input_script(size_t index) const
+{
+    // Mirrors input::from_data, coinbase scripts are never parsed.
+    const auto mode = previous_output(index).is_null() ?
+        script::parse_mode::raw_data : script::parse_mode::raw_data_fallback;
+
+    chain::script instance;
+    auto source = make_deserializer_unsafe(input_at(index));
+    skip(source, hash_size + sizeof(uint32_t));
+    instance.from_data(source, true, mode);
+    return instance;
+}
+
+chain::input transaction_view::input(size_t index) const
+{
+    if (index >= inputs_size())
+        throw std::out_of_range("transaction_view input index");
+
+    auto source = make_deserializer_unsafe(input_at(index));
+    return chain::input::factory_from_data(source);
+}
+
+// Outputs.
+// ----------------------------------------------------------------------------
+
+uint64_t transaction_view::value(size_t index) const
+{
+    auto source = make_deserializer_unsafe(output_at(index));
+    return source.read_8_bytes_little_endian();
+}
+
+data_slice transaction_view::output_script_data(size_t index) const
+{
+    auto source = make_deserializer_unsafe(output_at(index));
+    skip(source, sizeof(uint64_t));
+    const auto size = source.read_variable_uint_little_endian();
+    const auto begin = source.iterator();
+    return{ begin, begin + size };
+}
+
+chain::script transaction_view::output_script(size_t index) const
+{
+    chain::script instance;
+    auto source = make_deserializer_unsafe(output_at(index));
+    skip(source, sizeof(uint64_t));
+    instance.from_data(source, true, script::parse_mode::raw_data_fallback);
+    return instance;
+}
+
+chain::output transaction_view::output(size_t index) const
+{
+    if (index >= outputs_size())
+        throw std::out_of_range("transaction_view output index");
+
+    auto source = make_deserializer_unsafe(output_at(index));
+    return chain::output::factory_from_data(source);
+}
+
+chain::transaction transaction_view::to_transaction() const
+{
+    return layout_ ? transaction::factory_from_data(layout_->data) :
+        transaction();
+}
+
+} // namespace chain
+} // namespace libbitcoin
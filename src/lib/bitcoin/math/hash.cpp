@@ -26,6 +26,7 @@
 #include <errno.h>
 #include <new>
 #include <stdexcept>
+#include <metaverse/bitcoin/math/sha256_engine.hpp>
 #include "../math/external/crypto_scrypt.h"
 #include "../math/external/hmac_sha256.h"
 #include "../math/external/hmac_sha512.h"
@@ -54,20 +55,19 @@ short_hash sha1_hash(data_slice data)
 hash_digest sha256_hash(data_slice data)
 {
     hash_digest hash;
-    SHA256_(data.data(), data.size(), hash.data());
+    sha256::context context;
+    context.update(data.data(), data.size());
+    context.finalize(hash.data());
     return hash;
 }
 
 hash_digest sha256_hash(data_slice first, data_slice second)
 {
     hash_digest hash;
-
-    SHA256CTX context;
-    SHA256Init(&context);
-    SHA256Update(&context, first.data(), first.size());
-    SHA256Update(&context, second.data(), second.size());
-    SHA256Final(&context, hash.data());
-
+    sha256::context context;
+    context.update(first.data(), first.size());
+    context.update(second.data(), second.size());
+    context.finalize(hash.data());
     return hash;
 }
 
@@ -110,6 +110,16 @@ hash_digest bitcoin_hash(data_slice data)
     return sha256_hash(sha256_hash(data));
 }
 
+void bitcoin_hash64(uint8_t* out, const uint8_t* in, size_t count)
+{
+    sha256::double64(out, in, count);
+}
+
+std::string sha256_implementation()
+{
+    return sha256::selected().name;
+}
+
 short_hash bitcoin_short_hash(data_slice data)
 {
     return ripemd160_hash(sha256_hash(data));
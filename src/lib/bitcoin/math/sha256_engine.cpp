@@ -0,0 +1,253 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/math/sha256_engine.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "external/sha256.h"
+
+namespace libbitcoin {
+namespace sha256 {
+
+static const uint32_t initial[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static void store_big_endian(uint8_t* out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+static void transform_portable(uint32_t* state, const uint8_t* blocks,
+    size_t count)
+{
+    for (size_t block = 0; block < count; ++block)
+        SHA256Transform(state, blocks + block * block_size);
+}
+
+static engine detect()
+{
+    engine result{ "portable", transform_portable, nullptr, nullptr };
+
+#ifdef MVS_SHA256_X86
+    __builtin_cpu_init();
+
+    // A single sha-ni stream outpaces four sse lanes, so only use one.
+    if (shani_supported())
+    {
+        result.name = "sha-ni";
+        result.transform = transform_shani;
+    }
+    else if (__builtin_cpu_supports("sse4.1"))
+    {
+        result.name += "+sse4.1x4";
+        result.double64_4way = double64_sse41_4way;
+    }
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        result.name += "+avx2x8";
+        result.double64_8way = double64_avx2_8way;
+    }
+#endif
+
+    return result;
+}
+
+const engine& selected()
+{
+    // Initialization of a function static is thread safe.
+    static const engine instance = detect();
+    return instance;
+}
+
+std::vector<engine> supported()
+{
+    std::vector<engine> result
+    {
+        { "portable", transform_portable, nullptr, nullptr }
+    };
+
+#ifdef MVS_SHA256_X86
+    __builtin_cpu_init();
+
+    if (shani_supported())
+        result.push_back({ "sha-ni", transform_shani, nullptr, nullptr });
+
+    if (__builtin_cpu_supports("sse4.1"))
+        result.push_back({ "sse4.1x4", transform_portable,
+            double64_sse41_4way, nullptr });
+
+    if (__builtin_cpu_supports("avx2"))
+        result.push_back({ "avx2x8", transform_portable, nullptr,
+            double64_avx2_8way });
+#endif
+
+    return result;
+}
+
+// context
+// ----------------------------------------------------------------------------
+
+context::context()
+  : context(selected())
+{
+}
+
+context::context(const engine& instance)
+  : transform_(instance.transform), size_(0)
+{
+    std::memcpy(state_, initial, sizeof(state_));
+}
+
+void context::update(const uint8_t* data, size_t size)
+{
+    auto used = static_cast<size_t>(size_ % block_size);
+    size_ += size;
+
+    if (used != 0)
+    {
+        const auto fill = std::min(block_size - used, size);
+        std::memcpy(buffer_ + used, data, fill);
+        data += fill;
+        size -= fill;
+        used += fill;
+
+        if (used < block_size)
+            return;
+
+        transform_(state_, buffer_, 1);
+    }
+
+    // Whole blocks are compressed directly from the input.
+    const auto blocks = size / block_size;
+
+    if (blocks != 0)
+    {
+        transform_(state_, data, blocks);
+        data += blocks * block_size;
+        size -= blocks * block_size;
+    }
+
+    std::memcpy(buffer_, data, size);
+}
+
+void context::finalize(uint8_t* digest)
+{
+    static const uint8_t pad[block_size] = { 0x80 };
+    uint8_t length[8];
+    const auto bits = size_ * 8;
+    store_big_endian(length, static_cast<uint32_t>(bits >> 32));
+    store_big_endian(length + 4, static_cast<uint32_t>(bits));
+
+    const auto used = static_cast<size_t>(size_ % block_size);
+    const auto padding = used < 56 ? 56 - used : 120 - used;
+    update(pad, padding);
+    update(length, sizeof(length));
+
+    for (size_t word = 0; word < 8; ++word)
+        store_big_endian(digest + 4 * word, state_[word]);
+}
+
+// double64
+// ----------------------------------------------------------------------------
+
+// The second block of a 64 byte message is constant padding.
+static const uint8_t padding64[block_size] =
+{
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x00
+};
+
+static void double64_single(uint8_t* out, const uint8_t* in,
+    transform_function transform)
+{
+    uint32_t state[8];
+    std::memcpy(state, initial, sizeof(state));
+    transform(state, in, 1);
+    transform(state, padding64, 1);
+
+    // The digest is hashed again as a single padded block.
+    uint8_t block[block_size] = { 0 };
+    for (size_t word = 0; word < 8; ++word)
+        store_big_endian(block + 4 * word, state[word]);
+
+    block[digest_size] = 0x80;
+    block[block_size - 2] = 0x01;
+
+    std::memcpy(state, initial, sizeof(state));
+    transform(state, block, 1);
+
+    for (size_t word = 0; word < 8; ++word)
+        store_big_endian(out + 4 * word, state[word]);
+}
+
+// Each group reads all of its input before writing its output, and output
+// trails input, so hashing a merkle level in place is safe.
+void double64(uint8_t* out, const uint8_t* in, size_t count)
+{
+    double64(selected(), out, in, count);
+}
+
+void double64(const engine& instance, uint8_t* out, const uint8_t* in,
+    size_t count)
+{
+    if (instance.double64_8way != nullptr)
+    {
+        for (; count >= 8; count -= 8)
+        {
+            instance.double64_8way(out, in);
+            out += 8 * digest_size;
+            in += 8 * block_size;
+        }
+    }
+
+    if (instance.double64_4way != nullptr)
+    {
+        for (; count >= 4; count -= 4)
+        {
+            instance.double64_4way(out, in);
+            out += 4 * digest_size;
+            in += 4 * block_size;
+        }
+    }
+
+    for (; count > 0; --count)
+    {
+        double64_single(out, in, instance.transform);
+        out += digest_size;
+        in += block_size;
+    }
+}
+
+} // namespace sha256
+} // namespace libbitcoin
@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/math/sha256_engine.hpp>
+
+#ifdef MVS_SHA256_X86
+
+#include <cstddef>
+#include <cstdint>
+#include <cpuid.h>
+#include <immintrin.h>
+
+// Lane vectors wider than the baseline ABI never cross a call boundary here.
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+namespace libbitcoin {
+namespace sha256 {
+
+alignas(16) static const uint32_t k[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t initial[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+bool shani_supported()
+{
+    uint32_t eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    const auto sha = (ebx & (1u << 29)) != 0;
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    const auto sse41 = (ecx & (1u << 19)) != 0;
+    const auto ssse3 = (ecx & (1u << 9)) != 0;
+
+    return sha && sse41 && ssse3;
+}
+
+// sha-ni, one block at a time in the dedicated round instructions.
+// ----------------------------------------------------------------------------
+
+#define SHANI_TARGET __attribute__((target("sha,sse4.1")))
+
+static ALWAYS_INLINE SHANI_TARGET __m128i load_message(const uint8_t* in)
+{
+    const auto mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+        0x0405060700010203ull);
+    return _mm_shuffle_epi8(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(in)), mask);
+}
+
+static ALWAYS_INLINE SHANI_TARGET void quad_round(__m128i& state0,
+    __m128i& state1, __m128i message, size_t round)
+{
+    const auto constants = _mm_load_si128(
+        reinterpret_cast<const __m128i*>(k + round));
+    const auto words = _mm_add_epi32(message, constants);
+    state1 = _mm_sha256rnds2_epu32(state1, state0, words);
+    state0 = _mm_sha256rnds2_epu32(state0, state1,
+        _mm_shuffle_epi32(words, 0x0e));
+}
+
+// Extend the schedule by four words: next = schedule(m0, m1, m2, m3).
+static ALWAYS_INLINE SHANI_TARGET void extend(__m128i& m0, __m128i m1,
+    __m128i m2, __m128i m3)
+{
+    m0 = _mm_sha256msg1_epu32(m0, m1);
+    m0 = _mm_add_epi32(m0, _mm_alignr_epi8(m3, m2, 4));
+    m0 = _mm_sha256msg2_epu32(m0, m3);
+}
+
+SHANI_TARGET void transform_shani(uint32_t* state, const uint8_t* blocks,
+    size_t count)
+{
+    // The round instructions take the state as ABEF and CDGH.
+    auto abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+    auto efgh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+    const auto cdab = _mm_shuffle_epi32(abcd, 0xb1);
+    const auto hgfe = _mm_shuffle_epi32(efgh, 0x1b);
+    auto abef = _mm_alignr_epi8(cdab, hgfe, 8);
+    auto cdgh = _mm_blend_epi16(hgfe, cdab, 0xf0);
+
+    for (; count > 0; --count, blocks += block_size)
+    {
+        const auto saved_abef = abef;
+        const auto saved_cdgh = cdgh;
+
+        __m128i m[4];
+        for (size_t word = 0; word < 4; ++word)
+        {
+            m[word] = load_message(blocks + 16 * word);
+            quad_round(abef, cdgh, m[word], 4 * word);
+        }
+
+        for (size_t round = 16; round < 64; round += 4)
+        {
+            auto& next = m[(round / 4) % 4];
+            extend(next, m[(round / 4 + 1) % 4], m[(round / 4 + 2) % 4],
+                m[(round / 4 + 3) % 4]);
+            quad_round(abef, cdgh, next, round);
+        }
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    const auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    abcd = _mm_blend_epi16(feba, dchg, 0xf0);
+    efgh = _mm_alignr_epi8(dchg, feba, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abcd);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), efgh);
+}
+
+// Multi-buffer lanes, one independent message per vector lane. The generic
+// vector code below is inlined into each target specific entry point.
+// ----------------------------------------------------------------------------
+
+typedef uint32_t vector4 __attribute__((vector_size(16)));
+typedef uint32_t vector8 __attribute__((vector_size(32)));
+
+template <typename Vector>
+static ALWAYS_INLINE Vector rotate(const Vector& value, int bits)
+{
+    return (value >> bits) | (value << (32 - bits));
+}
+
+template <typename Vector>
+static ALWAYS_INLINE Vector broadcast(uint32_t value)
+{
+    return Vector{} + value;
+}
+
+template <typename Vector>
+static ALWAYS_INLINE void compress(Vector* state, Vector* w)
+{
+    auto a = state[0], b = state[1], c = state[2], d = state[3];
+    auto e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (size_t round = 0; round < 64; ++round)
+    {
+        auto& word = w[round & 15];
+
+        if (round >= 16)
+        {
+            const auto w15 = w[(round - 15) & 15];
+            const auto w2 = w[(round - 2) & 15];
+            word += (rotate(w15, 7) ^ rotate(w15, 18) ^ (w15 >> 3)) +
+                w[(round - 7) & 15] +
+                (rotate(w2, 17) ^ rotate(w2, 19) ^ (w2 >> 10));
+        }
+
+        const auto t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) +
+            ((e & f) ^ (~e & g)) + k[round] + word;
+        const auto t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) +
+            ((a & b) ^ (a & c) ^ (b & c));
+
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+template <typename Vector, size_t Lanes>
+static ALWAYS_INLINE void lanes_double64(uint8_t* out, const uint8_t* in)
+{
+    Vector w[16];
+    Vector state[8];
+
+    // All input is loaded before any output is written.
+    for (size_t word = 0; word < 16; ++word)
+        for (size_t lane = 0; lane < Lanes; ++lane)
+            w[word][lane] = __builtin_bswap32(*reinterpret_cast<
+                const uint32_t*>(in + lane * block_size + 4 * word));
+
+    for (size_t word = 0; word < 8; ++word)
+        state[word] = broadcast<Vector>(initial[word]);
+
+    compress(state, w);
+
+    // Padding block of a 64 byte message.
+    w[0] = broadcast<Vector>(0x80000000);
+    for (size_t word = 1; word < 15; ++word)
+        w[word] = broadcast<Vector>(0);
+    w[15] = broadcast<Vector>(512);
+    compress(state, w);
+
+    // The digest is hashed again as a single padded block.
+    for (size_t word = 0; word < 8; ++word)
+    {
+        w[word] = state[word];
+        state[word] = broadcast<Vector>(initial[word]);
+    }
+
+    w[8] = broadcast<Vector>(0x80000000);
+    for (size_t word = 9; word < 15; ++word)
+        w[word] = broadcast<Vector>(0);
+    w[15] = broadcast<Vector>(256);
+    compress(state, w);
+
+    for (size_t word = 0; word < 8; ++word)
+        for (size_t lane = 0; lane < Lanes; ++lane)
+            *reinterpret_cast<uint32_t*>(out + lane * digest_size +
+                4 * word) = __builtin_bswap32(state[word][lane]);
+}
+
+__attribute__((target("sse4.1")))
+void double64_sse41_4way(uint8_t* out, const uint8_t* in)
+{
+    lanes_double64<vector4, 4>(out, in);
+}
+
+__attribute__((target("avx2")))
+void double64_avx2_8way(uint8_t* out, const uint8_t* in)
+{
+    lanes_double64<vector8, 8>(out, in);
+}
+
+} // namespace sha256
+} // namespace libbitcoin
+
+#endif
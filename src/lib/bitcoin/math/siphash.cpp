@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/math/siphash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+#define ROTATE_LEFT(value, bits) (((value) << (bits)) | ((value) >> (64 - (bits))))
+
+#define SIP_ROUND(v0, v1, v2, v3) \
+    v0 += v1; v1 = ROTATE_LEFT(v1, 13); v1 ^= v0; v0 = ROTATE_LEFT(v0, 32); \
+    v2 += v3; v3 = ROTATE_LEFT(v3, 16); v3 ^= v2; \
+    v0 += v3; v3 = ROTATE_LEFT(v3, 21); v3 ^= v0; \
+    v2 += v1; v1 = ROTATE_LEFT(v1, 17); v1 ^= v2; v2 = ROTATE_LEFT(v2, 32)
+
+uint64_t siphash(uint64_t k0, uint64_t k1, data_slice message)
+{
+    uint64_t v0 = 0x736f6d6570736575ull ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dull ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ull ^ k0;
+    uint64_t v3 = 0x7465646279746573ull ^ k1;
+
+    const auto size = message.size();
+    const auto data = message.data();
+    const auto blocks = size - (size % sizeof(uint64_t));
+
+    for (size_t offset = 0; offset < blocks; offset += sizeof(uint64_t))
+    {
+        const auto word = from_little_endian_unsafe<uint64_t>(data + offset);
+        v3 ^= word;
+        SIP_ROUND(v0, v1, v2, v3);
+        SIP_ROUND(v0, v1, v2, v3);
+        v0 ^= word;
+    }
+
+    // The final word carries the remaining bytes and the message length.
+    uint64_t last = static_cast<uint64_t>(size) << 56;
+    for (size_t index = blocks; index < size; ++index)
+        last |= static_cast<uint64_t>(data[index]) << (8 * (index - blocks));
+
+    v3 ^= last;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+#undef SIP_ROUND
+#undef ROTATE_LEFT
+
+} // namespace libbitcoin
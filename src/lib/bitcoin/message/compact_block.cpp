@@ -22,7 +22,9 @@
 
 #include <initializer_list>
 #include <boost/iostreams/stream.hpp>
+#include <metaverse/bitcoin/math/siphash.hpp>
 #include <metaverse/bitcoin/message/version.hpp>
+#include <metaverse/bitcoin/utility/endian.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
@@ -59,6 +61,52 @@ compact_block compact_block::factory_from_data(uint32_t version,
     return instance;
 }
 
+compact_block compact_block::factory_from_block(const chain::block& block,
+    uint64_t nonce)
+{
+    compact_block instance;
+    instance.header = block.header;
+    instance.nonce = nonce;
+
+    if (block.transactions.empty())
+        return instance;
+
+    // The coinbase can never be in a peer's pool, so it is always sent.
+    prefilled_transaction coinbase;
+    coinbase.index = 0;
+    coinbase.transaction = block.transactions.front();
+    instance.transactions.push_back(std::move(coinbase));
+
+    uint64_t k0, k1;
+    instance.short_id_key(k0, k1);
+    instance.short_ids.reserve(block.transactions.size() - 1);
+
+    for (auto tx = block.transactions.begin() + 1;
+        tx != block.transactions.end(); ++tx)
+        instance.short_ids.push_back(to_short_id(k0, k1, tx->hash()));
+
+    return instance;
+}
+
+compact_block::short_id compact_block::to_short_id(uint64_t k0, uint64_t k1,
+    const hash_digest& tx_hash)
+{
+    // The short id is the low six bytes of the siphash, little endian.
+    const auto bytes = to_little_endian(siphash(k0, k1, tx_hash));
+    short_id out;
+    std::copy(bytes.begin(), bytes.begin() + out.size(), out.begin());
+    return out;
+}
+
+void compact_block::short_id_key(uint64_t& k0, uint64_t& k1) const
+{
+    data_chunk preimage(header.to_data(false));
+    extend_data(preimage, to_little_endian(nonce));
+    const auto key = sha256_hash(preimage);
+    k0 = from_little_endian_unsafe<uint64_t>(key.begin());
+    k1 = from_little_endian_unsafe<uint64_t>(key.begin() + sizeof(uint64_t));
+}
+
 bool compact_block::is_valid() const
 {
     return header.is_valid() && !short_ids.empty() && !transactions.empty();
@@ -20,45 +20,357 @@
  */
 #include <metaverse/bitcoin/utility/log.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <boost/date_time.hpp>
 #include <boost/format.hpp>
 #include <metaverse/bitcoin/unicode/unicode.hpp>
 
 namespace libbitcoin {
 
+// The wait of the background thread when the queue is empty, a queued line
+// wakes it earlier.
+static const auto idle_wait = std::chrono::milliseconds(50);
+
+// A bounded queue of lines with many producers and one consumer. Each slot
+// carries a sequence number telling whether it is free to write at a given
+// position or holds the line of that position, so neither side locks.
+class log_queue
+{
+public:
+    struct line
+    {
+        log::level level;
+        std::string domain;
+        std::string body;
+    };
+
+    log_queue(size_t capacity)
+      : slots_(round_up(capacity)), mask_(slots_.size() - 1),
+        enqueue_(0), dequeue_(0)
+    {
+        for (size_t position = 0; position < slots_.size(); ++position)
+            slots_[position].sequence.store(position,
+                std::memory_order_relaxed);
+    }
+
+    // The item is only moved from when it is queued.
+    bool push(line&& item, size_t& out_position)
+    {
+        auto position = enqueue_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            auto& slot = slots_[position & mask_];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) -
+                static_cast<intptr_t>(position);
+
+            // Full, the consumer has not read this slot yet.
+            if (difference < 0)
+                return false;
+
+            if (difference == 0 && enqueue_.compare_exchange_weak(position,
+                position + 1, std::memory_order_relaxed))
+            {
+                slot.item = std::move(item);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                out_position = position;
+                return true;
+            }
+
+            if (difference != 0)
+                position = enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool pop(line& out_item)
+    {
+        const auto position = dequeue_.load(std::memory_order_relaxed);
+        auto& slot = slots_[position & mask_];
+
+        // Empty, or the producer of this slot has not finished writing.
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+            return false;
+
+        out_item = std::move(slot.item);
+        slot.sequence.store(position + slots_.size(),
+            std::memory_order_release);
+        dequeue_.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct slot
+    {
+        std::atomic<size_t> sequence;
+        line item;
+    };
+
+    static size_t round_up(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        return size;
+    }
+
+    std::vector<slot> slots_;
+    const size_t mask_;
+    std::atomic<size_t> enqueue_;
+    std::atomic<size_t> dequeue_;
+};
+
+// The levels with an output function, one bit per level.
+static std::atomic<uint32_t> enabled_levels
+{
+#ifndef NDEBUG
+    (1u << static_cast<uint32_t>(log::level::trace)) |
+    (1u << static_cast<uint32_t>(log::level::debug)) |
+#endif
+    (1u << static_cast<uint32_t>(log::level::info)) |
+    (1u << static_cast<uint32_t>(log::level::warning)) |
+    (1u << static_cast<uint32_t>(log::level::error)) |
+    (1u << static_cast<uint32_t>(log::level::fatal))
+};
+
+// The background writer, its queue is only replaced while it is stopped.
+static std::unique_ptr<log_queue> lines;
+static std::thread writer_thread;
+static std::atomic<bool> writing(false);
+static std::atomic<bool> stopping(false);
+static std::atomic<bool> sleeping(false);
+static std::mutex wake_mutex;
+static std::condition_variable wake;
+
+// The loggers between checking writing and queuing their line. Stopping
+// waits for them, so that no line is queued after the final drain.
+static std::atomic<size_t> producers(0);
+
+// Set while stopping, a line logged then is written once the queued lines
+// are, so that the lines of a thread stay in order.
+static std::atomic<bool> draining(false);
+
+// The lines written by the background thread, in queue order, and the
+// loggers waiting for their line to be written.
+static std::atomic<size_t> written(0);
+static std::atomic<size_t> waiters(0);
+static std::mutex written_mutex;
+static std::condition_variable written_changed;
+
+// The background thread writes its own lines, it cannot wait for itself.
+static thread_local bool on_writer = false;
+
+static void wake_writer()
+{
+    if (sleeping.load())
+        wake.notify_one();
+}
+
 log::log(level value, const std::string& domain)
-  : level_(value), domain_(domain)
+  : level_(value)
 {
+    if (!enabled(value))
+        return;
+
+    domain_ = domain;
+    stream_.reset(new std::ostringstream);
 }
 
-// g++ bug in initializer list.
-// It should be: stream_(std::move(other.stream_))
-// gcc.gnu.org/bugzilla/show_bug.cgi?id=54316
 log::log(log&& other)
   : level_(other.level_),
     domain_(std::move(other.domain_)),
-    stream_(other.stream_.str())
+    stream_(std::move(other.stream_))
 {
 }
 
 log::~log()
 {
-    if (destinations_.count(level_) != 0)
-        destinations_[level_](level_, domain_, stream_.str());
+    if (!stream_)
+        return;
+
+    ++producers;
+
+    if (!writing.load() || on_writer)
+    {
+        --producers;
+
+        if (draining.load() && !on_writer)
+        {
+            ///////////////////////////////////////////////////////////////////
+            // Critical Section
+            std::unique_lock<std::mutex> lock(written_mutex);
+            written_changed.wait(lock, []() { return !draining.load(); });
+            ///////////////////////////////////////////////////////////////////
+        }
+
+        write(level_, domain_, stream_->str());
+        return;
+    }
+
+    // A full queue holds the logger back rather than write out of order.
+    size_t position;
+    log_queue::line item{ level_, std::move(domain_), stream_->str() };
+    while (!lines->push(std::move(item), position))
+    {
+        wake.notify_one();
+        std::this_thread::yield();
+    }
+
+    --producers;
+    wake_writer();
+
+    // Errors are written and flushed before the logger returns, in order
+    // behind the lines queued ahead of them.
+    if (level_ < level::error)
+        return;
+
+    ++waiters;
+    wake.notify_one();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(written_mutex);
+    written_changed.wait(lock, [position]()
+    {
+        return written.load() > position;
+    });
+    ///////////////////////////////////////////////////////////////////////////
+
+    --waiters;
+}
+
+uint32_t log::to_flag(level value)
+{
+    return 1u << static_cast<uint32_t>(value);
+}
+
+bool log::enabled(level value)
+{
+    return (enabled_levels.load(std::memory_order_relaxed) &
+        to_flag(value)) != 0;
+}
+
+void log::write(level value, const std::string& domain,
+    const std::string& body)
+{
+    const auto destination = destinations_.find(value);
+    if (destination != destinations_.end())
+        destination->second(value, domain, body);
+}
+
+void log::start_async(size_t capacity, flusher flush)
+{
+    if (writing.load())
+        return;
+
+    lines.reset(new log_queue(capacity));
+    written.store(0);
+    stopping.store(false);
+    writing.store(true);
+
+    writer_thread = std::thread([flush]()
+    {
+        on_writer = true;
+        log_queue::line item;
+
+        while (true)
+        {
+            if (lines->pop(item))
+            {
+                write(item.level, item.domain, item.body);
+
+                if (item.level >= level::error && flush)
+                    flush();
+
+                ++written;
+
+                if (waiters.load() != 0)
+                {
+                    ///////////////////////////////////////////////////////////
+                    // Critical Section
+                    written_mutex.lock();
+                    written_mutex.unlock();
+                    ///////////////////////////////////////////////////////////
+
+                    written_changed.notify_all();
+                }
+
+                continue;
+            }
+
+            if (flush)
+                flush();
+
+            if (stopping.load())
+                break;
+
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            sleeping.store(true);
+            wake.wait_for(lock, idle_wait);
+            sleeping.store(false);
+        }
+    });
+}
+
+void log::stop_async()
+{
+    if (!writing.load())
+        return;
+
+    // Lines logged from here are written by their own thread. The loggers
+    // that saw the writer running finish queuing before it is told to stop,
+    // it writes every queued line before it exits.
+    draining.store(true);
+    writing.store(false);
+    while (producers.load() != 0)
+        std::this_thread::yield();
+
+    stopping.store(true);
+    wake.notify_one();
+    writer_thread.join();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    written_mutex.lock();
+    draining.store(false);
+    written_mutex.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    written_changed.notify_all();
+}
+
+bool log::async()
+{
+    return writing.load();
 }
 
 void log::set_output_function(functor value)
 {
-    destinations_[level_] = value;
+    if (value)
+    {
+        destinations_[level_] = value;
+        enabled_levels |= to_flag(level_);
+        return;
+    }
+
+    destinations_.erase(level_);
+    enabled_levels &= ~to_flag(level_);
 }
 
 void log::clear()
 {
     destinations_.clear();
+    enabled_levels = 0;
 }
 
 log log::trace(const std::string& domain)
@@ -147,10 +459,7 @@ void log::output_cerr(level value, const std::string& domain,
 
 log::destinations log::destinations_
 {
-#ifdef NDEBUG
-    std::make_pair(level::trace, output_ignore),
-    std::make_pair(level::debug, output_ignore),
-#else
+#ifndef NDEBUG
     std::make_pair(level::trace, output_cout),
     std::make_pair(level::debug, output_cout),
 #endif
@@ -160,4 +469,14 @@ log::destinations log::destinations_
     std::make_pair(level::fatal, output_cerr)
 };
 
+// Joins the background writer if the process exits without stopping it,
+// destroyed before the destinations above.
+static struct async_guard
+{
+    ~async_guard()
+    {
+        log::stop_async();
+    }
+} guard;
+
 } // namespace libbitcoin
@@ -78,19 +78,15 @@ namespace libbitcoin {
                 }
             }
 
-            ofs.flush();
+            // The background writer flushes files once its queue is empty.
+            if (!log::async() || !std::is_same<T, bc::ofstream>::value)
+                ofs.flush();
             ///////////////////////////////////////////////////////////////////////
 
         }
 
 }
 
-static void output_ignore(bc::ofstream& file, log::level level,
-    const std::string& domain, const std::string& body)
-{
-
-}
-
 static void output_file(bc::ofstream& file, log::level level,
     const std::string& domain, const std::string& body)
 {
@@ -140,8 +136,7 @@ void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
     }
     else if (debug_log_level <log::level::info)
     {
-        log::trace("").set_output_function(std::bind(output_ignore,
-            std::ref(debug), _1, _2, _3));
+        log::trace("").set_output_function(nullptr);
         // debug|info => debug_log
         log::debug("").set_output_function(std::bind(output_file,
             std::ref(debug), _1, _2, _3));
@@ -149,10 +144,8 @@ void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
     else if (debug_log_level <log::level::warning)
     {
         // info => debug_log
-        log::trace("").set_output_function(std::bind(output_ignore,
-            std::ref(debug), _1, _2, _3));
-        log::debug("").set_output_function(std::bind(output_ignore,
-            std::ref(debug), _1, _2, _3));
+        log::trace("").set_output_function(nullptr);
+        log::debug("").set_output_function(nullptr);
     }
 
     // info => debug_log + console
@@ -167,4 +160,23 @@ void initialize_logging(bc::ofstream& debug, bc::ofstream& error,
         std::ref(error), std::ref(error_stream), _1, _2, _3));
 }
 
+void start_async_logging(bc::ofstream& debug, bc::ofstream& error,
+    size_t capacity)
+{
+    log::start_async(capacity, [&debug, &error]()
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        std::unique_lock<std::mutex> lock_file(file_mutex);
+        debug.flush();
+        error.flush();
+        ///////////////////////////////////////////////////////////////////////
+    });
+}
+
+void stop_async_logging()
+{
+    log::stop_async();
+}
+
 } // namespace libbitcoin
@@ -0,0 +1,336 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/metrics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <locale>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <metaverse/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+
+namespace {
+
+enum class kind
+{
+    counter,
+    gauge,
+    histogram
+};
+
+struct family
+{
+    kind type;
+    std::string help;
+    std::map<std::string, std::unique_ptr<metrics::counter>> counters;
+    std::map<std::string, std::unique_ptr<metrics::gauge>> gauges;
+    std::map<std::string, std::unique_ptr<metrics::histogram>> histograms;
+};
+
+struct registry
+{
+    std::mutex mutex;
+    std::map<std::string, family> families;
+};
+
+// Never destroyed, so that series stay valid for threads and statics that
+// outlive the other statics at exit.
+registry& get_registry()
+{
+    static const auto instance = new registry;
+    return *instance;
+}
+
+family& get_family(registry& registry, const std::string& name,
+    const std::string& help, kind type)
+{
+    auto it = registry.families.find(name);
+    if (it == registry.families.end())
+        it = registry.families.emplace(name, family{ type, help, {}, {}, {} }).first;
+
+    BITCOIN_ASSERT_MSG(it->second.type == type, "metric type mismatch");
+    return it->second;
+}
+
+void add_atomic(std::atomic<double>& value, double amount)
+{
+    auto current = value.load();
+    while (!value.compare_exchange_weak(current, current + amount));
+}
+
+std::string format(double value)
+{
+    if (std::isnan(value))
+        return "NaN";
+
+    if (std::isinf(value))
+        return value > 0 ? "+Inf" : "-Inf";
+
+    std::ostringstream stream;
+    stream.imbue(std::locale::classic());
+    stream.precision(15);
+    stream << value;
+    return stream.str();
+}
+
+std::string join(const std::string& labels, const std::string& more)
+{
+    if (labels.empty())
+        return "{" + more + "}";
+
+    return "{" + labels + "," + more + "}";
+}
+
+std::string braced(const std::string& labels)
+{
+    return labels.empty() ? labels : "{" + labels + "}";
+}
+
+const char* to_string(kind type)
+{
+    switch (type)
+    {
+        case kind::counter:
+            return "counter";
+        case kind::gauge:
+            return "gauge";
+        case kind::histogram:
+            return "histogram";
+    }
+
+    return "untyped";
+}
+
+} // namespace
+
+// counter
+// ----------------------------------------------------------------------------
+
+metrics::counter::counter()
+  : value_(0)
+{
+}
+
+void metrics::counter::increment(uint64_t amount)
+{
+    value_.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t metrics::counter::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+// gauge
+// ----------------------------------------------------------------------------
+
+metrics::gauge::gauge()
+  : value_(0)
+{
+}
+
+void metrics::gauge::set(double value)
+{
+    value_.store(value, std::memory_order_relaxed);
+}
+
+void metrics::gauge::add(double amount)
+{
+    add_atomic(value_, amount);
+}
+
+double metrics::gauge::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+// histogram
+// ----------------------------------------------------------------------------
+
+metrics::histogram::histogram(const std::vector<double>& bounds)
+  : bounds_(bounds),
+    buckets_(new std::atomic<uint64_t>[bounds.size()]),
+    count_(0),
+    sum_(0)
+{
+    BITCOIN_ASSERT(std::is_sorted(bounds_.begin(), bounds_.end()));
+
+    for (size_t index = 0; index < bounds_.size(); ++index)
+        buckets_[index] = 0;
+}
+
+void metrics::histogram::observe(double value)
+{
+    // The first bound not below the value, values above all bounds are only
+    // in the implicit +Inf bucket, which is the count.
+    const auto it = std::lower_bound(bounds_.begin(), bounds_.end(), value);
+    if (it != bounds_.end())
+        buckets_[it - bounds_.begin()].fetch_add(1, std::memory_order_relaxed);
+
+    count_.fetch_add(1, std::memory_order_relaxed);
+    add_atomic(sum_, value);
+}
+
+metrics::histogram::snapshot metrics::histogram::collect() const
+{
+    snapshot out{ bounds_, std::vector<uint64_t>(bounds_.size()), 0, 0 };
+
+    uint64_t total = 0;
+    for (size_t index = 0; index < bounds_.size(); ++index)
+    {
+        total += buckets_[index].load(std::memory_order_relaxed);
+        out.buckets[index] = total;
+    }
+
+    // Observations in flight may leave the count behind the buckets.
+    out.count = std::max(count_.load(std::memory_order_relaxed), total);
+    out.sum = sum_.load(std::memory_order_relaxed);
+    return out;
+}
+
+// registry
+// ----------------------------------------------------------------------------
+
+const std::vector<double>& metrics::latency_buckets()
+{
+    static const std::vector<double> bounds
+    {
+        0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+    };
+
+    return bounds;
+}
+
+metrics::counter& metrics::get_counter(const std::string& name,
+    const std::string& help, const std::string& labels)
+{
+    auto& registry = get_registry();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto& series = get_family(registry, name, help, kind::counter).counters;
+    auto& metric = series[labels];
+    if (!metric)
+        metric.reset(new counter);
+
+    return *metric;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+metrics::gauge& metrics::get_gauge(const std::string& name,
+    const std::string& help, const std::string& labels)
+{
+    auto& registry = get_registry();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto& series = get_family(registry, name, help, kind::gauge).gauges;
+    auto& metric = series[labels];
+    if (!metric)
+        metric.reset(new gauge);
+
+    return *metric;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+metrics::histogram& metrics::get_histogram(const std::string& name,
+    const std::string& help, const std::vector<double>& bounds,
+    const std::string& labels)
+{
+    auto& registry = get_registry();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto& series = get_family(registry, name, help, kind::histogram).histograms;
+    auto& metric = series[labels];
+    if (!metric)
+        metric.reset(new histogram(bounds));
+
+    return *metric;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+std::string metrics::render()
+{
+    auto& registry = get_registry();
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (const auto& entry: registry.families)
+    {
+        const auto& name = entry.first;
+        const auto& family = entry.second;
+
+        out << "# HELP " << name << " " << family.help << "\n";
+        out << "# TYPE " << name << " " << to_string(family.type) << "\n";
+
+        switch (family.type)
+        {
+            case kind::counter:
+                for (const auto& series: family.counters)
+                    out << name << braced(series.first) << " "
+                        << series.second->value() << "\n";
+                break;
+
+            case kind::gauge:
+                for (const auto& series: family.gauges)
+                    out << name << braced(series.first) << " "
+                        << format(series.second->value()) << "\n";
+                break;
+
+            case kind::histogram:
+                for (const auto& series: family.histograms)
+                {
+                    const auto& labels = series.first;
+                    const auto values = series.second->collect();
+
+                    for (size_t index = 0; index < values.bounds.size();
+                        ++index)
+                        out << name << "_bucket" << join(labels, "le=\"" +
+                            format(values.bounds[index]) + "\"") << " "
+                            << values.buckets[index] << "\n";
+
+                    out << name << "_bucket" << join(labels, "le=\"+Inf\"")
+                        << " " << values.count << "\n";
+                    out << name << "_sum" << braced(labels) << " "
+                        << format(values.sum) << "\n";
+                    out << name << "_count" << braced(labels) << " "
+                        << values.count << "\n";
+                }
+                break;
+        }
+    }
+
+    return out.str();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace libbitcoin
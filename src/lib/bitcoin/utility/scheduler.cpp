@@ -0,0 +1,422 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/scheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <metaverse/bitcoin/utility/asio.hpp>
+#include <metaverse/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+// The worker of the calling thread, if any, so that its posts stay local.
+static thread_local const scheduler* current_scheduler = nullptr;
+static thread_local size_t current_shard = 0;
+
+// The lane that is not held to the shared limit.
+static constexpr size_t consensus_lane =
+    static_cast<size_t>(scheduler::lane::consensus);
+
+const char* scheduler::to_string(lane value)
+{
+    switch (value)
+    {
+        case lane::consensus:
+            return "consensus";
+        case lane::network:
+            return "network";
+        case lane::storage:
+            return "storage";
+        case lane::rpc:
+            return "rpc";
+        case lane::background:
+            return "background";
+    }
+
+    return "unknown";
+}
+
+scheduler::scheduler()
+  : started_(false),
+    stopping_(false),
+    next_(0),
+    pending_(0),
+    shared_running_(0),
+    shared_limit_(0),
+    events_(0)
+{
+    for (auto& lane: counters_)
+    {
+        lane.limit = 0;
+        lane.queued = 0;
+        lane.running = 0;
+        lane.completed = 0;
+        lane.stolen = 0;
+        lane.wait = 0;
+        lane.max_wait = 0;
+    }
+}
+
+scheduler::~scheduler()
+{
+    stop();
+}
+
+void scheduler::start(size_t threads)
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    const auto shared = std::max(threads - 1, size_t(1));
+    const auto half = std::max(threads / 2, size_t(1));
+    const std::array<size_t, lanes> limits
+    {
+        {
+            threads,
+            shared,
+            half,
+            half,
+            size_t(1)
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    if (started_)
+        return;
+
+    for (size_t lane = 0; lane < lanes; ++lane)
+        counters_[lane].limit = limits[lane];
+
+    shared_limit_ = shared;
+
+    for (size_t index = 0; index < threads; ++index)
+        shards_.emplace_back(new shard);
+
+    stopping_ = false;
+    started_ = true;
+
+    for (size_t index = 0; index < threads; ++index)
+        threads_.emplace_back([this, index]()
+        {
+            work(index);
+        });
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void scheduler::stop()
+{
+    std::vector<asio::thread> threads;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    if (!started_ || stopping_)
+    {
+        mutex_.unlock();
+        return;
+    }
+
+    stopping_ = true;
+    threads.swap(threads_);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    wake_mutex_.lock();
+    ++events_;
+    wake_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    wake_.notify_all();
+
+    // The workers exit once every queue is empty.
+    for (auto& thread: threads)
+        if (thread.joinable())
+            thread.join();
+
+    std::vector<std::unique_ptr<shard>> shards;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    shards.swap(shards_);
+    started_ = false;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Jobs posted from outside while the workers exited run here.
+    for (auto& shard: shards)
+    {
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            task task;
+            while (pop(*shard, lane, false, task))
+            {
+                --pending_;
+                --counters_[lane].queued;
+                task.run();
+            }
+        }
+    }
+}
+
+void scheduler::post(lane lane, job job)
+{
+    const auto index = static_cast<size_t>(lane);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    if (!started_)
+    {
+        mutex_.unlock_shared();
+        //---------------------------------------------------------------------
+        job();
+        return;
+    }
+
+    const auto shard = current_scheduler == this ? current_shard :
+        next_++ % shards_.size();
+
+    auto& target = *shards_[shard];
+    target.mutex.lock();
+    target.lanes[index].push_back({ std::move(job), asio::steady_clock::now() });
+    ++counters_[index].queued;
+    ++pending_;
+    target.mutex.unlock();
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    notify();
+}
+
+size_t scheduler::threads() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+    return started_ ? shards_.size() : 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+scheduler::lane_stats scheduler::stats(lane lane) const
+{
+    const auto& lane_counters = counters_[static_cast<size_t>(lane)];
+
+    return
+    {
+        lane_counters.limit.load(),
+        lane_counters.queued.load(),
+        lane_counters.running.load(),
+        lane_counters.completed.load(),
+        lane_counters.stolen.load(),
+        lane_counters.wait.load(),
+        lane_counters.max_wait.load()
+    };
+}
+
+// Workers.
+// ----------------------------------------------------------------------------
+
+void scheduler::work(size_t index)
+{
+    current_scheduler = this;
+    current_shard = index;
+
+    while (true)
+    {
+        const auto seen = events_.load();
+
+        task task;
+        size_t lane;
+        if (take(index, task, lane))
+        {
+            execute(task, lane);
+            continue;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+
+        if (stopping_ && pending_ == 0)
+            break;
+
+        wake_.wait(lock, [this, seen]()
+        {
+            return events_ != seen || (stopping_ && pending_ == 0);
+        });
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    current_scheduler = nullptr;
+}
+
+// Shards are only read here, the workers are joined before they change.
+bool scheduler::take(size_t index, task& out_task, size_t& out_lane)
+{
+    const auto count = shards_.size();
+
+    for (size_t lane = 0; lane < lanes; ++lane)
+    {
+        if (counters_[lane].queued == 0 || !claim(lane))
+            continue;
+
+        if (pop(*shards_[index], lane, false, out_task))
+        {
+            out_lane = lane;
+            return true;
+        }
+
+        for (size_t offset = 1; offset < count; ++offset)
+        {
+            if (pop(*shards_[(index + offset) % count], lane, true, out_task))
+            {
+                ++counters_[lane].stolen;
+                out_lane = lane;
+                return true;
+            }
+        }
+
+        release(lane);
+    }
+
+    return false;
+}
+
+bool scheduler::claim(size_t lane)
+{
+    if (lane != consensus_lane && !claim_shared())
+        return false;
+
+    auto& counters = counters_[lane];
+    auto running = counters.running.load();
+
+    do
+    {
+        if (running >= counters.limit)
+        {
+            if (lane != consensus_lane)
+                --shared_running_;
+
+            return false;
+        }
+
+    } while (!counters.running.compare_exchange_weak(running, running + 1));
+
+    return true;
+}
+
+bool scheduler::claim_shared()
+{
+    auto running = shared_running_.load();
+
+    do
+    {
+        if (running >= shared_limit_)
+            return false;
+
+    } while (!shared_running_.compare_exchange_weak(running, running + 1));
+
+    return true;
+}
+
+void scheduler::release(size_t lane)
+{
+    if (lane != consensus_lane)
+        --shared_running_;
+
+    --counters_[lane].running;
+}
+
+void scheduler::execute(task& task, size_t lane)
+{
+    auto& counters = counters_[lane];
+    --counters.queued;
+    --pending_;
+
+    const auto waited = std::chrono::duration_cast<asio::microseconds>(
+        asio::steady_clock::now() - task.queued).count();
+    const auto wait = static_cast<uint64_t>(std::max(waited,
+        asio::microseconds::rep(0)));
+
+    counters.wait += wait;
+    auto maximum = counters.max_wait.load();
+    while (wait > maximum &&
+        !counters.max_wait.compare_exchange_weak(maximum, wait));
+
+    task.run();
+
+    ++counters.completed;
+    release(lane);
+
+    // The finished job may have held the last slot of a lane with work.
+    notify();
+}
+
+void scheduler::notify()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    wake_mutex_.lock();
+    ++events_;
+    wake_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    wake_.notify_one();
+}
+
+bool scheduler::pop(shard& shard, size_t lane, bool back, task& out_task)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& queue = shard.lanes[lane];
+
+    if (queue.empty())
+        return false;
+
+    if (back)
+    {
+        out_task = std::move(queue.back());
+        queue.pop_back();
+    }
+    else
+    {
+        out_task = std::move(queue.front());
+        queue.pop_front();
+    }
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace libbitcoin
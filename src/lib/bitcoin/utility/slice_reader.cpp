@@ -0,0 +1,275 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/slice_reader.hpp>
+
+#include <algorithm>
+#include <metaverse/bitcoin/constants.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/math/sha256_engine.hpp>
+#include <metaverse/bitcoin/utility/assert.hpp>
+#include <metaverse/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+// Consumed bytes are hashed in chunks of this size, while still in cache.
+static constexpr size_t hash_chunk_size = 16 * sha256::block_size;
+
+class slice_reader::hasher
+{
+public:
+    hasher()
+      : finalized_(false), checksum_(0)
+    {
+    }
+
+    void update(const uint8_t* data, size_t size)
+    {
+        BITCOIN_ASSERT(!finalized_);
+        context_.update(data, size);
+    }
+
+    uint32_t finalize()
+    {
+        if (!finalized_)
+        {
+            hash_digest first;
+            context_.finalize(first.data());
+            const auto second = sha256_hash(first);
+            checksum_ = from_little_endian_unsafe<uint32_t>(second.begin());
+            finalized_ = true;
+        }
+
+        return checksum_;
+    }
+
+private:
+    sha256::context context_;
+    bool finalized_;
+    uint32_t checksum_;
+};
+
+slice_reader::slice_reader(data_slice data, bool checksum)
+  : begin_(data.begin()),
+    position_(data.begin()),
+    end_(data.end()),
+    hashed_(data.begin()),
+    valid_(true),
+    hasher_(checksum ? new hasher : nullptr)
+{
+}
+
+// Defined here so that hasher is complete at destruction.
+slice_reader::~slice_reader()
+{
+}
+
+slice_reader::operator bool() const
+{
+    return valid_;
+}
+
+bool slice_reader::operator!() const
+{
+    return !valid_;
+}
+
+bool slice_reader::is_exhausted() const
+{
+    return valid_ && position_ == end_;
+}
+
+size_t slice_reader::position() const
+{
+    return static_cast<size_t>(position_ - begin_);
+}
+
+size_t slice_reader::remaining() const
+{
+    return static_cast<size_t>(end_ - position_);
+}
+
+const uint8_t* slice_reader::consume(size_t size)
+{
+    if (!valid_ || size > remaining())
+    {
+        valid_ = false;
+        return nullptr;
+    }
+
+    const auto data = position_;
+    position_ += size;
+
+    if (hasher_ && static_cast<size_t>(position_ - hashed_) >= hash_chunk_size)
+        hash_to(position_);
+
+    return data;
+}
+
+void slice_reader::hash_to(const uint8_t* position)
+{
+    BITCOIN_ASSERT(hasher_);
+    BITCOIN_ASSERT(position >= hashed_ && position <= end_);
+    hasher_->update(hashed_, static_cast<size_t>(position - hashed_));
+    hashed_ = position;
+}
+
+uint32_t slice_reader::checksum()
+{
+    BITCOIN_ASSERT_MSG(hasher_, "The reader was not created with checksum.");
+
+    if (!hasher_)
+        return 0;
+
+    // Trailing bytes are not consumed by the parse but are checksummed.
+    hash_to(end_);
+    return hasher_->finalize();
+}
+
+uint8_t slice_reader::read_byte()
+{
+    const auto data = consume(1);
+    return data == nullptr ? 0 : *data;
+}
+
+uint16_t slice_reader::read_2_bytes_little_endian()
+{
+    return read_little_endian<uint16_t>();
+}
+
+uint32_t slice_reader::read_4_bytes_little_endian()
+{
+    return read_little_endian<uint32_t>();
+}
+
+uint64_t slice_reader::read_8_bytes_little_endian()
+{
+    return read_little_endian<uint64_t>();
+}
+
+uint64_t slice_reader::read_variable_uint_little_endian()
+{
+    const auto length = read_byte();
+    if (length < 0xfd)
+        return length;
+    else if (length == 0xfd)
+        return read_2_bytes_little_endian();
+    else if (length == 0xfe)
+        return read_4_bytes_little_endian();
+
+    // length should be 0xff
+    return read_8_bytes_little_endian();
+}
+
+uint16_t slice_reader::read_2_bytes_big_endian()
+{
+    return read_big_endian<uint16_t>();
+}
+
+uint32_t slice_reader::read_4_bytes_big_endian()
+{
+    return read_big_endian<uint32_t>();
+}
+
+uint64_t slice_reader::read_8_bytes_big_endian()
+{
+    return read_big_endian<uint64_t>();
+}
+
+uint64_t slice_reader::read_variable_uint_big_endian()
+{
+    const auto length = read_byte();
+    if (length < 0xfd)
+        return length;
+    else if (length == 0xfd)
+        return read_2_bytes_big_endian();
+    else if (length == 0xfe)
+        return read_4_bytes_big_endian();
+
+    // length should be 0xff
+    return read_8_bytes_big_endian();
+}
+
+// The size is checked against the remaining range before allocation, so an
+// oversized length prefix cannot cause a large allocation.
+data_chunk slice_reader::read_data(size_t size)
+{
+    const auto data = consume(size);
+    if (data == nullptr)
+        return{};
+
+    return data_chunk(data, data + size);
+}
+
+size_t slice_reader::read_data(uint8_t* data, size_t size)
+{
+    const auto read_size = std::min(size, valid_ ? remaining() : 0);
+    const auto source = consume(read_size);
+
+    if (source != nullptr)
+        std::copy(source, source + read_size, data);
+
+    // Mirror the failbit of a short istream read.
+    if (read_size != size)
+        valid_ = false;
+
+    return read_size;
+}
+
+data_chunk slice_reader::read_data_to_eof()
+{
+    return read_data(valid_ ? remaining() : 0);
+}
+
+hash_digest slice_reader::read_hash()
+{
+    return read_bytes<hash_size>();
+}
+
+short_hash slice_reader::read_short_hash()
+{
+    return read_bytes<short_hash_size>();
+}
+
+mini_hash slice_reader::read_mini_hash()
+{
+    return read_bytes<mini_hash_size>();
+}
+
+std::string slice_reader::read_fixed_string(size_t length)
+{
+    const auto data = consume(length);
+    if (data == nullptr)
+        return{};
+
+    // Removes trailing 0s... Needed for string comparisons
+    const auto terminator = std::find(data, data + length, uint8_t(0));
+    return std::string(data, terminator);
+}
+
+std::string slice_reader::read_string()
+{
+    const auto size = read_variable_uint_little_endian();
+    BITCOIN_ASSERT(size <= bc::max_size_t);
+    const auto read_size = static_cast<size_t>(size);
+    return read_fixed_string(read_size);
+}
+
+} // namespace libbitcoin
@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <utility>
+
+namespace libbitcoin {
+
+namespace {
+
+struct ring
+{
+    std::mutex mutex;
+    tracer::list events;
+
+    // The total recorded since the last clear.
+    uint64_t next = 0;
+};
+
+// Never destroyed, spans may end during static destruction.
+ring& get_ring()
+{
+    static const auto instance = new ring;
+    return *instance;
+}
+
+std::atomic<bool> tracing(false);
+
+// Timestamps are taken from the process start, so they stay small.
+const asio::time_point epoch = asio::steady_clock::now();
+
+// Small sequential numbers read better than native ids in trace viewers.
+uint32_t thread_number()
+{
+    static std::atomic<uint32_t> threads(0);
+    static thread_local const uint32_t number = ++threads;
+    return number;
+}
+
+uint64_t microseconds(asio::duration span)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(span)
+        .count();
+}
+
+// The caller must hold the ring mutex.
+tracer::list ordered(const ring& buffer)
+{
+    if (buffer.events.size() < tracer::capacity)
+        return buffer.events;
+
+    // The oldest span is the next to be overwritten.
+    const auto oldest = buffer.events.begin() + buffer.next % tracer::capacity;
+    tracer::list out(oldest, buffer.events.end());
+    out.insert(out.end(), buffer.events.begin(), oldest);
+    return out;
+}
+
+} // namespace
+
+// tracer
+// ----------------------------------------------------------------------------
+
+bool tracer::enabled()
+{
+    return tracing.load(std::memory_order_relaxed);
+}
+
+void tracer::enable(bool value)
+{
+    if (value)
+    {
+        auto& buffer = get_ring();
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events.reserve(capacity);
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    tracing.store(value, std::memory_order_relaxed);
+}
+
+void tracer::clear()
+{
+    auto& buffer = get_ring();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.clear();
+    buffer.next = 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void tracer::record(const char* name, const char* category,
+    asio::time_point start, std::string detail)
+{
+    const auto end = asio::steady_clock::now();
+    event span
+    {
+        name,
+        category,
+        std::move(detail),
+        thread_number(),
+        start > epoch ? microseconds(start - epoch) : 0,
+        microseconds(end - start)
+    };
+
+    auto& buffer = get_ring();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    if (buffer.events.size() < capacity)
+        buffer.events.push_back(std::move(span));
+    else
+        buffer.events[buffer.next % capacity] = std::move(span);
+
+    ++buffer.next;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+tracer::list tracer::events()
+{
+    auto& buffer = get_ring();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    return ordered(buffer);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+tracer::list tracer::take(uint64_t& dropped)
+{
+    auto& buffer = get_ring();
+
+    // Allocated before locking, this replaces the buffer taken.
+    list out;
+    if (enabled())
+        out.reserve(capacity);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(buffer.mutex);
+
+    dropped = buffer.next > capacity ? buffer.next - capacity : 0;
+
+    // Put the oldest span first before handing the buffer out.
+    if (buffer.events.size() == capacity)
+        std::rotate(buffer.events.begin(),
+            buffer.events.begin() + buffer.next % capacity,
+            buffer.events.end());
+
+    buffer.events.swap(out);
+    buffer.next = 0;
+
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
+}
+
+uint64_t tracer::dropped()
+{
+    auto& buffer = get_ring();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    return buffer.next > capacity ? buffer.next - capacity : 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// trace_span
+// ----------------------------------------------------------------------------
+
+trace_span::trace_span(const char* name, const char* category)
+  : name_(name),
+    category_(category),
+    active_(tracer::enabled())
+{
+    if (active_)
+        start_ = asio::steady_clock::now();
+}
+
+trace_span::~trace_span()
+{
+    if (active_)
+        tracer::record(name_, category_, start_, std::move(detail_));
+}
+
+trace_span::operator bool() const
+{
+    return active_;
+}
+
+void trace_span::set_detail(std::string detail)
+{
+    detail_ = std::move(detail);
+}
+
+} // namespace libbitcoin
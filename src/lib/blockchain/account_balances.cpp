@@ -0,0 +1,638 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/account_balances.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+#define LOG_ACCOUNT_BALANCES "account_balances"
+
+using namespace bc::chain;
+using namespace bc::wallet;
+
+account_balances::account_balances(database::data_base& database)
+  : database_(database)
+{
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+void account_balances::get(const std::string& name,
+    uint64_t address_revision, address_reader read_addresses, uint64_t height,
+    uint64_t pool_revision, pool_reader read_pool, balance& out_balance)
+{
+    pool_list pool;
+    const auto stale = read_if_stale(name, address_revision, pool_revision,
+        read_pool, pool);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+    const auto& state = refresh(name, address_revision, read_addresses,
+        pool_revision, stale ? &pool : nullptr);
+    out_balance = to_balance(state.total, height);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_balances::get(const std::string& name,
+    uint64_t address_revision, address_reader read_addresses, uint64_t height,
+    uint64_t pool_revision, pool_reader read_pool, address_list& out_balances)
+{
+    out_balances.clear();
+
+    pool_list pool;
+    const auto stale = read_if_stale(name, address_revision, pool_revision,
+        read_pool, pool);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+    auto& state = refresh(name, address_revision, read_addresses,
+        pool_revision, stale ? &pool : nullptr);
+
+    out_balances.reserve(state.addresses.size());
+    for (const auto& address: state.addresses)
+        out_balances.emplace_back(address,
+            to_balance(state.by_address[address], height));
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_balances::remove(const std::string& name)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    erase_account(name);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_balances::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    accounts_.clear();
+    owners_.clear();
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool account_balances::read_if_stale(const std::string& name,
+    uint64_t address_revision, uint64_t pool_revision, pool_reader read_pool,
+    pool_list& out_pool)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    const auto it = accounts_.find(name);
+    const auto current = it != accounts_.end() &&
+        it->second.address_revision == address_revision &&
+        it->second.pool_revision == pool_revision;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (current)
+        return false;
+
+    out_pool = read_pool();
+    return true;
+}
+
+// Chain updates.
+// ----------------------------------------------------------------------------
+// Accounts indexed after the block was stored already include it, and those
+// indexed after it was removed never did, which the applied height tells.
+
+void account_balances::connect(const block& block, uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    if (accounts_.empty())
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    for (const auto& tx: block.transactions)
+    {
+        const auto tx_hash = tx.hash();
+        const auto coinbase = tx.is_coinbase();
+
+        for (auto& account: accounts_)
+        {
+            auto& state = account.second;
+            if (state.height >= height)
+                continue;
+
+            // The confirmed transaction replaces its pool counterpart.
+            if (state.pool.count(tx_hash) != 0)
+                remove_pool(state, tx_hash);
+
+            if (!coinbase)
+                for (const auto& input: tx.inputs)
+                    remove_coin(state, input.previous_output, false);
+        }
+
+        for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        {
+            std::string address;
+            if (!to_address(tx.outputs[index], address))
+                continue;
+
+            const auto owner = owners_.find(address);
+            if (owner == owners_.end())
+                continue;
+
+            auto coin = to_coin(tx.outputs[index], coinbase, height);
+            coin.address = address;
+
+            // A multisig address may be held by more than one account.
+            for (const auto& name: owner->second)
+            {
+                auto& state = accounts_[name];
+                if (state.height < height)
+                    add_coin(state, { tx_hash, index }, coin, true);
+            }
+        }
+    }
+
+    for (auto& account: accounts_)
+        if (account.second.height < height)
+            account.second.height = height;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_balances::disconnect(const block& block, uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    if (accounts_.empty())
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    // The block is no longer stored, outputs it spent from itself are found
+    // among its own transactions.
+    std::unordered_map<hash_digest, const transaction*> own;
+    for (const auto& tx: block.transactions)
+        own[tx.hash()] = &tx;
+
+    const auto restore = [this, &own, height](const output_point& point)
+    {
+        output prevout;
+        auto prevout_height = height;
+        auto coinbase = false;
+
+        const auto it = own.find(point.hash);
+        if (it != own.end())
+        {
+            if (point.index >= it->second->outputs.size())
+                return;
+
+            prevout = it->second->outputs[point.index];
+            coinbase = it->second->is_coinbase();
+        }
+        else
+        {
+            const auto result = database_.transactions.get(point.hash);
+            if (!result)
+                return;
+
+            const auto view = result.view();
+            if (!view.is_valid() || point.index >= view.outputs_size())
+                return;
+
+            prevout = view.output(point.index);
+            prevout_height = result.height();
+            coinbase = view.is_coinbase();
+        }
+
+        std::string address;
+        if (!to_address(prevout, address))
+            return;
+
+        const auto owner = owners_.find(address);
+        if (owner == owners_.end())
+            return;
+
+        auto coin = to_coin(prevout, coinbase, prevout_height);
+        coin.address = address;
+
+        for (const auto& name: owner->second)
+        {
+            auto& state = accounts_[name];
+            if (state.height >= height)
+                add_coin(state, point, coin, false);
+        }
+    };
+
+    for (auto tx = block.transactions.rbegin();
+        tx != block.transactions.rend(); ++tx)
+    {
+        const auto tx_hash = tx->hash();
+
+        for (uint32_t index = 0; index < tx->outputs.size(); ++index)
+        {
+            std::string address;
+            if (!to_address(tx->outputs[index], address))
+                continue;
+
+            const auto owner = owners_.find(address);
+            if (owner == owners_.end())
+                continue;
+
+            for (const auto& name: owner->second)
+            {
+                auto& state = accounts_[name];
+                if (state.height >= height)
+                    remove_coin(state, { tx_hash, index }, true);
+            }
+        }
+
+        if (!tx->is_coinbase())
+            for (const auto& input: tx->inputs)
+                restore(input.previous_output);
+    }
+
+    for (auto& account: accounts_)
+        if (account.second.height >= height)
+            account.second.height = height - 1;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Account state, these are called under the mutex.
+// ----------------------------------------------------------------------------
+
+account_balances::account_state& account_balances::refresh(
+    const std::string& name, uint64_t address_revision,
+    address_reader read_addresses, uint64_t pool_revision,
+    const pool_list* pool)
+{
+    auto it = accounts_.find(name);
+
+    // New addresses may already have history, so they rebuild the account.
+    // The revision is taken before the addresses are read, an address
+    // stored in between only causes another rebuild.
+    if (it == accounts_.end() ||
+        it->second.address_revision != address_revision)
+    {
+        erase_account(name);
+        it = accounts_.emplace(name, account_state()).first;
+        it->second.address_revision = address_revision;
+        build(name, it->second, read_addresses());
+    }
+
+    reconcile(it->second, pool_revision, pool);
+    return it->second;
+}
+
+void account_balances::build(const std::string& name, account_state& state,
+    const std::vector<account_address>& addresses)
+{
+    size_t top = 0;
+    database_.blocks.top(top);
+
+    state.height = top;
+
+    // Forces the first reconciliation with the pool.
+    state.pool_revision = max_uint64;
+
+    for (const auto& address: addresses)
+    {
+        const auto& encoded = address.get_address();
+
+        // An address stored twice is counted once.
+        if (state.by_address.count(encoded) != 0)
+            continue;
+
+        state.addresses.push_back(encoded);
+        owners_[encoded].push_back(name);
+        auto& totals = state.by_address[encoded];
+
+        const payment_address payment(encoded);
+        if (!payment)
+            continue;
+
+        const auto rows = database_.history.get(payment.hash(), 0, 0);
+
+        std::unordered_set<uint64_t> spent;
+        for (const auto& row: rows)
+            if (row.kind == point_kind::spend)
+                spent.insert(row.previous_checksum);
+
+        for (const auto& row: rows)
+        {
+            if (row.kind != point_kind::output)
+                continue;
+
+            totals.received += row.value;
+            state.total.received += row.value;
+
+            if (spent.count(row.point.checksum()) != 0)
+                continue;
+
+            const auto result = database_.transactions.get(row.point.hash);
+            if (!result)
+                continue;
+
+            const auto view = result.view();
+            if (!view.is_valid() || row.point.index >= view.outputs_size())
+                continue;
+
+            auto coin = to_coin(view.output(row.point.index),
+                view.is_coinbase(), row.height);
+            coin.address = encoded;
+            add_coin(state, row.point, coin, false);
+        }
+    }
+
+    log::debug(LOG_ACCOUNT_BALANCES) << "indexed " << state.coins.size()
+        << " unspent outputs of " << addresses.size() << " addresses of "
+        << name << " at height " << top;
+}
+
+void account_balances::reconcile(account_state& state, uint64_t pool_revision,
+    const pool_list* pool)
+{
+    if (state.pool_revision == pool_revision)
+        return;
+
+    // The account was current when the pool was left unread but has since
+    // been indexed again, the pool is applied on the next query.
+    if (pool == nullptr)
+        return;
+
+    const auto& transactions = *pool;
+
+    std::unordered_set<hash_digest> current;
+    for (const auto& tx: transactions)
+        current.insert(tx->hash());
+
+    // Transactions that left the pool first, to restore what they spent.
+    std::vector<hash_digest> left;
+    for (const auto& entry: state.pool)
+        if (current.count(entry.first) == 0)
+            left.push_back(entry.first);
+
+    for (const auto& tx_hash: left)
+        remove_pool(state, tx_hash);
+
+    // The pool order puts parents ahead of the transactions spending them.
+    for (const auto& tx: transactions)
+    {
+        const auto tx_hash = tx->hash();
+        if (state.pool.count(tx_hash) != 0)
+            continue;
+
+        // Confirmed but not yet cleared from the pool.
+        if (database_.transactions.get(tx_hash))
+            continue;
+
+        add_pool(state, *tx, tx_hash);
+    }
+
+    state.pool_revision = pool_revision;
+}
+
+void account_balances::add_pool(account_state& state, const transaction& tx,
+    const hash_digest& tx_hash)
+{
+    auto& effect = state.pool[tx_hash];
+
+    // Spends are kept even for unknown coins, the coin may be confirmed
+    // while the transaction is still pending.
+    for (const auto& input: tx.inputs)
+    {
+        state.pool_spends[input.previous_output] = tx_hash;
+        set_pool_spent(state, input.previous_output, true);
+        effect.spends.push_back(input.previous_output);
+    }
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+    {
+        std::string address;
+        if (!to_address(tx.outputs[index], address) ||
+            state.by_address.count(address) == 0)
+            continue;
+
+        auto coin = to_coin(tx.outputs[index], false, 0);
+        coin.address = address;
+
+        const output_point point{ tx_hash, index };
+        add_coin(state, point, coin, true);
+        effect.outputs.push_back(point);
+    }
+}
+
+void account_balances::remove_pool(account_state& state,
+    const hash_digest& tx_hash)
+{
+    const auto it = state.pool.find(tx_hash);
+    if (it == state.pool.end())
+        return;
+
+    for (const auto& point: it->second.outputs)
+    {
+        const auto coin = state.coins.find(point);
+        if (coin != state.coins.end() && coin->second.height == 0)
+            remove_coin(state, point, true);
+    }
+
+    for (const auto& point: it->second.spends)
+    {
+        const auto spend = state.pool_spends.find(point);
+        if (spend == state.pool_spends.end() || spend->second != tx_hash)
+            continue;
+
+        state.pool_spends.erase(spend);
+        set_pool_spent(state, point, false);
+    }
+
+    state.pool.erase(it);
+}
+
+void account_balances::add_coin(account_state& state,
+    const output_point& point, const coin& coin, bool received)
+{
+    auto& stored = state.coins[point] = coin;
+    stored.pool_spent = state.pool_spends.count(point) != 0;
+    apply(state.total, stored, true, received);
+    apply(state.by_address[stored.address], stored, true, received);
+}
+
+void account_balances::remove_coin(account_state& state,
+    const output_point& point, bool received)
+{
+    const auto it = state.coins.find(point);
+    if (it == state.coins.end())
+        return;
+
+    apply(state.total, it->second, false, received);
+    apply(state.by_address[it->second.address], it->second, false, received);
+    state.coins.erase(it);
+}
+
+void account_balances::set_pool_spent(account_state& state,
+    const output_point& point, bool spent)
+{
+    const auto it = state.coins.find(point);
+    if (it == state.coins.end() || it->second.pool_spent == spent)
+        return;
+
+    auto& totals = state.by_address[it->second.address];
+    apply(state.total, it->second, false, false);
+    apply(totals, it->second, false, false);
+    it->second.pool_spent = spent;
+    apply(state.total, it->second, true, false);
+    apply(totals, it->second, true, false);
+}
+
+void account_balances::erase_account(const std::string& name)
+{
+    const auto it = accounts_.find(name);
+    if (it == accounts_.end())
+        return;
+
+    // Only this account lets go of the address, a co-owner keeps it.
+    for (const auto& address: it->second.addresses)
+    {
+        auto& names = owners_[address];
+        names.erase(std::remove(names.begin(), names.end(), name),
+            names.end());
+
+        if (names.empty())
+            owners_.erase(address);
+    }
+
+    accounts_.erase(it);
+}
+
+// Utilities.
+// ----------------------------------------------------------------------------
+
+bool account_balances::to_address(const output& output,
+    std::string& out_address)
+{
+    const auto address = payment_address::extract(output.script);
+    if (!address)
+        return false;
+
+    out_address = address.encoded();
+    return true;
+}
+
+// The frozen rules of the history scan: deposits until their lock height
+// passes, pool deposits until confirmed and coinbase until mature.
+account_balances::coin account_balances::to_coin(output output, bool coinbase,
+    uint64_t height)
+{
+    coin coin;
+    coin.value = output.value;
+    coin.height = height;
+    coin.unlock = 0;
+    coin.asset_amount = 0;
+    coin.pool_spent = false;
+
+    const auto& operations = output.script.operations;
+    if (operation::is_pay_key_hash_with_lock_height_pattern(operations))
+        coin.unlock = height == 0 ? max_uint64 : height +
+            operation::get_lock_height_from_pay_key_hash_with_lock_height(
+                operations);
+    else if (coinbase)
+        coin.unlock = height + coinbase_maturity;
+
+    if (output.is_asset_issue() || output.is_asset_transfer())
+    {
+        coin.symbol = output.get_asset_symbol();
+        coin.asset_amount = output.get_asset_amount();
+    }
+
+    return coin;
+}
+
+void account_balances::apply(totals& totals, const coin& coin, bool add,
+    bool received)
+{
+    const auto update = [add](uint64_t& total, uint64_t value)
+    {
+        total = add ? total + value : total - value;
+    };
+
+    if (received)
+        update(totals.received, coin.value);
+
+    if (coin.height != 0)
+        update(totals.confirmed, coin.value);
+
+    if (coin.pool_spent)
+        return;
+
+    update(totals.unspent, coin.value);
+
+    if (coin.unlock != 0)
+    {
+        auto& locked = totals.locks[coin.unlock];
+        update(locked, coin.value);
+        if (locked == 0)
+            totals.locks.erase(coin.unlock);
+    }
+
+    if (!coin.symbol.empty())
+    {
+        auto& amount = totals.assets[coin.symbol];
+        update(amount, coin.asset_amount);
+        if (amount == 0)
+            totals.assets.erase(coin.symbol);
+    }
+}
+
+account_balances::balance account_balances::to_balance(const totals& totals,
+    uint64_t height)
+{
+    balance out{ totals.received, totals.confirmed, totals.unspent, 0,
+        totals.assets };
+
+    for (auto it = totals.locks.upper_bound(height); it != totals.locks.end();
+        ++it)
+        out.frozen_balance += it->second;
+
+    return out;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,433 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/account_history.hpp>
+
+#include <algorithm>
+#include <map>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+#define LOG_ACCOUNT_HISTORY "account_history"
+
+using namespace bc::chain;
+using namespace bc::wallet;
+
+account_history::account_history(database::data_base& database)
+  : database_(database)
+{
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+void account_history::get(const std::string& name,
+    uint64_t address_revision, address_reader read_addresses,
+    const filter& filter, uint64_t cursor, uint64_t offset, size_t limit,
+    page& out_page)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    // Index the account on first use or after its addresses changed.
+    if (!is_current(name, address_revision))
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        mutex_.unlock_upgrade_and_lock();
+
+        if (!is_current(name, address_revision))
+        {
+            erase_account(name);
+            auto& state = accounts_[name];
+            state.address_revision = address_revision;
+            build(name, state, read_addresses());
+        }
+
+        mutex_.unlock_and_lock_upgrade();
+        //---------------------------------------------------------------------
+    }
+
+    select(accounts_[name].entries, filter, cursor, offset, limit, out_page);
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_history::remove(const std::string& name)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    erase_account(name);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_history::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    accounts_.clear();
+    owners_.clear();
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_history::select(const entry_list& entries, const filter& filter,
+    uint64_t cursor, uint64_t offset, size_t limit, page& out_page)
+{
+    out_page.entries.clear();
+    out_page.total = 0;
+    out_page.next_cursor = 0;
+
+    uint64_t skipped = 0;
+    size_t last = 0;
+
+    for (auto index = entries.size(); index-- > 0;)
+    {
+        if (!matches(*entries[index], filter))
+            continue;
+
+        ++out_page.total;
+
+        if (cursor != 0 && index >= cursor)
+            continue;
+
+        if (cursor == 0 && skipped < offset)
+        {
+            ++skipped;
+            continue;
+        }
+
+        if (out_page.entries.size() < limit)
+        {
+            out_page.entries.push_back(entries[index]);
+            last = index;
+        }
+        else if (out_page.next_cursor == 0)
+        {
+            // A match remains below the page, continue from its last entry.
+            out_page.next_cursor = last;
+        }
+    }
+}
+
+account_history::entry account_history::digest(const transaction& tx,
+    uint64_t height, uint32_t timestamp, owner_test is_own)
+{
+    entry result;
+    result.hash = tx.hash();
+    result.height = height;
+    result.timestamp = timestamp;
+    result.sent = false;
+    result.inputs.reserve(tx.inputs.size());
+    result.outputs.reserve(tx.outputs.size());
+
+    for (const auto& input: tx.inputs)
+    {
+        input_summary summary;
+        const auto address = payment_address::extract(input.script);
+        if (address)
+        {
+            summary.address = address.encoded();
+            result.sent = result.sent || is_own(summary.address);
+        }
+
+        summary.script = input.script.to_string(1);
+        result.inputs.push_back(std::move(summary));
+    }
+
+    for (const auto& output: tx.outputs)
+    {
+        output_summary summary;
+        summary.own = false;
+
+        const auto address = payment_address::extract(output.script);
+        if (address)
+        {
+            summary.address = address.encoded();
+            summary.own = is_own(summary.address);
+        }
+
+        const auto& operations = output.script.operations;
+        summary.script = output.script.to_string(1);
+        summary.lock_height =
+            operation::is_pay_key_hash_with_lock_height_pattern(operations) ?
+            operation::get_lock_height_from_pay_key_hash_with_lock_height(
+                operations) : 0;
+        summary.value = output.value;
+        summary.attach = output.attach_data;
+        result.outputs.push_back(std::move(summary));
+    }
+
+    return result;
+}
+
+// Chain updates.
+// ----------------------------------------------------------------------------
+// Accounts indexed after the block was stored already include it, and those
+// indexed after it was removed never did, which the applied height tells.
+
+void account_history::connect(const block& block, uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    if (accounts_.empty())
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    const auto timestamp = block.header.timestamp;
+
+    for (const auto& tx: block.transactions)
+    {
+        // The records the database stores for the transaction, spends carry
+        // no asset symbol.
+        std::vector<std::pair<std::string, std::string>> records;
+
+        for (const auto& input: tx.inputs)
+        {
+            const auto address = payment_address::extract(input.script);
+            if (address)
+                records.emplace_back(address.encoded(), "");
+        }
+
+        for (auto output: tx.outputs)
+        {
+            const auto address = payment_address::extract(output.script);
+            if (!address)
+                continue;
+
+            const auto asset = output.is_asset_issue() ||
+                output.is_asset_transfer();
+            records.emplace_back(address.encoded(),
+                asset ? output.get_asset_symbol() : "");
+        }
+
+        // Each account the transaction touches gets its own digest, as the
+        // owned outputs differ.
+        std::map<std::string, entry> touched;
+        for (const auto& record: records)
+        {
+            const auto owner = owners_.find(record.first);
+            if (owner == owners_.end())
+                continue;
+
+            for (const auto& name: owner->second)
+            {
+                auto& state = accounts_[name];
+                if (state.height >= height)
+                    continue;
+
+                auto it = touched.find(name);
+                if (it == touched.end())
+                {
+                    const auto is_own = [&state](const std::string& address)
+                    {
+                        return state.owned.count(address) != 0;
+                    };
+
+                    it = touched.emplace(name,
+                        digest(tx, height, timestamp, is_own)).first;
+                }
+
+                it->second.records.push_back(record);
+            }
+        }
+
+        for (auto& account: touched)
+            accounts_[account.first].entries.push_back(
+                std::make_shared<const entry>(std::move(account.second)));
+    }
+
+    for (auto& account: accounts_)
+        if (account.second.height < height)
+            account.second.height = height;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void account_history::disconnect(const block&, uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    // The entries are in height order, those of the block are at the end.
+    for (auto& account: accounts_)
+    {
+        auto& state = account.second;
+        if (state.height < height)
+            continue;
+
+        while (!state.entries.empty() && state.entries.back()->height >= height)
+            state.entries.pop_back();
+
+        state.height = height - 1;
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Account state, these are called under the mutex.
+// ----------------------------------------------------------------------------
+
+bool account_history::is_current(const std::string& name,
+    uint64_t address_revision) const
+{
+    const auto it = accounts_.find(name);
+    return it != accounts_.end() &&
+        it->second.address_revision == address_revision;
+}
+
+void account_history::build(const std::string& name, account_state& state,
+    const std::vector<account_address>& addresses)
+{
+    size_t top = 0;
+    database_.blocks.top(top);
+
+    state.height = top;
+
+    struct pending
+    {
+        uint64_t height;
+        uint32_t timestamp;
+        std::vector<std::pair<std::string, std::string>> records;
+    };
+
+    std::unordered_map<hash_digest, pending> transactions;
+
+    for (const auto& address: addresses)
+    {
+        const auto& encoded = address.get_address();
+
+        // An address stored twice is read once.
+        if (!state.owned.insert(encoded).second)
+            continue;
+
+        owners_[encoded].push_back(name);
+
+        const auto rows = database_.address_assets.get(encoded, "", 0, 0, 0,
+            0);
+
+        for (const auto& row: *rows)
+        {
+            // Rows of a block being stored are left to connect.
+            if (row.height > top)
+                continue;
+
+            std::string symbol;
+            if (row.kind == point_kind::output)
+            {
+                const auto kind = row.data.get_kind_value();
+                if (kind == business_kind::asset_issue)
+                    symbol = boost::get<asset_detail>(
+                        row.data.get_data()).get_symbol();
+                else if (kind == business_kind::asset_transfer)
+                    symbol = boost::get<asset_transfer>(
+                        row.data.get_data()).get_address();
+            }
+
+            auto& tx = transactions[row.point.hash];
+            tx.height = row.height;
+            tx.timestamp = row.data.get_timestamp();
+            tx.records.emplace_back(encoded, symbol);
+        }
+    }
+
+    const auto is_own = [&state](const std::string& address)
+    {
+        return state.owned.count(address) != 0;
+    };
+
+    // Order by height and then by position in the block.
+    std::map<std::pair<uint64_t, size_t>, entry_ptr> ordered;
+    for (auto& each: transactions)
+    {
+        const auto result = database_.transactions.get(each.first);
+        if (!result)
+            continue;
+
+        auto item = digest(result.transaction(), each.second.height,
+            each.second.timestamp, is_own);
+        item.records = std::move(each.second.records);
+        ordered.emplace(std::make_pair(each.second.height, result.index()),
+            std::make_shared<const entry>(std::move(item)));
+    }
+
+    state.entries.reserve(ordered.size());
+    for (auto& each: ordered)
+        state.entries.push_back(std::move(each.second));
+
+    log::debug(LOG_ACCOUNT_HISTORY) << "indexed " << state.entries.size()
+        << " transactions of " << name << " at height " << top;
+}
+
+void account_history::erase_account(const std::string& name)
+{
+    const auto it = accounts_.find(name);
+    if (it == accounts_.end())
+        return;
+
+    for (const auto& address: it->second.owned)
+    {
+        auto& names = owners_[address];
+        names.erase(std::remove(names.begin(), names.end(), name),
+            names.end());
+
+        if (names.empty())
+            owners_.erase(address);
+    }
+
+    accounts_.erase(it);
+}
+
+bool account_history::matches(const entry& entry, const filter& filter)
+{
+    if ((filter.start_height != 0 || filter.end_height != 0) &&
+        (entry.height < filter.start_height ||
+            entry.height >= filter.end_height))
+        return false;
+
+    if (filter.address.empty() && filter.symbol.empty())
+        return true;
+
+    const auto match = [&filter](const std::pair<std::string, std::string>&
+        record)
+    {
+        return (filter.address.empty() || record.first == filter.address) &&
+            (filter.symbol.empty() || record.second == filter.symbol);
+    };
+
+    return std::any_of(entry.records.begin(), entry.records.end(), match);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/account_sessions.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <stdlib.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace blockchain {
+
+typedef std::chrono::steady_clock clock;
+
+// Overwrite memory in a way the compiler cannot elide as a dead store.
+static void secure_zero(void* data, size_t size)
+{
+    auto bytes = static_cast<volatile uint8_t*>(data);
+    while (size-- != 0)
+        *bytes++ = 0;
+}
+
+// Locks do not nest, so each locked allocation has pages of its own that
+// unlocking it cannot release from under another session.
+static size_t page_size()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    static const size_t size = info.dwPageSize;
+#else
+    static const size_t size = sysconf(_SC_PAGESIZE);
+#endif
+    return size;
+}
+
+static size_t round_to_pages(size_t size)
+{
+    const auto page = page_size();
+    return ((size + page - 1) / page) * page;
+}
+
+static void* allocate_pages(size_t size)
+{
+#ifdef _WIN32
+    const auto data = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE,
+        PAGE_READWRITE);
+    if (data == nullptr)
+        throw std::bad_alloc();
+#else
+    void* data;
+    if (posix_memalign(&data, page_size(), size) != 0)
+        throw std::bad_alloc();
+#endif
+    return data;
+}
+
+static void free_pages(void* data)
+{
+#ifdef _WIN32
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    free(data);
+#endif
+}
+
+static void lock_memory(void* data, size_t size)
+{
+    // Locking is best effort, it is limited by RLIMIT_MEMLOCK.
+#ifdef _WIN32
+    VirtualLock(data, size);
+#else
+    mlock(data, size);
+#endif
+}
+
+static void unlock_memory(void* data, size_t size)
+{
+#ifdef _WIN32
+    VirtualUnlock(data, size);
+#else
+    munlock(data, size);
+#endif
+}
+
+// Keeps secrets out of swap and wipes them before the memory is released.
+template <typename Type>
+struct locked_allocator
+{
+    typedef Type value_type;
+
+    locked_allocator()
+    {
+    }
+
+    template <typename Other>
+    locked_allocator(const locked_allocator<Other>&)
+    {
+    }
+
+    Type* allocate(size_t count)
+    {
+        const auto size = round_to_pages(count * sizeof(Type));
+        const auto data = allocate_pages(size);
+        lock_memory(data, size);
+        return static_cast<Type*>(data);
+    }
+
+    void deallocate(Type* data, size_t count)
+    {
+        const auto size = round_to_pages(count * sizeof(Type));
+        secure_zero(data, size);
+        unlock_memory(data, size);
+        free_pages(data);
+    }
+
+    template <typename Other>
+    bool operator==(const locked_allocator<Other>&) const
+    {
+        return true;
+    }
+
+    template <typename Other>
+    bool operator!=(const locked_allocator<Other>&) const
+    {
+        return false;
+    }
+};
+
+struct account_sessions::session
+{
+    struct key
+    {
+        ec_secret secret;
+        ec_compressed point;
+    };
+
+    // Reserved up front so the secrets are never copied by reallocation.
+    std::vector<key, locked_allocator<key>> keys;
+    std::unordered_map<std::string, size_t> index;
+    clock::time_point deadline;
+};
+
+size_t account_sessions::unlock(const std::string& name,
+    const chain::account_address::list& addresses, std::string& passphrase,
+    uint32_t seconds)
+{
+    const auto unlocked = std::make_shared<session>();
+    unlocked->keys.reserve(addresses.size());
+    unlocked->deadline = clock::now() + std::chrono::seconds(seconds);
+
+    for (const auto& address: addresses)
+    {
+        auto encoded = address.get_prv_key(passphrase);
+
+        session::key key;
+        const auto valid = decode_base16(key.secret, encoded) &&
+            secret_to_public(key.point, key.secret);
+        secure_zero(&encoded[0], encoded.size());
+
+        if (valid)
+        {
+            unlocked->index[address.get_address()] = unlocked->keys.size();
+            unlocked->keys.push_back(key);
+        }
+
+        secure_zero(&key, sizeof(key));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    sessions_[name] = unlocked;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return unlocked->keys.size();
+}
+
+bool account_sessions::lock(const std::string& name)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    const auto erased = sessions_.erase(name) != 0;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return erased;
+}
+
+uint32_t account_sessions::remaining(const std::string& name)
+{
+    const auto unlocked = find(name);
+    if (!unlocked)
+        return 0;
+
+    const auto left = std::chrono::duration_cast<std::chrono::seconds>(
+        unlocked->deadline - clock::now());
+    return static_cast<uint32_t>(left.count());
+}
+
+bool account_sessions::contains(const std::string& name,
+    const std::string& address)
+{
+    const auto unlocked = find(name);
+    return unlocked && unlocked->index.count(address) != 0;
+}
+
+bool account_sessions::find(const std::string& name,
+    const std::string& address, ec_secret& out_secret,
+    ec_compressed& out_point)
+{
+    const auto unlocked = find(name);
+    if (!unlocked)
+        return false;
+
+    const auto it = unlocked->index.find(address);
+    if (it == unlocked->index.end())
+        return false;
+
+    const auto& key = unlocked->keys[it->second];
+    out_secret = key.secret;
+    out_point = key.point;
+    return true;
+}
+
+account_sessions::session_ptr account_sessions::find(const std::string& name)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    const auto it = sessions_.find(name);
+    if (it == sessions_.end())
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return nullptr;
+    }
+
+    if (clock::now() < it->second->deadline)
+    {
+        const auto unlocked = it->second;
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return unlocked;
+    }
+
+    // Expired, the keys are wiped once the last user releases the session.
+    mutex_.unlock_upgrade_and_lock();
+    sessions_.erase(it);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return nullptr;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/address_owners.hpp>
+
+#include <algorithm>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+#define LOG_ADDRESS_OWNERS "address_owners"
+
+using namespace bc::chain;
+using namespace bc::wallet;
+
+address_owners::address_owners(database::data_base& database)
+  : database_(database),
+    loaded_(false),
+    revision_(0)
+{
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+bool address_owners::find(const payment_address& address,
+    name_list& out_names)
+{
+    out_names.clear();
+    if (!address)
+        return false;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    if (!loaded_)
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        mutex_.unlock_upgrade_and_lock();
+        load();
+        mutex_.unlock_and_lock_upgrade();
+        //---------------------------------------------------------------------
+    }
+
+    const auto it = owners_.find(address);
+    if (it != owners_.end())
+        out_names = it->second;
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return !out_names.empty();
+}
+
+bool address_owners::find(const std::string& address, name_list& out_names)
+{
+    return find(payment_address(address), out_names);
+}
+
+bool address_owners::owns(const std::string& name, const std::string& address)
+{
+    name_list names;
+    return find(address, names) &&
+        std::find(names.begin(), names.end(), name) != names.end();
+}
+
+uint64_t address_owners::revision(const std::string& name)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    if (!loaded_)
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        mutex_.unlock_upgrade_and_lock();
+        load();
+        mutex_.unlock_and_lock_upgrade();
+        //---------------------------------------------------------------------
+    }
+
+    const auto it = revisions_.find(name);
+    const auto revision = it == revisions_.end() ? 0 : it->second;
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return revision;
+}
+
+std::set<std::string> address_owners::owners(const transaction& tx)
+{
+    std::set<std::string> result;
+    name_list names;
+
+    for (const auto& input: tx.inputs)
+        if (find(payment_address::extract(input.script), names))
+            result.insert(names.begin(), names.end());
+
+    for (const auto& output: tx.outputs)
+        if (find(payment_address::extract(output.script), names))
+            result.insert(names.begin(), names.end());
+
+    return result;
+}
+
+// Updates.
+// ----------------------------------------------------------------------------
+
+void address_owners::store(const std::string& name,
+    const std::vector<account_address>& addresses)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    // Not yet loaded, the load reads the stored addresses.
+    if (loaded_)
+        add(name, addresses);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void address_owners::remove(const std::string& name)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    const auto it = addresses_.find(name);
+    if (it != addresses_.end())
+    {
+        for (const auto& address: it->second)
+        {
+            auto& names = owners_[address];
+            names.erase(std::remove(names.begin(), names.end(), name),
+                names.end());
+
+            if (names.empty())
+                owners_.erase(address);
+        }
+
+        addresses_.erase(it);
+    }
+
+    revisions_.erase(name);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Utilities.
+// ----------------------------------------------------------------------------
+
+void address_owners::load()
+{
+    if (loaded_)
+        return;
+
+    const auto accounts = database_.accounts.get_accounts();
+    for (const auto& account: *accounts)
+    {
+        const auto& name = account.get_name();
+        const data_chunk key(name.begin(), name.end());
+        add(name, database_.account_addresses.get(ripemd160_hash(key)));
+    }
+
+    loaded_ = true;
+    log::debug(LOG_ADDRESS_OWNERS) << "indexed " << owners_.size()
+        << " addresses of " << accounts->size() << " accounts";
+}
+
+void address_owners::add(const std::string& name,
+    const std::vector<account_address>& addresses)
+{
+    if (addresses.empty())
+        return;
+
+    // A later store always gets a new number, also after a removal.
+    revisions_[name] = ++revision_;
+
+    auto& owned = addresses_[name];
+    for (const auto& each: addresses)
+    {
+        const payment_address address(each.get_address());
+        if (!address)
+            continue;
+
+        auto& names = owners_[address];
+        if (std::find(names.begin(), names.end(), name) != names.end())
+            continue;
+
+        names.push_back(name);
+        owned.push_back(address);
+    }
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
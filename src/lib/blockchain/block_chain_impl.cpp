@@ -20,12 +20,14 @@
  */
 #include <metaverse/blockchain/block_chain_impl.hpp>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <unordered_map>
+#include <unordered_set>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -47,17 +49,35 @@ using namespace boost::interprocess;
 using namespace std::placeholders;
 using boost::filesystem::path;
 
-block_chain_impl::block_chain_impl(threadpool& pool,
+static auto& read_wait_seconds = metrics::get_histogram(
+    "mvs_chain_read_wait_seconds", "Time chain reads waited for a write.",
+    metrics::latency_buckets());
+
+block_chain_impl::block_chain_impl(threadpool& pool, scheduler& scheduler,
     const blockchain::settings& chain_settings,
     const database::settings& database_settings)
   : stopped_(true),
     settings_(chain_settings),
-    organizer_(pool, *this, chain_settings),
+    organizer_(pool, scheduler, *this, chain_settings),
     ////read_dispatch_(pool, NAME),
     ////write_dispatch_(pool, NAME),
-    transaction_pool_(pool, *this, chain_settings),
-    database_(database_settings)
-{
+    transaction_pool_(pool, scheduler, *this, chain_settings),
+    database_(database_settings),
+    account_balances_(database_),
+    account_history_(database_),
+    address_owners_(database_),
+    coin_cache_(uint64_t(chain_settings.coin_cache_megabytes) * 1024 * 1024),
+    utxo_views_(database_,
+        uint64_t(chain_settings.utxo_view_megabytes) * 1024 * 1024)
+{
+    transaction_pool_.set_change_handler(
+        [this](const transaction& tx, bool entered)
+        {
+            if (entered)
+                utxo_views_.add_pool(tx);
+            else
+                utxo_views_.remove_pool(tx);
+        });
 }
 
 // Close does not call stop because there is no way to detect thread join.
@@ -94,6 +114,11 @@ const settings& block_chain_impl::chain_settings() const
     return settings_;
 }
 
+coin_cache::statistics block_chain_impl::coin_cache_stats() const
+{
+    return coin_cache_.stats();
+}
+
 // Startup and shutdown.
 // ----------------------------------------------------------------------------
 
@@ -249,6 +274,12 @@ bool block_chain_impl::get_transaction(transaction& out_transaction,
     return true;
 }
 
+bool block_chain_impl::get_cached_coin(coin_cache::coin& out_coin,
+    const output_point& outpoint) const
+{
+    return coin_cache_.get(out_coin, outpoint);
+}
+
 // This is safe to call concurrently (but with no other methods).
 bool block_chain_impl::import(block::ptr block, uint64_t height)
 {
@@ -257,12 +288,45 @@ bool block_chain_impl::import(block::ptr block, uint64_t height)
 
     // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
     database_.push(*block, height);
+
+    // Imports may arrive out of order, so a spend can precede its output.
+    coin_cache_.clear();
+    utxo_views_.clear();
+
+    // Indexed accounts are not connected out of order either, they are
+    // indexed again from the store on next use.
+    account_balances_.clear();
+    account_history_.clear();
     return true;
 }
 
 bool block_chain_impl::push(block_detail::ptr block)
 {
     database_.push(*block->actual());
+    coin_cache_.connect(*block->actual(), block->height());
+    utxo_views_.connect(*block->actual(), block->height());
+    account_balances_.connect(*block->actual(), block->height());
+    account_history_.connect(*block->actual(), block->height());
+    return true;
+}
+
+bool block_chain_impl::push(const block_detail::list& blocks)
+{
+    chain::block::ptr_list actual;
+    actual.reserve(blocks.size());
+    for (const auto& block: blocks)
+        actual.push_back(block->actual());
+
+    database_.push(actual);
+
+    for (const auto& block: blocks)
+    {
+        coin_cache_.connect(*block->actual(), block->height());
+        utxo_views_.connect(*block->actual(), block->height());
+        account_balances_.connect(*block->actual(), block->height());
+        account_history_.connect(*block->actual(), block->height());
+    }
+
     return true;
 }
 
@@ -291,6 +355,10 @@ bool block_chain_impl::pop_from(block_detail::list& out_blocks,
     for (uint64_t index = top; index >= height; --index)
     {
         const auto block = std::make_shared<block_detail>(database_.pop());
+        coin_cache_.disconnect(*block->actual());
+        utxo_views_.disconnect(*block->actual(), index);
+        account_balances_.disconnect(*block->actual(), index);
+        account_history_.disconnect(*block->actual(), index);
         out_blocks.push_back(block);
     }
 
@@ -321,6 +389,14 @@ void block_chain_impl::store(message::block_message::ptr block,
     // A flood of valid orphans from multiple peers could tie up the CPU here,
     // but resolving that cleanly requires removing the orphan pool.
 
+    // This is not posted to the consensus lane of the scheduler. Holding the
+    // network thread until the block is organized keeps the channel from
+    // reading further blocks, which bounds the blocks in flight; queued on
+    // the scheduler they would pile up in memory during sync. The expensive
+    // part, script verification, already runs on the consensus lane through
+    // the verifier, with this thread taking part. Reorganization
+    // notifications stay on the threadpool as they relay to channels.
+
     ////write_dispatch_.ordered(
     ////    std::bind(&block_chain_impl::do_store,
     ////        this, block, handler));
@@ -381,9 +457,21 @@ void block_chain_impl::fetch_serial(perform_read_functor perform_read)
 
     const auto do_read = [try_read]()
     {
+        // Only a read blocked by a write reads the clock.
+        if (try_read())
+        {
+            read_wait_seconds.observe(0);
+            return;
+        }
+
+        const auto start = asio::steady_clock::now();
+
         // Sleep while waiting for write to complete.
         while (!try_read())
             std::this_thread::sleep_for(asio::milliseconds(10));
+
+        read_wait_seconds.observe(std::chrono::duration<double>(
+            asio::steady_clock::now() - start).count());
     };
 
     // Initiate serial read operation.
@@ -928,6 +1016,70 @@ void block_chain_impl::fetch_spend(const chain::output_point& outpoint,
     fetch_serial(do_fetch);
 }
 
+void block_chain_impl::fetch_prevouts(const chain::transaction& tx,
+    prevouts_fetch_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto do_fetch = [this, &tx, handler](size_t slock)
+    {
+        prevout_list prevouts;
+        prevouts.reserve(tx.inputs.size());
+
+        // Inputs commonly share a previous transaction, read it once.
+        std::unordered_map<hash_digest, std::pair<uint64_t,
+            chain::transaction>> read;
+        coin_cache::coin coin;
+
+        for (const auto& input: tx.inputs)
+        {
+            const auto& point = input.previous_output;
+
+            // A cached coin is known unspent.
+            if (coin_cache_.get(coin, point))
+            {
+                prevouts.push_back({ true, false, coin.coinbase, coin.height,
+                    coin.output });
+                continue;
+            }
+
+            auto it = read.find(point.hash);
+
+            if (it == read.end())
+            {
+                const auto result = database_.transactions.get(point.hash);
+                if (!result)
+                {
+                    prevouts.push_back({ false, false, false, 0, {} });
+                    continue;
+                }
+
+                it = read.emplace(point.hash, std::make_pair(result.height(),
+                    result.transaction())).first;
+            }
+
+            const auto height = it->second.first;
+            const auto& previous_tx = it->second.second;
+            if (point.index >= previous_tx.outputs.size())
+            {
+                prevouts.push_back({ false, false, false, 0, {} });
+                continue;
+            }
+
+            const auto spent = database_.spends.get(point).valid;
+            prevouts.push_back({ true, spent, previous_tx.is_coinbase(),
+                height, previous_tx.outputs[point.index] });
+        }
+
+        return finish_fetch(slock, handler, error::success, prevouts);
+    };
+    fetch_serial(do_fetch);
+}
+
 void block_chain_impl::fetch_history(const wallet::payment_address& address,
     uint64_t limit, uint64_t from_height, history_fetch_handler handler)
 {
@@ -1080,6 +1232,7 @@ operation_result block_chain_impl::store_account_address(std::shared_ptr<account
 	const auto hash = get_short_hash(address->get_name());
 	database_.account_addresses.store(hash, *address);
 	database_.account_addresses.sync();
+	address_owners_.store(address->get_name(), { *address });
 	///////////////////////////////////////////////////////////////////////////
 	return operation_result::okay;
 }
@@ -1099,6 +1252,9 @@ operation_result block_chain_impl::delete_account_address(const std::string& nam
 	for( auto each : addr_vec )
 		database_.account_addresses.delete_last_row(hash);
 	database_.account_addresses.sync();
+	account_balances_.remove(name);
+	account_history_.remove(name);
+	address_owners_.remove(name);
 	///////////////////////////////////////////////////////////////////////////
 	return operation_result::okay;
 }
@@ -1106,9 +1262,31 @@ operation_result block_chain_impl::delete_account_address(const std::string& nam
 std::shared_ptr<account_address> block_chain_impl::get_account_address 
                     (const std::string& name, const std::string& address)
 {
+	// Skip the scan of the account rows when the account cannot own it.
+	if (!is_account_address(name, address))
+		return nullptr;
+
 	return database_.account_addresses.get(get_short_hash(name), address);
 }
 
+bool block_chain_impl::is_account_address(const std::string& name,
+	const std::string& address)
+{
+	return address_owners_.owns(name, address);
+}
+
+bool block_chain_impl::get_address_owners(const std::string& address,
+	address_owners::name_list& out_names)
+{
+	return address_owners_.find(address, out_names);
+}
+
+std::set<std::string> block_chain_impl::get_transaction_owners(
+	const chain::transaction& tx)
+{
+	return address_owners_.owners(tx);
+}
+
 std::shared_ptr<std::vector<account_address>> block_chain_impl::get_account_addresses(const std::string& name)
 {
 	auto sp_addr = std::make_shared<std::vector<account_address>>();
@@ -1741,6 +1919,45 @@ bool block_chain_impl::get_transaction(const hash_digest& hash,
 	
 }
 
+bool block_chain_impl::get_transaction_view(const hash_digest& hash,
+    chain::transaction_view& view, uint64_t& tx_height)
+{
+    if (stopped())
+        return false;
+
+    // Confirmed transactions are viewed straight from their stored bytes.
+    const auto result = database_.transactions.get(hash);
+    if (result)
+    {
+        view = result.view();
+        tx_height = result.height();
+        return view.is_valid();
+    }
+
+    // Unconfirmed transactions are serialized by the pool, without a copy.
+    boost::mutex mutex;
+    auto found = false;
+
+    mutex.lock();
+    auto f = [&view, &found, &mutex](const code& ec,
+        const chain::transaction_view& pool_view)
+    {
+        if (ec == error::success)
+        {
+            view = pool_view;
+            found = true;
+        }
+
+        mutex.unlock();
+    };
+
+    pool().fetch_view(hash, f);
+    boost::unique_lock<boost::mutex> lock(mutex);
+
+    tx_height = 0;
+    return found && view.is_valid();
+}
+
 bool block_chain_impl::get_transaction_callback(const hash_digest& hash,
     std::function<void(const code&, const chain::transaction&)> handler)
 {
@@ -1993,14 +2210,138 @@ bool block_chain_impl::get_tx_inputs_etp_value (chain::transaction& tx, uint64_t
     
 }
 
-void block_chain_impl::safe_store_account(account& acc, std::vector<std::shared_ptr<account_address>>& addresses)
+blockchain::account_sessions& block_chain_impl::account_sessions()
+{
+    return account_sessions_;
+}
+
+bool block_chain_impl::get_account_balance(const std::string& name,
+    account_balances::balance& out_balance)
+{
+    uint64_t height = 0;
+    get_last_height(height);
+
+    // The address rows are read only if the account changed since indexed.
+    account_balances_.get(name, address_owners_.revision(name),
+        [this, &name]() { return *get_account_addresses(name); }, height,
+        pool().revision(), [this]() { return get_pool_transactions(); },
+        out_balance);
+    return true;
+}
+
+bool block_chain_impl::get_account_balance(const std::string& name,
+    account_balances::address_list& out_balances)
+{
+    uint64_t height = 0;
+    get_last_height(height);
+
+    // The address rows are read only if the account changed since indexed.
+    account_balances_.get(name, address_owners_.revision(name),
+        [this, &name]() { return *get_account_addresses(name); }, height,
+        pool().revision(), [this]() { return get_pool_transactions(); },
+        out_balances);
+    return true;
+}
+
+bool block_chain_impl::get_account_history(const std::string& name,
+    const account_history::filter& filter, uint64_t cursor, uint64_t offset,
+    size_t limit, account_history::page& out_page)
+{
+    // The address rows are read only if the account changed since indexed.
+    account_history_.get(name, address_owners_.revision(name),
+        [this, &name]() { return *get_account_addresses(name); }, filter,
+        cursor, offset, limit, out_page);
+    return true;
+}
+
+void block_chain_impl::get_address_utxos(const std::string& address,
+    utxo_views::coin_list& out_coins)
+{
+    utxo_views_.get(address, [this](const std::string& address)
+    {
+        return read_address_utxos(address);
+    }, out_coins);
+}
+
+// The outputs of the address in the store and the pool less those spent in
+// the store, the views leave out the ones spent in the pool.
+utxo_views::coin_list block_chain_impl::read_address_utxos(
+    const std::string& address)
+{
+    utxo_views::coin_list coins;
+    const wallet::payment_address payment(address);
+
+    history_compact::list rows;
+    if (!payment || !get_history(payment, 0, 0, rows))
+        return coins;
+
+    // Pool rows are at height zero.
+    std::unordered_set<uint64_t> spent;
+    for (const auto& row: rows)
+        if (row.kind == point_kind::spend && row.height != 0)
+            spent.insert(row.previous_checksum);
+
+    // The pool index may still hold an output that is now confirmed.
+    std::unordered_map<output_point, size_t> positions;
+    transaction_view view;
+    uint64_t tx_height;
+
+    for (const auto& row: rows)
+    {
+        if (row.kind != point_kind::output ||
+            spent.count(row.point.checksum()) != 0)
+            continue;
+
+        const auto position = positions.find(row.point);
+        if (position != positions.end())
+        {
+            if (row.height != 0)
+                coins[position->second].height = row.height;
+
+            continue;
+        }
+
+        if (!get_transaction_view(row.point.hash, view, tx_height) ||
+            row.point.index >= view.outputs_size())
+            continue;
+
+        positions.emplace(row.point, coins.size());
+        coins.push_back({ row.point, view.output(row.point.index), row.height,
+            view.is_coinbase() });
+    }
+
+    return coins;
+}
+
+message::transaction_message::ptr_list block_chain_impl::get_pool_transactions()
+{
+    message::transaction_message::ptr_list transactions;
+    boost::mutex mutex;
+
+    mutex.lock();
+    auto f = [&transactions, &mutex](const code& ec,
+        const message::transaction_message::ptr_list& pool_transactions)
+    {
+        if ((code)error::success == ec)
+            transactions = pool_transactions;
+        mutex.unlock();
+    };
+
+    pool().fetch(f);
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return transactions;
+}
+
+void block_chain_impl::safe_store_account(account& acc, const account_address::list& addresses)
 {
     if (stopped())
         return;
 
-    for(auto& address:addresses) {
-        const auto hash = get_short_hash(address->get_name());
-        database_.account_addresses.safe_store(hash, *address);
+    // All addresses of a batch belong to the account, so share one key.
+    if (!addresses.empty()) {
+        const auto hash = get_short_hash(acc.get_name());
+        database_.account_addresses.safe_store(hash, addresses);
+        address_owners_.store(acc.get_name(), addresses);
     }
 
     const auto hash = get_hash(acc.get_name());
@@ -90,5 +90,19 @@ const hash_digest block_detail::hash() const
     return actual_block_->header.hash();
 }
 
+const std::vector<std::string>& block_detail::issued_assets() const
+{
+    const auto collect = [this]()
+    {
+        for (auto& tx: actual_block_->transactions)
+            for (auto& output: tx.outputs)
+                if (output.is_asset_issue())
+                    issued_assets_.push_back(output.get_asset_symbol());
+    };
+
+    std::call_once(issued_assets_once_, collect);
+    return issued_assets_;
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
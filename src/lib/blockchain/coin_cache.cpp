@@ -0,0 +1,216 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/coin_cache.hpp>
+
+#include <utility>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::chain;
+
+// The spent points are left in the eviction order, rebuild it once they
+// outnumber the cached coins by this much.
+static constexpr size_t stale_order_slack = 1024;
+
+static auto& cache_coins = metrics::get_gauge(
+    "mvs_coin_cache_coins", "Unspent outputs in the coin cache.");
+static auto& cache_bytes = metrics::get_gauge(
+    "mvs_coin_cache_bytes", "Estimated heap held by the coin cache.");
+static auto& cache_hits = metrics::get_counter(
+    "mvs_coin_cache_lookups_total", "Coin cache lookups by result.",
+    "result=\"hit\"");
+static auto& cache_misses = metrics::get_counter(
+    "mvs_coin_cache_lookups_total", "Coin cache lookups by result.",
+    "result=\"miss\"");
+
+coin_cache::coin_cache(uint64_t capacity_bytes)
+  : capacity_(capacity_bytes),
+    bytes_(0),
+    hits_(0),
+    misses_(0)
+{
+}
+
+bool coin_cache::get(coin& out_coin, const output_point& point) const
+{
+    if (capacity_ == 0)
+        return false;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    const auto it = coins_.find(point);
+    const auto found = it != coins_.end();
+
+    if (found)
+        out_coin = it->second;
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (found)
+    {
+        ++hits_;
+        cache_hits.increment();
+    }
+    else
+    {
+        ++misses_;
+        cache_misses.increment();
+    }
+
+    return found;
+}
+
+void coin_cache::connect(const block& block, uint64_t height)
+{
+    if (capacity_ == 0)
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    for (const auto& tx: block.transactions)
+    {
+        const auto coinbase = tx.is_coinbase();
+
+        if (!coinbase)
+            for (const auto& input: tx.inputs)
+                remove(input.previous_output);
+
+        const auto tx_hash = tx.hash();
+        for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+            add({ tx_hash, index }, { tx.outputs[index], height, coinbase });
+    }
+
+    evict();
+    cache_coins.set(coins_.size());
+    cache_bytes.set(bytes_);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The outputs the block spent are not restored, they are read from the
+// database until stored again.
+void coin_cache::disconnect(const block& block)
+{
+    if (capacity_ == 0)
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    for (const auto& tx: block.transactions)
+    {
+        const auto tx_hash = tx.hash();
+        for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+            remove({ tx_hash, index });
+    }
+
+    cache_coins.set(coins_.size());
+    cache_bytes.set(bytes_);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void coin_cache::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    coins_.clear();
+    order_.clear();
+    bytes_ = 0;
+    cache_coins.set(0);
+    cache_bytes.set(0);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+coin_cache::statistics coin_cache::stats() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    const auto coins = coins_.size();
+    const auto bytes = bytes_;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return { coins, bytes, capacity_, hits_.load(), misses_.load() };
+}
+
+// An estimate of the heap the coin holds, including its map node and its
+// place in the eviction order.
+uint64_t coin_cache::footprint(const coin& coin)
+{
+    return sizeof(coin_map::value_type) + 2 * sizeof(void*) +
+        sizeof(output_point) + coin.output.serialized_size();
+}
+
+void coin_cache::add(const output_point& point, coin&& coin)
+{
+    const auto bytes = footprint(coin);
+    const auto result = coins_.emplace(point, std::move(coin));
+    if (!result.second)
+        return;
+
+    bytes_ += bytes;
+    order_.push_back(point);
+}
+
+void coin_cache::remove(const output_point& point)
+{
+    const auto it = coins_.find(point);
+    if (it == coins_.end())
+        return;
+
+    bytes_ -= footprint(it->second);
+    coins_.erase(it);
+}
+
+void coin_cache::evict()
+{
+    // Drop the oldest coins, skipping the points already spent.
+    while (bytes_ > capacity_ && !order_.empty())
+    {
+        remove(order_.front());
+        order_.pop_front();
+    }
+
+    if (order_.size() <= 2 * coins_.size() + stale_order_slack)
+        return;
+
+    std::deque<output_point> live;
+    for (const auto& point: order_)
+        if (coins_.find(point) != coins_.end())
+            live.push_back(point);
+
+    order_.swap(live);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <memory>
 #include <numeric>
+#include <thread>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
 #include <metaverse/blockchain/orphan_pool.hpp>
@@ -46,13 +47,25 @@ using namespace bc::config;
 
 #define NAME "organizer"
 
-organizer::organizer(threadpool& pool, simple_chain& chain,
-    const settings& settings)
+// Zero configures one helper per core, the validating thread makes the rest.
+static size_t verify_threads(uint32_t configured)
+{
+    if (configured != 0)
+        return configured;
+
+    const auto cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+organizer::organizer(threadpool& pool, scheduler& scheduler,
+    simple_chain& chain, const settings& settings)
   : stopped_(true),
     use_testnet_rules_(settings.use_testnet_rules),
     checkpoints_(checkpoint::sort(settings.checkpoints)),
     chain_(chain),
-    orphan_pool_(settings.block_pool_capacity),
+    orphan_pool_(settings.block_pool_capacity,
+        uint64_t(settings.block_pool_megabytes) * 1024 * 1024),
+    verifier_(scheduler, verify_threads(settings.verify_threads)),
     subscriber_(std::make_shared<reorganize_subscriber>(pool, NAME))
 {
 }
@@ -66,6 +79,7 @@ void organizer::start()
 void organizer::stop()
 {
     stopped_ = true;
+    verifier_.stop();
     subscriber_->stop();
     subscriber_->invoke(error::service_stopped, 0, {}, {});
 }
@@ -95,20 +109,13 @@ code organizer::verify_asset_exist(uint64_t fork_point,
     const block_detail::list& orphan_chain, uint64_t orphan_index)
 {
     block_chain_impl& chain = (block_chain_impl&)chain_;
-    auto& block = *orphan_chain[orphan_index]->actual();
     std::set<string> assets;
-    for(auto& tx : block.transactions)
+    for(auto& symbol : orphan_chain[orphan_index]->issued_assets())
     {
-        for(auto& output : tx.outputs)
+        auto result = assets.insert(symbol);
+        if(result.second == false)
         {
-            if(output.is_asset_issue())
-            {
-                auto result = assets.insert(output.get_asset_symbol());
-                if(result.second == false)
-                {
-                    return error::asset_exist;
-                }
-            }
+            return error::asset_exist;
         }
     }
 
@@ -126,20 +133,14 @@ code organizer::verify_asset_exist(uint64_t fork_point,
         }
     }
 
+    // The earlier blocks of the branch, each collects its symbols once.
     for(uint64_t i = 0; i < orphan_index; ++i)
     {
-        auto& block = *orphan_chain[orphan_index - 1]->actual();
-        for(auto& tx : block.transactions)
+        for(auto& symbol : orphan_chain[i]->issued_assets())
         {
-            for(auto& output : tx.outputs)
+            if(assets.find(symbol) != assets.end())
             {
-                if(output.is_asset_issue())
-                {
-                    if(assets.find(output.get_asset_symbol()) != assets.end())
-                    {
-                        return error::asset_exist;
-                    }
-                }
+                return error::asset_exist;
             }
         }
     }
@@ -169,8 +170,16 @@ code organizer::verify(uint64_t fork_point,
         orphan_index, height, *current_block, use_testnet_rules_, checkpoints_,
             callback);
 
+    code ec;
+
     // Checks that are independent of the chain.
-    auto ec = validate.check_block(static_cast<blockchain::block_chain_impl&>(this->chain_));
+    {
+        trace_span span("validate_block.check_block", "block");
+        if (span)
+            span.set_detail(std::to_string(height));
+
+        ec = validate.check_block(static_cast<blockchain::block_chain_impl&>(this->chain_));
+    }
 
     if (ec)
         return ec;
@@ -178,7 +187,13 @@ code organizer::verify(uint64_t fork_point,
     validate.initialize_context();
 
     // Checks that are dependent on height and preceding blocks.
-    ec = validate.accept_block();
+    {
+        trace_span span("validate_block.accept_block", "block");
+        if (span)
+            span.set_detail(std::to_string(height));
+
+        ec = validate.accept_block();
+    }
 
     if (ec)
         return ec;
@@ -195,11 +210,15 @@ code organizer::verify(uint64_t fork_point,
         << ") txs and (" << total_inputs << ") inputs";
 
     // Time this for logging.
-    const auto timed = [this, &ec, &validate]()
+    const auto timed = [this, &ec, &validate, height]()
     {
+        trace_span span("validate_block.connect_block", "block");
+        if (span)
+            span.set_detail(std::to_string(height));
+
         hash_digest err_tx;
         // Checks that include input->output traversal.
-        ec = validate.connect_block(err_tx);
+        ec = validate.connect_block(err_tx, verifier_);
         if(ec && err_tx != null_hash) {
             dynamic_cast<block_chain_impl&>(chain_).pool().delete_tx(err_tx);
         }
@@ -258,6 +277,10 @@ void organizer::process(block_detail::ptr process_block)
     {
         process_block = blocks.back();
         blocks.pop_back();
+
+        trace_span span("organizer.process", "block");
+        if (span)
+            span.set_detail(encode_hash(process_block->hash()));
         // Trace the chain in the orphan pool
         auto orphan_chain = orphan_pool_.trace(process_block);
         BITCOIN_ASSERT(orphan_chain.size() >= 1);
@@ -384,9 +407,15 @@ void organizer::replace_chain(uint64_t fork_index,
 
         // Indicates the block is not an orphan.
         arrival_block->set_height(++arrival_index);
+    }
 
-        // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
-        if(chain_.push(arrival_block) == false)
+    // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
+    // The branch is stored as one batch.
+    const auto pushed = chain_.push(orphan_chain);
+
+    for (const auto arrival_block: orphan_chain)
+    {
+        if(pushed == false)
         {
             log::warning(LOG_BLOCKCHAIN)
                 << " push block height:" << arrival_block->actual()->header.number
@@ -435,6 +464,15 @@ void organizer::clip_orphans(block_detail::list& orphan_chain,
     // Remove from orphans pool and process queue.
     auto orphan_start = orphan_chain.begin() + orphan_index;
 
+    // Other branches building on the invalid block are invalid as well.
+    for (const auto& descendant: orphan_pool_.descendants((*orphan_start)->hash()))
+    {
+        descendant->set_error(error::previous_block_invalid);
+        descendant->set_processed();
+        remove_processed(descendant);
+        orphan_pool_.remove(descendant);
+    }
+
     for (auto it = orphan_start; it != orphan_chain.end(); ++it)
     {
         if (it == orphan_start)
@@ -459,6 +497,10 @@ void organizer::notify_reorganize(uint64_t fork_point,
     const block_detail::list& orphan_chain,
     const block_detail::list& replaced_chain)
 {
+    trace_span span("organizer.notify", "block");
+    if (span)
+        span.set_detail(std::to_string(fork_point));
+
     const auto to_block_ptr = [](const block_detail::ptr& detail)
     {
         return detail->actual();
@@ -27,37 +27,60 @@
 namespace libbitcoin {
 namespace blockchain {
 
-orphan_pool::orphan_pool(size_t capacity)
+static auto& orphan_blocks = metrics::get_gauge(
+    "mvs_orphan_pool_blocks", "Blocks in the orphan pool.");
+static auto& orphan_bytes = metrics::get_gauge(
+    "mvs_orphan_pool_bytes", "Serialized size of the orphan pool blocks.");
+static auto& orphan_evicted = metrics::get_counter(
+    "mvs_orphan_pool_evicted_total", "Blocks evicted from the orphan pool.");
+
+orphan_pool::orphan_pool(size_t capacity, uint64_t byte_capacity)
+  : capacity_(capacity == 0 ? 1 : capacity),
+    byte_capacity_(byte_capacity),
+    sequence_(0),
+    bytes_(0)
 {
-    buffer_.reserve(capacity == 0 ? 1 : capacity);
+    entries_.reserve(capacity_);
 }
 
 // There is no validation whatsoever of the block up to this pont.
 bool orphan_pool::add(block_detail::ptr block)
 {
-    const auto& header = block->actual()->header;
+    const chain::block& actual = *block->actual();
+    const auto& header = actual.header;
+    const auto hash = block->hash();
+    const auto size = actual.serialized_size();
 
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_upgrade();
 
     // No duplicates allowed.
-    if (exists(header))
+    if (entries_.find(hash) != entries_.end())
     {
         mutex_.unlock_upgrade();
         //-----------------------------------------------------------------
         return false;
     }
 
-    const auto old_size = buffer_.size();
+    const auto old_size = entries_.size();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
-    buffer_.push_back(block);
+    evict(size);
+
+    const auto sequence = ++sequence_;
+    entries_.emplace(hash, entry{ block, sequence, size });
+    children_[header.previous_block_hash].push_back(hash);
+    arrivals_.emplace(sequence, hash);
+    bytes_ += size;
+    orphan_blocks.set(entries_.size());
+    orphan_bytes.set(bytes_);
+
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
     log::debug(LOG_BLOCKCHAIN)
-        << "Orphan pool added block [" << encode_hash(block->hash())
+        << "Orphan pool added block [" << encode_hash(hash)
         << "] previous [" << encode_hash(header.previous_block_hash)
         << "] old size (" << old_size << ").";
 
@@ -66,32 +89,36 @@ bool orphan_pool::add(block_detail::ptr block)
 
 void orphan_pool::remove(block_detail::ptr block)
 {
+    const auto hash = block->hash();
+
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_upgrade();
 
-    const auto it = std::find(buffer_.begin(), buffer_.end(), block);
+    const auto it = entries_.find(hash);
 
-    if (it == buffer_.end())
+    // Another block with the same hash is not this one.
+    if (it == entries_.end() || it->second.block != block)
     {
         mutex_.unlock_upgrade();
         //-----------------------------------------------------------------
         return;
     }
 
-    const auto old_size = buffer_.size();
+    const auto old_size = entries_.size();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
-    buffer_.erase(it);
+    erase(it);
+    orphan_blocks.set(entries_.size());
+    orphan_bytes.set(bytes_);
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
     log::debug(LOG_BLOCKCHAIN)
-        << "Orphan pool removed block [" << encode_hash(block->hash())
+        << "Orphan pool removed block [" << encode_hash(hash)
         << "] old size (" << old_size << ").";
 }
 
-// TODO: use hash table pool to eliminate this O(n^2) search.
 void orphan_pool::filter(message::get_data::ptr message) const
 {
     auto& inventories = message->inventories;
@@ -101,7 +128,7 @@ void orphan_pool::filter(message::get_data::ptr message) const
     shared_lock lock(mutex_);
 
     for (auto it = inventories.begin(); it != inventories.end();)
-        if (it->is_block_type() && exists(it->hash))
+        if (it->is_block_type() && entries_.find(it->hash) != entries_.end())
             it = inventories.erase(it);
         else
             ++it;
@@ -111,7 +138,6 @@ void orphan_pool::filter(message::get_data::ptr message) const
 block_detail::list orphan_pool::trace(block_detail::ptr end) const
 {
     block_detail::list trace;
-    trace.reserve(buffer_.size());
     trace.push_back(end);
     auto hash = end->actual()->header.previous_block_hash;
 
@@ -119,10 +145,12 @@ block_detail::list orphan_pool::trace(block_detail::ptr end) const
     // Critical Section
     mutex_.lock_shared();
 
-    for (auto it = rfind(buffer_.rbegin(), hash); it != buffer_.rend(); it = rfind(it, hash))
+    // The pool holds at most one block per hash, so the walk cannot loop.
+    for (auto it = entries_.find(hash); it != entries_.end();
+        it = entries_.find(hash))
     {
-        trace.push_back(*it);
-        hash = (*it)->actual()->header.previous_block_hash;
+        trace.push_back(it->second.block);
+        hash = it->second.block->actual()->header.previous_block_hash;
     }
 
     mutex_.unlock_shared();
@@ -130,23 +158,58 @@ block_detail::list orphan_pool::trace(block_detail::ptr end) const
 
     BITCOIN_ASSERT(!trace.empty());
     std::reverse(trace.begin(), trace.end());
-    trace.shrink_to_fit();
     return trace;
 }
 
+block_detail::list orphan_pool::descendants(const hash_digest& hash) const
+{
+    block_detail::list descendants;
+    std::vector<hash_digest> parents{ hash };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    for (size_t index = 0; index < parents.size(); ++index)
+    {
+        const auto children = children_.find(parents[index]);
+        if (children == children_.end())
+            continue;
+
+        for (const auto& child: children->second)
+        {
+            const auto it = entries_.find(child);
+            if (it == entries_.end())
+                continue;
+
+            descendants.push_back(it->second.block);
+            parents.push_back(child);
+        }
+    }
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return descendants;
+}
+
 block_detail::list orphan_pool::unprocessed() const
 {
     block_detail::list unprocessed;
-    unprocessed.reserve(buffer_.size());
 
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_shared();
 
+    unprocessed.reserve(entries_.size());
+
     // Earlier blocks enter pool first, so reversal helps avoid fragmentation.
-    for (auto it = buffer_.rbegin(); it != buffer_.rend(); ++it)
-        if (!(*it)->processed())
-            unprocessed.push_back(*it);
+    for (auto it = arrivals_.rbegin(); it != arrivals_.rend(); ++it)
+    {
+        const auto& block = entries_.find(it->second)->second.block;
+        if (!block->processed())
+            unprocessed.push_back(block);
+    }
 
     mutex_.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
@@ -185,46 +248,48 @@ block_detail::ptr orphan_pool::delete_pending_block(const hash_digest& needed_bl
 // private
 //-----------------------------------------------------------------------------
 
-bool orphan_pool::exists(const hash_digest& hash) const
+void orphan_pool::erase(entry_map::iterator it)
 {
-    const auto match = [&hash](const block_detail::ptr& entry)
-    {
-        return hash == entry->hash();
-    };
+    const auto& hash = it->first;
+    const auto& previous = it->second.block->actual()->header.previous_block_hash;
 
-    return std::any_of(buffer_.begin(), buffer_.end(), match);
-}
-
-bool orphan_pool::exists(const chain::header& header) const
-{
-    const auto match = [&header](const block_detail::ptr& entry)
+    // Children of the block stay indexed under its hash, to be found again
+    // if it returns to the pool.
+    const auto siblings = children_.find(previous);
+    if (siblings != children_.end())
     {
-        return header == entry->actual()->header;
-    };
+        auto& hashes = siblings->second;
+        hashes.erase(std::remove(hashes.begin(), hashes.end(), hash),
+            hashes.end());
 
-    return std::any_of(buffer_.begin(), buffer_.end(), match);
+        if (hashes.empty())
+            children_.erase(siblings);
+    }
+
+    arrivals_.erase(it->second.sequence);
+    bytes_ -= it->second.size;
+    entries_.erase(it);
 }
 
-/*
-orphan_pool::const_iterator orphan_pool::find(buffer::const_iterator begin, const hash_digest& hash) const
+// Make room for a block of the size, oldest first.
+void orphan_pool::evict(uint64_t size)
 {
-    const auto match = [&hash](const block_detail::ptr& entry)
+    const auto full = [this, size]()
     {
-        return hash == entry->hash();
+        return entries_.size() >= capacity_ || (byte_capacity_ != 0 &&
+            bytes_ + size > byte_capacity_);
     };
 
-    return std::find_if(begin, buffer_.end(), match);
-}
-*/
-
-orphan_pool::const_reverse_iterator orphan_pool::rfind(buffer::const_reverse_iterator begin, const hash_digest& hash) const
-{
-    const auto match = [&hash](const block_detail::ptr& entry)
+    while (!arrivals_.empty() && full())
     {
-        return hash == entry->hash();
-    };
+        const auto it = entries_.find(arrivals_.begin()->second);
 
-    return std::find_if(begin, buffer_.rend(), match);
+        log::debug(LOG_BLOCKCHAIN)
+            << "Orphan pool evicted block [" << encode_hash(it->first) << "].";
+
+        erase(it);
+        orphan_evicted.increment();
+    }
 }
 
 } // namespace blockchain
@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/script_verifier.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/validate_transaction.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+// Checks are claimed one at a time from a shared cursor by the caller and by
+// each helper, so an expensive multisig does not hold up a whole partition.
+struct script_verifier::batch
+{
+    batch(const check::list& checks)
+      : checks(checks),
+        size(checks.size()),
+        outcomes(checks.size(), result::unchecked),
+        next(0),
+        failed(false),
+        done(0)
+    {
+    }
+
+    // Only dereferenced by a thread holding an unfinished claim.
+    const check::list& checks;
+    const size_t size;
+    results outcomes;
+
+    std::atomic<size_t> next;
+    std::atomic<bool> failed;
+
+    // Completed claims are counted under the mutex, which also publishes
+    // each outcome to the waiting caller.
+    size_t done;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+script_verifier::script_verifier(scheduler& scheduler, size_t helpers)
+  : helpers_(helpers),
+    stopped_(helpers == 0),
+    scheduler_(scheduler)
+{
+}
+
+script_verifier::~script_verifier()
+{
+    stop();
+}
+
+void script_verifier::stop()
+{
+    stopped_ = true;
+}
+
+bool script_verifier::verify(const check& check)
+{
+    return validate_transaction::check_consensus(check.prevout_script,
+        *check.context, check.input_index, check.flags);
+}
+
+void script_verifier::drain(batch& work)
+{
+    while (!work.failed)
+    {
+        const auto index = work.next++;
+        if (index >= work.size)
+            break;
+
+        const auto valid = verify(work.checks[index]);
+        work.outcomes[index] = valid ? result::valid : result::invalid;
+
+        if (!valid)
+            work.failed = true;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::unique_lock<std::mutex> lock(work.mutex);
+        ++work.done;
+        lock.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        work.finished.notify_one();
+    }
+}
+
+script_verifier::results script_verifier::verify(const check::list& checks)
+{
+    if (checks.empty())
+        return{};
+
+    const auto work = std::make_shared<batch>(checks);
+
+    // The caller is one of the workers, so one check needs no helper.
+    const auto helpers = stopped_ ? 0 : std::min(helpers_, checks.size() - 1);
+
+    for (size_t helper = 0; helper < helpers; ++helper)
+        scheduler_.post(scheduler::lane::consensus, [work]() { drain(*work); });
+
+    drain(*work);
+
+    // Close the cursor so that late helpers cannot claim, then wait for the
+    // claims still in flight on other threads.
+    const auto claimed = std::min(work->next.exchange(work->size), work->size);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(work->mutex);
+    work->finished.wait(lock, [&work, claimed]()
+    {
+        return work->done == claimed;
+    });
+    ///////////////////////////////////////////////////////////////////////////
+
+    return work->outcomes;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -31,8 +31,13 @@ using namespace boost::filesystem;
 
 settings::settings()
   : block_pool_capacity(5000),
+    block_pool_megabytes(256),
+    coin_cache_megabytes(128),
+    utxo_view_megabytes(32),
     transaction_pool_capacity(4096),
     transaction_pool_consistency(false),
+    transaction_pool_backlog(4096),
+    verify_threads(0),
     use_testnet_rules(false)
 {
 }
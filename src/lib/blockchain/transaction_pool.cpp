@@ -38,15 +38,30 @@ using namespace chain;
 using namespace wallet;
 using namespace std::placeholders;
 
-transaction_pool::transaction_pool(threadpool& pool, block_chain& chain,
-    const settings& settings)
+static auto& pool_transactions = metrics::get_gauge(
+    "mvs_txpool_transactions", "Transactions in the memory pool.");
+static auto& pool_validating = metrics::get_gauge(
+    "mvs_txpool_validating", "Transactions being validated.");
+static auto& pool_backlog = metrics::get_gauge(
+    "mvs_txpool_backlog", "Transactions waiting for validation.");
+static auto& pool_stored = metrics::get_counter(
+    "mvs_txpool_stored_total", "Transactions added to the memory pool.");
+static auto& pool_rejected = metrics::get_counter(
+    "mvs_txpool_rejected_total", "Transactions refused by the memory pool.");
+
+transaction_pool::transaction_pool(threadpool& pool, scheduler& scheduler,
+    block_chain& chain, const settings& settings)
   : stopped_(true),
+    revision_(0),
     maintain_consistency_(settings.transaction_pool_consistency),
     buffer_(settings.transaction_pool_capacity),
+    validating_(0),
     dispatch_(pool, NAME),
     blockchain_(chain),
     index_(pool, chain),
-    subscriber_(std::make_shared<transaction_subscriber>(pool, NAME))
+    subscriber_(std::make_shared<transaction_subscriber>(pool, NAME)),
+    backlog_limit_(settings.transaction_pool_backlog),
+    scheduler_(scheduler)
 {
 }
 
@@ -95,6 +110,20 @@ void transaction_pool::inventory(message::inventory::ptr inventory)
 
 void transaction_pool::validate(transaction_ptr tx, validate_handler handler)
 {
+    // The span covers the queueing as well as the validation stages.
+    if (tracer::enabled())
+    {
+        const auto start = asio::steady_clock::now();
+        const auto validated = handler;
+        handler = [start, validated](const code& ec, transaction_ptr tx,
+            const indexes& unconfirmed)
+        {
+            tracer::record("transaction_pool.validate", "transaction", start,
+                encode_hash(tx->hash()));
+            validated(ec, tx, unconfirmed);
+        };
+    }
+
     dispatch_.ordered(&transaction_pool::do_validate,
         this, tx, handler);
 }
@@ -108,17 +137,69 @@ void transaction_pool::do_validate(transaction_ptr tx,
         return;
     }
 
+    if (validating_ < validate_limit())
+    {
+        begin_validate(tx, handler);
+        return;
+    }
+
+    // Push back on the senders once the backlog is full.
+    if (backlog_.size() >= backlog_limit_)
+    {
+        log::debug(LOG_BLOCKCHAIN)
+            << "Transaction validation backlog full (" << backlog_.size()
+            << "), dropping [" << encode_hash(tx->hash()) << "]";
+        handler(error::pool_filled, tx, {});
+        return;
+    }
+
+    backlog_.push_back({ tx, handler });
+    pool_backlog.set(backlog_.size());
+}
+
+void transaction_pool::begin_validate(transaction_ptr tx,
+    validate_handler handler)
+{
+    pool_validating.set(++validating_);
     const auto validate = std::make_shared<validate_transaction>(
-        blockchain_, *tx, *this, dispatch_);
+        blockchain_, *tx, *this, dispatch_, scheduler_);
 
     validate->start(
         dispatch_.ordered_delegate(&transaction_pool::handle_validated,
             this, _1, _2, _3, handler));
 }
 
+// Give the slot of a finished validation to the oldest waiting transaction.
+void transaction_pool::next_validate()
+{
+    BITCOIN_ASSERT(validating_ > 0);
+    pool_validating.set(--validating_);
+
+    while (!backlog_.empty() && validating_ < validate_limit())
+    {
+        const auto next = backlog_.front();
+        backlog_.pop_front();
+        pool_backlog.set(backlog_.size());
+
+        if (stopped())
+            next.handler(error::service_stopped, next.tx, {});
+        else
+            begin_validate(next.tx, next.handler);
+    }
+}
+
+// Enough transactions to keep every scheduler thread busy while the others
+// wait for the pool dispatcher.
+size_t transaction_pool::validate_limit() const
+{
+    return 2 * std::max(scheduler_.threads(), size_t(1));
+}
+
 void transaction_pool::handle_validated(const code& ec, transaction_ptr tx,
     const indexes& unconfirmed, validate_handler handler)
 {
+    next_validate();
+
     if (stopped())
     {
         handler(error::service_stopped, tx, {});
@@ -139,9 +220,19 @@ void transaction_pool::handle_validated(const code& ec, transaction_ptr tx,
         return;
     }
 
-    // Recheck the memory pool, as a duplicate may have been added.
+    // Recheck the memory pool, as transactions validate concurrently a
+    // duplicate or a conflicting spend may have been added.
     if (is_in_pool(tx->hash()))
+    {
         handler(error::duplicate, tx, {});
+        return;
+    }
+
+    if (is_spent_in_pool(tx))
+    {
+        handler(error::double_spend, tx, {});
+        return;
+    }
 
     for(auto& output : tx->outputs){
         if(output.is_asset_issue()
@@ -174,12 +265,19 @@ void transaction_pool::do_store(const code& ec, transaction_ptr tx,
     const indexes& unconfirmed, confirm_handler handle_confirm,
     validate_handler handle_validate)
 {
+    trace_span span("transaction_pool.store", "transaction");
+    if (span)
+        span.set_detail(encode_hash(tx->hash()));
+
     if (ec)
     {
+        pool_rejected.increment();
         handle_validate(ec, tx, {});
         return;
     }
 
+    pool_stored.increment();
+
     // Set up deindexing to run after transaction pool removal.
     const auto do_deindex = [this, handle_confirm](const code ec,
         transaction_ptr tx)
@@ -250,7 +348,9 @@ void transaction_pool::delete_tx(const hash_digest& tx_hash)
             if(item->tx->hash() == tx_hash)
             {
                 log::debug(LOG_BLOCKCHAIN) << " delete_tx hash:" << libbitcoin::encode_hash(tx_hash) << " success";
+                const auto tx = item->tx;
                 buffer_.erase(item);
+                changed(*tx, false);
                 break;
             }
         }
@@ -281,6 +381,29 @@ void transaction_pool::fetch(const hash_digest& transaction_hash,
     dispatch_.ordered(tx_fetcher);
 }
 
+void transaction_pool::fetch_view(const hash_digest& transaction_hash,
+    fetch_view_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto view_fetcher = [this, transaction_hash, handler]()
+    {
+        const auto it = find(transaction_hash);
+
+        if (it == buffer_.end())
+            handler(error::not_found, {});
+        else
+            handler(error::success,
+                chain::transaction_view::factory_from_transaction(*it->tx));
+    };
+
+    dispatch_.ordered(view_fetcher);
+}
+
 void transaction_pool::fetch_history(const payment_address& address,
     size_t limit, size_t from_height,
     block_chain::history_fetch_handler handler)
@@ -385,6 +508,16 @@ void transaction_pool::subscribe_transaction(
     subscriber_->subscribe(handle_transaction, error::service_stopped, {}, {});
 }
 
+uint64_t transaction_pool::revision() const
+{
+    return revision_;
+}
+
+void transaction_pool::set_change_handler(change_handler handler)
+{
+    handle_change_ = handler;
+}
+
 void transaction_pool::notify_transaction(const point::indexes& unconfirmed,
     transaction_ptr tx)
 {
@@ -401,16 +534,41 @@ void transaction_pool::add(transaction_ptr tx, confirm_handler handler)
     if (maintain_consistency_ && buffer_.size() == buffer_.capacity())
         delete_package(error::pool_filled);
 
+    // Otherwise the push overwrites the oldest.
+    if (buffer_.full() && !buffer_.empty())
+        changed(*buffer_.front().tx, false);
+
     buffer_.push_back({ tx, handler });
+    changed(*tx, true);
+}
+
+void transaction_pool::changed()
+{
+    ++revision_;
+    pool_transactions.set(buffer_.size());
+}
+
+void transaction_pool::changed(const transaction& tx, bool entered)
+{
+    if (handle_change_)
+        handle_change_(tx, entered);
+
+    changed();
 }
 
 // There has been a reorg, clear the memory pool using the given reason code.
 void transaction_pool::clear(const code& ec)
 {
     for (const auto& entry: buffer_)
+    {
         entry.handle_confirm(ec, entry.tx);
 
+        if (handle_change_)
+            handle_change_(*entry.tx, false);
+    }
+
     buffer_.clear();
+    changed();
 }
 
 // Delete memory pool txs that are obsoleted by a new block acceptance.
@@ -528,8 +686,10 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
     if (it == buffer_.end())
         return false;
 
-    it->handle_confirm(ec, it->tx);
+    auto tx = it->tx;
+    it->handle_confirm(ec, tx);
     buffer_.erase(it);
+    changed(*tx, false);
 
     while(1){
         const auto it = std::find_if(buffer_.begin(), buffer_.end(), matched);
@@ -537,8 +697,10 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
         if (it == buffer_.end())
             break;
 
-        it->handle_confirm(ec, it->tx);
+        tx = it->tx;
+        it->handle_confirm(ec, tx);
         buffer_.erase(it);
+        changed(*tx, false);
     }
 
     return true;
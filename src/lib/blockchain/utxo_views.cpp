@@ -0,0 +1,388 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/utxo_views.hpp>
+
+#include <utility>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::chain;
+using namespace bc::wallet;
+
+static auto& view_bytes = metrics::get_gauge(
+    "mvs_utxo_views_bytes", "Estimated heap held by the utxo views.");
+static auto& view_hits = metrics::get_counter(
+    "mvs_utxo_views_lookups_total", "Utxo view lookups by result.",
+    "result=\"hit\"");
+static auto& view_misses = metrics::get_counter(
+    "mvs_utxo_views_lookups_total", "Utxo view lookups by result.",
+    "result=\"miss\"");
+
+utxo_views::utxo_views(database::data_base& database, uint64_t capacity_bytes)
+  : database_(database),
+    capacity_(capacity_bytes),
+    bytes_(0),
+    revision_(0)
+{
+}
+
+// Queries.
+// ----------------------------------------------------------------------------
+
+void utxo_views::get(const std::string& address, coin_reader read_coins,
+    coin_list& out_coins)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    if (select(address, out_coins))
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        view_hits.increment();
+        return;
+    }
+
+    const auto revision = revision_;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    view_misses.increment();
+    const auto coins = read_coins(address);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    // A change applied while reading may be missing from the coins read,
+    // they are then used once and read again on the next query.
+    if (capacity_ != 0 && revision_ == revision)
+    {
+        store(address, coins);
+        select(address, out_coins);
+        evict();
+    }
+    else
+    {
+        select(coins, out_coins);
+    }
+
+    view_bytes.set(bytes_);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void utxo_views::clear()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    ++revision_;
+    addresses_.clear();
+    recent_.clear();
+    owners_.clear();
+    bytes_ = 0;
+    view_bytes.set(0);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Chain updates.
+// ----------------------------------------------------------------------------
+
+void utxo_views::connect(const block& block, uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    ++revision_;
+
+    for (const auto& tx: block.transactions)
+    {
+        const auto coinbase = tx.is_coinbase();
+
+        if (!coinbase)
+            for (const auto& input: tx.inputs)
+                remove(input.previous_output, false);
+
+        // The confirmed output replaces its pool counterpart.
+        const auto tx_hash = tx.hash();
+        for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        {
+            std::string address;
+            if (to_address(tx.outputs[index], address))
+                add(address, { { tx_hash, index }, tx.outputs[index], height,
+                    coinbase });
+        }
+    }
+
+    evict();
+    view_bytes.set(bytes_);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void utxo_views::disconnect(const block& block, uint64_t height)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    ++revision_;
+
+    // The block is no longer stored, outputs it spent from itself are found
+    // among its own transactions.
+    std::unordered_map<hash_digest, const transaction*> own;
+    for (const auto& tx: block.transactions)
+        own[tx.hash()] = &tx;
+
+    const auto restore = [this, &own, height](const output_point& point)
+    {
+        output prevout;
+        auto prevout_height = height;
+        auto coinbase = false;
+
+        const auto it = own.find(point.hash);
+        if (it != own.end())
+        {
+            if (point.index >= it->second->outputs.size())
+                return;
+
+            prevout = it->second->outputs[point.index];
+            coinbase = it->second->is_coinbase();
+        }
+        else
+        {
+            const auto result = database_.transactions.get(point.hash);
+            if (!result)
+                return;
+
+            const auto view = result.view();
+            if (!view.is_valid() || point.index >= view.outputs_size())
+                return;
+
+            prevout = view.output(point.index);
+            prevout_height = result.height();
+            coinbase = view.is_coinbase();
+        }
+
+        std::string address;
+        if (to_address(prevout, address))
+            add(address, { point, prevout, prevout_height, coinbase });
+    };
+
+    for (auto tx = block.transactions.rbegin();
+        tx != block.transactions.rend(); ++tx)
+    {
+        const auto tx_hash = tx->hash();
+        for (uint32_t index = 0; index < tx->outputs.size(); ++index)
+            remove({ tx_hash, index }, false);
+
+        if (!tx->is_coinbase())
+            for (const auto& input: tx->inputs)
+                restore(input.previous_output);
+    }
+
+    evict();
+    view_bytes.set(bytes_);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Pool updates, these are called on the pool dispatcher.
+// ----------------------------------------------------------------------------
+
+void utxo_views::add_pool(const transaction& tx)
+{
+    const auto tx_hash = tx.hash();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    ++revision_;
+
+    // Spends are kept for any point, the address of the coin may be read
+    // while the transaction is still pending.
+    for (const auto& input: tx.inputs)
+        pool_spends_[input.previous_output] = tx_hash;
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+    {
+        std::string address;
+        if (to_address(tx.outputs[index], address))
+            add(address, { { tx_hash, index }, tx.outputs[index], 0, false });
+    }
+
+    evict();
+    view_bytes.set(bytes_);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void utxo_views::remove_pool(const transaction& tx)
+{
+    const auto tx_hash = tx.hash();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    ++revision_;
+
+    for (const auto& input: tx.inputs)
+    {
+        const auto spend = pool_spends_.find(input.previous_output);
+        if (spend != pool_spends_.end() && spend->second == tx_hash)
+            pool_spends_.erase(spend);
+    }
+
+    // Outputs confirmed by a connected block are kept.
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+        remove({ tx_hash, index }, true);
+
+    view_bytes.set(bytes_);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Address state, these are called under the mutex.
+// ----------------------------------------------------------------------------
+
+bool utxo_views::select(const std::string& address, coin_list& out_coins)
+{
+    const auto it = addresses_.find(address);
+    if (it == addresses_.end())
+        return false;
+
+    recent_.splice(recent_.begin(), recent_, it->second.recent);
+
+    for (const auto& entry: it->second.coins)
+        if (pool_spends_.count(entry.first) == 0)
+            out_coins.push_back(entry.second);
+
+    return true;
+}
+
+void utxo_views::select(const coin_list& coins, coin_list& out_coins) const
+{
+    for (const auto& coin: coins)
+        if (pool_spends_.count(coin.point) == 0)
+            out_coins.push_back(coin);
+}
+
+void utxo_views::store(const std::string& address, const coin_list& coins)
+{
+    if (addresses_.count(address) != 0)
+        return;
+
+    recent_.push_front(address);
+    addresses_[address] = { {}, 0, recent_.begin() };
+
+    for (const auto& coin: coins)
+        add(address, coin);
+}
+
+void utxo_views::add(const std::string& address, const coin& coin)
+{
+    const auto it = addresses_.find(address);
+    if (it == addresses_.end())
+        return;
+
+    auto& state = it->second;
+    const auto existing = state.coins.find(coin.point);
+    if (existing != state.coins.end())
+    {
+        const auto bytes = footprint(existing->second, address);
+        state.bytes -= bytes;
+        bytes_ -= bytes;
+        existing->second = coin;
+    }
+    else
+    {
+        state.coins.emplace(coin.point, coin);
+        owners_[coin.point] = address;
+    }
+
+    const auto bytes = footprint(coin, address);
+    state.bytes += bytes;
+    bytes_ += bytes;
+}
+
+void utxo_views::remove(const output_point& point, bool pool_only)
+{
+    const auto owner = owners_.find(point);
+    if (owner == owners_.end())
+        return;
+
+    auto& state = addresses_[owner->second];
+    const auto it = state.coins.find(point);
+    if (it != state.coins.end())
+    {
+        if (pool_only && it->second.height != 0)
+            return;
+
+        const auto bytes = footprint(it->second, owner->second);
+        state.bytes -= bytes;
+        bytes_ -= bytes;
+        state.coins.erase(it);
+    }
+
+    owners_.erase(owner);
+}
+
+void utxo_views::evict()
+{
+    // Drop the least recently queried addresses.
+    while (bytes_ > capacity_ && !recent_.empty())
+    {
+        const auto it = addresses_.find(recent_.back());
+        for (const auto& entry: it->second.coins)
+            owners_.erase(entry.first);
+
+        bytes_ -= it->second.bytes;
+        addresses_.erase(it);
+        recent_.pop_back();
+    }
+}
+
+// Utilities.
+// ----------------------------------------------------------------------------
+
+bool utxo_views::to_address(const output& output, std::string& out_address)
+{
+    const auto address = payment_address::extract(output.script);
+    if (!address)
+        return false;
+
+    out_address = address.encoded();
+    return true;
+}
+
+// An estimate of the heap the coin holds, including its map nodes.
+uint64_t utxo_views::footprint(const coin& coin, const std::string& address)
+{
+    return sizeof(coin_map::value_type) + sizeof(output_point) +
+        address.size() + 4 * sizeof(void*) + coin.output.serialized_size();
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
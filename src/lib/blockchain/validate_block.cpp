@@ -25,6 +25,7 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <system_error>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
@@ -456,7 +457,8 @@ bool validate_block::is_valid_coinbase_height(size_t height, const block& block)
     return std::equal(expected.begin(), expected.end(), actual.begin());
 }
 
-code validate_block::connect_block(hash_digest& err_tx) const
+code validate_block::connect_block(hash_digest& err_tx,
+    script_verifier& verifier) const
 {
     err_tx = null_hash;
     const auto& transactions = current_block_.transactions;
@@ -479,6 +481,7 @@ code validate_block::connect_block(hash_digest& err_tx) const
 
     uint64_t fees = 0;
     size_t total_sigops = 0;
+    script_verifier::check::list checks;
     const auto count = transactions.size();
     size_t coinage_reward_coinbase_index = 1;
     size_t get_coinage_reward_tx_count = 0;
@@ -513,7 +516,7 @@ code validate_block::connect_block(hash_digest& err_tx) const
         RETURN_IF_STOPPED();
 
         // Consensus checks here.
-        if (!validate_inputs(tx, tx_index, value_in, total_sigops))
+        if (!validate_inputs(tx, tx_index, value_in, total_sigops, checks))
         {
             err_tx = tx.hash();
             return error::validate_inputs_failed;
@@ -534,6 +537,23 @@ code validate_block::connect_block(hash_digest& err_tx) const
 
     RETURN_IF_STOPPED();
 
+    // Scripts are verified last, as a batch, since they dominate the cost.
+    const auto results = verifier.verify(checks);
+
+    for (size_t check = 0; check < results.size(); ++check)
+    {
+        if (results[check] != script_verifier::result::invalid)
+            continue;
+
+        const auto& failed = checks[check];
+        err_tx = failed.context->transaction().hash();
+        log::warning(LOG_BLOCKCHAIN) << "Invalid input ["
+            << encode_hash(err_tx) << ":" << failed.input_index << "]";
+        return error::validate_inputs_failed;
+    }
+
+    RETURN_IF_STOPPED();
+
     const auto& coinbase = transactions.front();
     const auto reward = coinbase.total_output_value();
     const auto value = consensus::miner::calculate_block_subsidy(height_, testnet_) + fees;
@@ -561,14 +581,18 @@ bool validate_block::is_spent_duplicate(const transaction& tx) const
 }
 
 bool validate_block::validate_inputs(const transaction& tx,
-    size_t index_in_parent, uint64_t& value_in, size_t& total_sigops) const
+    size_t index_in_parent, uint64_t& value_in, size_t& total_sigops,
+    script_verifier::check::list& checks) const
 {
     BITCOIN_ASSERT(!tx.is_coinbase());
 
-    ////////////// TODO: parallelize. //////////////
+    // Serialization and signature hashing state is shared by all inputs,
+    // and outlives this call in the deferred script checks.
+    const auto context = std::make_shared<const chain::sighash_context>(tx);
+
     for (size_t input_index = 0; input_index < tx.inputs.size(); ++input_index)
-        if (!connect_input(index_in_parent, tx, input_index, value_in,
-            total_sigops))
+        if (!connect_input(index_in_parent, context, input_index, value_in,
+            total_sigops, checks))
         {
             log::warning(LOG_BLOCKCHAIN) << "Invalid input ["
                 << encode_hash(tx.hash()) << ":"
@@ -604,28 +628,52 @@ bool validate_block::script_hash_signature_operations_count(size_t& out_count,
 }
 
 bool validate_block::connect_input(size_t index_in_parent,
-    const transaction& current_tx, size_t input_index, uint64_t& value_in,
-    size_t& total_sigops) const
+    const script_verifier::check::context_ptr& context, size_t input_index,
+    uint64_t& value_in, size_t& total_sigops,
+    script_verifier::check::list& checks) const
 {
+    const auto& current_tx = context->transaction();
     BITCOIN_ASSERT(input_index < current_tx.inputs.size());
 
     // Lookup previous output
-    size_t previous_height;
-    transaction previous_tx;
+    coin_cache::coin coin;
     const auto& input = current_tx.inputs[input_index];
     const auto& previous_output = input.previous_output;
 
-    // This searches the blockchain and then the orphan pool up to and
-    // including the current (orphan) block and excluding blocks above fork.
-    if (!fetch_transaction(previous_tx, previous_height, previous_output.hash))
+    // A cached coin is unspent in the chain, only the orphans may spend it.
+    const auto cached = fetch_cached_coin(coin, previous_output);
+
+    if (!cached)
     {
-        log::warning(LOG_BLOCKCHAIN)
-            << "Failure fetching input transaction ["
-            << encode_hash(previous_output.hash) << "]";
-        return false;
+        size_t previous_height;
+        transaction previous_tx;
+
+        // This searches the blockchain and then the orphan pool up to and
+        // including the current (orphan) block and excluding blocks above fork.
+        if (!fetch_transaction(previous_tx, previous_height,
+            previous_output.hash))
+        {
+            log::warning(LOG_BLOCKCHAIN)
+                << "Failure fetching input transaction ["
+                << encode_hash(previous_output.hash) << "]";
+            return false;
+        }
+
+        if (previous_output.index >= previous_tx.outputs.size())
+        {
+            log::warning(LOG_BLOCKCHAIN)
+                << "Missing input output ["
+                << encode_hash(previous_output.hash) << "]";
+            return false;
+        }
+
+        coin.output = previous_tx.outputs[previous_output.index];
+        coin.height = previous_height;
+        coin.coinbase = previous_tx.is_coinbase();
     }
 
-    const auto& previous_tx_out = previous_tx.outputs[previous_output.index];
+    const auto& previous_tx_out = coin.output;
+    const auto previous_height = coin.height;
 
     // Signature operations count if script_hash payment type.
     size_t count;
@@ -652,7 +700,7 @@ bool validate_block::connect_input(size_t index_in_parent,
     }
 
     // Check coinbase maturity has been reached
-    if (previous_tx.is_coinbase())
+    if (coin.coinbase)
     {
         BITCOIN_ASSERT(previous_height <= height_);
         const auto height_difference = height_ - previous_height;
@@ -663,15 +711,13 @@ bool validate_block::connect_input(size_t index_in_parent,
         }
     }
 
-    if (!validate_transaction::check_consensus(previous_tx_out.script,
-        current_tx, input_index, activations_))
-    {
-        log::warning(LOG_BLOCKCHAIN) << "Input script invalid consensus.";
-        return false;
-    }
+    // Defer the script (and so signature) check to the block's batch.
+    checks.push_back({ context, previous_tx_out.script,
+        static_cast<uint32_t>(input_index), activations_ });
 
     // Search for double spends.
-    if (is_output_spent(previous_output, index_in_parent, input_index))
+    if (cached ? orphan_is_spent(previous_output, index_in_parent, input_index) :
+        is_output_spent(previous_output, index_in_parent, input_index))
     {
         log::warning(LOG_BLOCKCHAIN) << "Double spend attempt.";
         return false;
@@ -172,6 +172,15 @@ bool validate_block_impl::fetch_transaction(chain::transaction& tx,
     return true;
 }
 
+// The cache follows the stored chain, its coins are unspent up to the fork
+// point if created at or below it.
+bool validate_block_impl::fetch_cached_coin(coin_cache::coin& out_coin,
+    const chain::output_point& outpoint) const
+{
+    return chain_.get_cached_coin(out_coin, outpoint) &&
+        out_coin.height <= fork_index_;
+}
+
 bool validate_block_impl::fetch_orphan_transaction(chain::transaction& tx,
     size_t& tx_height, const hash_digest& tx_hash) const
 {
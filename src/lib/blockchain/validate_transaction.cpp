@@ -21,6 +21,7 @@
 #include <metaverse/blockchain/validate_transaction.hpp>
 #include <metaverse/bitcoin/chain/script/operation.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -45,21 +46,24 @@ using namespace std::placeholders;
 static constexpr uint32_t max_transaction_size = 1000000;
 
 validate_transaction::validate_transaction(block_chain& chain,
-    transaction_ptr tx, const transaction_pool& pool,
-    dispatcher& dispatch)
+    transaction_ptr tx, const transaction_pool& pool, dispatcher& dispatch,
+    scheduler& scheduler)
   : blockchain_(chain),
     tx_(tx),
+    sighash_(*tx),
     pool_(pool),
     dispatch_(dispatch),
+    scheduler_(scheduler),
     tx_hash_(tx->hash())
 {
 }
 
 validate_transaction::validate_transaction(block_chain& chain,
     const chain::transaction& tx, const transaction_pool& pool,
-    dispatcher& dispatch)
+    dispatcher& dispatch, scheduler& scheduler)
   : validate_transaction(chain,
-        std::make_shared<message::transaction_message>(tx), pool, dispatch)
+        std::make_shared<message::transaction_message>(tx), pool, dispatch,
+        scheduler)
 {
 }
 
@@ -79,14 +83,17 @@ void validate_transaction::start(validate_handler handler)
         return;
     }
 
-    ///////////////////////////////////////////////////////////////////////////
-    // TODO: change to fetch_unspent_transaction, spent dups ok (BIP30).
-    ///////////////////////////////////////////////////////////////////////////
-    // Check for duplicates in the blockchain.
-    blockchain_.fetch_transaction(tx_hash_,
-        dispatch_.unordered_delegate(
-            &validate_transaction::handle_duplicate_check,
-                shared_from_this(), _1));
+    // TODO: we may want to allow spent-in-pool (RBF).
+    if (pool_.is_spent_in_pool(tx_))
+    {
+        handle_validate_(error::double_spend, tx_, {});
+        return;
+    }
+
+    // The reads wait out block writes, their lane is bounded and cannot take
+    // the worker kept for consensus.
+    scheduler_.post(scheduler::lane::storage,
+        std::bind(&validate_transaction::lookup, shared_from_this()));
 }
 
 code validate_transaction::basic_checks(blockchain::block_chain_impl& chain) const
@@ -118,6 +125,27 @@ bool validate_transaction::is_standard() const
     return true;
 }
 
+// Chain lookup stage.
+// ----------------------------------------------------------------------------
+// The chain handlers are bound, so the reads don't leave the lookup thread.
+
+void validate_transaction::lookup()
+{
+    // The chain reads complete on this thread.
+    trace_span span("validate_transaction.lookup", "transaction");
+    if (span)
+        span.set_detail(encode_hash(tx_hash_));
+
+    ///////////////////////////////////////////////////////////////////////////
+    // TODO: change to fetch_unspent_transaction, spent dups ok (BIP30).
+    ///////////////////////////////////////////////////////////////////////////
+    // Check for duplicates in the blockchain.
+    blockchain_.fetch_transaction(tx_hash_,
+        dispatcher::bound_delegate(
+            &validate_transaction::handle_duplicate_check,
+                shared_from_this(), _1));
+}
+
 void validate_transaction::handle_duplicate_check(
     const code& ec)
 {
@@ -130,16 +158,9 @@ void validate_transaction::handle_duplicate_check(
         return;
     }
 
-    // TODO: we may want to allow spent-in-pool (RBF).
-    if (pool_.is_spent_in_pool(tx_))
-    {
-        handle_validate_(error::double_spend, tx_, {});
-        return;
-    }
-
     // Check inputs, we already know it is not a coinbase tx.
     blockchain_.fetch_last_height(
-        dispatch_.unordered_delegate(&validate_transaction::set_last_height,
+        dispatcher::bound_delegate(&validate_transaction::set_last_height,
             shared_from_this(), _1, _2));
 }
 
@@ -154,113 +175,123 @@ void validate_transaction::set_last_height(const code& ec,
 
     // Used for checking coinbase maturity
     last_block_height_ = last_height;
-    current_input_ = 0;
-    value_in_ = 0;
-	asset_amount_in_ = 0;
-	old_symbol_in_ = "";
-	new_symbol_in_ = "";
-	business_tp_in_ = 0;
-
-    // Begin looping through the inputs, fetching the previous tx.
-    if (!tx_->inputs.empty())
-        next_previous_transaction();
-}
 
-void validate_transaction::next_previous_transaction()
-{
-    BITCOIN_ASSERT(current_input_ < tx_->inputs.size());
-
-    // First we fetch the parent block height for a transaction.
-    // Needed for checking the coinbase maturity.
-    blockchain_.fetch_transaction_index(
-        tx_->inputs[current_input_].previous_output.hash,
-            dispatch_.unordered_delegate(
-                &validate_transaction::previous_tx_index,
-                    shared_from_this(), _1, _2));
+    // Fetch every previous transaction in one read.
+    blockchain_.fetch_prevouts(*tx_,
+        dispatcher::bound_delegate(&validate_transaction::handle_prevouts,
+            shared_from_this(), _1, _2));
 }
 
-void validate_transaction::previous_tx_index(const code& ec,
-    size_t parent_height)
+void validate_transaction::handle_prevouts(const code& ec,
+    const block_chain::prevout_list& prevouts)
 {
     if (ec)
     {
-        search_pool_previous_tx();
+        handle_validate_(ec, tx_, {});
         return;
     }
 
-    BITCOIN_ASSERT(current_input_ < tx_->inputs.size());
-    const auto& prev_tx_hash = tx_->inputs[current_input_].previous_output.hash;
-    
-    // Now fetch actual transaction body
-    blockchain_.fetch_transaction(prev_tx_hash,
-        dispatch_.unordered_delegate(&validate_transaction::handle_previous_tx,
-            shared_from_this(), _1, _2, parent_height));
-}
+    BITCOIN_ASSERT(prevouts.size() == tx_->inputs.size());
+    prevouts_ = prevouts;
 
-void validate_transaction::search_pool_previous_tx()
-{
-    transaction previous_tx;
-    const auto& current_input = tx_->inputs[current_input_];
+    const auto found = [](const block_chain::prevout& prevout)
+    {
+        return prevout.found;
+    };
 
-    if (!pool_.find(previous_tx, current_input.previous_output.hash))
+    if (std::all_of(prevouts_.begin(), prevouts_.end(), found))
     {
-        const auto list = point::indexes{ current_input_ };
-        handle_validate_(error::input_not_found, tx_, list);
+        scheduler_.post(scheduler::lane::network,
+            std::bind(&validate_transaction::connect_inputs,
+                shared_from_this()));
         return;
     }
 
-    // parent_height ignored here as mempool transactions cannot be coinbase.
-    BITCOIN_ASSERT(!previous_tx.is_coinbase());
-    static constexpr size_t parent_height = 0;
-    handle_previous_tx(error::success, previous_tx, parent_height);
-    unconfirmed_.push_back(current_input_);
+    // The pool is protected by its dispatcher.
+    dispatch_.ordered(&validate_transaction::search_pool_prevouts,
+        shared_from_this());
 }
 
-void validate_transaction::handle_previous_tx(const code& ec,
-    const transaction& previous_tx, size_t parent_height)
+// Pool stage.
+// ----------------------------------------------------------------------------
+
+void validate_transaction::search_pool_prevouts()
 {
-    if (ec)
+    for (current_input_ = 0; current_input_ < prevouts_.size();
+        ++current_input_)
     {
-        const auto list = point::indexes{ current_input_ };
-        handle_validate_(error::input_not_found, tx_, list);
-        return;
-    }
+        auto& prevout = prevouts_[current_input_];
+        if (prevout.found)
+            continue;
 
-    ///////////////////////////////////////////////////////////////////////////
-    // HACK: this assumes that the mempool is operating at min block version 4.
-    ///////////////////////////////////////////////////////////////////////////
+        transaction previous_tx;
+        const auto& previous_output = tx_->inputs[current_input_].previous_output;
+        if (!pool_.find(previous_tx, previous_output.hash))
+        {
+            const auto list = point::indexes{ current_input_ };
+            handle_validate_(error::input_not_found, tx_, list);
+            return;
+        }
 
-    // Should check if inputs are standard here...
-    if (!connect_input(*tx_, current_input_, previous_tx, parent_height,
-        last_block_height_, value_in_, script_context::all_enabled, asset_amount_in_, old_symbol_in_,
-    new_symbol_in_, business_tp_in_))
-    {
-        const auto list = point::indexes{ current_input_ };
-        handle_validate_(error::validate_inputs_failed, tx_, list);
-        return;
+        if (previous_output.index >= previous_tx.outputs.size())
+        {
+            const auto list = point::indexes{ current_input_ };
+            handle_validate_(error::validate_inputs_failed, tx_, list);
+            return;
+        }
+
+        // The height is ignored as mempool transactions cannot be coinbase.
+        BITCOIN_ASSERT(!previous_tx.is_coinbase());
+        prevout.output = previous_tx.outputs[previous_output.index];
+        prevout.found = true;
+        unconfirmed_.push_back(current_input_);
     }
 
-    // Search for double spends...
-    blockchain_.fetch_spend(tx_->inputs[current_input_].previous_output,
-        dispatch_.unordered_delegate(&validate_transaction::check_double_spend,
-            shared_from_this(), _1, _2));
+    scheduler_.post(scheduler::lane::network,
+        std::bind(&validate_transaction::connect_inputs, shared_from_this()));
 }
 
-void validate_transaction::check_double_spend(const code& ec, 
-    const chain::input_point&)
+// Consensus stage.
+// ----------------------------------------------------------------------------
+
+void validate_transaction::connect_inputs()
 {
-    if (ec != (code)error::unspent_output)
-    {
-        handle_validate_(error::double_spend, tx_, {});
-        return;
-    }
+    trace_span span("validate_transaction.connect_inputs", "transaction");
+    if (span)
+        span.set_detail(encode_hash(tx_hash_));
 
-    // End of connect_input checks.
-    ++current_input_;
-    if (current_input_ < tx_->inputs.size())
+    value_in_ = 0;
+    asset_amount_in_ = 0;
+    old_symbol_in_ = "";
+    new_symbol_in_ = "";
+    business_tp_in_ = 0;
+
+    for (current_input_ = 0; current_input_ < prevouts_.size();
+        ++current_input_)
     {
-        next_previous_transaction();
-        return;
+        const auto& prevout = prevouts_[current_input_];
+
+        ///////////////////////////////////////////////////////////////////////
+        // HACK: this assumes that the mempool is operating at min block version 4.
+        ///////////////////////////////////////////////////////////////////////
+
+        // Should check if inputs are standard here...
+        if (!connect_input(sighash_, current_input_, prevout.output,
+            prevout.coinbase, prevout.height, last_block_height_, value_in_,
+            script_context::all_enabled, asset_amount_in_, old_symbol_in_,
+            new_symbol_in_, business_tp_in_))
+        {
+            const auto list = point::indexes{ current_input_ };
+            handle_validate_(error::validate_inputs_failed, tx_, list);
+            return;
+        }
+
+        // Search for double spends...
+        if (prevout.spent)
+        {
+            handle_validate_(error::double_spend, tx_, {});
+            return;
+        }
     }
 
     // current_input_ will be invalid on last pass.
@@ -403,6 +434,14 @@ code validate_transaction::check_transaction_basic(const transaction& tx, blockc
 bool validate_transaction::check_consensus(const script& prevout_script,
     const transaction& current_tx, size_t input_index, uint32_t flags)
 {
+    const chain::sighash_context context(current_tx);
+    return check_consensus(prevout_script, context, input_index, flags);
+}
+
+bool validate_transaction::check_consensus(const script& prevout_script,
+    const chain::sighash_context& context, size_t input_index, uint32_t flags)
+{
+    const auto& current_tx = context.transaction();
     BITCOIN_ASSERT(input_index <= max_uint32);
     BITCOIN_ASSERT(input_index < current_tx.inputs.size());
     const auto input_index32 = static_cast<uint32_t>(input_index);
@@ -410,7 +449,7 @@ bool validate_transaction::check_consensus(const script& prevout_script,
 #ifdef WITH_CONSENSUS
     using namespace bc::consensus;
     const auto previous_output_script = prevout_script.to_data(false);
-    data_chunk current_transaction = current_tx.to_data();
+    const auto& current_transaction = context.serialized();
 
     // Convert native flags to libbitcoin-consensus flags.
     uint32_t consensus_flags = verify_flags_none;
@@ -435,7 +474,7 @@ bool validate_transaction::check_consensus(const script& prevout_script,
     const auto& current_input_script = current_tx.inputs[input_index].script;
 
     const auto valid = script::verify(current_input_script,
-        previous_output_script, current_tx, input_index32, flags);
+        previous_output_script, context, input_index32, flags);
 #endif
 
     if (!valid)
@@ -446,19 +485,12 @@ bool validate_transaction::check_consensus(const script& prevout_script,
     return valid;
 }
 
-bool validate_transaction::connect_input(const transaction& tx,
-    size_t current_input, const transaction& previous_tx,
+bool validate_transaction::connect_input(const chain::sighash_context& context,
+    size_t current_input, const output& previous_output, bool coinbase,
     size_t parent_height, size_t last_block_height, uint64_t& value_in,
     uint32_t flags, uint64_t& asset_amount_in, std::string& old_symbol_in,
     std::string& new_symbol_in, uint32_t& business_tp_in)
 {
-    const auto& input = tx.inputs[current_input];
-    const auto& previous_outpoint = tx.inputs[current_input].previous_output;
-
-    if (previous_outpoint.index >= previous_tx.outputs.size())
-        return false;
-
-    const auto& previous_output = previous_tx.outputs[previous_outpoint.index];
     const auto output_value = previous_output.value;
 	if (output_value > max_money())
 		return false;
@@ -485,7 +517,7 @@ bool validate_transaction::connect_input(const transaction& tx,
 			business_tp_in = ASSET_TRANSFERABLE_TYPE;
 	}
 
-    if (previous_tx.is_coinbase())
+    if (coinbase)
     {
         const auto height_difference = last_block_height - parent_height;
 
@@ -493,7 +525,8 @@ bool validate_transaction::connect_input(const transaction& tx,
             return false;
     }
 
-    if (!check_consensus(previous_output.script, tx, current_input, flags))
+    if (!check_consensus(previous_output.script, context, current_input,
+        flags))
         return false;
 
     value_in += output_value;
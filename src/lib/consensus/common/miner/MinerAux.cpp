@@ -13,6 +13,7 @@
 #include <metaverse/consensus/libdevcore/Exceptions.h>
 #include <boost/throw_exception.hpp>
 #include <metaverse/bitcoin/utility/log.hpp>
+#include <metaverse/bitcoin/utility/metrics.hpp>
 
 
 using namespace libbitcoin;
@@ -20,6 +21,11 @@ using namespace std;
 
 MinerAux* libbitcoin::MinerAux::s_this = nullptr;
 #define LOG_MINER "etp_hash"
+
+static auto& miner_rate = metrics::get_gauge(
+    "mvs_miner_hashes_per_second", "Hash rate of the last mining round.");
+static auto& miner_hashes = metrics::get_counter(
+    "mvs_miner_hashes_total", "Hashes computed by the miner.");
 MinerAux::~MinerAux()
 {
 }
@@ -99,6 +105,7 @@ bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (voi
 		}
 		if(is_exit() == true)
 		{
+			miner_hashes.increment(hashCount);
 			ethashReturn.success = false;
 			return ethashReturn.success;
 		}
@@ -106,6 +113,8 @@ bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (voi
     ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count();
     ms = ms? ms : 1;
     get()->m_rate = hashCount * 1000 / ms;
+    miner_rate.set(get()->m_rate);
+    miner_hashes.increment(hashCount);
 
 	return ethashReturn.success;
 }
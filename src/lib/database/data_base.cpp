@@ -67,7 +67,7 @@ bool data_base::initialize(const path& prefix, const chain::block& genesis)
     if (!paths.touch_all())
         return false;
 
-    data_base instance(paths, 0, 0);
+    data_base instance(paths, 0, 0, 0);
 
     if (!instance.create()) {
         return false;
@@ -78,6 +78,16 @@ bool data_base::initialize(const path& prefix, const chain::block& genesis)
     instance.push(genesis);
     return instance.stop();
 }
+
+bool data_base::initialize_undo(const path& prefix)
+{
+    const store paths(prefix);
+
+    // Started databases initialize a touched undo file.
+    return exists(paths.block_undos_lookup) ||
+        touch_file(paths.block_undos_lookup);
+}
+
 bool data_base::is_lower_database(const path& prefix)
 {
 	auto metadata_path = prefix / db_metadata::file_name;
@@ -141,6 +151,7 @@ data_base::store::store(const path& prefix)
 {
     // Hash-based lookup (hash tables).
     blocks_lookup = prefix / "block_table";
+    block_undos_lookup = prefix / "block_undo_table";
     history_lookup = prefix / "history_table";
     spends_lookup = prefix / "spend_table";
     transactions_lookup = prefix / "transaction_table";
@@ -172,6 +183,7 @@ bool data_base::store::touch_all() const
     return
         touch_file(blocks_lookup) &&
         touch_file(blocks_index) &&
+        touch_file(block_undos_lookup) &&
         touch_file(history_lookup) &&
         touch_file(history_rows) &&
         touch_file(stealth_rows) &&
@@ -193,6 +205,7 @@ data_base::blockchain_store::blockchain_store(const path& prefix)
 {
     // Hash-based lookup (hash tables).
     blocks_lookup = prefix / "block_table";
+    block_undos_lookup = prefix / "block_undo_table";
     history_lookup = prefix / "history_table";
     spends_lookup = prefix / "spend_table";
     transactions_lookup = prefix / "transaction_table";
@@ -216,6 +229,7 @@ bool data_base::blockchain_store::touch_all() const
     return
         touch_file(blocks_lookup) &&
         touch_file(blocks_index) &&
+        touch_file(block_undos_lookup) &&
         touch_file(history_lookup) &&
         touch_file(history_rows) &&
         touch_file(stealth_rows) &&
@@ -367,24 +381,26 @@ void data_base::uninitialize_lock(const path& lock)
 
 data_base::data_base(const settings& settings)
   : data_base(default_data_path() / settings.directory, settings.history_start_height,
-        settings.stealth_start_height)
+        settings.stealth_start_height, settings.block_undo_depth)
 {
 }
 
 data_base::data_base(const path& prefix, size_t history_height,
-    size_t stealth_height)
-  : data_base(store(prefix), history_height, stealth_height)
+    size_t stealth_height, size_t undo_depth)
+  : data_base(store(prefix), history_height, stealth_height, undo_depth)
 {
 }
 
 data_base::data_base(const store& paths, size_t history_height,
-    size_t stealth_height)
+    size_t stealth_height, size_t undo_depth)
   : lock_file_path_(paths.database_lock),
     history_height_(history_height),
     stealth_height_(stealth_height),
+    undo_depth_(undo_depth),
     sequential_lock_(0),
     mutex_(std::make_shared<shared_mutex>()),
     blocks(paths.blocks_lookup, paths.blocks_index, mutex_),
+    block_undos(paths.block_undos_lookup, mutex_),
     history(paths.history_lookup, paths.history_rows, mutex_),
     stealth(paths.stealth_rows, mutex_),
     spends(paths.spends_lookup, mutex_),
@@ -445,6 +461,7 @@ bool data_base::create()
     // Return the result of the database create.
     return 
         blocks.create() &&
+        block_undos.create() &&
         history.create() &&
         spends.create() &&
         stealth.create() &&
@@ -463,6 +480,7 @@ bool data_base::blockchain_create()
     // Return the result of the database create.
     return 
         blocks.create() &&
+        block_undos.create() &&
         history.create() &&
         spends.create() &&
         stealth.create() &&
@@ -541,6 +559,7 @@ bool data_base::start()
     const auto start_exclusive = begin_write();
     const auto start_result =
         blocks.start() &&
+        block_undos.start() &&
         history.start() &&
         spends.start() &&
         stealth.start() &&
@@ -552,7 +571,7 @@ bool data_base::start()
 		account_assets.start()&&
 		account_addresses.start()
 		/* end database for account, asset, address_asset relationship */
-        ;
+        && compact_undo();
     const auto end_exclusive = end_write();
 
     // Return the result of the database start.
@@ -564,6 +583,7 @@ bool data_base::stop()
 {
     const auto start_exclusive = begin_write();
     const auto blocks_stop = blocks.stop();
+    const auto block_undos_stop = block_undos.stop();
     const auto history_stop = history.stop();
     const auto spends_stop = spends.stop();
     const auto stealth_stop = stealth.stop();
@@ -586,6 +606,7 @@ bool data_base::stop()
     return
         start_exclusive &&
         blocks_stop &&
+        block_undos_stop &&
         history_stop &&
         spends_stop &&
         stealth_stop &&
@@ -604,6 +625,7 @@ bool data_base::stop()
 bool data_base::close()
 {
     const auto blocks_close = blocks.close();
+    const auto block_undos_close = block_undos.close();
     const auto history_close = history.close();
     const auto spends_close = spends.close();
     const auto stealth_close = stealth.close();
@@ -619,6 +641,7 @@ bool data_base::close()
     // Return the cumulative result of the database closes.
     return
         blocks_close &&
+        block_undos_close &&
         history_close &&
         spends_close &&
         stealth_close &&
@@ -697,6 +720,7 @@ void data_base::synchronize()
 	account_assets.sync();
 	account_addresses.sync();
 	/* end database for account, asset, address_asset relationship */
+    block_undos.sync();
     blocks.sync();
 }
 
@@ -708,6 +732,40 @@ void data_base::push(const block& block)
 
 void data_base::push(const block& block, uint64_t height)
 {
+    trace_span span("data_base.push", "block");
+    if (span)
+        span.set_detail(std::to_string(height));
+
+    push_block(block, height);
+
+    // Synchronise everything that was added.
+    synchronize();
+}
+
+void data_base::push(const block::ptr_list& blocks)
+{
+    // Height is unsafe unless database locked.
+    auto height = get_next_height(this->blocks);
+
+    trace_span span("data_base.push", "block");
+    if (span)
+        span.set_detail(std::to_string(height) + " (" +
+            std::to_string(blocks.size()) + " blocks)");
+
+    for (const auto& block: blocks)
+        push_block(*block, height++);
+
+    // Synchronise everything that was added, once for the batch.
+    synchronize();
+}
+
+// Index the block without updating the stored counts.
+void data_base::push_block(const block& block, uint64_t height)
+{
+    // The rows added by this block, local so that concurrent pushes of
+    // different blocks do not share them.
+    block_undo undo;
+
     for (size_t index = 0; index < block.transactions.size(); ++index)
     {
         // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
@@ -721,27 +779,60 @@ void data_base::push(const block& block, uint64_t height)
 		timestamp_ = block.header.timestamp; // for address_asset_database store_input/store_output used only
         // Add inputs
         if (!tx.is_coinbase())
-            push_inputs(tx_hash, height, tx.inputs);
+            push_inputs(tx_hash, height, tx.inputs, undo);
 
         // Add outputs
-        push_outputs(tx_hash, height, tx.outputs);
+        push_outputs(tx_hash, height, tx.outputs, undo);
 
         // Add stealth outputs
         push_stealth(tx_hash, height, tx.outputs);
 
         // Add transaction
         transactions.store(height, index, tx);
+        undo.add_transaction(tx_hash);
     }
 
+    // Add the rows to remove when the block is popped.
+    block_undos.store(block.header.hash(), undo);
+    prune_undo(height);
+
     // Add block itself.
     blocks.store(block, height);
+}
 
-    // Synchronise everything that was added.
-    synchronize();
+// A block this deep is not expected to be popped, if it is its rows are read
+// back out of its scripts. The space is reused once the store is restarted.
+void data_base::prune_undo(uint64_t height)
+{
+    if (undo_depth_ == 0 || height < undo_depth_)
+        return;
+
+    const auto result = blocks.get(height - undo_depth_);
+    if (result)
+        block_undos.remove(result.header().hash());
+}
+
+// Keep the rows of the top blocks only, pruned rows still hold their space.
+bool data_base::compact_undo()
+{
+    size_t top;
+    if (undo_depth_ == 0 || !blocks.top(top))
+        return true;
+
+    hash_list keep;
+    const auto bottom = top < undo_depth_ ? 0 : top - undo_depth_ + 1;
+    for (auto height = bottom; height <= top; ++height)
+    {
+        const auto result = blocks.get(height);
+        if (result)
+            keep.push_back(result.header().hash());
+    }
+
+    return block_undos.compact(keep);
 }
 
 void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
-    const input::list& inputs)
+    const input::list& inputs, block_undo& undo)
 {
     for (uint32_t index = 0; index < inputs.size(); ++index)
     {
@@ -749,6 +840,7 @@ void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
         const auto& input = inputs[index];
         const chain::input_point point{ tx_hash, index };
         spends.store(input.previous_output, point);
+        undo.add_spend(input.previous_output);
 
         if (height < history_height_)
             continue;
@@ -759,20 +851,22 @@ void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
             continue;
 
         const auto& previous = input.previous_output;
-        history.add_input(address.hash(), point, height, previous);
+        const auto address_hash = address.hash();
+        history.add_input(address_hash, point, height, previous);
+        undo.add_history(address_hash);
 
 		/* begin added for asset issue/transfer */
 		auto address_str = address.encoded();
 		data_chunk data(address_str.begin(), address_str.end());
 		short_hash key = ripemd160_hash(data);
 		address_assets.store_input(key, point, height, previous, timestamp_);
-		address_assets.sync();
+		undo.add_address_asset(key);
 		/* end added for asset issue/transfer */
     }
 }
 
 void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
-    const output::list& outputs)
+    const output::list& outputs, block_undo& undo)
 {
     if (height < history_height_)
         return;
@@ -788,7 +882,9 @@ void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
             continue;
 
         const auto value = output.value;
-        history.add_output(address.hash(), point, height, value);
+        const auto address_hash = address.hash();
+        history.add_output(address_hash, point, height, value);
+        undo.add_history(address_hash);
 		
 		/* begin added for asset issue/transfer */
 		// add for coin reward
@@ -800,7 +896,7 @@ void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
 			push_attachemnt(output.attach_data, address, point, height, value);
 		}
 		*/
-		push_attachemnt(output.attach_data, address, point, height, value);
+		push_attachemnt(output.attach_data, address, point, height, value, undo);
 		/* end added for asset issue/transfer */
     }
 }
@@ -873,21 +969,33 @@ chain::block data_base::pop()
         block.transactions.emplace_back(tx_result.transaction());
     }
 
-    // Loop txs backwards, the reverse of how they are added.
-    // Remove txs, then outputs, then inputs (also reverse order).
-    for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
+    const auto block_hash = block.header.hash();
+    block_undo undo;
+
+    if (block_undos.get(block_hash, undo))
+    {
+        pop_undo(undo);
+        block_undos.remove(block_hash);
+    }
+    else
     {
-        transactions.remove(tx->hash());
-        pop_outputs(tx->outputs, height);
+        // Blocks pushed before undo rows were stored.
+        // Loop txs backwards, the reverse of how they are added.
+        // Remove txs, then outputs, then inputs (also reverse order).
+        for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
+        {
+            transactions.remove(tx->hash());
+            pop_outputs(tx->outputs, height);
 
-        if (!tx->is_coinbase())
-            pop_inputs(tx->inputs, height);
+            if (!tx->is_coinbase())
+                pop_inputs(tx->inputs, height);
+        }
     }
 
     // Stealth unlink is not implemented.
     stealth.unlink(height);
     blocks.unlink(height);
-	blocks.remove(block.header.hash()); // wdy remove block from block hash table
+	blocks.remove(block_hash); // wdy remove block from block hash table
 
     // Synchronise everything that was changed.
     synchronize();
@@ -896,6 +1004,34 @@ chain::block data_base::pop()
     return block;
 }
 
+// Remove the rows in the reverse of the order they were added.
+void data_base::pop_undo(const block_undo& undo)
+{
+    const auto rows = undo.rows();
+
+    for (auto row = rows.rbegin(); row != rows.rend(); ++row)
+    {
+        switch (row->kind)
+        {
+            case block_undo::row_kind::transaction:
+                transactions.remove(row->hash);
+                break;
+            case block_undo::row_kind::spend:
+                spends.remove(row->point);
+                break;
+            case block_undo::row_kind::history:
+                history.delete_last_row(row->key);
+                break;
+            case block_undo::row_kind::address_asset:
+                address_assets.delete_last_row(row->key);
+                break;
+            case block_undo::row_kind::asset:
+                assets.remove(row->hash);
+                break;
+        }
+    }
+}
+
 void data_base::pop_inputs(const input::list& inputs, size_t height)
 {
     // Loop in reverse.
@@ -954,15 +1090,17 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
 #include <metaverse/bitcoin/config/base16.hpp>
 using namespace libbitcoin::config;
 void data_base::push_attachemnt(const attachment& attach, const payment_address& address,
-		const output_point& outpoint, uint32_t output_height, uint64_t value)
+		const output_point& outpoint, uint32_t output_height, uint64_t value,
+		block_undo& undo)
 {
 	auto address_str = address.encoded();
 	log::trace(LOG_DATABASE) << "push_attachemnt address_str=" << address_str;
 	log::trace(LOG_DATABASE) << "push_attachemnt address hash=" << base16(address.hash());
 	data_chunk data(address_str.begin(), address_str.end());
 	short_hash hash = ripemd160_hash(data);
-	auto visitor = attachment_visitor(this, hash, outpoint, output_height, value);
+	auto visitor = attachment_visitor(this, hash, outpoint, output_height, value, undo);
 	boost::apply_visitor(visitor, const_cast<attachment&>(attach).get_attach());
+	undo.add_address_asset(hash);
 }
 
 void data_base::push_etp(const etp& etp, const short_hash& key,
@@ -970,7 +1108,6 @@ void data_base::push_etp(const etp& etp, const short_hash& key,
 {
 	address_assets.store_output(key, outpoint, output_height, value, 
 		static_cast<typename std::underlying_type<business_kind>::type>(business_kind::etp), timestamp_, etp);
-	address_assets.sync();
 		
 }
 void data_base::push_etp_award(const etp_award& award, const short_hash& key,
@@ -978,42 +1115,40 @@ void data_base::push_etp_award(const etp_award& award, const short_hash& key,
 {
 	address_assets.store_output(key, outpoint, output_height, value, 
 		static_cast<typename std::underlying_type<business_kind>::type>(business_kind::etp_award), timestamp_, award);
-	address_assets.sync();
 }
 void data_base::push_message(const chain::blockchain_message& msg, const short_hash& key,
 		const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
 	address_assets.store_output(key, outpoint, output_height, value, 
 		static_cast<typename std::underlying_type<business_kind>::type>(business_kind::message), timestamp_, msg);
-	address_assets.sync();
 		
 }
 void data_base::push_asset(const asset& sp, const short_hash& key,
-			const output_point& outpoint, uint32_t output_height, uint64_t value) // sp = smart property
+			const output_point& outpoint, uint32_t output_height, uint64_t value,
+			block_undo& undo) // sp = smart property
 {
-	auto visitor = asset_visitor(this, key, outpoint, output_height, value);
+	auto visitor = asset_visitor(this, key, outpoint, output_height, value, undo);
 	boost::apply_visitor(visitor, const_cast<asset&>(sp).get_data());
 }
 
 void data_base::push_asset_detail(const asset_detail& sp_detail, const short_hash& key,
-			const output_point& outpoint, uint32_t output_height, uint64_t value)
-
+			const output_point& outpoint, uint32_t output_height, uint64_t value,
+			block_undo& undo)
 {
 	const data_chunk& data = data_chunk(sp_detail.get_symbol().begin(), sp_detail.get_symbol().end());
     const auto hash = sha256_hash(data);
 	//assets.store(hash, sp_detail);
 	auto bc_asset = blockchain_asset(0, outpoint,output_height, sp_detail);
 	assets.store(hash, bc_asset);
+	undo.add_asset(hash);
 	address_assets.store_output(key, outpoint, output_height, value, 
 		static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_issue), timestamp_, sp_detail);
-	address_assets.sync();
 }
 void data_base::push_asset_transfer(const asset_transfer& sp_transfer, const short_hash& key,
 			const output_point& outpoint, uint32_t output_height, uint64_t value)
 {
 	address_assets.store_output(key, outpoint, output_height, value, 
 		static_cast<typename std::underlying_type<business_kind>::type>(business_kind::asset_transfer), timestamp_, sp_transfer);
-	address_assets.sync();
 }
 /* end store asset related info into database */
 
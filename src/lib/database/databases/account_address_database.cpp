@@ -163,6 +163,17 @@ void account_address_database::safe_store(const short_hash& key, const account_a
     rows_multimap_.add_row(key, write);
 }
 
+void account_address_database::safe_store(const short_hash& key,
+    const account_address::list& addresses)
+{
+    const auto write = [&addresses](size_t row, memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_data(addresses[row].to_data());
+    };
+    rows_multimap_.add_rows(key, addresses.size(), write);
+}
+
 void account_address_database::delete_last_row(const short_hash& key)
 {
     rows_multimap_.delete_last_row(key);
@@ -0,0 +1,273 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/block_undo_database.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+
+BC_CONSTEXPR size_t number_buckets = 600000;
+BC_CONSTEXPR size_t header_size = slab_hash_table_header_size(number_buckets);
+BC_CONSTEXPR size_t initial_map_file_size = header_size + minimum_slabs_size;
+
+// Undo rows.
+// ----------------------------------------------------------------------------
+
+// Each row is its kind followed by its key.
+void block_undo::clear()
+{
+    data_.clear();
+}
+
+bool block_undo::empty() const
+{
+    return data_.empty();
+}
+
+void block_undo::add_transaction(const hash_digest& tx_hash)
+{
+    data_.push_back(static_cast<uint8_t>(row_kind::transaction));
+    extend_data(data_, tx_hash);
+}
+
+void block_undo::add_spend(const chain::output_point& previous)
+{
+    data_.push_back(static_cast<uint8_t>(row_kind::spend));
+    extend_data(data_, previous.to_data());
+}
+
+void block_undo::add_history(const short_hash& key)
+{
+    data_.push_back(static_cast<uint8_t>(row_kind::history));
+    extend_data(data_, key);
+}
+
+void block_undo::add_address_asset(const short_hash& key)
+{
+    data_.push_back(static_cast<uint8_t>(row_kind::address_asset));
+    extend_data(data_, key);
+}
+
+void block_undo::add_asset(const hash_digest& symbol_hash)
+{
+    data_.push_back(static_cast<uint8_t>(row_kind::asset));
+    extend_data(data_, symbol_hash);
+}
+
+block_undo::list block_undo::rows() const
+{
+    list rows;
+    auto deserial = make_deserializer(data_.begin(), data_.end());
+
+    while (!deserial.is_exhausted())
+    {
+        row next;
+        next.kind = static_cast<row_kind>(deserial.read_byte());
+
+        switch (next.kind)
+        {
+            case row_kind::transaction:
+            case row_kind::asset:
+                next.hash = deserial.read_hash();
+                break;
+            case row_kind::spend:
+                next.point = chain::point::factory_from_data(deserial);
+                break;
+            case row_kind::history:
+            case row_kind::address_asset:
+                next.key = deserial.read_short_hash();
+                break;
+        }
+
+        rows.push_back(next);
+    }
+
+    return rows;
+}
+
+const data_chunk& block_undo::data() const
+{
+    return data_;
+}
+
+void block_undo::set_data(data_chunk&& data)
+{
+    data_ = std::move(data);
+}
+
+// Database.
+// ----------------------------------------------------------------------------
+
+block_undo_database::block_undo_database(const path& map_filename,
+    std::shared_ptr<shared_mutex> mutex)
+  : lookup_file_(map_filename, mutex),
+    lookup_header_(lookup_file_, number_buckets),
+    lookup_manager_(lookup_file_, header_size),
+    lookup_map_(lookup_header_, lookup_manager_)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+block_undo_database::~block_undo_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool block_undo_database::create()
+{
+    // Resize and create require a started file.
+    if (!lookup_file_.start())
+        return false;
+
+    // This will throw if insufficient disk space.
+    lookup_file_.resize(initial_map_file_size);
+
+    if (!lookup_header_.create() ||
+        !lookup_manager_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return
+        lookup_header_.start() &&
+        lookup_manager_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+// Start files and primitives.
+bool block_undo_database::start()
+{
+    if (!lookup_file_.start())
+        return false;
+
+    // The file of a store created before undo rows holds the touch byte only.
+    if (lookup_file_.size() < initial_map_file_size)
+    {
+        lookup_file_.resize(initial_map_file_size);
+
+        if (!lookup_header_.create() ||
+            !lookup_manager_.create())
+            return false;
+    }
+
+    return
+        lookup_header_.start() &&
+        lookup_manager_.start();
+}
+
+// Stop files.
+bool block_undo_database::stop()
+{
+    return lookup_file_.stop();
+}
+
+// Close files.
+bool block_undo_database::close()
+{
+    return lookup_file_.close();
+}
+
+// ----------------------------------------------------------------------------
+
+bool block_undo_database::get(const hash_digest& block_hash,
+    block_undo& out_undo) const
+{
+    const auto memory = lookup_map_.find(block_hash);
+    if (!memory)
+        return false;
+
+    const auto address = REMAP_ADDRESS(memory);
+    auto deserial = make_deserializer_unsafe(address);
+    const auto size = deserial.read_4_bytes_little_endian();
+    out_undo.set_data(deserial.read_data(size));
+    return true;
+}
+
+void block_undo_database::store(const hash_digest& block_hash,
+    const block_undo& undo)
+{
+    const auto& data = undo.data();
+
+    BITCOIN_ASSERT(data.size() <= max_uint32);
+    const auto size32 = static_cast<uint32_t>(data.size());
+    const auto value_size = 4 + data.size();
+
+    auto write = [&size32, &data](memory_ptr memory)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(memory));
+        serial.write_4_bytes_little_endian(size32);
+        serial.write_data(data);
+    };
+    lookup_map_.store(block_hash, write, value_size);
+}
+
+bool block_undo_database::remove(const hash_digest& block_hash)
+{
+    return lookup_map_.unlink(block_hash);
+}
+
+bool block_undo_database::compact(const hash_list& keep)
+{
+    std::vector<std::pair<hash_digest, block_undo>> kept;
+    kept.reserve(keep.size());
+
+    for (const auto& block_hash: keep)
+    {
+        block_undo undo;
+        if (get(block_hash, undo))
+            kept.emplace_back(block_hash, std::move(undo));
+    }
+
+    // Empty the table and store the kept rows from the start of the slabs.
+    if (!lookup_header_.create() || !lookup_header_.start())
+        return false;
+
+    lookup_manager_.clear();
+
+    for (const auto& entry: kept)
+        store(entry.first, entry.second);
+
+    sync();
+    return true;
+}
+
+void block_undo_database::sync()
+{
+    lookup_manager_.sync();
+}
+
+} // namespace database
+} // namespace libbitcoin
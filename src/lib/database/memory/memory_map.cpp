@@ -32,6 +32,7 @@
     #include <sys/mman.h>
     #define FILE_OPEN_PERMISSIONS S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH
 #endif
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <fcntl.h>
@@ -60,6 +61,12 @@ using boost::filesystem::path;
 #define EXPANSION_NUMERATOR 150
 #define EXPANSION_DENOMINATOR 100
 
+static auto& map_resizes = metrics::get_counter(
+    "mvs_database_resizes_total", "Database file resizes and remaps.");
+static auto& map_resize_seconds = metrics::get_histogram(
+    "mvs_database_resize_seconds", "Time taken to resize and remap a file.",
+    metrics::latency_buckets());
+
 size_t memory_map::file_size(int file_handle)
 {
     if (file_handle == -1)
@@ -325,12 +332,17 @@ memory_ptr memory_map::reserve(size_t size, size_t expansion)
     if (size > file_size_)
     {
         const auto target = size * expansion / EXPANSION_DENOMINATOR;
+        const auto start = asio::steady_clock::now();
 
         if (!truncate_mapped(target))
         {
             handle_error("resize", filename_);
             throw std::runtime_error("Resize failure, disk space may be low.");
         }
+
+        map_resizes.increment();
+        map_resize_seconds.observe(std::chrono::duration<double>(
+            asio::steady_clock::now() - start).count());
     }
 
     logical_size_ = size;
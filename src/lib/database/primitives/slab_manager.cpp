@@ -95,6 +95,19 @@ void slab_manager::sync() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void slab_manager::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_WRITE(mutex_);
+
+    // The file keeps its size until it is closed at the logical size.
+    payload_size_ = sizeof(file_offset);
+    file_.resize(header_size_ + payload_size_);
+    write_size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 // protected
 file_offset slab_manager::payload_size() const
 {
@@ -73,5 +73,14 @@ chain::transaction transaction_result::transaction() const
     return deserialize_tx(memory + height_size + index_size);
     //// return deserialize_tx(memory + 8, size_limit_ - 8);
 }
+
+chain::transaction_view transaction_result::view() const
+{
+    BITCOIN_ASSERT(slab_);
+    const auto memory = REMAP_ADDRESS(slab_);
+    return transaction_view::factory_from_memory(
+        memory + height_size + index_size);
+}
+
 } // namespace database
 } // namespace libbitcoin
@@ -30,6 +30,7 @@ using namespace boost::filesystem;
 settings::settings()
   : history_start_height(0),
     stealth_start_height(0),
+    block_undo_depth(5000),
     directory("database")
 {
 }
@@ -21,7 +21,10 @@
 #include <metaverse/explorer/dispatch.hpp>
 
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 #include <metaverse/explorer/command.hpp>
@@ -130,23 +133,61 @@ console_result dispatch_command(int argc, const char* argv[],
     return command->invoke(out, err);
 }
 
-console_result dispatch_command(int argc, const char* argv[],
-    Json::Value& jv_output, 
+// Run a parsed command for the node.
+static console_result invoke_command(command& command, Json::Value& jv_output,
     libbitcoin::server::server_node& node, uint8_t api_version)
 {
-    std::istringstream input;
-    std::ostringstream output;
+    command.set_api_version(api_version);
 
-    const std::string target(argv[0]);
+    if (command.category(ctgy_extension))
+    {
+
+        // fixme. is_blockchain_sync has some problem.
+        // if (command->category(ctgy_online) && node.is_blockchain_sync()) {
+        if (command.category(ctgy_online) &&
+            !node.chain_impl().chain_settings().use_testnet_rules) {
+       	    uint64_t height{0};
+            node.chain_impl().get_last_height(height);
+            if (!command.is_block_height_fullfilled(height))
+                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
+        }                                                                       
+
+        return static_cast<commands::command_extension&>(command).invoke(jv_output, node);
+
+    }else{
+        std::ostringstream output;
+        command.set_api_version(1); // only compatible for v1
+        auto retcode = command.invoke(output, output);
+        jv_output = output.str();
+        return retcode;
+    }
+}
+
+static std::shared_ptr<command> find_command(const std::string& target)
+{
     const auto command = find(target);
 
     if (!command)
     {
+        std::ostringstream output;
         const std::string superseding(formerly(target));
         display_invalid_command(output, target, superseding);
         throw invalid_command_exception{ output.str() };
     }
 
+    return command;
+}
+
+console_result dispatch_command(int argc, const char* argv[],
+    Json::Value& jv_output, 
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    std::istringstream input;
+    std::ostringstream output;
+
+    const std::string target(argv[0]);
+    const auto command = find_command(target);
+
     auto& in = get_command_input(*command, input);
 
     parser metadata(*command);
@@ -165,31 +206,81 @@ console_result dispatch_command(int argc, const char* argv[],
         return console_result::okay;
     }
 
-    command->set_api_version(api_version);
+    return invoke_command(*command, jv_output, node, api_version);
+}
 
-    if (command->category(ctgy_extension))
+// A JSON value as command line tokens, an array gives one token per item.
+static std::vector<std::string> to_tokens(const Json::Value& value)
+{
+    std::vector<std::string> tokens;
+
+    if (value.isArray())
+    {
+        for (const auto& item: value)
+            tokens.push_back(item.asString());
+    }
+    else if (!value.isNull())
     {
+        tokens.push_back(value.asString());
+    }
 
-        // fixme. is_blockchain_sync has some problem.
-        // if (command->category(ctgy_online) && node.is_blockchain_sync()) {
-        if (command->category(ctgy_online) &&
-            !node.chain_impl().chain_settings().use_testnet_rules) {
-       	    uint64_t height{0};
-            node.chain_impl().get_last_height(height);
-            if (!command->is_block_height_fullfilled(height))
-                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
-        }                                                                       
+    return tokens;
+}
 
-        return static_cast<commands::command_extension*>(command.get())->invoke(jv_output, node);
+void split_params(const Json::Value& params,
+    parser::named_values& out_named, parser::token_values& out_tokens)
+{
+    auto options_read = false;
+    for (const auto& param: params)
+    {
+        if (!param.isObject())
+        {
+            out_tokens.push_back(param.asString());
+            continue;
+        }
+
+        if (options_read)
+            continue;
+
+        options_read = true;
+        for (const auto& key: param.getMemberNames())
+            out_named.emplace_back(key, to_tokens(param[key]));
+    }
+}
 
-    }else{
-        command->set_api_version(1); // only compatible for v1
-        auto retcode = command->invoke(output, output);
+console_result dispatch_command(const std::string& method,
+    const Json::Value& params, Json::Value& jv_output,
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    std::istringstream input;
+    std::ostringstream output;
+
+    const auto command = find_command(method);
+
+    parser::named_values named;
+    parser::token_values tokens;
+    split_params(params, named, tokens);
+
+    auto& in = get_command_input(*command, input);
+
+    parser metadata(*command);
+    std::string error_message;
+
+    if (!metadata.parse(error_message, in, named, tokens))
+    {
+        display_invalid_parameter(output, error_message);
+        throw command_params_exception{ output.str() };
+    }
+
+    if (metadata.help())
+    {
+        command->write_help(output);
         jv_output = output.str();
-        return retcode;
+        return console_result::okay;
     }
-}
 
+    return invoke_command(*command, jv_output, node, api_version);
+}
 
 } // namespace explorer
 } // namespace libbitcoin
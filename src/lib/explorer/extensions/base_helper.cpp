@@ -20,6 +20,7 @@
 
 #include <metaverse/explorer/commands/offline_commands_impl.hpp>
 #include <metaverse/explorer/extensions/base_helper.hpp>
+#include <metaverse/explorer/extensions/coin_selection.hpp>
 #include <metaverse/explorer/dispatch.hpp>
 #include <metaverse/explorer/extensions/exception.hpp>
 #include <unordered_map>
@@ -29,6 +30,32 @@ namespace libbitcoin {
 namespace explorer {
 namespace commands {
 
+// Overwrite memory in a way the compiler cannot elide as a dead store.
+static void secure_zero(void* data, size_t size)
+{
+    auto bytes = static_cast<volatile uint8_t*>(data);
+    while (size-- != 0)
+        *bytes++ = 0;
+}
+
+// Wipes a signing key copied to the stack when it leaves scope, thrown or not.
+class secret_wiper
+{
+public:
+    secret_wiper(ec_secret& secret)
+      : secret_(secret)
+    {
+    }
+
+    ~secret_wiper()
+    {
+        secure_zero(secret_.data(), secret_.size());
+    }
+
+private:
+    ec_secret& secret_;
+};
+
 std::string get_multisig_script(uint8_t m, uint8_t n, std::vector<std::string>& public_keys){
     std::sort(public_keys.begin(), public_keys.end());
     std::ostringstream ss;
@@ -202,12 +229,12 @@ chain::points_info sync_fetchutxo(uint64_t amount, wallet::payment_address& addr
 {
     // history::list rows
     auto rows = get_address_history(addr, blockchain);
-    log::trace("get_history=")<<rows.size();
+    BC_LOG_TRACE("get_history=")<<rows.size();
     
     uint64_t height = 0;
     blockchain.get_last_height(height);
     chain::output_info::list unspent;
-    chain::transaction tx_temp;
+    chain::transaction_view tx_temp;
     uint64_t tx_height;
     uint64_t total_unspent = 0;
     
@@ -215,10 +242,10 @@ chain::points_info sync_fetchutxo(uint64_t amount, wallet::payment_address& addr
     {       
         // spend unconfirmed (or no spend attempted)
         if (row.spend.hash == null_hash
-                && blockchain.get_transaction(row.output.hash, tx_temp, tx_height)) {
+                && blockchain.get_transaction_view(row.output.hash, tx_temp, tx_height)) {
             // fetch utxo script to check deposit utxo
             //log::debug("get_tx=")<<blockchain.get_transaction(row.output.hash, tx_temp); // todo -- return value check
-            auto output = tx_temp.outputs.at(row.output.index);
+            auto output = tx_temp.output(row.output.index);
             bool is_deposit_utxo = false;
 
             // deposit utxo in transaction pool
@@ -274,7 +301,7 @@ void sync_fetch_asset_balance (std::string& addr,
     // history::list rows
     auto rows = get_address_history(address, blockchain);
     
-    chain::transaction tx_temp;
+    chain::transaction_view tx_temp;
     uint64_t tx_height;
     uint64_t height = 0;
     blockchain.get_last_height(height);
@@ -282,8 +309,8 @@ void sync_fetch_asset_balance (std::string& addr,
     for (auto& row: rows) {     
         // spend unconfirmed (or no spend attempted)
         if ((row.spend.hash == null_hash)
-                && blockchain.get_transaction(row.output.hash, tx_temp, tx_height)) {
-            auto output = tx_temp.outputs.at(row.output.index);
+                && blockchain.get_transaction_view(row.output.hash, tx_temp, tx_height)) {
+            auto output = tx_temp.output(row.output.index);
             if((output.is_asset_transfer() || output.is_asset_issue())) {
                 auto pos = std::find_if(sh_asset_vec->begin(), sh_asset_vec->end(), [&](const asset_detail& elem){
                         return output.get_asset_symbol() == elem.get_symbol();
@@ -307,7 +334,7 @@ void sync_fetch_asset_balance_record (std::string& addr,
     // history::list rows
     auto rows = get_address_history(address, blockchain);
     
-    chain::transaction tx_temp;
+    chain::transaction_view tx_temp;
     uint64_t tx_height;
     uint64_t height = 0;
     blockchain.get_last_height(height);
@@ -315,8 +342,8 @@ void sync_fetch_asset_balance_record (std::string& addr,
     for (auto& row: rows) {     
         // spend unconfirmed (or no spend attempted)
         if ((row.spend.hash == null_hash)
-                && blockchain.get_transaction(row.output.hash, tx_temp, tx_height)) {
-            auto output = tx_temp.outputs.at(row.output.index);
+                && blockchain.get_transaction_view(row.output.hash, tx_temp, tx_height)) {
+            auto output = tx_temp.output(row.output.index);
             if((output.is_asset_transfer() || output.is_asset_issue())) {
                 auto pos = std::find_if(sh_asset_vec->begin(), sh_asset_vec->end(), [&](const asset_detail& elem){
                         return ((output.get_asset_symbol() == elem.get_symbol()) 
@@ -340,14 +367,14 @@ void sync_fetchbalance (wallet::payment_address& address,
 {
     // history::list rows
     auto rows = get_address_history(address, blockchain);
-    log::trace("get_history=")<<rows.size();
+    BC_LOG_TRACE("get_history=")<<rows.size();
 
     uint64_t total_received = 0;
     uint64_t confirmed_balance = 0;
     uint64_t unspent_balance = 0;
     uint64_t frozen_balance = 0;
     
-    chain::transaction tx_temp;
+    chain::transaction_view tx_temp;
     uint64_t tx_height;
     uint64_t height = 0;
     blockchain.get_last_height(height);
@@ -361,9 +388,9 @@ void sync_fetchbalance (wallet::payment_address& address,
     
         // spend unconfirmed (or no spend attempted)
         if ((row.spend.hash == null_hash)
-                && blockchain.get_transaction(row.output.hash, tx_temp, tx_height)) {
+                && blockchain.get_transaction_view(row.output.hash, tx_temp, tx_height)) {
             //log::debug("get_tx=")<<blockchain.get_transaction(row.output.hash, tx_temp); // todo -- return value check
-            auto output = tx_temp.outputs.at(row.output.index);
+            auto output = tx_temp.output(row.output.index);
 
             // deposit utxo in transaction pool
             if ((output.script.pattern() == bc::chain::script_pattern::pay_key_hash_with_lock_height)
@@ -496,316 +523,49 @@ void base_transfer_helper::sum_payment_amount(){
         payment_asset_ += iter.asset_amount;
     }
 }
-void base_transfer_helper::sync_fetchutxo (const std::string& prikey, const std::string& addr) 
-#if 1
-{
-    auto waddr = wallet::payment_address(addr);
-    // history::list rows
-    auto rows = get_address_history(waddr, blockchain_);
-    log::trace("get_history=")<<rows.size();
-        
-    chain::transaction tx_temp;
-    uint64_t tx_height;
-    uint64_t height = 0;
-    auto frozen_flag = false;
-    address_asset_record record;
-    
-    blockchain_.get_last_height(height);
-
-    for (auto& row: rows)
-    {
-        frozen_flag = false;
-        if((unspent_etp_ >= payment_etp_) && (unspent_asset_ >= payment_asset_)) // performance improve
-            break;
-                
-        // spend unconfirmed (or no spend attempted)
-        if ((row.spend.hash == null_hash)
-                && blockchain_.get_transaction(row.output.hash, tx_temp, tx_height)) {
-            auto output = tx_temp.outputs.at(row.output.index);
-
-            // deposit utxo in transaction pool
-            if ((output.script.pattern() == bc::chain::script_pattern::pay_key_hash_with_lock_height)
-                        && !row.output_height) { 
-                frozen_flag = true;
-            }
-
-            // deposit utxo in block
-            if(chain::operation::is_pay_key_hash_with_lock_height_pattern(output.script.operations)
-                && row.output_height) { 
-                uint64_t lock_height = chain::operation::get_lock_height_from_pay_key_hash_with_lock_height(output.script.operations);
-                if((row.output_height + lock_height) > height) { // utxo already in block but deposit not expire
-                    frozen_flag = true;
-                }
-            }
-            
-            // coin base etp maturity etp check
-            if(tx_temp.is_coinbase()
-                && !(output.script.pattern() == bc::chain::script_pattern::pay_key_hash_with_lock_height)) { // incase readd deposit
-                // add not coinbase_maturity etp into frozen
-                if((!row.output_height ||
-                            (row.output_height && (height - row.output_height) < coinbase_maturity))) {
-                    frozen_flag = true;
-                }
-            }
-            log::trace("frozen_flag=")<< frozen_flag;
-            log::trace("payment_asset_=")<< payment_asset_;
-            log::trace("is_etp=")<< output.is_etp();
-            log::trace("value=")<< row.value;
-            log::trace("is_trans=")<< output.is_asset_transfer();
-            log::trace("is_issue=")<< output.is_asset_issue();
-            log::trace("symbol=")<< symbol_;
-            log::trace("outpuy symbol=")<< output.get_asset_symbol();
-            // add to from list
-            if(!frozen_flag){
-                // etp -> etp tx
-                if(!payment_asset_ && output.is_etp()){
-                    record.prikey = prikey;
-                    record.addr = addr;
-                    record.amount = row.value;
-                    record.symbol = "";
-                    record.asset_amount = 0;
-                    record.type = utxo_attach_type::etp;
-                    record.output = row.output;
-                    record.script = output.script;
-                    
-                    if(unspent_etp_ < payment_etp_) {
-                        from_list_.push_back(record);
-                        unspent_etp_ += record.amount;
-                    }
-                // asset issue/transfer
-                } else { 
-                    if(output.is_etp()){
-                        record.prikey = prikey;
-                        record.addr = addr;
-                        record.amount = row.value;
-                        record.symbol = "";
-                        record.asset_amount = 0;
-                        record.type = utxo_attach_type::etp;
-                        record.output = row.output;
-                        record.script = output.script;
-                        
-                        if(unspent_etp_ < payment_etp_) {
-                            from_list_.push_back(record);
-                            unspent_etp_ += record.amount;
-                        }
-                    } else if (output.is_asset_issue() && (symbol_ == output.get_asset_symbol())){
-                        record.prikey = prikey;
-                        record.addr = addr;
-                        record.amount = row.value;
-                        record.symbol = output.get_asset_symbol();
-                        record.asset_amount = output.get_asset_amount();
-                        record.type = utxo_attach_type::asset_issue;
-                        record.output = row.output;
-                        record.script = output.script;
-                        
-                        if((unspent_asset_ < payment_asset_)
-                            || (unspent_etp_ < payment_etp_)) {
-                            from_list_.push_back(record);
-                            unspent_asset_ += record.asset_amount;
-                            unspent_etp_ += record.amount;
-                        }
-                    } else if (output.is_asset_transfer() && (symbol_ == output.get_asset_symbol())){
-                        record.prikey = prikey;
-                        record.addr = addr;
-                        record.amount = row.value;
-                        record.symbol = output.get_asset_symbol();
-                        record.asset_amount = output.get_asset_amount();
-                        record.type = utxo_attach_type::asset_transfer;
-                        record.output = row.output;
-                        record.script = output.script;
-                        
-                        if((unspent_asset_ < payment_asset_)
-                            || (unspent_etp_ < payment_etp_)){
-                            from_list_.push_back(record);
-                            unspent_asset_ += record.asset_amount;
-                            unspent_etp_ += record.amount;
-                        }
-                        log::trace("unspent_asset_=")<< unspent_asset_;
-                        log::trace("unspent_etp_=")<< unspent_etp_;
-                    }
-                    // not add message process here, because message utxo have no etp value
-                }
-            }
-        }
-    
-    }
-    rows.clear();
-    
-}
-#endif
-
-#if 0
-{
-    using namespace bc::client;
+void base_transfer_helper::select_unspent(bool script_addresses) {
+    // get address list
+    auto pvaddr = blockchain_.get_account_addresses(name_);
+    if(!pvaddr) 
+        throw address_list_nullptr_exception{"nullptr for address list"};
 
-    auto address = payment_address(addr);
-    const auto connection = get_connection(cmd_);
-    obelisk_client client(connection);
-    if (!client.connect(connection))
-    {
-        throw connection_exception{"failure connection to " + connection.server.to_string()} ;
+    // select utxo only in from_ address, if it is one of the account's
+    std::vector<std::string> addresses;
+    for (auto& each : *pvaddr) {
+        const auto& address = each.get_address();
+        if((from_.empty() || address == from_)
+            && blockchain_.is_script_address(address) == script_addresses)
+            addresses.push_back(address);
     }
 
-    uint64_t height = 0;
-    blockchain_.get_last_height(height);
-
-    auto on_done = [&addr, &prikey, this, height](const history::list& rows)
-    {       
-        for (auto& row: rows) {
-            if((unspent_etp_ >= payment_etp_) && (unspent_asset_ >= payment_asset_)) // performance improve
-                break;
+    const auto view = utxo_view::fetch(blockchain_, addresses);
 
-            //std::function<void(chain::transaction& tx, uint64_t& tx_height)>
-            auto sum_balance = [&row, &addr, &prikey, this, height](const code& ec, const chain::transaction& tx)-> void
-            {
-                address_asset_record record;
-                auto frozen_flag = false;
+    utxo_list selected;
+    select_coins(selection_, *view, symbol_, payment_etp_, payment_asset_,
+        tx_limit, selected);
 
-                auto output = tx.outputs.at(row.output.index);
-            
-                // deposit utxo in transaction pool
-                if ((output.script.pattern() == bc::chain::script_pattern::pay_key_hash_with_lock_height)
-                            && !row.output_height) { 
-                    frozen_flag = true;
-                }
-            
-                // deposit utxo in block
-                if(chain::operation::is_pay_key_hash_with_lock_height_pattern(output.script.operations)
-                    && row.output_height) { 
-                    uint64_t lock_height = chain::operation::get_lock_height_from_pay_key_hash_with_lock_height(output.script.operations);
-                    if((row.output_height + lock_height) > height) { // utxo already in block but deposit not expire
-                        frozen_flag = true;
-                    }
-                }
-                
-                // coin base etp maturity etp check
-                if(tx.is_coinbase()
-                    && !(output.script.pattern() == bc::chain::script_pattern::pay_key_hash_with_lock_height)) { // incase readd deposit
-                    // add not coinbase_maturity etp into frozen
-                    if((!row.output_height ||
-                                (row.output_height && (height - row.output_height) < coinbase_maturity))) {
-                        frozen_flag = true;
-                    }
-                }
-                // add to from list
-                if(!frozen_flag){
-                    // etp -> etp tx
-                    if(!payment_asset_ && output.is_etp()){
-                        record.prikey = prikey;
-                        record.addr = addr;
-                        record.amount = row.value;
-                        record.symbol = "";
-                        record.asset_amount = 0;
-                        record.type = utxo_attach_type::etp;
-                        record.output = row.output;
-                        record.script = output.script;
-                        
-                        if(unspent_etp_ < payment_etp_) {
-                            from_list_.push_back(record);
-                            unspent_etp_ += record.amount;
-                        }
-                    // asset issue/transfer
-                    } else { 
-                        if(output.is_etp()){
-                            record.prikey = prikey;
-                            record.addr = addr;
-                            record.amount = row.value;
-                            record.symbol = "";
-                            record.asset_amount = 0;
-                            record.type = utxo_attach_type::etp;
-                            record.output = row.output;
-                            record.script = output.script;
-                            
-                            if(unspent_etp_ < payment_etp_) {
-                                from_list_.push_back(record);
-                                unspent_etp_ += record.amount;
-                            }
-                        } else if (output.is_asset_issue() && (symbol_ == output.get_asset_symbol())){
-                            record.prikey = prikey;
-                            record.addr = addr;
-                            record.amount = row.value;
-                            record.symbol = output.get_asset_symbol();
-                            record.asset_amount = output.get_asset_amount();
-                            record.type = utxo_attach_type::asset_issue;
-                            record.output = row.output;
-                            record.script = output.script;
-                            
-                            if((unspent_asset_ < payment_asset_)
-                                || (unspent_etp_ < payment_etp_)) {
-                                from_list_.push_back(record);
-                                unspent_asset_ += record.asset_amount;
-                                unspent_etp_ += record.amount;
-                            }
-                        } else if (output.is_asset_transfer() && (symbol_ == output.get_asset_symbol())){
-                            record.prikey = prikey;
-                            record.addr = addr;
-                            record.amount = row.value;
-                            record.symbol = output.get_asset_symbol();
-                            record.asset_amount = output.get_asset_amount();
-                            record.type = utxo_attach_type::asset_transfer;
-                            record.output = row.output;
-                            record.script = output.script;
-                            
-                            if((unspent_asset_ < payment_asset_)
-                                || (unspent_etp_ < payment_etp_)){
-                                from_list_.push_back(record);
-                                unspent_asset_ += record.asset_amount;
-                                unspent_etp_ += record.amount;
-                            }
-                        }
-                        // not add message process here, because message utxo have no etp value
-                    }
-                
-                }
+    // only the keys of the addresses spent from are decrypted
+    std::unordered_map<std::string, std::string> prikeys;
+    for (auto& record : selected) {
+        auto key = prikeys.find(record.addr);
+        if(key == prikeys.end()) {
+            auto match = [&record](const account_address& each) {
+                return each.get_address() == record.addr;
             };
-            // spend unconfirmed (or no spend attempted)
-            if (row.spend.hash == null_hash)
-                    blockchain_.get_transaction_callback(row.output.hash, sum_balance); 
-        
+            auto address = std::find_if(pvaddr->begin(), pvaddr->end(), match);
+            key = prikeys.emplace(record.addr, get_private_key(*address)).first;
         }
-    };
 
-    auto on_error = [](const code& error)
-    {
-        if(error) {
-            throw std::logic_error{error.message()};
-        }
-    };
-
-    // The v3 client API works with and normalizes either server API.
-    //// client.address_fetch_history(on_error, on_done, address);
-    client.address_fetch_history2(on_error, on_done, address);
-    client.wait();
-
-    return ;
+        record.prikey = key->second;
+        unspent_etp_ += record.amount;
+        unspent_asset_ += record.asset_amount;
+        from_list_.push_back(record);
+    }
 }
-#endif
+
 void base_transfer_helper::populate_unspent_list() {
-    // get address list
-    auto pvaddr = blockchain_.get_account_addresses(name_);
-    if(!pvaddr) 
-        throw address_list_nullptr_exception{"nullptr for address list"};
+    select_unspent(false);
 
-    // get from address balances
-    for (auto& each : *pvaddr){
-        // filter script address
-        if(blockchain_.is_script_address(each.get_address()))
-            continue;
-        if(from_.empty()) { // select utxo in all account addresses
-            base_transfer_helper::sync_fetchutxo (each.get_prv_key(passwd_), each.get_address());
-            if((unspent_etp_ >= payment_etp_)
-                && (unspent_asset_ >= payment_asset_))
-                break;
-        } else { // select utxo only in from_ address
-            if ( from_ == each.get_address() ) { // find address
-                base_transfer_helper::sync_fetchutxo (each.get_prv_key(passwd_), each.get_address());
-                if((unspent_etp_ >= payment_etp_)
-                    && (unspent_asset_ >= payment_asset_))
-                    break;
-            }
-        }
-    }
-    
     if(from_list_.empty())
         throw tx_source_exception{"not enough etp in from address or you are't own from address!"};
 
@@ -923,16 +683,50 @@ void base_transfer_helper::check_tx(){
     }
 }
 
+std::string base_transfer_helper::get_private_key(const account_address& address)
+{
+    // Records of unlocked addresses are signed from the session instead.
+    if (blockchain_.account_sessions().contains(name_, address.get_address()))
+        return "";
+
+    return address.get_prv_key(passwd_);
+}
+
+void base_transfer_helper::get_signing_key(const address_asset_record& record,
+    ec_secret& secret, ec_compressed& point)
+{
+    if (blockchain_.account_sessions().find(name_, record.addr, secret, point))
+        return;
+
+    // The session may have expired since the unspent list was populated.
+    auto prikey = record.prikey;
+    if (prikey.empty()) {
+        const auto address = blockchain_.get_account_address(name_, record.addr);
+        if (!address)
+            throw tx_sign_exception{record.addr + " private key not found"};
+        prikey = address->get_prv_key(passwd_);
+    }
+
+    const auto valid = decode_base16(secret, prikey) &&
+        secret_to_public(point, secret);
+    secure_zero(&prikey[0], prikey.size());
+
+    if (!valid)
+        throw tx_sign_exception{"invalid private key of " + record.addr};
+}
+
 void base_transfer_helper::sign_tx_inputs(){
     uint32_t index = 0;
+    const bc::chain::sighash_context sighash(tx_);
     for (auto& fromeach : from_list_){
         // paramaters
         explorer::config::hashtype sign_type;
         uint8_t hash_type = (signature_hash_algorithm)sign_type;
 
-        bc::explorer::config::ec_private config_private_key(fromeach.prikey);
-        const ec_secret& private_key =    config_private_key;    
-        bc::wallet::ec_private ec_private_key(private_key, 0u, true);
+        ec_secret private_key;
+        const secret_wiper wiper(private_key);
+        ec_compressed public_point;
+        get_signing_key(fromeach, private_key, public_point);
 
         bc::explorer::config::script config_contract(fromeach.script);
         const bc::chain::script& contract = config_contract;
@@ -940,15 +734,13 @@ void base_transfer_helper::sign_tx_inputs(){
         // gen sign
         bc::endorsement endorse;
         if (!bc::chain::script::create_endorsement(endorse, private_key,
-            contract, tx_, index, hash_type))
+            contract, sighash, index, hash_type))
         {
             throw tx_sign_exception{"get_input_sign sign failure"};
         }
 
         // do script
-        auto&& public_key = ec_private_key.to_public();
-        data_chunk public_key_data;
-        public_key.to_data(public_key_data);
+        const auto public_key_data = to_chunk(public_point);
         bc::chain::script ss;
         ss.operations.push_back({bc::chain::opcode::special, endorse});
         ss.operations.push_back({bc::chain::opcode::special, public_key_data});
@@ -1035,9 +827,9 @@ void base_transaction_constructor::sync_fetchutxo (const std::string& addr)
     auto waddr = wallet::payment_address(addr);
     // history::list rows
     auto rows = get_address_history(waddr, blockchain_);
-    log::trace("get_history=")<<rows.size();
+    BC_LOG_TRACE("get_history=")<<rows.size();
         
-    chain::transaction tx_temp;
+    chain::transaction_view tx_temp;
     uint64_t tx_height;
     uint64_t height = 0;
     auto frozen_flag = false;
@@ -1053,8 +845,8 @@ void base_transaction_constructor::sync_fetchutxo (const std::string& addr)
                 
         // spend unconfirmed (or no spend attempted)
         if ((row.spend.hash == null_hash)
-                && blockchain_.get_transaction(row.output.hash, tx_temp, tx_height)) {
-            auto output = tx_temp.outputs.at(row.output.index);
+                && blockchain_.get_transaction_view(row.output.hash, tx_temp, tx_height)) {
+            auto output = tx_temp.output(row.output.index);
 
             // deposit utxo in transaction pool
             if ((output.script.pattern() == bc::chain::script_pattern::pay_key_hash_with_lock_height)
@@ -1080,14 +872,14 @@ void base_transaction_constructor::sync_fetchutxo (const std::string& addr)
                     frozen_flag = true;
                 }
             }
-            log::trace("frozen_flag=")<< frozen_flag;
-            log::trace("payment_asset_=")<< payment_asset_;
-            log::trace("is_etp=")<< output.is_etp();
-            log::trace("value=")<< row.value;
-            log::trace("is_trans=")<< output.is_asset_transfer();
-            log::trace("is_issue=")<< output.is_asset_issue();
-            log::trace("symbol=")<< symbol_;
-            log::trace("outpuy symbol=")<< output.get_asset_symbol();
+            BC_LOG_TRACE("frozen_flag=")<< frozen_flag;
+            BC_LOG_TRACE("payment_asset_=")<< payment_asset_;
+            BC_LOG_TRACE("is_etp=")<< output.is_etp();
+            BC_LOG_TRACE("value=")<< row.value;
+            BC_LOG_TRACE("is_trans=")<< output.is_asset_transfer();
+            BC_LOG_TRACE("is_issue=")<< output.is_asset_issue();
+            BC_LOG_TRACE("symbol=")<< symbol_;
+            BC_LOG_TRACE("outpuy symbol=")<< output.get_asset_symbol();
             // add to from list
             if(!frozen_flag){
                 // etp -> etp tx
@@ -1153,8 +945,8 @@ void base_transaction_constructor::sync_fetchutxo (const std::string& addr)
                             unspent_asset_ += record.asset_amount;
                             unspent_etp_ += record.amount;
                         }
-                        log::trace("unspent_asset_=")<< unspent_asset_;
-                        log::trace("unspent_etp_=")<< unspent_etp_;
+                        BC_LOG_TRACE("unspent_asset_=")<< unspent_asset_;
+                        BC_LOG_TRACE("unspent_etp_=")<< unspent_etp_;
                     }
                     // not add message process here, because message utxo have no etp value
                 }
@@ -1460,31 +1252,9 @@ void sending_multisig_etp::populate_change() {
 }
 
 void sending_multisig_etp::populate_unspent_list() {
-    // get address list
-    auto pvaddr = blockchain_.get_account_addresses(name_);
-    if(!pvaddr) 
-        throw address_list_nullptr_exception{"nullptr for address list"};
+    // must be script address
+    select_unspent(true);
 
-    // get from address balances
-    for (auto& each : *pvaddr){
-        // must be script address
-        if(!blockchain_.is_script_address(each.get_address()))
-            continue;
-        if(from_.empty()) { // select utxo in all account addresses
-            base_transfer_helper::sync_fetchutxo (each.get_prv_key(passwd_), each.get_address());
-            if((unspent_etp_ >= payment_etp_)
-                && (unspent_asset_ >= payment_asset_))
-                break;
-        } else { // select utxo only in from_ address
-            if ( from_ == each.get_address() ) { // find address
-                base_transfer_helper::sync_fetchutxo (each.get_prv_key(passwd_), each.get_address());
-                if((unspent_etp_ >= payment_etp_)
-                    && (unspent_asset_ >= payment_asset_))
-                    break;
-            }
-        }
-    }
-    
     if(from_list_.empty())
         throw tx_source_exception{"not enough etp in from address or you are't own from address!"};
 
@@ -1501,20 +1271,23 @@ void sending_multisig_etp::populate_unspent_list() {
 
 void sending_multisig_etp::sign_tx_inputs() {
     uint32_t index = 0;
+    const bc::chain::sighash_context sighash(tx_);
     std::string prikey, pubkey, multisig_script;
     
     for (auto& fromeach : from_list_){
         // populate unlock script
         multisig_script = multisig_.get_multisig_script();
-        log::trace("wdy script=") << multisig_script;
+        BC_LOG_TRACE("wdy script=") << multisig_script;
         //wallet::payment_address payment("3JoocenkYHEKFunupQSgBUR5bDWioiTq5Z");
         //log::trace("wdy hash=") << libbitcoin::config::base16(payment.hash());
         // prepare sign
         explorer::config::hashtype sign_type;
         uint8_t hash_type = (signature_hash_algorithm)sign_type;
         
-        bc::explorer::config::ec_private config_private_key(fromeach.prikey);
-        const ec_secret& private_key =    config_private_key;    
+        ec_secret private_key;
+        const secret_wiper wiper(private_key);
+        ec_compressed public_point;
+        get_signing_key(fromeach, private_key, public_point);
         
         bc::explorer::config::script config_contract(multisig_script);
         const bc::chain::script& contract = config_contract;
@@ -1522,7 +1295,7 @@ void sending_multisig_etp::sign_tx_inputs() {
         // gen sign
         bc::endorsement endorse;
         if (!bc::chain::script::create_endorsement(endorse, private_key,
-            contract, tx_, index, hash_type))
+            contract, sighash, index, hash_type))
         {
             throw tx_sign_exception{"get_input_sign sign failure"};
         }
@@ -0,0 +1,366 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/explorer/extensions/coin_selection.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+
+// The number of search steps before branch and bound gives up.
+static constexpr size_t bnb_tries = 100000;
+
+// The change branch and bound tolerates when no exact match exists.
+static constexpr uint64_t etp_change_window = 10000;
+
+static void collect_unspent(bc::blockchain::block_chain_impl& blockchain,
+    const std::string& address, uint64_t height, utxo_list& out)
+{
+    bc::blockchain::utxo_views::coin_list coins;
+    blockchain.get_address_utxos(address, coins);
+
+    for (auto& coin: coins)
+    {
+        auto& output = coin.output;
+        const auto& operations = output.script.operations;
+        const auto deposit = chain::operation::
+            is_pay_key_hash_with_lock_height_pattern(operations);
+
+        // deposit utxo in transaction pool, or in block but not expired
+        if (deposit && (!coin.height || (coin.height +
+            chain::operation::get_lock_height_from_pay_key_hash_with_lock_height(
+                operations)) > height))
+            continue;
+
+        // coin base etp maturity check, deposits are matured by lock height
+        if (coin.coinbase && !deposit && (!coin.height
+            || (height - coin.height) < coinbase_maturity))
+            continue;
+
+        address_asset_record record;
+        record.addr = address;
+        record.amount = output.value;
+        record.output = coin.point;
+        record.script = output.script;
+        record.hd_index = 0;
+
+        if (output.is_etp()) {
+            record.symbol = "";
+            record.asset_amount = 0;
+            record.type = utxo_attach_type::etp;
+        } else if (output.is_asset_issue()) {
+            record.symbol = output.get_asset_symbol();
+            record.asset_amount = output.get_asset_amount();
+            record.type = utxo_attach_type::asset_issue;
+        } else if (output.is_asset_transfer()) {
+            record.symbol = output.get_asset_symbol();
+            record.asset_amount = output.get_asset_amount();
+            record.type = utxo_attach_type::asset_transfer;
+        } else {
+            // message utxo have no etp value
+            continue;
+        }
+
+        out.push_back(std::move(record));
+    }
+}
+
+utxo_view::ptr utxo_view::fetch(bc::blockchain::block_chain_impl& blockchain,
+    const std::vector<std::string>& addresses)
+{
+    uint64_t height = 0;
+    blockchain.get_last_height(height);
+
+    const auto view = std::make_shared<utxo_list>();
+    for (const auto& address: addresses)
+        collect_unspent(blockchain, address, height, *view);
+
+    log::debug("utxo_view") << "selected " << view->size() << " utxo of "
+        << addresses.size() << " addresses at height " << height;
+
+    return view;
+}
+
+bool parse_coin_selection(const std::string& text,
+    coin_selection& out_strategy)
+{
+    if (text == "branch-and-bound")
+        out_strategy = coin_selection::branch_and_bound;
+    else if (text == "largest-first")
+        out_strategy = coin_selection::largest_first;
+    else if (text == "minimize-inputs")
+        out_strategy = coin_selection::minimize_inputs;
+    else
+        return false;
+
+    return true;
+}
+
+// The strategies below work on values sorted in descending order and
+// return positions into them.
+typedef std::vector<uint64_t> value_list;
+typedef std::vector<size_t> position_list;
+
+// Take the largest values until the target is met.
+static bool largest_first(const value_list& values, uint64_t target,
+    position_list& out)
+{
+    uint64_t total = 0;
+    for (size_t position = 0; position < values.size() && total < target;
+        ++position)
+    {
+        out.push_back(position);
+        total += values[position];
+    }
+
+    return total >= target;
+}
+
+// Use as few values as largest first does, but fill the last slot with the
+// smallest value that still meets the target, to keep the change low.
+static bool minimize_inputs(const value_list& values, uint64_t target,
+    position_list& out)
+{
+    if (!largest_first(values, target, out))
+        return false;
+
+    if (out.empty())
+        return true;
+
+    const auto last = out.back();
+    const auto need = target - (std::accumulate(out.begin(), out.end() - 1,
+        uint64_t(0), [&values](uint64_t sum, size_t position)
+        {
+            return sum + values[position];
+        }));
+
+    auto best = last;
+    for (auto position = values.size(); position-- > last;)
+    {
+        if (values[position] >= need)
+        {
+            best = position;
+            break;
+        }
+    }
+
+    out.back() = best;
+    return true;
+}
+
+// Depth first search for the subset whose excess over the target is the
+// lowest, within the window, preferring fewer values on ties. Each step
+// either includes the next value or backtracks to exclude the last included
+// one, pruning branches that overshoot the window or cannot reach the target.
+static bool branch_and_bound(const value_list& values, uint64_t target,
+    uint64_t window, size_t max_inputs, position_list& out)
+{
+    uint64_t available = 0;
+    for (const auto value: values)
+        available += value;
+
+    if (available < target)
+        return false;
+
+    std::vector<bool> included;
+    std::vector<bool> best;
+    size_t count = 0;
+    size_t best_count = 0;
+    uint64_t current = 0;
+    auto best_excess = max_uint64;
+
+    included.reserve(values.size());
+
+    for (size_t step = 0; step < bnb_tries; ++step)
+    {
+        auto backtrack = false;
+
+        if (current + available < target || current > target + window
+            || (current < target && count == max_inputs))
+        {
+            backtrack = true;
+        }
+        else if (current >= target)
+        {
+            const auto excess = current - target;
+            if (excess < best_excess ||
+                (excess == best_excess && count < best_count))
+            {
+                best = included;
+                best_count = count;
+                best_excess = excess;
+            }
+
+            if (best_excess == 0 && best_count == 1)
+                break;
+
+            backtrack = true;
+        }
+
+        if (backtrack)
+        {
+            // Walk back to the last included value, its exclusion branch is
+            // the next one not yet searched.
+            while (!included.empty() && !included.back())
+            {
+                included.pop_back();
+                available += values[included.size()];
+            }
+
+            if (included.empty())
+                break;
+
+            included.back() = false;
+            current -= values[included.size() - 1];
+            --count;
+        }
+        else
+        {
+            const auto position = included.size();
+            available -= values[position];
+
+            // Including an equal value after excluding its predecessor only
+            // repeats the branch already searched.
+            if (!included.empty() && !included.back()
+                && values[position] == values[position - 1])
+            {
+                included.push_back(false);
+            }
+            else
+            {
+                included.push_back(true);
+                current += values[position];
+                ++count;
+            }
+        }
+    }
+
+    if (best_excess == max_uint64)
+        return false;
+
+    for (size_t position = 0; position < best.size(); ++position)
+        if (best[position])
+            out.push_back(position);
+
+    return true;
+}
+
+// Choose from the coins for the target measured by value_of.
+template <typename ValueOf>
+static bool select(coin_selection strategy, const utxo_list& coins,
+    uint64_t target, uint64_t window, size_t max_inputs, ValueOf value_of,
+    utxo_list& out)
+{
+    if (target == 0)
+        return true;
+
+    utxo_list sorted(coins);
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [&value_of](const address_asset_record& left,
+            const address_asset_record& right)
+        {
+            return value_of(left) > value_of(right);
+        });
+
+    value_list values;
+    values.reserve(sorted.size());
+    for (const auto& coin: sorted)
+        values.push_back(value_of(coin));
+
+    position_list positions;
+    auto found = false;
+
+    switch (strategy)
+    {
+        case coin_selection::branch_and_bound:
+            found = branch_and_bound(values, target, window, max_inputs,
+                positions);
+            if (!found)
+            {
+                positions.clear();
+                found = minimize_inputs(values, target, positions);
+            }
+            break;
+        case coin_selection::largest_first:
+            found = largest_first(values, target, positions);
+            break;
+        case coin_selection::minimize_inputs:
+            found = minimize_inputs(values, target, positions);
+            break;
+    }
+
+    if (!found)
+    {
+        out.insert(out.end(), sorted.begin(), sorted.end());
+        return false;
+    }
+
+    for (const auto position: positions)
+        out.push_back(sorted[position]);
+
+    return true;
+}
+
+bool select_coins(coin_selection strategy, const utxo_list& coins,
+    const std::string& symbol, uint64_t etp_amount, uint64_t asset_amount,
+    size_t max_inputs, utxo_list& out_selected)
+{
+    utxo_list etp_coins;
+    utxo_list asset_coins;
+
+    for (const auto& coin: coins)
+    {
+        if (coin.type == utxo_attach_type::etp)
+            etp_coins.push_back(coin);
+        else if (asset_amount != 0 && coin.symbol == symbol)
+            asset_coins.push_back(coin);
+    }
+
+    // Assets first, the etp they carry lowers the etp still to be covered.
+    const auto asset_found = select(strategy, asset_coins, asset_amount, 0,
+        max_inputs, [](const address_asset_record& coin)
+        {
+            return coin.asset_amount;
+        }, out_selected);
+
+    uint64_t etp_selected = 0;
+    for (const auto& coin: out_selected)
+        etp_selected += coin.amount;
+
+    const auto etp_left = etp_amount > etp_selected ?
+        etp_amount - etp_selected : 0;
+    const auto inputs_left = max_inputs > out_selected.size() ?
+        max_inputs - out_selected.size() : 0;
+
+    const auto etp_found = select(strategy, etp_coins, etp_left,
+        etp_change_window, inputs_left, [](const address_asset_record& coin)
+        {
+            return coin.amount;
+        }, out_selected);
+
+    return asset_found && etp_found;
+}
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
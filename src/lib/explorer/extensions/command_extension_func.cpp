@@ -23,6 +23,7 @@
 #include <memory>    
 #include <string>    
 #include <array>     
+#include <unordered_map>
 
 #include <metaverse/explorer/command.hpp>                
 #include <metaverse/explorer/dispatch.hpp>
@@ -35,6 +36,8 @@
 #include <metaverse/explorer/extensions/commands/getinfo.hpp>
 #include <metaverse/explorer/extensions/commands/getheight.hpp>
 #include <metaverse/explorer/extensions/commands/getpeerinfo.hpp>
+#include <metaverse/explorer/extensions/commands/getnettraffic.hpp>
+#include <metaverse/explorer/extensions/commands/gettrace.hpp>
 #include <metaverse/explorer/extensions/commands/getaddressetp.hpp>
 #include <metaverse/explorer/extensions/commands/addnode.hpp>
 #include <metaverse/explorer/extensions/commands/getmininginfo.hpp>
@@ -46,6 +49,8 @@
 #include <metaverse/explorer/extensions/commands/getnewaccount.hpp>
 #include <metaverse/explorer/extensions/commands/getaccount.hpp>
 #include <metaverse/explorer/extensions/commands/deleteaccount.hpp>
+#include <metaverse/explorer/extensions/commands/lockaccount.hpp>
+#include <metaverse/explorer/extensions/commands/unlockaccount.hpp>
 #include <metaverse/explorer/extensions/commands/listaddresses.hpp>
 #include <metaverse/explorer/extensions/commands/getnewaddress.hpp>
 #include <metaverse/explorer/extensions/commands/getblock.hpp>
@@ -105,6 +110,8 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func)
     func(make_shared<importkeyfile>());
     func(make_shared<importaccount>());
     func(make_shared<changepasswd>());
+    func(make_shared<unlockaccount>());
+    func(make_shared<lockaccount>());
 
     // wallet
     func(make_shared<getheight>());
@@ -117,6 +124,8 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func)
     func(make_shared<getmininginfo>());
     func(make_shared<getinfo>());
     func(make_shared<getpeerinfo>());
+    func(make_shared<getnettraffic>());
+    func(make_shared<gettrace>());
     func(make_shared<getaddressetp>());
     func(make_shared<addnode>());
     func(make_shared<gettx>());
@@ -161,127 +170,111 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func)
     func(make_shared<sendrawtx>());
 }
 
-shared_ptr<command> find_extension(const string& symbol)
+// Create a command of the type, optionally under one of its former names.
+template <typename Command>
+static command_factory factory()
+{
+    return []()
+    {
+        return std::make_shared<Command>();
+    };
+}
+
+template <typename Command>
+static command_factory factory(const std::string& symbol)
+{
+    return [symbol]()
+    {
+        return std::make_shared<Command>(symbol);
+    };
+}
+
+// Commands hold the state of a single call, so the table keeps factories
+// rather than instances. It is built once, on first use.
+static const std::unordered_map<std::string, command_factory>& registry()
 {
-    using namespace std;
     using namespace commands;
-    if (symbol == stopmining::symbol() || symbol == "stop")
-        return make_shared<stopmining>();
-    if (symbol == startmining::symbol() || symbol == "start")
-        return make_shared<startmining>();
-    if (symbol == getinfo::symbol())
-        return make_shared<getinfo>();
-    if (symbol == getheight::symbol())
-        return make_shared<getheight>();
-    if (symbol == "fetch-height")
-        return make_shared<getheight>(symbol);
-    if (symbol == getpeerinfo::symbol())
-        return make_shared<getpeerinfo>();
-    if (symbol == getaddressetp::symbol() || symbol == "fetch-balance")
-        return make_shared<getaddressetp>();
-    if (symbol == addnode::symbol())
-        return make_shared<addnode>();
-    if (symbol == getmininginfo::symbol())
-        return make_shared<getmininginfo>();
-    if (symbol == gettx::symbol() || symbol == "gettransaction")
-        return make_shared<gettx>();
-    if (symbol == "fetch-tx")
-        return make_shared<gettx>(symbol);
-    if (symbol == dumpkeyfile::symbol() || symbol == "exportaccountasfile")
-        return make_shared<dumpkeyfile>();
-    if (symbol == importkeyfile::symbol() || symbol == "importaccountfromfile")
-        return make_shared<importkeyfile>();
-    if (symbol == importaccount::symbol())
-        return make_shared<importaccount>();
-    if (symbol == getnewaccount::symbol())
-        return make_shared<getnewaccount>();
-    if (symbol == getaccount::symbol())
-        return make_shared<getaccount>();
-    if (symbol == deleteaccount::symbol())
-        return make_shared<deleteaccount>();
-    if (symbol == listaddresses::symbol())
-        return make_shared<listaddresses>();
-    if (symbol == getnewaddress::symbol())
-        return make_shared<getnewaddress>();
-    if (symbol == getpublickey::symbol())
-        return make_shared<getpublickey>();
-    if (symbol == getblock::symbol())
-        return make_shared<getblock>();
-    if (symbol == validateaddress::symbol())
-        return make_shared<validateaddress>();
-    if (symbol == listbalances::symbol())
-        return make_shared<listbalances>();
-    if (symbol == getbalance::symbol())
-        return make_shared<getbalance>();
-    if (symbol == "getbestblockhash")
-        return make_shared<getblockheader>(symbol);
-    if (symbol == getblockheader::symbol() || symbol == "fetch-header" || symbol == "getbestblockheader")
-        return make_shared<getblockheader>();
-    if (symbol == listtxs::symbol())
-        return make_shared<listtxs>();
-    if (symbol == deposit::symbol())
-        return make_shared<deposit>();
-    if (symbol == send::symbol())
-        return make_shared<send>();
-    if (symbol == sendmore::symbol())
-        return make_shared<sendmore>();
-    if (symbol == sendfrom::symbol())
-        return make_shared<sendfrom>();
-    if (symbol == listassets::symbol())
-        return make_shared<listassets>();
-    if (symbol == getasset::symbol())
-        return make_shared<getasset>();
-    if (symbol == getaccountasset::symbol())
-        return make_shared<getaccountasset>();
-    if (symbol == createasset::symbol())
-        return make_shared<createasset>();
-    if (symbol == deletelocalasset::symbol() || symbol == "deleteasset" )
-        return make_shared<deletelocalasset>();
-    if (symbol == issue::symbol())
-        return make_shared<issue>();
-    if (symbol == issuefrom::symbol())
-        return make_shared<issuefrom>();
-    if (symbol == sendasset::symbol())
-        return make_shared<sendasset>();
-    if (symbol == sendassetfrom::symbol())
-        return make_shared<sendassetfrom>();
-    if (symbol == getwork::symbol())
-        return make_shared<getwork>();
-    if (symbol == submitwork::symbol())
-        return make_shared<submitwork>();
-    if (symbol == setminingaccount::symbol())
-        return make_shared<setminingaccount>();
-    if (symbol == changepasswd::symbol())
-        return make_shared<changepasswd>();
-    if (symbol == getnewmultisig::symbol())
-        return make_shared<getnewmultisig>();
-    if (symbol == listmultisig::symbol())
-        return make_shared<listmultisig>();
-    if (symbol == deletemultisig::symbol())
-        return make_shared<deletemultisig>();
-    if (symbol == createmultisigtx::symbol())
-        return make_shared<createmultisigtx>();
-    if (symbol == signmultisigtx::symbol())
-        return make_shared<signmultisigtx>();
-    if (symbol == createrawtx::symbol())
-        return make_shared<createrawtx>();
-    if (symbol == decoderawtx::symbol())
-        return make_shared<decoderawtx>();
-    if (symbol == signrawtx::symbol())
-        return make_shared<signrawtx>();
-    if (symbol == sendrawtx::symbol())
-        return make_shared<sendrawtx>();
-    if (symbol == issuefrom::symbol())
-        return make_shared<issuefrom>();
-    if (symbol == sendassetfrom::symbol())
-        return make_shared<sendassetfrom>();
-    if (symbol == shutdown::symbol())
-        return make_shared<shutdown>();
-    if (symbol == getmemorypool::symbol())
-        return make_shared<getmemorypool>();
-    if (symbol == getaddressasset::symbol())
-        return make_shared<getaddressasset>();
-    return nullptr;
+    static const std::unordered_map<std::string, command_factory> table
+    {
+        { stopmining::symbol(), factory<stopmining>() },
+        { "stop", factory<stopmining>() },
+        { startmining::symbol(), factory<startmining>() },
+        { "start", factory<startmining>() },
+        { getinfo::symbol(), factory<getinfo>() },
+        { getheight::symbol(), factory<getheight>() },
+        { "fetch-height", factory<getheight>("fetch-height") },
+        { getpeerinfo::symbol(), factory<getpeerinfo>() },
+        { getnettraffic::symbol(), factory<getnettraffic>() },
+        { gettrace::symbol(), factory<gettrace>() },
+        { getaddressetp::symbol(), factory<getaddressetp>() },
+        { "fetch-balance", factory<getaddressetp>() },
+        { addnode::symbol(), factory<addnode>() },
+        { getmininginfo::symbol(), factory<getmininginfo>() },
+        { gettx::symbol(), factory<gettx>() },
+        { "gettransaction", factory<gettx>() },
+        { "fetch-tx", factory<gettx>("fetch-tx") },
+        { dumpkeyfile::symbol(), factory<dumpkeyfile>() },
+        { "exportaccountasfile", factory<dumpkeyfile>() },
+        { importkeyfile::symbol(), factory<importkeyfile>() },
+        { "importaccountfromfile", factory<importkeyfile>() },
+        { importaccount::symbol(), factory<importaccount>() },
+        { getnewaccount::symbol(), factory<getnewaccount>() },
+        { getaccount::symbol(), factory<getaccount>() },
+        { deleteaccount::symbol(), factory<deleteaccount>() },
+        { unlockaccount::symbol(), factory<unlockaccount>() },
+        { lockaccount::symbol(), factory<lockaccount>() },
+        { listaddresses::symbol(), factory<listaddresses>() },
+        { getnewaddress::symbol(), factory<getnewaddress>() },
+        { getpublickey::symbol(), factory<getpublickey>() },
+        { getblock::symbol(), factory<getblock>() },
+        { validateaddress::symbol(), factory<validateaddress>() },
+        { listbalances::symbol(), factory<listbalances>() },
+        { getbalance::symbol(), factory<getbalance>() },
+        { "getbestblockhash", factory<getblockheader>("getbestblockhash") },
+        { getblockheader::symbol(), factory<getblockheader>() },
+        { "fetch-header", factory<getblockheader>() },
+        { "getbestblockheader", factory<getblockheader>() },
+        { listtxs::symbol(), factory<listtxs>() },
+        { deposit::symbol(), factory<deposit>() },
+        { send::symbol(), factory<send>() },
+        { sendmore::symbol(), factory<sendmore>() },
+        { sendfrom::symbol(), factory<sendfrom>() },
+        { listassets::symbol(), factory<listassets>() },
+        { getasset::symbol(), factory<getasset>() },
+        { getaccountasset::symbol(), factory<getaccountasset>() },
+        { createasset::symbol(), factory<createasset>() },
+        { deletelocalasset::symbol(), factory<deletelocalasset>() },
+        { "deleteasset", factory<deletelocalasset>() },
+        { issue::symbol(), factory<issue>() },
+        { issuefrom::symbol(), factory<issuefrom>() },
+        { sendasset::symbol(), factory<sendasset>() },
+        { sendassetfrom::symbol(), factory<sendassetfrom>() },
+        { getwork::symbol(), factory<getwork>() },
+        { submitwork::symbol(), factory<submitwork>() },
+        { setminingaccount::symbol(), factory<setminingaccount>() },
+        { changepasswd::symbol(), factory<changepasswd>() },
+        { getnewmultisig::symbol(), factory<getnewmultisig>() },
+        { listmultisig::symbol(), factory<listmultisig>() },
+        { deletemultisig::symbol(), factory<deletemultisig>() },
+        { createmultisigtx::symbol(), factory<createmultisigtx>() },
+        { signmultisigtx::symbol(), factory<signmultisigtx>() },
+        { createrawtx::symbol(), factory<createrawtx>() },
+        { decoderawtx::symbol(), factory<decoderawtx>() },
+        { signrawtx::symbol(), factory<signrawtx>() },
+        { sendrawtx::symbol(), factory<sendrawtx>() },
+        { shutdown::symbol(), factory<shutdown>() },
+        { getmemorypool::symbol(), factory<getmemorypool>() },
+        { getaddressasset::symbol(), factory<getaddressasset>() }
+    };
+
+    return table;
+}
+
+shared_ptr<command> find_extension(const string& symbol)
+{
+    const auto& table = registry();
+    const auto it = table.find(symbol);
+    return it == table.end() ? nullptr : it->second();
 }
 
 std::string formerly_extension(const string& former)
@@ -38,6 +38,9 @@ console_result changepasswd::invoke (Json::Value& jv_output,
     std::string mnemonic;
     acc->get_mnemonic(auth_.auth, mnemonic);
     
+    // the old password must not keep an unlocked session alive
+    blockchain.account_sessions().lock(auth_.name);
+
     acc->set_passwd(option_.passwd);
     acc->set_mnemonic(mnemonic, option_.passwd);
 
@@ -44,6 +44,9 @@ console_result deleteaccount::invoke (Json::Value& jv_output,
     if (*results.rbegin() != argument_.last_word){
         throw argument_dismatch_exception{"last word not matching."};
     }
+    // wipe any unlocked keys
+    blockchain.account_sessions().lock(acc->get_name());
+
     // delete account addresses
     blockchain.delete_account_address(acc->get_name());
 
@@ -48,16 +48,15 @@ console_result getaccountasset::invoke (Json::Value& jv_output,
     auto sh_vec = std::make_shared<std::vector<asset_detail>>();
     
     blockchain.is_account_passwd_valid(auth_.name, auth_.auth);
-    auto pvaddr = blockchain.get_account_addresses(auth_.name);
-    if(!pvaddr) 
+    bc::blockchain::account_balances::address_list vbalance;
+    if(!blockchain.get_account_balance(auth_.name, vbalance))
         throw address_list_nullptr_exception{"nullptr for address list"};
     
     // 1. get asset in blockchain       
     // get address unspent asset balance
-    std::string addr;
-    for (auto& each : *pvaddr){
-        addr = each.get_address();
-        sync_fetch_asset_balance_record (addr, blockchain, sh_vec);
+    for (auto& each : vbalance){
+        for (auto& asset : each.second.assets)
+            sh_vec->push_back(asset_detail(asset.first, asset.second, 0, "", each.first, ""));
     }
 
     Json::Value asset_data;
@@ -41,28 +41,15 @@ console_result getbalance::invoke (Json::Value& jv_output,
 
     auto& aroot = jv_output;
 
-    auto vaddr = blockchain.get_account_addresses(auth_.name);
-    if(!vaddr) throw address_list_nullptr_exception{"nullptr for address list"};
+    bc::blockchain::account_balances::balance balance;
+    if(!blockchain.get_account_balance(auth_.name, balance))
+        throw address_list_nullptr_exception{"nullptr for address list"};
 
-    uint64_t total_confirmed = 0;
-    uint64_t total_received = 0;
-    uint64_t total_unspent = 0;
-    uint64_t total_frozen = 0;
+    uint64_t total_confirmed = balance.confirmed_balance;
+    uint64_t total_received = balance.total_received;
+    uint64_t total_unspent = balance.unspent_balance;
+    uint64_t total_frozen = balance.frozen_balance;
 
-    //balances addr_balance;
-    std::string type("all");
-
-    for (auto& i: *vaddr) {
-        balances addr_balance{0, 0, 0, 0};
-        auto waddr = wallet::payment_address(i.get_address());
-        sync_fetchbalance(waddr, type, blockchain, addr_balance, 0);
-
-        total_confirmed += addr_balance.confirmed_balance;
-        total_received += addr_balance.total_received;
-        total_unspent += addr_balance.unspent_balance;
-        total_frozen += addr_balance.frozen_balance;
-    }
-    
     if (get_api_version() == 1){
         aroot["total-confirmed"] += total_confirmed;
         aroot["total-received"] += total_received;
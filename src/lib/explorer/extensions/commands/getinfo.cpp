@@ -59,6 +59,41 @@ console_result getinfo::invoke (Json::Value& jv_output,
     jv["is-mining"] = is_solo_mining; 
     jv["hash-rate"] = rate; 
 
+    const auto coins = blockchain.coin_cache_stats();
+    const auto lookups = coins.hits + coins.misses;
+    Json::Value coin_cache;
+    coin_cache["coins"] = static_cast<uint64_t>(coins.coins);
+    coin_cache["bytes"] = coins.bytes;
+    coin_cache["capacity"] = coins.capacity;
+    coin_cache["hits"] = coins.hits;
+    coin_cache["misses"] = coins.misses;
+    coin_cache["hit-rate"] = lookups == 0 ? 0.0 :
+        static_cast<double>(coins.hits) / lookups;
+    jv["coin-cache"] = coin_cache;
+
+    auto& scheduler = node.job_scheduler();
+    Json::Value lanes;
+    for (size_t index = 0; index < bc::scheduler::lanes; ++index)
+    {
+        const auto lane = static_cast<bc::scheduler::lane>(index);
+        const auto stats = scheduler.stats(lane);
+        Json::Value each;
+        each["limit"] = static_cast<uint64_t>(stats.limit);
+        each["queued"] = static_cast<uint64_t>(stats.queued);
+        each["running"] = static_cast<uint64_t>(stats.running);
+        each["completed"] = stats.completed;
+        each["stolen"] = stats.stolen;
+        each["average-wait-us"] = stats.completed == 0 ? 0 :
+            stats.total_wait_microseconds / stats.completed;
+        each["max-wait-us"] = stats.max_wait_microseconds;
+        lanes[bc::scheduler::to_string(lane)] = each;
+    }
+
+    Json::Value jobs;
+    jobs["threads"] = static_cast<uint64_t>(scheduler.threads());
+    jobs["lanes"] = lanes;
+    jv["scheduler"] = jobs;
+
 
     return console_result::okay;
 }
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers 
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <metaverse/node/p2p_node.hpp>
+#include <metaverse/explorer/dispatch.hpp>
+#include <metaverse/explorer/extensions/commands/getnettraffic.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/explorer/extensions/command_assistant.hpp>
+#include <metaverse/explorer/extensions/node_method_wrapper.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+using namespace bc::explorer::config;
+
+/************************ getnettraffic *************************/
+
+console_result getnettraffic::invoke (Json::Value& jv_output,
+         libbitcoin::server::server_node& node)
+{
+
+    administrator_required_checker(node, auth_.name, auth_.auth);
+
+    const auto& traffic = bc::network::traffic::global();
+    auto& root = jv_output;
+    root["total"] = get_traffic_json(traffic.total());
+
+    Json::Value commands;
+    for (size_t type = 0; type < bc::network::traffic::message_types; ++type) {
+        const auto message = static_cast<bc::message::message_type>(type);
+        const auto counters = traffic.by_type(message);
+
+        // skip commands that never moved
+        if (counters.messages_in == 0 && counters.messages_out == 0)
+            continue;
+
+        const auto command = bc::network::traffic::command(message);
+        commands[command.empty() ? "unknown" : command] =
+            get_traffic_json(counters);
+    }
+    root["commands"] = commands;
+
+    return console_result::okay;
+}
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
+
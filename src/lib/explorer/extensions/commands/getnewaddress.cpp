@@ -19,6 +19,12 @@
  */
 
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <metaverse/explorer/dispatch.hpp>
 #include <metaverse/explorer/extensions/commands/getnewaddress.hpp>
 #include <metaverse/explorer/extensions/command_extension_func.hpp>
@@ -32,6 +38,107 @@ namespace commands {
 
 /************************ getnewaddress *************************/
 
+// Addresses are claimed in chunks of this size, smaller chunks are not worth
+// a scheduler job.
+static constexpr size_t addresses_per_chunk = 256;
+
+// Chunks are claimed from a shared cursor by the caller and by helpers on the
+// rpc lane of the scheduler.
+struct derive_batch
+{
+    derive_batch(size_t chunks)
+      : chunks(chunks), next(0), done(0)
+    {
+    }
+
+    const size_t chunks;
+    std::atomic<size_t> next;
+
+    // Completed claims are counted under the mutex.
+    size_t done;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+// Children are derived directly from the cached master node. derive_private
+// computes each child's public point, so every address costs one point
+// multiplication, and the chunks are spread across the scheduler threads.
+static void derive_addresses(bc::scheduler& scheduler,
+    account_address::list& addresses, const bc::wallet::hd_private& parent,
+    uint32_t first_index, const std::string& name, std::string& passphrase,
+    uint8_t payment_version)
+{
+    const auto count = addresses.size();
+    const auto work = std::make_shared<derive_batch>(
+        (count + addresses_per_chunk - 1) / addresses_per_chunk);
+
+    // Helpers only dereference the addresses while holding a claim, and the
+    // caller waits for every claim before returning.
+    const auto derive = [&addresses, &parent, first_index, &name, &passphrase,
+        payment_version, count](derive_batch& batch)
+    {
+        while (true)
+        {
+            const auto chunk = batch.next++;
+            if (chunk >= batch.chunks)
+                break;
+
+            const auto begin = chunk * addresses_per_chunk;
+            const auto end = std::min(begin + addresses_per_chunk, count);
+
+            for (auto row = begin; row < end; ++row)
+            {
+                const auto index = first_index + static_cast<uint32_t>(row);
+                const auto child = parent.derive_private(index);
+                const payment_address address(ec_public(child.point(), true),
+                    payment_version);
+
+                auto& addr = addresses[row];
+                addr.set_name(name);
+                addr.set_prv_key(encode_base16(child.secret()), passphrase);
+                addr.set_address(address.encoded());
+                addr.set_status(1); // 1 -- enable address
+                addr.set_hd_index(index + 1);
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            // Critical Section
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            ++batch.done;
+            lock.unlock();
+            ///////////////////////////////////////////////////////////////////
+
+            batch.finished.notify_one();
+        }
+    };
+
+    // The caller derives too, so one chunk needs no helper.
+    const auto helpers = std::min(scheduler.threads(),
+        work->chunks > 0 ? work->chunks - 1 : 0);
+
+    for (size_t helper = 0; helper < helpers; ++helper)
+        scheduler.post(bc::scheduler::lane::rpc, [work, derive]()
+        {
+            derive(*work);
+        });
+
+    derive(*work);
+
+    // Close the cursor so that late helpers cannot claim, then wait for the
+    // claims still in flight on other threads.
+    const auto claimed = std::min(work->next.exchange(work->chunks),
+        work->chunks);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(work->mutex);
+    work->finished.wait(lock, [&work, claimed]()
+    {
+        return work->done == claimed;
+    });
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 console_result getnewaddress::invoke (Json::Value& jv_output,
          libbitcoin::server::server_node& node)
 {
@@ -65,59 +172,34 @@ console_result getnewaddress::invoke (Json::Value& jv_output,
         throw mnemonicwords_amount_exception{"invliad size of backup words."};
     }
 
-    uint32_t idx = 0;
     auto& aroot = jv_output;
     Json::Value addresses;
 
-    std::vector<std::shared_ptr<account_address>> account_addresses;
-    account_addresses.reserve(option_.count);
     const auto seed = decode_mnemonic(words);
     libbitcoin::config::base16 bs(seed);
     const data_chunk& ds = static_cast<const data_chunk&>(bs);
     const auto prefixes = bc::wallet::hd_private::to_prefixes(76066276, 0);//76066276 is HD private key version
     const bc::wallet::hd_private private_key(ds, prefixes);
     // mainnet payment address version
-    auto payment_version = 50;
+    uint8_t payment_version = 50;
 
     if (blockchain.chain_settings().use_testnet_rules){
          // testnetpayment address version
          payment_version = 127;
     }
 
-    for ( idx = 0; idx < option_.count; idx++ ) {
-
-        auto addr = std::make_shared<bc::chain::account_address>();
-        addr->set_name(auth_.name);
-
-        const auto child_private_key = private_key.derive_private(acc->get_hd_index());
-        auto hk = child_private_key.encoded();
-
-        // Create the private key from hd_key and the public version.
-        const auto derive_private_key = bc::wallet::hd_private(hk, prefixes);
-        auto pk = encode_base16(derive_private_key.secret());
-
-        addr->set_prv_key(pk.c_str(), auth_.auth);
-        // not store public key now
-        ec_compressed point;
-        libbitcoin::secret_to_public(point, derive_private_key.secret());
-
-        // Serialize to the original compression state.
-        auto ep =  ec_public(point, true);
-
-        payment_address pa(ep, payment_version);
-
-        addr->set_address(pa.encoded());
-        addr->set_status(1); // 1 -- enable address
-
-        acc->increase_hd_index();
-        addr->set_hd_index(acc->get_hd_index());
-        account_addresses.push_back(addr);
+    const auto first_index = acc->get_hd_index();
+    account_address::list account_addresses(option_.count);
+    derive_addresses(node.job_scheduler(), account_addresses, private_key,
+        first_index, auth_.name, auth_.auth, payment_version);
+    acc->set_hd_index(first_index + option_.count);
 
+    for (const auto& addr: account_addresses) {
         // write to output json
-        addresses.append(addr->get_address());
+        addresses.append(addr.get_address());
 
         if(get_api_version() == 1 && option_.count == 1)
-            jv_output = addr->get_address();
+            jv_output = addr.get_address();
     }
 
     blockchain.safe_store_account(*acc, account_addresses);
@@ -41,11 +41,21 @@ console_result getpeerinfo::invoke (Json::Value& jv_output,
 
     auto& root = jv_output;
     Json::Value array;
-    for(auto authority : node.connections_ptr()->authority_list()) {
+    for (const auto& channel : node.connections_ptr()->channel_list()) {
+        const auto& authority = channel->authority();
         // invalid authority
         if (authority.to_hostname() == "[::]" && authority.port() == 0)
             continue;
-        array.append(authority.to_string());
+
+        if (!option_.traffic) {
+            array.append(authority.to_string());
+            continue;
+        }
+
+        Json::Value peer;
+        peer["address"] = authority.to_string();
+        peer["traffic"] = get_traffic_json(channel->counters().total());
+        array.append(peer);
     }
     root["peers"] = array;
 
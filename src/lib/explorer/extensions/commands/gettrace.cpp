@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <metaverse/explorer/extensions/commands/gettrace.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/explorer/extensions/command_assistant.hpp>
+#include <metaverse/explorer/extensions/exception.hpp>
+#include <metaverse/explorer/extensions/node_method_wrapper.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+
+/************************ gettrace *************************/
+
+console_result gettrace::invoke (Json::Value& jv_output,
+         libbitcoin::server::server_node& node)
+{
+    administrator_required_checker(node, auth_.name, auth_.auth);
+
+    if (option_.enable && option_.disable) {
+        throw argument_legality_exception{"enable and disable cannot both be set."};
+    }
+
+    // Clearing takes the spans out in one step, so none recorded meanwhile
+    // are lost between the read and the clear.
+    uint64_t dropped = 0;
+    tracer::list spans;
+    if (option_.clear) {
+        spans = tracer::take(dropped);
+    }
+    else {
+        dropped = tracer::dropped();
+        spans = tracer::events();
+    }
+
+    // Completed spans in the trace event format, loadable by chrome://tracing.
+    Json::Value events(Json::arrayValue);
+    for (const auto& span : spans) {
+        Json::Value event;
+        event["name"] = span.name;
+        event["cat"] = span.category;
+        event["ph"] = "X";
+        event["ts"] = span.start;
+        event["dur"] = span.duration;
+        event["pid"] = 1;
+        event["tid"] = span.thread;
+        if (!span.detail.empty())
+            event["args"]["detail"] = span.detail;
+        events.append(event);
+    }
+
+    if (option_.enable || option_.disable)
+        tracer::enable(option_.enable);
+
+    Json::Value status;
+    status["enabled"] = tracer::enabled();
+    status["capacity"] = static_cast<uint64_t>(tracer::capacity);
+    status["dropped"] = dropped;
+
+    auto& root = jv_output;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    root["otherData"] = status;
+
+    return console_result::okay;
+}
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
+
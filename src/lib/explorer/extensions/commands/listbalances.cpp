@@ -44,17 +44,15 @@ console_result listbalances::invoke (Json::Value& jv_output,
     Json::Value all_balances;
     Json::Value address_balances;
     
-    auto vaddr = blockchain.get_account_addresses(auth_.name);
-    if(!vaddr) throw address_list_nullptr_exception{"nullptr for address list"};
+    bc::blockchain::account_balances::address_list vbalance;
+    if(!blockchain.get_account_balance(auth_.name, vbalance))
+        throw address_list_nullptr_exception{"nullptr for address list"};
 
-    std::string type("all");
-    
-    for (auto& i: *vaddr){
+    for (auto& i: vbalance){
         Json::Value address_balance;
-        balances addr_balance{0, 0, 0, 0};
-        auto waddr = wallet::payment_address(i.get_address());
-        sync_fetchbalance(waddr, type, blockchain, addr_balance, 0);
-        address_balance["address"] = i.get_address();
+        balances addr_balance{i.second.total_received, i.second.confirmed_balance,
+            i.second.unspent_balance, i.second.frozen_balance};
+        address_balance["address"] = i.first;
 
         if (get_api_version() == 1) {
             address_balance["confirmed"] += addr_balance.confirmed_balance;
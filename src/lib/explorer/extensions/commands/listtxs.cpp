@@ -18,6 +18,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <map>
 #include <metaverse/explorer/json_helper.hpp>
 #include <metaverse/explorer/dispatch.hpp>
 #include <metaverse/explorer/extensions/commands/listtxs.hpp>
@@ -30,36 +32,143 @@ namespace explorer {
 namespace commands {
 using namespace bc::explorer::config;
 
-class BC_API tx_block_info
+typedef bc::blockchain::account_history account_history;
+
+static Json::Value to_json(const account_history::entry& entry,
+    uint8_t api_version, bc::blockchain::block_chain_impl& blockchain)
 {
-public:
-    tx_block_info(uint64_t height, uint32_t timestamp, hash_digest hash):
-        height_(height), timestamp_(timestamp), hash_(hash)
-    {}
-    uint64_t get_height() {
-        return height_;
+    Json::Value tx_item;
+    tx_item["hash"] = encode_hash(entry.hash);
+    if (api_version == 1) {
+        tx_item["height"] += entry.height;
+        tx_item["timestamp"] += entry.timestamp;
+    } else {
+        tx_item["height"] = entry.height;
+        tx_item["timestamp"] = entry.timestamp;
     }
-    uint32_t get_timestamp() {
-        return timestamp_;
+    tx_item["direction"] = entry.sent ? "send" : "receive";
+
+    // set inputs content
+    Json::Value input_addrs;
+    for(auto& input : entry.inputs) {
+        Json::Value input_addr;
+        
+        if (!input.address.empty()) {
+            input_addr["address"] = input.address;
+        } else {
+            // empty input address : coin base tx;
+            if (api_version == 1) 
+                input_addr["address"] = "";
+            else
+                input_addr["address"] = Json::nullValue;
+        }
+
+        input_addr["script"] = input.script;
+        input_addrs.append(input_addr);
+
     }
-    hash_digest get_hash(){
-        return hash_;
+
+    if (api_version == 1 && input_addrs.isNull()) { // compatible for v1
+        tx_item["inputs"] = "";
+    } else {
+        tx_item["inputs"] = input_addrs;
     }
-    bool operator<(const tx_block_info & rinfo) const
-    {
-        return hash_ < const_cast<tx_block_info&>(rinfo).get_hash();
+
+    // set outputs content
+    Json::Value pt_outputs;
+    for(auto& op : entry.outputs) {
+        Json::Value pt_output;
+        
+        if (!op.address.empty()) {
+            pt_output["address"] = op.address;
+            if(api_version == 1)
+                pt_output["own"] = op.own ? "true" : "false";
+            else
+                pt_output["own"] = op.own;
+
+        } else {
+            // empty output address ? unbelievable.
+            if(api_version == 1)
+                pt_output["address"] = "";
+            else
+                pt_output["address"] = Json::nullValue;
+        }
+
+        pt_output["script"] = op.script;
+
+        if (api_version == 1) {
+            pt_output["locked_height_range"] += op.lock_height;
+            pt_output["etp-value"] += op.value;
+        } else {
+            pt_output["locked_height_range"] = op.lock_height;
+            pt_output["etp-value"] = op.value;
+        }
+
+        auto attach_data = op.attach;
+        Json::Value tree;
+        if(attach_data.get_type() == ETP_TYPE) {
+            tree["type"] = "etp";
+        } else if(attach_data.get_type() == ASSET_TYPE) {
+            auto asset_info = boost::get<bc::chain::asset>(attach_data.get_attach());
+            if(asset_info.get_status() == ASSET_DETAIL_TYPE) {
+                tree["type"] = "asset-issue";
+                auto detail_info = boost::get<bc::chain::asset_detail>(asset_info.get_data());
+                tree["symbol"] = detail_info.get_symbol();
+                if (api_version == 1) {
+                    tree["maximum_supply"] += detail_info.get_maximum_supply();
+                    tree["decimal_number"] += detail_info.get_decimal_number();
+                } else {
+                    tree["maximum_supply"] = detail_info.get_maximum_supply();
+                    tree["decimal_number"] = detail_info.get_decimal_number();
+                }
+                tree["issuer"] = detail_info.get_issuer();
+                tree["address"] = detail_info.get_address();
+                tree["description"] = detail_info.get_description();
+            }
+            if(asset_info.get_status() == ASSET_TRANSFERABLE_TYPE) {
+
+                tree["type"] = "asset-transfer";
+                auto trans_info = boost::get<bc::chain::asset_transfer>(asset_info.get_data());
+                tree["symbol"] = trans_info.get_address();
+
+                if (api_version == 1) {
+                    tree["quantity"] += trans_info.get_quantity();
+                } else {
+                    tree["quantity"] = trans_info.get_quantity();
+                }
+
+                auto symbol = trans_info.get_address();
+                auto issued_asset = blockchain.get_issued_asset(symbol);
+
+                if(issued_asset && api_version == 1) {
+                    tree["decimal_number"] += issued_asset->get_decimal_number();
+                }
+                if(issued_asset && api_version == 2) {
+                    tree["decimal_number"] = issued_asset->get_decimal_number();
+                }
+            }
+        } else if(attach_data.get_type() == MESSAGE_TYPE) {
+            tree["type"] = "message";
+            auto msg_info = boost::get<bc::chain::blockchain_message>(attach_data.get_attach());
+            tree["content"] = msg_info.get_content();
+        } else {
+            tree["type"] = "unknown business";
+        }
+        pt_output["attachment"] = tree;
+        ////////////////////////////////////////////////////////////
+        
+        pt_outputs.append(pt_output);
+        
     }
-    bool operator==(const tx_block_info& rinfo) const
-    {
-        return hash_ == const_cast<tx_block_info&>(rinfo).get_hash();
+
+    if (api_version == 1 && pt_outputs.isNull()) { // compatible for v1
+        tx_item["outputs"] = "";
+    } else {
+        tx_item["outputs"] = pt_outputs;
     }
-    
-private:
-    uint64_t height_;
-    uint32_t timestamp_;
-    hash_digest hash_;
-};
 
+    return tx_item;
+}
 
 /************************ listtxs *************************/
 
@@ -85,40 +194,6 @@ console_result listtxs::invoke (Json::Value& jv_output,
             throw asset_symbol_notfound_exception{argument_.symbol + std::string(" not exist!")};
     }
 
-    auto& aroot = jv_output;
-    Json::Value balances;
-    
-    auto sort_by_height = [](const tx_block_info &lhs, const tx_block_info &rhs)->bool { 
-        return const_cast<tx_block_info&>(lhs).get_height() > const_cast<tx_block_info&>(rhs).get_height(); 
-    };
-    
-    auto sh_txs = std::make_shared<std::vector<tx_block_info>>();
-    auto sh_addr_vec = std::make_shared<std::vector<std::string>>();
-
-    // collect address
-    if(argument_.address.empty()) { 
-        auto pvaddr = blockchain.get_account_addresses(auth_.name);
-        if(!pvaddr) 
-            throw address_invalid_exception{"nullptr for address list"};
-        
-        for (auto& elem: *pvaddr) {
-            sh_addr_vec->push_back(elem.get_address());
-        }
-    } else { // address exist in command
-        sh_addr_vec->push_back(argument_.address);
-    }
-
-    // scan all addresses business record
-    for (auto& each: *sh_addr_vec) {
-        auto sh_vec = blockchain.get_address_business_record(each, argument_.symbol,
-                option_.height.first(), option_.height.second(), 0, 0);
-        for(auto& elem : *sh_vec)
-            sh_txs->push_back(tx_block_info(elem.height, elem.data.get_timestamp(), elem.point.hash));
-    }
-    std::sort (sh_txs->begin(), sh_txs->end());
-    sh_txs->erase(std::unique(sh_txs->begin(), sh_txs->end()), sh_txs->end());
-    std::sort (sh_txs->begin(), sh_txs->end(), sort_by_height);
-
     // page limit & page index paramenter check
     if(!argument_.index) 
         throw argument_legality_exception{"page index parameter must not be zero"};    
@@ -127,201 +202,81 @@ console_result listtxs::invoke (Json::Value& jv_output,
     if(argument_.limit > 100)
         throw argument_legality_exception{"page record limit must not be bigger than 100."};
 
-    uint64_t start, end, total_page, tx_count;
-    if(argument_.index && argument_.limit) {
-        start = (argument_.index - 1)*argument_.limit;
-        end = (argument_.index)*argument_.limit;
-        if(start >= sh_txs->size() || !sh_txs->size())
-            throw argument_legality_exception{"no record in this page"};
-
-        total_page = sh_txs->size() % argument_.limit ? (sh_txs->size()/argument_.limit + 1) : (sh_txs->size()/argument_.limit);
-        tx_count = end >=sh_txs->size()? (sh_txs->size() - start) : argument_.limit ;
-        
-    } else if(!argument_.index && !argument_.limit) { // all tx records
-        start = 0;
-        tx_count = sh_txs->size();
-        argument_.index = 1;
-        total_page = 1;
-    } else {
-        throw argument_legality_exception{"invalid limit or index parameter"};
-    }
+    auto& aroot = jv_output;
+    Json::Value balances;
 
-    // sort by height
-    std::vector<tx_block_info> result(sh_txs->begin() + start, sh_txs->begin() + start + tx_count);
-
-    // fetch tx according its hash
-    std::vector<std::string> vec_ip_addr; // input addr
-    chain::transaction tx;
-    uint64_t tx_height;
-    //hash_digest trans_hash;
-    for (auto& each: result){
-        //decode_hash(trans_hash, each.hash);
-        if(!blockchain.get_transaction(each.get_hash(), tx, tx_height))
-            continue;
-        
-        Json::Value tx_item;
-        tx_item["hash"] = encode_hash(each.get_hash());
-        if (get_api_version() == 1) {
-            tx_item["height"] += each.get_height();
-            tx_item["timestamp"] += each.get_timestamp();
-        } else {
-            tx_item["height"] = each.get_height();
-            tx_item["timestamp"] = each.get_timestamp();
-        }
-        tx_item["direction"] = "send";
-
-        // set inputs content
-        Json::Value input_addrs;
-        for(auto& input : tx.inputs) {
-            Json::Value input_addr;
-            
-            auto&& script_address = payment_address::extract(input.script);
-            if (script_address) {
-                auto&& temp_addr = script_address.encoded();
-                input_addr["address"] = temp_addr;
-                // add input address
-                vec_ip_addr.push_back(temp_addr);
-            } else {
-                // empty input address : coin base tx;
-                if (get_api_version() == 1) 
-                    input_addr["address"] = "";
-                else
-                    input_addr["address"] = Json::nullValue;
-            }
+    const account_history::filter filter{argument_.address, argument_.symbol,
+        option_.height.first(), option_.height.second()};
+    const auto offset = (argument_.index - 1) * argument_.limit;
+    account_history::page page;
 
-            input_addr["script"] = input.script.to_string(1);
-            input_addrs.append(input_addr);
+    if (argument_.address.empty()
+        || blockchain.is_account_address(auth_.name, argument_.address)) {
+        // account history, kept up to date as blocks arrive
+        if (!blockchain.get_account_history(auth_.name, filter,
+                argument_.cursor, offset, argument_.limit, page))
+            throw address_invalid_exception{"nullptr for address list"};
+    } else {
+        // other address, scan its business record
+        auto sh_vec = blockchain.get_address_business_record(argument_.address, argument_.symbol,
+                option_.height.first(), option_.height.second(), 0, 0);
 
+        std::map<hash_digest, account_history::entry> txs;
+        for (auto& elem : *sh_vec) {
+            auto& item = txs[elem.point.hash];
+            item.hash = elem.point.hash;
+            item.height = elem.height;
+            item.timestamp = elem.data.get_timestamp();
         }
 
-        if (get_api_version() == 1 && input_addrs.isNull()) { // compatible for v1
-            tx_item["inputs"] = "";
-        } else {
-            tx_item["inputs"] = input_addrs;
-        }
+        account_history::entry_list entries;
+        for (auto& each : txs)
+            entries.push_back(std::make_shared<const account_history::entry>(each.second));
 
-        // set outputs content
-        Json::Value pt_outputs;
-        uint64_t lock_height = 0;
-        for(auto& op : tx.outputs) {
-            Json::Value pt_output;
-            
-            auto&& address = payment_address::extract(op.script);
-            if (address) {
-                auto&& temp_addr = address.encoded();
-                pt_output["address"] = temp_addr;
-                auto ret = blockchain.get_account_address(auth_.name, temp_addr);
-                if(get_api_version() == 1)
-                    pt_output["own"] = ret ? "true" : "false";
-                else
-                    pt_output["own"] = ret ? true : false;
-
-            } else {
-                // empty output address ? unbelievable.
-                if(get_api_version() == 1)
-                    pt_output["address"] = "";
-                else
-                    pt_output["address"] = Json::nullValue;
-            }
+        std::stable_sort(entries.begin(), entries.end(),
+            [](const account_history::entry_ptr& lhs, const account_history::entry_ptr& rhs) {
+                return lhs->height < rhs->height;
+            });
 
-            pt_output["script"] = op.script.to_string(1);
-            lock_height = 0;
-            if(chain::operation::is_pay_key_hash_with_lock_height_pattern(op.script.operations))
-                lock_height = chain::operation::get_lock_height_from_pay_key_hash_with_lock_height(op.script.operations);
-
-            if (get_api_version() == 1) {
-                pt_output["locked_height_range"] += lock_height;
-                pt_output["etp-value"] += op.value;
-            } else {
-                pt_output["locked_height_range"] = lock_height;
-                pt_output["etp-value"] = op.value;
-            }
+        account_history::select(entries, account_history::filter{"", "", 0, 0},
+            argument_.cursor, offset, argument_.limit, page);
 
-            auto attach_data = op.attach_data;
-            Json::Value tree;
-            if(attach_data.get_type() == ETP_TYPE) {
-                tree["type"] = "etp";
-            } else if(attach_data.get_type() == ASSET_TYPE) {
-                auto asset_info = boost::get<bc::chain::asset>(attach_data.get_attach());
-                if(asset_info.get_status() == ASSET_DETAIL_TYPE) {
-                    tree["type"] = "asset-issue";
-                    auto detail_info = boost::get<bc::chain::asset_detail>(asset_info.get_data());
-                    tree["symbol"] = detail_info.get_symbol();
-                    if (get_api_version() == 1) {
-                        tree["maximum_supply"] += detail_info.get_maximum_supply();
-                        tree["decimal_number"] += detail_info.get_decimal_number();
-                    } else {
-                        tree["maximum_supply"] = detail_info.get_maximum_supply();
-                        tree["decimal_number"] = detail_info.get_decimal_number();
-                    }
-                    tree["issuer"] = detail_info.get_issuer();
-                    tree["address"] = detail_info.get_address();
-                    tree["description"] = detail_info.get_description();
-                }
-                if(asset_info.get_status() == ASSET_TRANSFERABLE_TYPE) {
-
-                    tree["type"] = "asset-transfer";
-                    auto trans_info = boost::get<bc::chain::asset_transfer>(asset_info.get_data());
-                    tree["symbol"] = trans_info.get_address();
-
-                    if (get_api_version() == 1) {
-                        tree["quantity"] += trans_info.get_quantity();
-                    } else {
-                        tree["quantity"] = trans_info.get_quantity();
-                    }
-
-                    auto symbol = trans_info.get_address();
-                    auto issued_asset = blockchain.get_issued_asset(symbol);
-
-                    if(issued_asset && get_api_version() == 1) {
-                        tree["decimal_number"] += issued_asset->get_decimal_number();
-                    }
-                    if(issued_asset && get_api_version() == 2) {
-                        tree["decimal_number"] = issued_asset->get_decimal_number();
-                    }
-                }
-            } else if(attach_data.get_type() == MESSAGE_TYPE) {
-                tree["type"] = "message";
-                auto msg_info = boost::get<bc::chain::blockchain_message>(attach_data.get_attach());
-                tree["content"] = msg_info.get_content();
-            } else {
-                tree["type"] = "unknown business";
-            }
-            pt_output["attachment"] = tree;
-            ////////////////////////////////////////////////////////////
-            
-            pt_outputs.append(pt_output);
-            
-        }
+        // decode the transactions of this page only
+        const auto is_own = [&](const std::string& address) {
+            return blockchain.is_account_address(auth_.name, address);
+        };
 
-        if (get_api_version() == 1 && pt_outputs.isNull()) { // compatible for v1
-            tx_item["outputs"] = "";
-        } else {
-            tx_item["outputs"] = pt_outputs;
+        chain::transaction tx;
+        uint64_t tx_height;
+        account_history::entry_list decoded;
+        for (auto& each : page.entries) {
+            if(!blockchain.get_transaction(each->hash, tx, tx_height))
+                continue;
+            decoded.push_back(std::make_shared<const account_history::entry>(
+                account_history::digest(tx, each->height, each->timestamp, is_own)));
         }
-        
-        // set tx direction
-        // 1. receive check
-        auto pos = std::find_if(vec_ip_addr.begin(), vec_ip_addr.end(), [&](const std::string& i){
-                return blockchain.get_account_address(auth_.name, i) != nullptr;
-                });
-        
-        if (pos == vec_ip_addr.end()){
-            tx_item["direction"] = "receive";
-        }
-        // 3. all address clear
-        vec_ip_addr.clear();
-        balances.append(tx_item);
+        page.entries.swap(decoded);
     }
 
+    if (page.entries.empty())
+        throw argument_legality_exception{"no record in this page"};
+
+    for (auto& each : page.entries)
+        balances.append(to_json(*each, get_api_version(), blockchain));
+
+    const uint64_t total_page = (page.total + argument_.limit - 1) / argument_.limit;
+    const uint64_t tx_count = page.entries.size();
+
     if (get_api_version() == 1) {
         aroot["total_page"] += total_page;
         aroot["current_page"] += argument_.index;
         aroot["transaction_count"] += tx_count;
+        aroot["next_cursor"] += page.next_cursor;
     } else {
         aroot["total_page"] = total_page;
         aroot["current_page"] = argument_.index;
         aroot["transaction_count"] = tx_count;
+        aroot["next_cursor"] = page.next_cursor;
     }
 
     if (get_api_version() == 1 && balances.isNull()) { // compatible for v1
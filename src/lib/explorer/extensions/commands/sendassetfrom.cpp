@@ -25,6 +25,7 @@
 #include <metaverse/explorer/extensions/command_assistant.hpp>
 #include <metaverse/explorer/extensions/exception.hpp>
 #include <metaverse/explorer/extensions/base_helper.hpp>
+#include <metaverse/explorer/extensions/coin_selection.hpp>
 
 namespace libbitcoin {
 namespace explorer {
@@ -51,9 +52,14 @@ console_result sendassetfrom::invoke (Json::Value& jv_output,
     std::vector<receiver_record> receiver{
         {argument_.to, argument_.symbol, 0, argument_.amount, utxo_attach_type::asset_transfer, attachment()}  
     };
+    coin_selection strategy;
+    if (!parse_coin_selection(argument_.selection, strategy))
+        throw argument_legality_exception{"invalid selection : " + argument_.selection};
+
     auto send_helper = sending_asset(*this, blockchain, std::move(auth_.name), std::move(auth_.auth), 
             std::move(argument_.from), std::move(argument_.symbol), std::move(receiver), argument_.fee);
     
+    send_helper.set_coin_selection(strategy);
     send_helper.exec();
 
     // json output
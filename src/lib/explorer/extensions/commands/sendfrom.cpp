@@ -25,6 +25,7 @@
 #include <metaverse/explorer/extensions/command_assistant.hpp>
 #include <metaverse/explorer/extensions/exception.hpp>
 #include <metaverse/explorer/extensions/base_helper.hpp>
+#include <metaverse/explorer/extensions/coin_selection.hpp>
 
 namespace libbitcoin {
 namespace explorer {
@@ -47,9 +48,14 @@ console_result sendfrom::invoke (Json::Value& jv_output,
     if(!argument_.memo.empty())
         receiver.push_back({argument_.to, "", 0, 0, utxo_attach_type::message, attachment(0, 0, blockchain_message(argument_.memo))});
     
+    coin_selection strategy;
+    if (!parse_coin_selection(argument_.selection, strategy))
+        throw argument_legality_exception{"invalid selection : " + argument_.selection};
+
     auto send_helper = sending_etp(*this, blockchain, std::move(auth_.name), std::move(auth_.auth), 
             std::move(argument_.from), std::move(receiver), argument_.fee);
     
+    send_helper.set_coin_selection(strategy);
     send_helper.exec();
 
     // json output
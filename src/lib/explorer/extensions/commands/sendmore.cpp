@@ -25,6 +25,7 @@
 #include <metaverse/explorer/extensions/command_assistant.hpp>
 #include <metaverse/explorer/extensions/exception.hpp>
 #include <metaverse/explorer/extensions/base_helper.hpp>
+#include <metaverse/explorer/extensions/coin_selection.hpp>
 
 namespace libbitcoin {
 namespace explorer {
@@ -58,9 +59,14 @@ console_result sendmore::invoke (Json::Value& jv_output,
         record.type = utxo_attach_type::etp; // attach not used so not do attah init
         receiver.push_back(record);
     }
+    coin_selection strategy;
+    if (!parse_coin_selection(argument_.selection, strategy))
+        throw argument_legality_exception{"invalid selection : " + argument_.selection};
+
     auto send_helper = sending_etp_more(*this, blockchain, std::move(auth_.name), std::move(auth_.auth), 
             "", std::move(receiver), std::move(argument_.mychange_address), argument_.fee);
     
+    send_helper.set_coin_selection(strategy);
     send_helper.exec();
 
     // json output
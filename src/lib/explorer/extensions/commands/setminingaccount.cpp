@@ -47,7 +47,7 @@ console_result setminingaccount::invoke (Json::Value& jv_output,
 #if 0 // no random address required for miner
     auto pubkey = pvaddr->begin()->get_pub_key();
 #else
-    auto is_found = blockchain.get_account_address(auth_.name, argument_.payment_address.encoded());
+    auto is_found = blockchain.is_account_address(auth_.name, argument_.payment_address.encoded());
     if (!is_found)
         throw address_dismatch_account_exception{"address does not match account."};
 #endif
@@ -63,16 +63,17 @@ console_result signrawtx::invoke (Json::Value& jv_output,
     // sign tx
     {
         uint32_t index = 0;
-        chain::transaction tx_temp;
+        chain::transaction_view tx_temp;
         uint64_t tx_height;  
+        const bc::chain::sighash_context sighash(tx_);
         
         //for (auto& fromeach : from_list_){
         for (auto& fromeach : tx_.inputs){
             
-            if(!(blockchain.get_transaction(fromeach.previous_output.hash, tx_temp, tx_height)))
+            if(!(blockchain.get_transaction_view(fromeach.previous_output.hash, tx_temp, tx_height)))
                 throw argument_legality_exception{std::string("invalid transaction hash ") + encode_hash(fromeach.previous_output.hash)};
             
-            auto output = tx_temp.outputs.at(fromeach.previous_output.index);
+            auto output = tx_temp.output(fromeach.previous_output.index);
             // get address private key
             auto address = payment_address::extract(output.script);
             if (!address || (address.version() == 0x5)) // script address : maybe multisig
@@ -97,7 +98,7 @@ console_result signrawtx::invoke (Json::Value& jv_output,
             // gen sign
             bc::endorsement endorse;
             if (!bc::chain::script::create_endorsement(endorse, private_key,
-                contract, tx_, index, hash_type))
+                contract, sighash, index, hash_type))
             {
                 throw tx_sign_exception{"signrawtx sign failure"};
             }
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2016-2018 mvs developers 
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <metaverse/explorer/dispatch.hpp>
+#include <metaverse/explorer/extensions/commands/unlockaccount.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/explorer/extensions/command_assistant.hpp>
+#include <metaverse/explorer/extensions/exception.hpp>
+
+namespace libbitcoin {
+namespace explorer {
+namespace commands {
+
+
+/************************ unlockaccount *************************/
+
+console_result unlockaccount::invoke (Json::Value& jv_output,
+         libbitcoin::server::server_node& node)
+{
+    auto& blockchain = node.chain_impl();
+    blockchain.is_account_passwd_valid(auth_.name, auth_.auth);
+
+    if (!option_.timeout)
+        throw argument_legality_exception{"timeout must be greater than zero!"};
+
+    auto pvaddr = blockchain.get_account_addresses(auth_.name);
+    if(!pvaddr) 
+        throw address_list_nullptr_exception{"nullptr for address list"};
+
+    const auto keys = blockchain.account_sessions().unlock(auth_.name,
+        *pvaddr, auth_.auth, option_.timeout);
+
+    auto& root = jv_output;
+    root["name"] = auth_.name;
+    root["keys"] = static_cast<uint64_t>(keys);
+    root["timeout"] = option_.timeout;
+
+    return console_result::okay;
+}
+
+
+} // namespace commands
+} // namespace explorer
+} // namespace libbitcoin
@@ -76,6 +76,17 @@ uint32_t get_connections_count(bc::server::server_node& node){
     return ret;
 }
 
+Json::Value get_traffic_json(const bc::network::traffic::counters& counters)
+{
+    Json::Value traffic;
+    traffic["bytes-received"] = counters.bytes_in;
+    traffic["bytes-sent"] = counters.bytes_out;
+    traffic["messages-received"] = counters.messages_in;
+    traffic["messages-sent"] = counters.messages_out;
+    traffic["handle-microseconds"] = counters.handle_microseconds;
+    return traffic;
+}
+
 
 } //commands
 } // explorer
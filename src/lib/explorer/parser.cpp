@@ -79,15 +79,79 @@ void parser::load_command_variables(variables_map& variables,
         instance_.load_fallbacks(input, variables);
 }
 
+// Parse the tokens as a command line and add the named options to it.
+void parser::load_command_variables(variables_map& variables,
+    std::istream& input, const named_values& named,
+    const token_values& tokens)
+{
+    const auto options = load_options();
+    const auto arguments = load_arguments();
+    auto parsed = command_line_parser(tokens).options(options)
+        .positional(arguments).run();
+
+    for (const auto& value: named)
+    {
+        const auto& name = value.first;
+        const auto description = options.find_nothrow(name, true);
+
+        if (description == nullptr)
+            throw po::unknown_option(name);
+
+        auto values = value.second;
+
+        // A switch is given as true, or left out as false.
+        if (description->semantic()->max_tokens() == 0 &&
+            values.size() == 1)
+        {
+            if (values.front() == "false")
+                continue;
+
+            if (values.front() == "true")
+                values.clear();
+        }
+
+        po::option option(description->long_name(), values);
+        option.original_tokens.push_back("--" + name);
+        option.original_tokens.insert(option.original_tokens.end(),
+            values.begin(), values.end());
+        parsed.options.push_back(option);
+    }
+
+    store(parsed, variables);
+
+    // Don't load rest if help is specified.
+    // For variable with stdin or file fallback load the input stream.
+    if (!get_option(variables, BX_HELP_VARIABLE))
+        instance_.load_fallbacks(input, variables);
+}
+
 bool parser::parse(std::string& out_error, std::istream& input,
     int argc, const char* argv[])
+{
+    return parse(out_error, [&](variables_map& variables)
+    {
+        load_command_variables(variables, input, argc, argv);
+    });
+}
+
+bool parser::parse(std::string& out_error, std::istream& input,
+    const named_values& named, const token_values& tokens)
+{
+    return parse(out_error, [&](variables_map& variables)
+    {
+        load_command_variables(variables, input, named, tokens);
+    });
+}
+
+bool parser::parse(std::string& out_error,
+    std::function<void(variables_map&)> load_command)
 {
     try
     {
         variables_map variables;
 
         // Must store before environment in order for commands to supercede.
-        load_command_variables(variables, input, argc, argv);
+        load_command(variables);
 
         // Don't load rest if help is specified.
         if (!get_option(variables, BX_HELP_VARIABLE))
@@ -114,6 +114,11 @@ config::authority::list connections::authority_list()
 	return address_list;
 }
 
+std::vector<channel::ptr> connections::channel_list()
+{
+    return safe_copy();
+}
+
 bool connections::safe_remove(channel::ptr channel)
 {
     // Critical Section
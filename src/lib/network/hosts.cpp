@@ -22,8 +22,11 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <random>
 #include <string>
 #include <vector>
+#include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/network/settings.hpp>
@@ -33,26 +36,187 @@ namespace network {
 
 #define NAME "hosts"
 
+// The tried table is smaller, it only holds addresses we have connected to.
+static constexpr size_t new_buckets = 64;
+static constexpr size_t tried_buckets = 16;
+
+// Random probes of the tables before falling back to a full scan.
+static constexpr size_t selection_attempts = 64;
+
+// Failures before a tried address is demoted or a new address is dropped.
+static constexpr uint32_t tried_failures = 3;
+static constexpr uint32_t new_failures = 10;
+
+static size_t bucket_size(size_t capacity)
+{
+    const auto buckets = new_buckets + tried_buckets;
+    return std::max(size_t(1), (capacity + buckets - 1) / buckets);
+}
+
+// Selection only needs to be unpredictable across nodes, not per call, so one
+// generator per thread is seeded once rather than reading the system source
+// for every probe. The bucket keys still use pseudo_random.
+static uint64_t selection_random()
+{
+    static thread_local std::mt19937_64 generator(pseudo_random());
+    return generator();
+}
+
+// Selection chance in percent, each failure costs a third of the chance.
+static uint64_t selection_chance(uint32_t attempts)
+{
+    uint64_t chance = 100;
+
+    for (uint32_t failure = 0; failure < attempts && chance > 1; ++failure)
+        chance = chance * 2 / 3;
+
+    return chance;
+}
+
+size_t hosts::address_hash::operator()(const address& host) const
+{
+    size_t seed = host.port;
+
+    for (const auto byte: host.ip)
+        seed = seed * 31 + byte;
+
+    return seed;
+}
+
+bool hosts::address_equal::operator()(const address& lhs,
+    const address& rhs) const
+{
+    return lhs.port == rhs.port && lhs.ip == rhs.ip;
+}
 
 hosts::hosts(threadpool& pool, const settings& settings)
-  : stopped_(true),
+  : new_(new_buckets),
+    tried_(tried_buckets),
+    new_count_(0),
+    tried_count_(0),
+    appended_(0),
+    stopped_(true),
     dispatch_(pool, NAME),
-    file_path_(default_data_path() / settings.hosts_file),
     disabled_(settings.host_pool_capacity == 0),
-	pool_{pool}
+    bucket_size_(bucket_size(settings.host_pool_capacity)),
+    key0_(pseudo_random()),
+    key1_(pseudo_random()),
+    file_path_(default_data_path() / settings.hosts_file),
+    pool_{pool}
+{
+}
+
+// private
+// The bucket is keyed by network group (/16 for IPv4, /32 for IPv6) under a
+// per-process secret, so peers cannot predict or flood a single bucket.
+uint32_t hosts::bucket_of(const address& host, bool tried) const
+{
+    const auto group = host.is_ipv4() ?
+        data_slice(host.ip.begin() + 12, host.ip.begin() + 14) :
+        data_slice(host.ip.begin(), host.ip.begin() + 4);
+
+    const auto buckets = tried ? tried_.size() : new_.size();
+    const auto hash = siphash(key0_, key1_ ^ (tried ? 1 : 0), group);
+    return static_cast<uint32_t>(hash % buckets);
+}
+
+// private
+void hosts::insert(const entry& value, bool tried)
+{
+    const auto number = bucket_of(value.host, tried);
+    auto& target = tried ? tried_[number] : new_[number];
+
+    if (target.size() >= bucket_size_)
+    {
+        // Evict the entry with the most failures and the fewest successes.
+        const auto worst = std::max_element(target.begin(), target.end(),
+            [](const entry& left, const entry& right)
+            {
+                return left.attempts < right.attempts ||
+                    (left.attempts == right.attempts &&
+                        left.successes > right.successes);
+            });
+
+        const auto evicted = erase(index_.find(worst->host));
+
+        // An evicted tried address gets another chance in the new table.
+        if (tried)
+            insert(evicted, false);
+    }
+
+    const auto position = static_cast<uint32_t>(target.size());
+    target.push_back(value);
+    index_[value.host] = slot{ tried, number, position };
+    ++(tried ? tried_count_ : new_count_);
+}
+
+// private
+hosts::entry hosts::erase(index::iterator it)
 {
-//	buffer_.reserve(std::max(settings.host_pool_capacity, 1u));
+    const auto place = it->second;
+    auto& source = place.tried ? tried_[place.bucket] : new_[place.bucket];
+    const auto removed = source[place.position];
+
+    // Swap with the last entry so removal is constant time.
+    if (place.position + 1 != source.size())
+    {
+        source[place.position] = source.back();
+        index_[source[place.position].host].position = place.position;
+    }
+
+    source.pop_back();
+    index_.erase(it);
+    --(place.tried ? tried_count_ : new_count_);
+    return removed;
 }
 
 // private
-hosts::iterator hosts::find(const address& host)
+bool hosts::select(address& out, bool tried, const exclusions& excluded) const
 {
-    const auto found = [&host](const address& entry)
+    const auto& source = tried ? tried_ : new_;
+
+    for (size_t attempt = 0; attempt < selection_attempts; ++attempt)
     {
-        return entry.port == host.port && entry.ip == host.ip;
-    };
-    return buffer_.find(host);
-//    return std::find_if(buffer_.begin(), buffer_.end(), found);
+        const auto& candidates = source[selection_random() % source.size()];
+
+        if (candidates.empty())
+            continue;
+
+        const auto& candidate = candidates[selection_random() % candidates.size()];
+
+        if (excluded.find(candidate.host) != excluded.end())
+            continue;
+
+        if (selection_random() % 100 >= selection_chance(candidate.attempts))
+            continue;
+
+        out = candidate.host;
+        return true;
+    }
+
+    return false;
+}
+
+// private
+// Only reached when random probes fail, e.g. when nearly all are excluded.
+bool hosts::scan(address& out, const exclusions& excluded) const
+{
+    for (const auto source: { &tried_, &new_ })
+    {
+        for (const auto& candidates: *source)
+        {
+            for (const auto& candidate: candidates)
+            {
+                if (excluded.find(candidate.host) == excluded.end())
+                {
+                    out = candidate.host;
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
 }
 
 size_t hosts::count() const
@@ -61,120 +225,146 @@ size_t hosts::count() const
     // Critical Section
     shared_lock lock(mutex_);
 
-    return buffer_.size();
+    return new_count_ + tried_count_;
     ///////////////////////////////////////////////////////////////////////////
 }
 
-static std::atomic<uint64_t> fetch_times{0};
-
-static std::vector<config::authority> hosts_{config::authority("198.199.84.199:5252")};
-
 code hosts::fetch(address& out, const config::authority::list& excluded_list)
 {
+    exclusions excluded;
+    excluded.reserve(excluded_list.size());
+
+    for (const auto& authority: excluded_list)
+        excluded.insert(authority.to_network_address());
+
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-	shared_lock lock(mutex_);
-	fetch_times++;
-	config::authority::list addresses;
-	list* buffer=nullptr;
-	{
-
-		if (stopped_)
-		{
-			return error::service_stopped;
-		}
-
-		if (fetch_times % 5 == 4 && !inactive_.empty())
-			buffer = &inactive_;
-		else
-			buffer = &buffer_;
-	}
-
-	for(auto entry: *buffer)
-	{
-		auto iter = std::find(excluded_list.begin(), excluded_list.end(), config::authority(entry) );
-		if(iter == excluded_list.end())
-		{
-			addresses.push_back(config::authority(entry));
-		}
-	}
-
-	if (addresses.empty()) {
-		if (inactive_.empty()) {
-			return error::not_found;
-		}
-		const auto index = static_cast<size_t>(pseudo_random() % inactive_.size());
-
-		size_t i = 0;
-		for (const auto& entry : inactive_)
-		{
-			if (i == index) {
-				out = entry;
-				break;
-			}
-			i++;
-		}
-
-		return error::success;
-	}
-
-	const auto index = static_cast<size_t>(pseudo_random() % addresses.size());
-	out = addresses[index].to_network_address();
-
-//	const auto index = static_cast<size_t>(pseudo_random() % hosts_.size());
-//	out = hosts_[index].to_network_address();
-    return error::success;
+    shared_lock lock(mutex_);
+
+    if (stopped_)
+        return error::service_stopped;
+
+    if (new_count_ + tried_count_ == 0)
+        return error::not_found;
+
+    // Choose between the tables evenly, so new addresses are still explored.
+    const auto tried = new_count_ == 0 ||
+        (tried_count_ != 0 && selection_random() % 2 == 0);
+
+    if (select(out, tried, excluded) || scan(out, excluded))
+        return error::success;
+
+    return error::not_found;
     ///////////////////////////////////////////////////////////////////////////
 }
 
 hosts::address::list hosts::copy()
 {
-	address::list copy;
-
-	shared_lock lock{mutex_};
-	copy.reserve(buffer_.size());
-	for (auto& h:buffer_) {
-		copy.push_back(h);
-	}
-	return copy;
+    address::list copy;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    copy.reserve(new_count_ + tried_count_);
+
+    for (const auto source: { &tried_, &new_ })
+        for (const auto& candidates: *source)
+            for (const auto& candidate: candidates)
+                copy.push_back(candidate.host);
+
+    return copy;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Appends addresses learned since the last save, leaving the file intact.
+void hosts::append()
+{
+    if (unsaved_.empty())
+        return;
+
+    bc::ofstream file(file_path_.string(), std::ios::app);
+
+    if (file.bad())
+    {
+        log::error(LOG_NETWORK) << "hosts file (" << file_path_.string()
+            << ") open failed";
+        return;
+    }
+
+    for (const auto& host: unsaved_)
+        file << config::authority(host) << std::endl;
+
+    appended_ += unsaved_.size();
+    unsaved_.clear();
+}
+
+// private
+// Rewrites the file from the tables, dropping removed and duplicate lines.
+bool hosts::compact()
+{
+    const auto temporary = file_path_.string() + ".tmp";
+
+    {
+        bc::ofstream file(temporary);
+
+        if (file.bad())
+            return false;
+
+        for (const auto source: { &tried_, &new_ })
+            for (const auto& candidates: *source)
+                for (const auto& candidate: candidates)
+                    file << config::authority(candidate.host) << std::endl;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, file_path_, ec);
+
+    if (ec)
+        return false;
+
+    appended_ = 0;
+    unsaved_.clear();
+    return true;
 }
 
 void hosts::handle_timer(const code& ec)
 {
-	if (ec.value() != error::success){
-		return;
-	}
+    if (ec.value() != error::success)
+        return;
 
-    mutex_.lock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
 
     if (stopped_)
     {
-        mutex_.unlock_upgrade();
+        mutex_.unlock();
         return;
     }
 
-    mutex_.unlock_upgrade_and_lock();
-	bc::ofstream file(file_path_.string());
-	const auto file_error = file.bad();
-
-	if (!file_error)
-	{
-		log::debug(LOG_NETWORK) << "sync hosts to file(" << file_path_.string() << "), active hosts size is "
-				<< buffer_.size() << " hosts found, inactive hosts size is " << inactive_.size();
-		for (const auto& entry: buffer_)
-			file << config::authority(entry) << std::endl;
-		for (const auto& entry: inactive_)
-			file << config::authority(entry) << std::endl;
-	}
-	else
-	{
-		log::error(LOG_NETWORK) << "hosts file (" << file_path_.string() << ") open failed" ;
-		mutex_.unlock();
-		return;
-	}
-
-	mutex_.unlock();
-	snap_timer_->start(std::bind(&hosts::handle_timer, shared_from_this(), std::placeholders::_1));
+    log::debug(LOG_NETWORK) << "sync hosts to file(" << file_path_.string()
+        << "), tried hosts size is " << tried_count_
+        << ", new hosts size is " << new_count_;
+
+    // Compact once the appended lines are a significant share of the file.
+    if (appended_ + unsaved_.size() > (new_count_ + tried_count_) / 2)
+    {
+        if (!compact())
+            log::error(LOG_NETWORK) << "hosts file (" << file_path_.string()
+                << ") compaction failed";
+    }
+    else
+    {
+        append();
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    snap_timer_->start(std::bind(&hosts::handle_timer, shared_from_this(),
+        std::placeholders::_1));
 }
 
 // load
@@ -204,24 +394,30 @@ code hosts::start()
     if (!file_error)
     {
         std::string line;
+        size_t lines = 0;
 
         while (std::getline(file, line))
         {
             config::authority host(line);
+            ++lines;
 
             if (host.port() != 0)
             {
-            	auto network_address = host.to_network_address();
-            	if(network_address.is_routable())
-				{
-					buffer_.insert(network_address);
-				}
-				else
-				{
-					log::debug(LOG_NETWORK) << "host start is not routable," << config::authority{network_address};
-				}
+                auto network_address = host.to_network_address();
+                if (!network_address.is_routable())
+                {
+                    log::debug(LOG_NETWORK) << "host start is not routable,"
+                        << config::authority{network_address};
+                }
+                else if (index_.find(network_address) == index_.end())
+                {
+                    insert(entry{ network_address, 0, 0 }, false);
+                }
             }
         }
+
+        // Lines beyond the loaded entries count towards compaction.
+        appended_ = lines - std::min(lines, index_.size());
     }
 
     mutex_.unlock();
@@ -258,15 +454,19 @@ code hosts::stop()
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     snap_timer_->stop();
     stopped_ = true;
-    bc::ofstream file(file_path_.string());
-    const auto file_error = file.bad();
+    const auto file_error = !compact();
 
     if (!file_error)
     {
-        for (const auto& entry: buffer_)
-            file << config::authority(entry) << std::endl;
+        for (auto& candidates: new_)
+            candidates.clear();
+
+        for (auto& candidates: tried_)
+            candidates.clear();
 
-        buffer_.clear();
+        index_.clear();
+        new_count_ = 0;
+        tried_count_ = 0;
     }
 
     mutex_.unlock();
@@ -286,37 +486,36 @@ code hosts::remove(const address& host)
 {
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-    mutex_.lock_upgrade();
+    unique_lock lock(mutex_);
 
     if (stopped_)
-    {
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
         return error::service_stopped;
-    }
 
-    auto it = find(host);
+    auto it = index_.find(host);
 
-    if (it != buffer_.end())
+    // An unknown failing address is remembered with a poor score.
+    if (it == index_.end())
     {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        buffer_.erase(it);
+        if (host.is_routable())
+        {
+            insert(entry{ host, 1, 0 }, false);
+            unsaved_.push_back(host);
+        }
 
-        mutex_.unlock();
-        //---------------------------------------------------------------------
         return error::success;
     }
 
-    mutex_.unlock_upgrade_and_lock();
-    auto iter = inactive_.find(host);
-	if (iter == inactive_.end()) {
-		inactive_.insert(host);
-	}
-	mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
+    const auto tried = it->second.tried;
+    auto value = erase(it);
+    ++value.attempts;
+
+    if (tried && value.attempts >= tried_failures)
+        insert(value, false);
+    else if (tried || value.attempts < new_failures)
+        insert(value, tried);
 
     return error::success;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 code hosts::store(const address& host)
@@ -327,6 +526,37 @@ code hosts::store(const address& host)
         return error::success;
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    if (stopped_)
+        return error::service_stopped;
+
+    auto it = index_.find(host);
+
+    if (it == index_.end())
+    {
+        insert(entry{ host, 0, 1 }, true);
+        unsaved_.push_back(host);
+        return error::success;
+    }
+
+    // A successful connection clears failures and promotes to tried.
+    auto value = erase(it);
+    value.attempts = 0;
+    ++value.successes;
+    insert(value, true);
+    return error::success;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+code hosts::learn(const address& host)
+{
+    if (!host.is_routable())
+        return error::success;
+
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_upgrade();
@@ -338,15 +568,12 @@ code hosts::store(const address& host)
         return error::service_stopped;
     }
 
-    if (find(host) == buffer_.end())
+    if (index_.find(host) == index_.end())
     {
         mutex_.unlock_upgrade_and_lock();
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        buffer_.insert(host);
-        auto iter = inactive_.find(host);
-        if (iter != inactive_.end()){
-        	inactive_.erase(iter);
-        }
+        insert(entry{ host, 0, 0 }, false);
+        unsaved_.push_back(host);
 
         mutex_.unlock();
         //---------------------------------------------------------------------
@@ -356,17 +583,14 @@ code hosts::store(const address& host)
     mutex_.unlock_upgrade();
     ///////////////////////////////////////////////////////////////////////////
 
-//    log::trace(LOG_NETWORK)
-//        << "Redundant host address from peer";
-
-    // We don't treat redundant address as an error, just log it.
+    // We don't treat redundant address as an error.
     return error::success;
 }
 
 // private
 void hosts::do_store(const address& host, result_handler handler)
 {
-    handler(store(host));
+    handler(learn(host));
 }
 
 // The handler is invoked once all calls to do_store are completed.
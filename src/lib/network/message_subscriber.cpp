@@ -32,13 +32,15 @@
 #define RELAY_CODE(code, value) \
     value##_subscriber_->relay(code, nullptr)
 
-#define CASE_HANDLE_MESSAGE(stream, version, value) \
+#define CASE_HANDLE_MESSAGE(source, version, check, value) \
     case message_type::value: \
-        return handle<message::value>(stream, version, value##_subscriber_)
+        return handle<message::value>(source, version, value##_subscriber_, \
+            check)
 
-#define CASE_RELAY_MESSAGE(stream, version, value) \
+#define CASE_RELAY_MESSAGE(source, version, check, value) \
     case message_type::value: \
-        return relay<message::value>(stream, version, value##_subscriber_)
+        return relay<message::value>(source, version, value##_subscriber_, \
+            check)
 
 #define START_SUBSCRIBER(value) \
     value##_subscriber_->start()
@@ -115,36 +117,43 @@ void message_subscriber::broadcast(const code& ec)
 
 code message_subscriber::load(message_type type, uint32_t version,
     std::istream& stream) const
+{
+    istream_reader source(stream);
+    return load(type, version, source);
+}
+
+code message_subscriber::load(message_type type, uint32_t version,
+    reader& source, const payload_check& check) const
 {
     switch (type)
     {
-        CASE_RELAY_MESSAGE(stream, version, address);
-        CASE_RELAY_MESSAGE(stream, version, alert);
-        CASE_HANDLE_MESSAGE(stream, version, block_message);
-        CASE_RELAY_MESSAGE(stream, version, block_transactions);
-        CASE_RELAY_MESSAGE(stream, version, compact_block);
-        CASE_RELAY_MESSAGE(stream, version, fee_filter);
-        CASE_RELAY_MESSAGE(stream, version, filter_add);
-        CASE_RELAY_MESSAGE(stream, version, filter_clear);
-        CASE_RELAY_MESSAGE(stream, version, filter_load);
-        CASE_RELAY_MESSAGE(stream, version, get_address);
-        CASE_RELAY_MESSAGE(stream, version, get_blocks);
-        CASE_RELAY_MESSAGE(stream, version, get_block_transactions);
-        CASE_RELAY_MESSAGE(stream, version, get_data);
-        CASE_RELAY_MESSAGE(stream, version, get_headers);
-        CASE_RELAY_MESSAGE(stream, version, headers);
-        CASE_RELAY_MESSAGE(stream, version, inventory);
-        CASE_RELAY_MESSAGE(stream, version, memory_pool);
-        CASE_RELAY_MESSAGE(stream, version, merkle_block);
-        CASE_RELAY_MESSAGE(stream, version, not_found);
-        CASE_RELAY_MESSAGE(stream, version, ping);
-        CASE_RELAY_MESSAGE(stream, version, pong);
-        CASE_RELAY_MESSAGE(stream, version, reject);
-        CASE_RELAY_MESSAGE(stream, version, send_headers);
-        CASE_RELAY_MESSAGE(stream, version, send_compact_blocks);
-        CASE_RELAY_MESSAGE(stream, version, transaction_message);
-        CASE_RELAY_MESSAGE(stream, version, verack);
-        CASE_HANDLE_MESSAGE(stream, version, version);
+        CASE_RELAY_MESSAGE(source, version, check, address);
+        CASE_RELAY_MESSAGE(source, version, check, alert);
+        CASE_HANDLE_MESSAGE(source, version, check, block_message);
+        CASE_RELAY_MESSAGE(source, version, check, block_transactions);
+        CASE_RELAY_MESSAGE(source, version, check, compact_block);
+        CASE_RELAY_MESSAGE(source, version, check, fee_filter);
+        CASE_RELAY_MESSAGE(source, version, check, filter_add);
+        CASE_RELAY_MESSAGE(source, version, check, filter_clear);
+        CASE_RELAY_MESSAGE(source, version, check, filter_load);
+        CASE_RELAY_MESSAGE(source, version, check, get_address);
+        CASE_RELAY_MESSAGE(source, version, check, get_blocks);
+        CASE_RELAY_MESSAGE(source, version, check, get_block_transactions);
+        CASE_RELAY_MESSAGE(source, version, check, get_data);
+        CASE_RELAY_MESSAGE(source, version, check, get_headers);
+        CASE_RELAY_MESSAGE(source, version, check, headers);
+        CASE_RELAY_MESSAGE(source, version, check, inventory);
+        CASE_RELAY_MESSAGE(source, version, check, memory_pool);
+        CASE_RELAY_MESSAGE(source, version, check, merkle_block);
+        CASE_RELAY_MESSAGE(source, version, check, not_found);
+        CASE_RELAY_MESSAGE(source, version, check, ping);
+        CASE_RELAY_MESSAGE(source, version, check, pong);
+        CASE_RELAY_MESSAGE(source, version, check, reject);
+        CASE_RELAY_MESSAGE(source, version, check, send_headers);
+        CASE_RELAY_MESSAGE(source, version, check, send_compact_blocks);
+        CASE_RELAY_MESSAGE(source, version, check, transaction_message);
+        CASE_RELAY_MESSAGE(source, version, check, verack);
+        CASE_HANDLE_MESSAGE(source, version, check, version);
         case message_type::unknown:
         default:
             return error::not_found;
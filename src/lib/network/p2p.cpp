@@ -77,6 +77,7 @@ void p2p::start(result_handler handler)
 
     threadpool_.join();
     threadpool_.spawn(settings_.threads, thread_priority::low);
+    scheduler_.start(settings_.scheduler_threads);
 
     stopped_ = false;
     stop_subscriber_->start();
@@ -276,6 +277,10 @@ bool p2p::close()
     // Signal current work to stop and threadpool to stop accepting new work.
     const auto result = p2p::stop();
 
+    // Finish the prioritized work while the threadpool still runs, since a
+    // job may post to it. Jobs posted once stopped run on the posting thread.
+    scheduler_.stop();
+
     // Block on join of all threads in the threadpool.
     threadpool_.join();
     return result;
@@ -311,6 +316,11 @@ threadpool& p2p::thread_pool()
     return threadpool_;
 }
 
+scheduler& p2p::job_scheduler()
+{
+    return scheduler_;
+}
+
 // Subscriptions.
 // ----------------------------------------------------------------------------
 
@@ -39,48 +39,6 @@
 namespace libbitcoin {
 namespace network {
 
-#ifndef NDEBUG
-class traffic{
-public:
-    static traffic& instance();
-
-    void rx(uint64_t bytes){
-        rx_.fetch_add(bytes);
-    }
-
-    void tx(uint64_t bytes){
-        tx_.fetch_add(bytes);
-    }
-
-    ~traffic(){
-        auto now = std::chrono::system_clock::now();
-        log::trace(LOG_NETWORK) << "it costs " << std::chrono::duration_cast<std::chrono::seconds>(now - start_time_).count() << " seconds, rx," << rx_.load() << ",tx," << tx_.load();
-    }
-private:
-    static boost::detail::spinlock spinlock_;
-    static std::shared_ptr<traffic> instance_;
-    traffic():rx_{0}, tx_{0}, start_time_{std::chrono::system_clock::now()}
-    {
-    }
-
-private:
-    std::atomic<uint64_t> rx_;
-    std::atomic<uint64_t> tx_;
-    std::chrono::system_clock::time_point start_time_;
-};
-traffic& traffic::instance(){
-    if (instance_ == nullptr) {
-        boost::detail::spinlock::scoped_lock guard{spinlock_};
-        if (instance_ == nullptr) {
-            instance_.reset(new traffic{});
-        }
-    }
-    return *instance_;
-}
-boost::detail::spinlock traffic::spinlock_;
-std::shared_ptr<traffic> traffic::instance_ = nullptr;
-#endif
-
 #define NAME "proxy"
 
 using namespace message;
@@ -112,6 +70,11 @@ proxy::~proxy()
 // Properties.
 // ----------------------------------------------------------------------------
 
+const traffic& proxy::counters() const
+{
+    return traffic_;
+}
+
 const config::authority& proxy::authority() const
 {
     return authority_;
@@ -188,15 +151,12 @@ void proxy::handle_read_heading(const boost_code& ec, size_t)
     // TODO: verify client quick disconnect.
     if (ec)
     {
-        log::trace(LOG_NETWORK)
+        BC_LOG_TRACE(LOG_NETWORK)
             << "Heading read failure [" << authority() << "] "
             << code(error::boost_to_error_code(ec)).message();
         stop(ec);
         return;
     }
-#ifndef NDEBUG
-    traffic::instance().rx(heading_buffer_.size());
-#endif
     const auto head = heading::factory_from_data(heading_buffer_);
 
     if (!head.is_valid())
@@ -209,7 +169,7 @@ void proxy::handle_read_heading(const boost_code& ec, size_t)
 
     if (head.magic != protocol_magic_)
     {
-        log::trace(LOG_NETWORK)
+        BC_LOG_TRACE(LOG_NETWORK)
             << "Invalid heading magic (" << head.magic << ") from ["
             << authority() << "]";
         stop(error::bad_magic);
@@ -259,73 +219,83 @@ void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
     // TODO: verify client quick disconnect.
     if (ec)
     {
-        log::trace(LOG_NETWORK)
+        BC_LOG_TRACE(LOG_NETWORK)
             << "Payload read failure [" << authority() << "] "
             << code(error::boost_to_error_code(ec)).message();
         stop(ec);
         return;
     }
 
-#ifndef NDEBUG
-    traffic::instance().rx(payload_buffer_.size());
-#endif
+    const auto start = std::chrono::steady_clock::now();
+    const auto handled = handle_request(head, peer_protocol_version_.load());
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
 
-    auto checksum = bitcoin_checksum(payload_buffer_);
-    if (head.checksum != checksum)
-    {
-        log::trace(LOG_NETWORK)
-            << "Invalid " << head.command << " payload from [" << authority()
-            << "] bad checksum. size is " << payload_size;
-        stop(error::bad_stream);
-        return;
-    }
-    
-    ///////////////////////////////////////////////////////////////////////////
-    // TODO: we aren't getting a stream benefit if we read the full payload
-    // before parsing the message. Should just make this a message parse.
-    ///////////////////////////////////////////////////////////////////////////
+    const auto bytes = heading_buffer_.size() + payload_size;
+    traffic_.received(head.type(), bytes, elapsed);
+    traffic::global().received(head.type(), bytes, elapsed);
 
-    handle_request(payload_buffer_, peer_protocol_version_.load(), head, payload_size);
+    if (!handled)
+        return;
 
     handle_activity();
     read_heading();
 }
 
-void proxy::handle_request(data_chunk payload_buffer, uint32_t peer_protocol_version, heading head, size_t payload_size)
+// The payload is parsed in place from the read buffer, which is not reused
+// until the next read is started. The checksum is accumulated as the payload
+// is consumed and subscribers are notified only once it has been verified.
+bool proxy::handle_request(const heading& head, uint32_t peer_protocol_version)
 {
-    bool succeed = false;
+    trace_span span("proxy.parse", "network");
+    if (span)
+        span.set_detail(head.command);
 
-    // Notify subscribers of the new message.
-    payload_source source(payload_buffer);
-    payload_stream istream(source);
-    const auto version = peer_protocol_version;
+    slice_reader source(payload_buffer_, true);
+    auto bad_checksum = false;
+    auto trailing = false;
 
-    const auto code = message_subscriber_.load(head.type(), version, istream);
+    const auto check = [&]()
+    {
+        bad_checksum = (source.checksum() != head.checksum);
+        trailing = !source.is_exhausted();
+        return bad_checksum || trailing ? error::bad_stream : error::success;
+    };
 
-    const auto consumed = istream.peek() == std::istream::traits_type::eof();
+    const auto code = message_subscriber_.load(head.type(),
+        peer_protocol_version, source, check);
 
-    if (code)
+    if (bad_checksum)
     {
-        log::warning(LOG_NETWORK)
+        BC_LOG_TRACE(LOG_NETWORK)
             << "Invalid " << head.command << " payload from [" << authority()
-            << "] " << code.message();
-        stop(code);
-        return;
+            << "] bad checksum. size is " << payload_buffer_.size();
+        stop(error::bad_stream);
+        return false;
     }
 
-    if (!consumed)
+    if (trailing)
     {
         log::warning(LOG_NETWORK)
             << "Invalid " << head.command << " payload from [" << authority()
             << "] trailing bytes.";
         stop(error::bad_stream);
-        return;
+        return false;
     }
 
-    log::trace(LOG_NETWORK)
+    if (code)
+    {
+        log::warning(LOG_NETWORK)
+            << "Invalid " << head.command << " payload from [" << authority()
+            << "] " << code.message();
+        stop(code);
+        return false;
+    }
+
+    BC_LOG_TRACE(LOG_NETWORK)
         << "Valid " << head.command << " payload from [" << authority()
-        << "] (" << payload_size << " bytes)";
-    succeed = true;
+        << "] (" << payload_buffer_.size() << " bytes)";
+    return true;
 }
 
 // Message send sequence.
@@ -340,12 +310,10 @@ void proxy::do_send(const std::string& command, const_buffer buffer,
         return;
     }
 
-    if (command == "headers") {
-    	log::trace(LOG_NETWORK) << "";
-    }
+    const auto type = heading{ 0, command, 0, 0 }.type();
 
     //thin log network
-	log::trace(LOG_NETWORK)
+	BC_LOG_TRACE(LOG_NETWORK)
 		<< "Sending " << command << " to [" << authority() << "] ("
 		<< buffer.size() << " bytes)";
 
@@ -359,7 +327,7 @@ void proxy::do_send(const std::string& command, const_buffer buffer,
     request_callback h{nullptr};
     {
         auto pThis = shared_from_this();
-        auto f = [this, pThis, buffer, handler](){
+        auto f = [this, pThis, buffer, type, handler](){
             if (stopped())
             {
                 handler(error::channel_stopped);
@@ -369,7 +337,7 @@ void proxy::do_send(const std::string& command, const_buffer buffer,
 			auto& native_socket = socket->get();
             async_write(native_socket, buffer,
                     std::bind(&proxy::handle_send,
-                    		shared_from_this(), _1, buffer, handler));
+                    		shared_from_this(), _1, buffer, type, handler));
         };
         const auto socket = socket_->get_socket();
         outbound_size = outbound_queue_.size();
@@ -402,25 +370,25 @@ void proxy::do_send(const std::string& command, const_buffer buffer,
     using namespace boost::asio;
     async_write(socket->get(), buffer,
         std::bind(&proxy::handle_send,
-            shared_from_this(), _1, buffer, handler));
+            shared_from_this(), _1, buffer, type, handler));
 #endif
     // The shared buffer is kept in scope until the handler is invoked.
     ///////////////////////////////////////////////////////////////////////////
 }
 
 void proxy::handle_send(const boost_code& ec, const_buffer buffer,
-    result_handler handler)
+    message_type type, result_handler handler)
 {
     const auto error = code(error::boost_to_error_code(ec));
 
     if (error)
-        log::trace(LOG_NETWORK)
+        BC_LOG_TRACE(LOG_NETWORK)
             << "Failure sending " << buffer.size() << " byte message to ["
             << authority() << "] " << error.message();
-    else{
-#ifndef NDEBUG
-        traffic::instance().tx(buffer.size());
-#endif
+    else
+    {
+        traffic_.sent(type, buffer.size());
+        traffic::global().sent(type, buffer.size());
     }
 
     handler(error);
@@ -438,7 +406,7 @@ void proxy::handle_send(const boost_code& ec, const_buffer buffer,
         const auto socket = socket_->get_socket();
         if(outbound_queue_.empty())
             return;
-        log::trace(LOG_NETWORK) << "channel:" << reinterpret_cast<int64_t>(this) << " outbound size," << outbound_queue_.size();
+        BC_LOG_TRACE(LOG_NETWORK) << "channel:" << reinterpret_cast<int64_t>(this) << " outbound size," << outbound_queue_.size();
         h = std::move(outbound_queue_.front());
         outbound_queue_.pop();
         has_sent_.store(false);
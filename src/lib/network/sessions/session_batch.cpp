@@ -152,10 +152,11 @@ void session_batch::handle_connect(const code& ec, channel::ptr channel,
         log::trace(LOG_NETWORK)
             << "Failure connecting to [" << host << "] " << count << ","
             << ec.message();
-        if (ec == error::channel_timeout) // if connect is not aviliable, change it into inactive state
-        	remove(host.to_network_address(), [](const code&){});
-		else
-			store(host.to_network_address());
+        // A timeout counts against the address score, other failures are
+        // not attributable to the host and leave its score unchanged.
+        if (ec == error::channel_timeout)
+            remove(host.to_network_address(), [](const code&){});
+
         handler(ec, channel);
         return;
     }
@@ -128,7 +128,10 @@ void session_seed::start_seed(const config::endpoint& seed,
 
     // OUTBOUND CONNECT
     connect->connect(seed, BIND4(handle_connect, _1, _2, seed, handler), [this](const asio::endpoint& endpoint){
-    	network_.store(config::authority{endpoint}.to_network_address(), [](const code& ec){});
+    	// Resolved seed addresses are learned, they have not been tried.
+    	const message::network_address::list resolved{
+    	    config::authority{endpoint}.to_network_address() };
+    	network_.store(resolved, [](const code& ec){});
     	log::debug(LOG_NETWORK) << "session seed store," << endpoint ;
     });
 }
@@ -30,6 +30,7 @@ using namespace bc::message;
 // Common default values (no settings context).
 settings::settings()
   : threads(16),
+    scheduler_threads(0),
     protocol(version::level::maximum),
     inbound_connections(32),
     outbound_connections(8),
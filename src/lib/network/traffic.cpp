@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/network/traffic.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace message;
+
+// Counters are statistics, they do not order other memory operations.
+static constexpr auto relaxed = std::memory_order_relaxed;
+
+traffic& traffic::global()
+{
+    static traffic instance;
+    return instance;
+}
+
+std::string traffic::command(message_type type)
+{
+    switch (type)
+    {
+        case message_type::address: return address::command;
+        case message_type::alert: return alert::command;
+        case message_type::block_message: return block_message::command;
+        case message_type::block_transactions: return block_transactions::command;
+        case message_type::compact_block: return compact_block::command;
+        case message_type::fee_filter: return fee_filter::command;
+        case message_type::filter_add: return filter_add::command;
+        case message_type::filter_clear: return filter_clear::command;
+        case message_type::filter_load: return filter_load::command;
+        case message_type::get_address: return get_address::command;
+        case message_type::get_block_transactions: return get_block_transactions::command;
+        case message_type::get_blocks: return get_blocks::command;
+        case message_type::get_data: return get_data::command;
+        case message_type::get_headers: return get_headers::command;
+        case message_type::headers: return headers::command;
+        case message_type::inventory: return inventory::command;
+        case message_type::memory_pool: return memory_pool::command;
+        case message_type::merkle_block: return merkle_block::command;
+        case message_type::not_found: return not_found::command;
+        case message_type::ping: return ping::command;
+        case message_type::pong: return pong::command;
+        case message_type::reject: return reject::command;
+        case message_type::send_compact_blocks: return send_compact_blocks::command;
+        case message_type::send_headers: return send_headers::command;
+        case message_type::transaction_message: return transaction_message::command;
+        case message_type::verack: return verack::command;
+        case message_type::version: return version::command;
+        default: return {};
+    }
+}
+
+traffic::traffic()
+{
+    for (auto& value: cells_)
+    {
+        value.bytes_in = 0;
+        value.bytes_out = 0;
+        value.messages_in = 0;
+        value.messages_out = 0;
+        value.handle_microseconds = 0;
+    }
+}
+
+void traffic::received(message_type type, uint64_t bytes,
+    uint64_t microseconds)
+{
+    auto& value = cells_[static_cast<size_t>(type)];
+    value.bytes_in.fetch_add(bytes, relaxed);
+    value.messages_in.fetch_add(1, relaxed);
+    value.handle_microseconds.fetch_add(microseconds, relaxed);
+}
+
+void traffic::sent(message_type type, uint64_t bytes)
+{
+    auto& value = cells_[static_cast<size_t>(type)];
+    value.bytes_out.fetch_add(bytes, relaxed);
+    value.messages_out.fetch_add(1, relaxed);
+}
+
+traffic::counters traffic::by_type(message_type type) const
+{
+    const auto& value = cells_[static_cast<size_t>(type)];
+
+    return
+    {
+        value.bytes_in.load(relaxed),
+        value.bytes_out.load(relaxed),
+        value.messages_in.load(relaxed),
+        value.messages_out.load(relaxed),
+        value.handle_microseconds.load(relaxed)
+    };
+}
+
+traffic::counters traffic::total() const
+{
+    counters sum{ 0, 0, 0, 0, 0 };
+
+    for (size_t type = 0; type < message_types; ++type)
+    {
+        const auto value = by_type(static_cast<message_type>(type));
+        sum.bytes_in += value.bytes_in;
+        sum.bytes_out += value.bytes_out;
+        sum.messages_in += value.messages_in;
+        sum.messages_out += value.messages_out;
+        sum.handle_microseconds += value.handle_microseconds;
+    }
+
+    return sum;
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -139,10 +139,15 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.network.threads),
         "The number of threads in the application threadpool, defaults to 50."
     )
+    (
+        "network.scheduler_threads",
+        value<uint32_t>(&configured.network.scheduler_threads),
+        "The number of threads running prioritized validation and query work, defaults to 0 (one per core)."
+    )
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
-        "The network protocol version, defaults to 70012."
+        "The network protocol version, defaults to 70012, 70014 enables compact block relay."
     )
     (
         "network.identifier",
@@ -261,6 +266,11 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.database.stealth_start_height),
         "The lower limit of stealth indexing, defaults to 500000."
     )
+    (
+        "database.block_undo_depth",
+        value<uint32_t>(&configured.database.block_undo_depth),
+        "The number of top blocks that keep the rows to pop them, deeper blocks are popped by reading their scripts, defaults to 5000 (0 keeps every block)."
+    )
     (
         "database.directory",
         value<path>(&configured.database.directory),
@@ -273,6 +283,21 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.chain.block_pool_capacity),
         "The maximum number of orphan blocks in the pool, defaults to 50."
     )
+    (
+        "blockchain.block_pool_megabytes",
+        value<uint32_t>(&configured.chain.block_pool_megabytes),
+        "The maximum size of the orphan blocks in the pool, defaults to 256 (0 for no limit)."
+    )
+    (
+        "blockchain.coin_cache_megabytes",
+        value<uint32_t>(&configured.chain.coin_cache_megabytes),
+        "The maximum size of the cache of recent unspent outputs, defaults to 128 (0 to disable)."
+    )
+    (
+        "blockchain.utxo_view_megabytes",
+        value<uint32_t>(&configured.chain.utxo_view_megabytes),
+        "The maximum size of the unspent outputs kept for recently queried addresses, defaults to 32 (0 to disable)."
+    )
     (
         "blockchain.transaction_pool_capacity",
         value<uint32_t>(&configured.chain.transaction_pool_capacity),
@@ -283,6 +308,16 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.transaction_pool_consistency),
         "Enforce consistency between the pool and the blockchain, defaults to false."
     )
+    (
+        "blockchain.transaction_pool_backlog",
+        value<uint32_t>(&configured.chain.transaction_pool_backlog),
+        "The maximum number of transactions waiting for validation, defaults to 4096."
+    )
+    (
+        "blockchain.verify_threads",
+        value<uint32_t>(&configured.chain.verify_threads),
+        "The number of threads helping to verify block scripts, defaults to 0 (one per core)."
+    )
     (
         "blockchain.use_testnet_rules",
         value<bool>(&configured.chain.use_testnet_rules),
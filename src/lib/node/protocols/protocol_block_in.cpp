@@ -24,6 +24,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 
@@ -41,15 +42,34 @@ using namespace std::placeholders;
 static constexpr auto perpetual_timer = true;
 static const auto get_blocks_interval = asio::seconds(100);
 
+// Bounds the reconstruction slots a peer can make us allocate.
+static constexpr uint64_t max_compact_transactions = max_uint16;
+
+// Widen a six byte short id for use as a hash map key.
+static uint64_t short_id_value(const compact_block::short_id& id)
+{
+    uint64_t value = 0;
+    for (size_t index = 0; index < id.size(); ++index)
+        value |= static_cast<uint64_t>(id[index]) << (8 * index);
+
+    return value;
+}
+
 protocol_block_in::protocol_block_in(p2p& network, channel::ptr channel,
-    block_chain& blockchain)
+    block_chain& blockchain, transaction_pool& pool)
   : protocol_timer(network, channel, perpetual_timer, NAME),
     blockchain_(blockchain),
+    pool_(pool),
     last_locator_top_(null_hash),
     current_chain_top_(null_hash),
 
     // TODO: move send_headers to a derived class protocol_block_in_70012.
     headers_from_peer_(peer_version().value >= version::level::bip130),
+
+    // Compact blocks are used only if both ends are configured for bip152.
+    compact_from_peer_(
+        network.network_settings().protocol >= version::level::bip152 &&
+        peer_version().value >= version::level::bip152),
     headers_batch_size_{0},
 
     CONSTRUCT_TRACK(protocol_block_in)
@@ -66,6 +86,14 @@ protocol_block_in::ptr protocol_block_in::do_subscribe()
 
     SUBSCRIBE2(inventory, handle_receive_inventory, _1, _2);
     SUBSCRIBE2(block_message, handle_receive_block, _1, _2);
+
+    if (compact_from_peer_)
+    {
+        SUBSCRIBE2(compact_block, handle_receive_compact_block, _1, _2);
+        SUBSCRIBE2(block_transactions, handle_receive_block_transactions,
+            _1, _2);
+    }
+
     protocol_timer::start(get_blocks_interval, BIND1(get_block_inventory, _1));
     return std::dynamic_pointer_cast<protocol_block_in>(protocol::shared_from_this());
 }
@@ -84,6 +112,15 @@ void protocol_block_in::start()
 //        SEND2(send_headers(), handle_send, _1, send_headers::command);
     }
 
+    if (compact_from_peer_)
+    {
+        // Ask the peer to push new blocks to us as compact blocks.
+        send_compact_blocks request;
+        request.high_bandwidth_mode = true;
+        request.version = 1;
+        SEND2(request, handle_send, _1, send_compact_blocks::command);
+    }
+
     // Subscribe to block acceptance notifications (for gap fill redundancy).
     blockchain_.subscribe_reorganize(
         BIND4(handle_reorganized, _1, _2, _3, _4));
@@ -419,6 +456,259 @@ void protocol_block_in::handle_store_block(const code& ec, block_ptr message)
 //    send_get_blocks(message->header.hash());
 }
 
+// Receive compact block sequence (BIP152).
+//-----------------------------------------------------------------------------
+
+bool protocol_block_in::handle_receive_compact_block(const code& ec,
+    compact_block_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting compact block from [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    const auto count = message->short_ids.size() +
+        message->transactions.size();
+
+    if (count == 0 || count > max_compact_transactions)
+    {
+        log::debug(LOG_NODE)
+            << "Invalid compact block size (" << count << ") from ["
+            << authority() << "]";
+        stop(error::bad_stream);
+        return false;
+    }
+
+    reset_timer();
+
+    // Short ids are matched against every transaction in the memory pool.
+    pool_.fetch(BIND3(handle_fetch_pool, _1, _2, message));
+    return true;
+}
+
+void protocol_block_in::handle_fetch_pool(const code& ec,
+    const std::vector<transaction_ptr>& pool, compact_block_ptr message)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    const auto hash = message->header.hash();
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure fetching pool for compact block ["
+            << encode_hash(hash) << "] " << ec.message();
+        send_get_full_block(hash);
+        return;
+    }
+
+    const auto count = message->short_ids.size() +
+        message->transactions.size();
+
+    auto state = std::make_shared<compact_state>();
+    state->hash = hash;
+    state->header = message->header;
+    state->transactions.resize(count);
+    std::vector<bool> filled(count, false);
+
+    // Prefilled indexes are differentially encoded.
+    uint64_t index = 0;
+    auto first = true;
+    for (const auto& prefilled: message->transactions)
+    {
+        index = first ? prefilled.index : index + prefilled.index + 1;
+        first = false;
+
+        if (index >= count || filled[index])
+        {
+            log::debug(LOG_NODE)
+                << "Invalid compact block prefill index from ["
+                << authority() << "]";
+            stop(error::bad_stream);
+            return;
+        }
+
+        state->transactions[index] = prefilled.transaction;
+        filled[index] = true;
+    }
+
+    // Short ids occupy the remaining slots in order.
+    std::unordered_map<uint64_t, uint64_t> slots;
+    slots.reserve(message->short_ids.size());
+    auto slot = 0u;
+    auto collision = false;
+
+    for (const auto& id: message->short_ids)
+    {
+        while (filled[slot])
+            ++slot;
+
+        collision |= !slots.emplace(short_id_value(id), slot++).second;
+    }
+
+    uint64_t k0, k1;
+    message->short_id_key(k0, k1);
+
+    for (const auto& tx: pool)
+    {
+        if (collision)
+            break;
+
+        const auto id = compact_block::to_short_id(k0, k1, tx->hash());
+        const auto it = slots.find(short_id_value(id));
+        if (it == slots.end())
+            continue;
+
+        // Two pool transactions share a short id, the block is ambiguous.
+        collision = filled[it->second];
+        state->transactions[it->second] = *tx;
+        filled[it->second] = true;
+    }
+
+    if (collision)
+    {
+        log::debug(LOG_NODE)
+            << "Short id collision in compact block [" << encode_hash(hash)
+            << "] from [" << authority() << "]";
+        send_get_full_block(hash);
+        return;
+    }
+
+    for (uint64_t position = 0; position < count; ++position)
+        if (!filled[position])
+            state->missing.push_back(position);
+
+    log::trace(LOG_NODE)
+        << "Compact block [" << encode_hash(hash) << "] from ["
+        << authority() << "] missing " << state->missing.size() << " of "
+        << count << " transactions";
+
+    if (state->missing.empty())
+    {
+        complete_compact_block(state);
+        return;
+    }
+
+    send_get_block_transactions(state);
+}
+
+void protocol_block_in::send_get_block_transactions(compact_state::ptr state)
+{
+    get_block_transactions request;
+    request.block_hash = state->hash;
+    request.indexes.reserve(state->missing.size());
+
+    // Requested indexes are differentially encoded.
+    auto first = true;
+    uint64_t previous = 0;
+    for (const auto index: state->missing)
+    {
+        request.indexes.push_back(first ? index : index - previous - 1);
+        previous = index;
+        first = false;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(compact_mutex_);
+    pending_compact_ = state;
+    ///////////////////////////////////////////////////////////////////////////
+
+    SEND2(request, handle_send, _1, request.command);
+}
+
+void protocol_block_in::send_get_full_block(const hash_digest& hash)
+{
+    const get_data request{ { inventory::type_id::block, hash } };
+    ++headers_batch_size_;
+    SEND2(request, handle_send, _1, request.command);
+}
+
+bool protocol_block_in::handle_receive_block_transactions(const code& ec,
+    block_transactions_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting block transactions from [" << authority()
+            << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    compact_state::ptr state;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        unique_lock lock(compact_mutex_);
+
+        // Ignore responses to a superseded request.
+        if (!pending_compact_ || pending_compact_->hash != message->block_hash)
+            return true;
+
+        state.swap(pending_compact_);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (message->transactions.size() != state->missing.size())
+    {
+        log::debug(LOG_NODE)
+            << "Invalid block transactions count from [" << authority()
+            << "]";
+        send_get_full_block(state->hash);
+        return true;
+    }
+
+    auto tx = message->transactions.begin();
+    for (const auto index: state->missing)
+        state->transactions[index] = std::move(*tx++);
+
+    state->missing.clear();
+    complete_compact_block(state);
+    return true;
+}
+
+void protocol_block_in::complete_compact_block(compact_state::ptr state)
+{
+    state->header.transaction_count = state->transactions.size();
+
+    // A short id collision with a non-block pool tx is caught here.
+    if (chain::block::generate_merkle_root(state->transactions) !=
+        state->header.merkle)
+    {
+        log::debug(LOG_NODE)
+            << "Compact block [" << encode_hash(state->hash)
+            << "] reconstruction failed from [" << authority() << "]";
+        send_get_full_block(state->hash);
+        return;
+    }
+
+    const auto block = std::make_shared<block_message>(
+        std::move(state->header), std::move(state->transactions));
+
+    // We will pick this up in handle_reorganized.
+    block->set_originator(nonce());
+
+    log::trace(LOG_NODE)
+        << "from " << authority() << ",reconstructed compact block hash,"
+        << encode_hash(state->hash) << ",tx-size,"
+        << block->header.transaction_count;
+
+    blockchain_.store(block, BIND2(handle_store_block, _1, block));
+}
+
 // Subscription.
 //-----------------------------------------------------------------------------
 
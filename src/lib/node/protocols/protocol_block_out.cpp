@@ -55,6 +55,12 @@ protocol_block_out::protocol_block_out(p2p& network, channel::ptr channel,
     headers_to_peer_(network.network_settings().protocol >=
         version::level::bip130),
 
+    // Compact blocks are used only if both ends are configured for bip152.
+    compact_enabled_(
+        network.network_settings().protocol >= version::level::bip152 &&
+        peer_version().value >= version::level::bip152),
+    compact_to_peer_(false),
+
     CONSTRUCT_TRACK(protocol_block_out)
 {
 }
@@ -73,6 +79,14 @@ protocol_block_out::ptr protocol_block_out::do_subscribe()
     SUBSCRIBE2(get_blocks, handle_receive_get_blocks, _1, _2);
     SUBSCRIBE2(get_data, handle_receive_get_data, _1, _2);
 
+    if (compact_enabled_)
+    {
+        SUBSCRIBE2(send_compact_blocks, handle_receive_send_compact_blocks,
+            _1, _2);
+        SUBSCRIBE2(get_block_transactions,
+            handle_receive_get_block_transactions, _1, _2);
+    }
+
     protocol_events::start(BIND1(handle_stop, _1));
     return std::dynamic_pointer_cast<protocol_block_out>(protocol::shared_from_this());
 }
@@ -119,6 +133,34 @@ bool protocol_block_out::handle_receive_send_headers(const code& ec,
     return false;
 }
 
+// Receive send_compact_blocks.
+//-----------------------------------------------------------------------------
+
+bool protocol_block_out::handle_receive_send_compact_blocks(const code& ec,
+    send_compact_blocks_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting " << send_compact_blocks::command
+            << " from [" << authority() << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    // Only version 1 (no segregated witness) compact blocks are supported.
+    if (message->version != 1)
+        return true;
+
+    // In high bandwidth mode new blocks are pushed as compact blocks.
+    // The peer may toggle the mode at any time, so remain subscribed.
+    compact_to_peer_.store(message->high_bandwidth_mode);
+    return true;
+}
+
 // Receive get_headers sequence.
 //-----------------------------------------------------------------------------
 
@@ -322,6 +364,10 @@ bool protocol_block_out::handle_receive_get_data(const code& ec,
         else if (inventory.type == inventory::type_id::filtered_block)
             blockchain_.fetch_merkle_block(inventory.hash,
                 BIND3(send_merkle_block, _1, _2, inventory.hash));
+        else if (inventory.type == inventory::type_id::compact_block &&
+            compact_enabled_)
+            blockchain_.fetch_block(inventory.hash,
+                BIND3(send_compact_block, _1, _2, inventory.hash));
     }
 
     return true;
@@ -388,6 +434,114 @@ void protocol_block_out::send_merkle_block(const code& ec,
     SEND2(*message, handle_send, _1, message->command);
 }
 
+// TODO: move not_found to derived class protocol_block_out_70001.
+void protocol_block_out::send_compact_block(const code& ec,
+    chain::block::ptr block, const hash_digest& hash)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    if (ec == (code)error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Compact block requested by [" << authority() << "] not found.";
+
+        const not_found reply{ { inventory::type_id::compact_block, hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating compact block requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    const auto announcement = compact_block::factory_from_block(*block,
+        pseudo_random());
+    SEND2(announcement, handle_send, _1, compact_block::command);
+}
+
+// Receive get_block_transactions sequence.
+//-----------------------------------------------------------------------------
+
+bool protocol_block_out::handle_receive_get_block_transactions(const code& ec,
+    get_block_transactions_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting get_block_transactions from [" << authority()
+            << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    blockchain_.fetch_block(message->block_hash,
+        BIND3(send_block_transactions, _1, _2, message));
+    return true;
+}
+
+void protocol_block_out::send_block_transactions(const code& ec,
+    chain::block::ptr block, get_block_transactions_ptr message)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    if (ec == (code)error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Block transactions requested by [" << authority()
+            << "] not found.";
+
+        const not_found reply{ { inventory::type_id::block,
+            message->block_hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating block transactions requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    block_transactions response;
+    response.block_hash = message->block_hash;
+    response.transactions.reserve(message->indexes.size());
+
+    // Requested indexes are differentially encoded.
+    auto first = true;
+    uint64_t index = 0;
+    for (const auto offset: message->indexes)
+    {
+        index = first ? offset : index + offset + 1;
+        first = false;
+
+        if (index >= block->transactions.size())
+        {
+            log::debug(LOG_NODE)
+                << "Invalid get_block_transactions index from ["
+                << authority() << "]";
+            stop(error::bad_stream);
+            return;
+        }
+
+        response.transactions.push_back(block->transactions[index]);
+    }
+
+    SEND2(response, handle_send, _1, response.command);
+}
+
 // Subscription.
 //-----------------------------------------------------------------------------
 
@@ -417,6 +571,32 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
     BITCOIN_ASSERT(max_size_t - fork_point >= incoming.size());
     current_chain_height_.store(fork_point + incoming.size());
 
+    // High bandwidth compact block peers get the blocks pushed directly.
+    if (compact_to_peer_)
+    {
+        auto& blockchain = static_cast<block_chain_impl&>(blockchain_);
+        uint64_t top;
+        auto is_got = blockchain.get_last_height(top);
+        int64_t block_interval = 20000;
+        auto res = std::abs(static_cast<int64_t>(top) - static_cast<int64_t>(peer_start_height()));
+        if (!is_got || res > block_interval)
+        {
+            return true;
+        }
+
+        for (const auto& block: incoming)
+        {
+            if (block->originator() == nonce())
+                continue;
+
+            const auto announcement = compact_block::factory_from_block(
+                *block, pseudo_random());
+            SEND2(announcement, handle_send, _1, compact_block::command);
+        }
+
+        return true;
+    }
+
     // TODO: move announce headers to a derived class protocol_block_in_70012.
     if (headers_to_peer_)
     {
@@ -130,14 +130,6 @@ bool protocol_block_sync::handle_receive(const code& ec, block_ptr message,
     // Add the block to the blockchain store.
     reservation_->import(message);
 
-    if (reservation_->toggle_partitioned())
-    {
-        log::trace(LOG_NODE)
-            << "Restarting partitioned slot (" << reservation_->slot() << ").";
-        complete(error::channel_stopped);
-        return false;
-    }
-
     // Request more blocks if our reservation has been expanded.
     send_get_blocks(complete, false);
     return true;
@@ -42,9 +42,6 @@ using namespace config;
 using namespace network;
 using namespace std::placeholders;
 
-// The interval in which all-channel block download performance is tested.
-static const asio::seconds regulator_interval(5);
-
 session_block_sync::session_block_sync(p2p& network, header_queue& hashes,
     simple_chain& chain, const settings& settings)
   : session_batch(network, false),
@@ -61,8 +58,6 @@ session_block_sync::session_block_sync(p2p& network, header_queue& hashes,
 
 void session_block_sync::start(result_handler handler)
 {
-    // TODO: create session_timer base class and pass interval via start.
-    timer_ = std::make_shared<deadline>(pool_, regulator_interval);
     session::start(CONCURRENT2(handle_started, _1, handler));
 }
 
@@ -97,9 +92,6 @@ void session_block_sync::handle_started(const code& ec, result_handler handler)
     });
     log::info(LOG_NODE)
             << "table size," << table.size();
-
-
-    ////reset_timer(connector);
 }
 
 // Block sync sequence.
@@ -185,7 +177,6 @@ void session_block_sync::handle_complete(const code& ec, channel::ptr channel,
 {
     if (!ec)
     {
-        timer_->stop();
         scoped_lock lock{mutex_};
         --reservations_count_;
         reservations_.remove(row);
@@ -219,41 +210,5 @@ void session_block_sync::handle_channel_stop(const code& ec,
         << "Channel stopped on slot (" << row->slot() << ") " << ec.message();
 }
 
-
-// Timer.
-// ----------------------------------------------------------------------------
-
-// private:
-void session_block_sync::reset_timer(connector::ptr connect)
-{
-    if (stopped())
-        return;
-
-    timer_->start(BIND2(handle_timer, _1, connect));
-}
-
-void session_block_sync::handle_timer(const code& ec, connector::ptr connect)
-{
-    if (stopped())
-        return;
-
-    log::debug(LOG_NODE)
-        << "Fired session_block_sync timer: " << ec.message();
-
-    ////// TODO: If (total database time as a fn of total time) add a channel.
-    ////// TODO: push into reservations_ implementation.
-    ////// TODO: add a boolean increment method to the synchronizer and pass here.
-    ////const size_t id = reservations_.table().size();
-    ////const auto row = std::make_shared<reservation>(reservations_, id);
-    ////const synchronizer<result_handler> handler({}, 0, "name", true);
-
-    ////if (add) new_connection(connect, row, handler);
-
-    ////// TODO: drop the slowest channel
-    //////If (drop) reservations_.prune();
-
-    reset_timer(connect);
-}
-
 } // namespace node
 } // namespace libbitcoin
@@ -19,6 +19,7 @@
  */
 #include <metaverse/node/utility/reservation.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
@@ -49,14 +50,18 @@ static constexpr size_t minimum_history = 3;
 // Simple conversion factor, since we trace in micro and report in seconds.
 static constexpr size_t micro_per_second = 1000 * 1000;
 
+// The in-flight window bounds, used until a rate is established.
+static constexpr size_t minimum_window = 16;
+static constexpr size_t initial_window = 128;
+
 reservation::reservation(reservations& reservations, size_t slot,
     uint32_t block_timeout_seconds)
   : rate_({ true, 0, 0, 0 }),
     stopped_(false),
     pending_(true),
-    partitioned_(false),
     reservations_(reservations),
     slot_(slot),
+    block_timeout_seconds_(block_timeout_seconds),
     rate_window_(minimum_history * block_timeout_seconds * micro_per_second)
 {
 }
@@ -251,6 +256,31 @@ size_t reservation::size() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
+size_t reservation::in_flight() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(hash_mutex_);
+
+    return requested_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The number of blocks the peer is expected to deliver in one block timeout.
+size_t reservation::window() const
+{
+    const auto maximum = reservations_.max_request();
+    const auto record = rate();
+
+    if (record.idle)
+        return std::min(initial_window, maximum);
+
+    const auto expected = record.normal() * micro_per_second *
+        block_timeout_seconds_;
+    const auto size = static_cast<size_t>(std::ceil(expected));
+    return std::max(minimum_window, std::min(size, maximum));
+}
+
 bool reservation::stopped() const
 {
     // Critical Section (stop)
@@ -261,7 +291,7 @@ bool reservation::stopped() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
-// Obtain and clear the outstanding blocks request.
+// Obtain the next blocks request, keeping up to a window of blocks in flight.
 message::get_data reservation::request(bool new_channel)
 {
     message::get_data packet;
@@ -270,33 +300,36 @@ message::get_data reservation::request(bool new_channel)
     if (new_channel)
         reset();
 
+    // This reads the rate, so it must precede the hash lock.
+    const auto window_size = window();
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    hash_mutex_.lock_upgrade();
+    unique_lock lock(hash_mutex_);
 
-    if (!new_channel && !pending_)
-    {
-        hash_mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
+    // A new channel has nothing in flight, the old requests were discarded.
+    if (new_channel)
+        requested_.clear();
+
+    // Top up only once half of the window has drained, to batch requests.
+    if (!new_channel && (!pending_ || requested_.size() > window_size / 2))
         return packet;
-    }
 
-    // Build get_blocks request message.
-    for (auto height = heights_.right.begin(); height != heights_.right.end();
-        ++height)
+    // Build get_blocks request message from the lowest unrequested heights.
+    for (auto height = heights_.right.begin(); height != heights_.right.end() &&
+        requested_.size() < window_size; ++height)
     {
+        if (!requested_.insert(height->first).second)
+            continue;
+
         static const auto id = message::inventory::type_id::block;
         const message::inventory_vector inventory{ id, height->second };
         packet.inventories.emplace_back(inventory);
     }
 
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    hash_mutex_.unlock_upgrade_and_lock();
-    pending_ = false;
-    hash_mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
-
+    pending_ = requested_.size() < heights_.size();
     return packet;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 void reservation::insert(const config::checkpoint& checkpoint)
@@ -383,61 +416,60 @@ void reservation::populate()
     ///////////////////////////////////////////////////////////////////////////
 }
 
-bool reservation::toggle_partitioned()
-{
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    hash_mutex_.lock_upgrade();
-
-    if (partitioned_)
-    {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        hash_mutex_.unlock_upgrade_and_lock();
-        partitioned_ = false;
-        pending_ = true;
-        hash_mutex_.unlock();
-        //---------------------------------------------------------------------
-        return true;
-    }
-
-    hash_mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
-    return false;
-}
-
-// Give the minimal row ~ half of our hashes, return false if minimal is empty.
+// Give the minimal row ~ half of our queued hashes, or our stragglers if all
+// are in flight and minimal is faster. Return false if minimal is empty.
 bool reservation::partition(reservation::ptr minimal)
 {
     // This assumes that partition has been called under a table mutex.
     if (!minimal->empty())
         return true;
 
+    // Rates are read before taking the hash lock.
+    const auto faster = minimal->rate().normal() > rate().normal();
+
     // Critical Section (hash)
     ///////////////////////////////////////////////////////////////////////////
-    hash_mutex_.lock_upgrade();
-
-    // Take half of the maximal reservation, rounding up to get last entry.
-    const auto own_size = heights_.size();
-    BITCOIN_ASSERT(own_size < max_size_t && (own_size + 1) / 2 <= max_uint32);
-    const auto offset = static_cast<uint32_t>(own_size + 1) / 2;
-    auto it = heights_.right.begin();
+    unique_lock lock(hash_mutex_);
 
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    hash_mutex_.unlock_upgrade_and_lock();
+    BITCOIN_ASSERT(requested_.size() <= heights_.size());
+    const auto queued = heights_.size() - requested_.size();
 
-    // TODO: move the range in a single command.
-    for (size_t index = 0; index < offset; ++index)
+    if (queued > 0)
     {
-        minimal->heights_.right.insert(std::move(*it));
-        it = heights_.right.erase(it);
+        // Take the upper half of the queued hashes, rounding up to get last
+        // entry. Our window is not touched, so our channel continues.
+        auto remaining = (queued + 1) / 2;
+        auto it = heights_.right.end();
+
+        while (remaining > 0 && it != heights_.right.begin())
+        {
+            --it;
+
+            if (requested_.count(it->first) != 0)
+                continue;
+
+            minimal->heights_.right.insert(*it);
+            it = heights_.right.erase(it);
+            --remaining;
+        }
+    }
+    else if (faster)
+    {
+        // Everything we hold is in flight on a slower channel, so hand the
+        // stragglers to the faster row. This leaves us empty and stopped, and
+        // any of these blocks that we later receive are ignored as unsolicited.
+        for (auto it = heights_.right.begin(); it != heights_.right.end();
+            it = heights_.right.erase(it))
+            minimal->heights_.right.insert(*it);
+
+        requested_.clear();
     }
 
-    partitioned_ = !heights_.empty();
     const auto populated = !minimal->empty();
     minimal->pending_ = populated;
+    pending_ = requested_.size() < heights_.size();
 
-    if (!partitioned_)
+    if (heights_.empty())
     {
         // Critical Section (stop)
         ///////////////////////////////////////////////////////////////////////
@@ -448,7 +480,7 @@ bool reservation::partition(reservation::ptr minimal)
         ///////////////////////////////////////////////////////////////////////
     }
 
-    hash_mutex_.unlock();
+    lock.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
     if (populated)
@@ -480,6 +512,7 @@ bool reservation::find_height_and_erase(const hash_digest& hash,
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     hash_mutex_.unlock_upgrade_and_lock();
     heights_.left.erase(it);
+    requested_.erase(out_height);
     hash_mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
@@ -40,6 +40,18 @@ using namespace bc::chain;
 // The protocol maximum size of get data block requests.
 static constexpr size_t max_block_request = 50000;
 
+// Block import rates are kept per microsecond.
+static constexpr size_t micro_per_second = 1000 * 1000;
+
+static auto& download_slots = metrics::get_gauge(
+    "mvs_download_active_slots", "Block download slots importing blocks.");
+static auto& download_rate = metrics::get_gauge(
+    "mvs_download_rate_blocks_per_second",
+    "Mean block import rate of the active download slots.");
+static auto& download_deviation = metrics::get_gauge(
+    "mvs_download_rate_deviation_blocks_per_second",
+    "Standard deviation of the block import rates of the active slots.");
+
 reservations::reservations(header_queue& hashes, simple_chain& chain,
     const settings& settings)
   : hashes_(hashes),
@@ -96,6 +108,10 @@ reservations::rate_statistics reservations::rates() const
     auto squares = std::accumulate(rates.begin(), rates.end(), 0.0, summary);
     auto quotient = divide<double>(squares, active_rows);
     auto standard_deviation = std::sqrt(quotient);
+
+    download_slots.set(active_rows);
+    download_rate.set(mean * micro_per_second);
+    download_deviation.set(standard_deviation * micro_per_second);
     return{ active_rows, mean, standard_deviation };
 }
 
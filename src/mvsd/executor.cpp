@@ -52,6 +52,25 @@ static const auto application_name = "bs";
 
 std::promise<code> executor::stopping_;
 
+// Logs on a background thread while in scope, its thread is joined however
+// the scope is left, a joinable thread would terminate the process at exit.
+class async_logging
+{
+public:
+    async_logging(bc::ofstream& debug, bc::ofstream& error)
+    {
+        start_async_logging(debug, error);
+    }
+
+    ~async_logging()
+    {
+        stop_async_logging();
+    }
+
+    async_logging(const async_logging&) = delete;
+    void operator=(const async_logging&) = delete;
+};
+
 executor::executor(parser& metadata, std::istream& input,
     std::ostream& output, std::ostream& error)
   : metadata_(metadata), output_(output),
@@ -137,8 +156,8 @@ bool executor::do_initchain()
             throw std::runtime_error{"lower blockchain db not compatible with mvsd. please download the newest mvsd with blockdata!"};
     	} else if(data_base::is_higher_database(data_path)) {
             throw std::runtime_error{"higher blockchain db not compatible with mvsd. please download the newest mvsd with blockdata!"};
-		} else {
-			// version equal nothing to do 
+		} else if (!data_base::initialize_undo(data_path)) {
+            throw std::runtime_error{"create block undo table failed"};
 		}
 	}
 
@@ -211,6 +230,9 @@ bool executor::run()
     // Ensure all configured services can function.
     set_minimum_threadpool_size();
 
+    // The node logs from its own threads from here on.
+    const async_logging logging(debug_file_, error_file_);
+
     // Now that the directory is verified we can create the node for it.
     node_ = std::make_shared<server_node>(metadata_.configured);
 
@@ -14,6 +14,7 @@
  * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
  * 02110-1301, USA.
  */
+#include <chrono>
 #include <exception>
 #include <functional> //hash
 
@@ -31,6 +32,14 @@ thread_local OStream HttpServ::out_;
 thread_local Tokeniser<'/'> HttpServ::uri_;
 thread_local int HttpServ::state_ = 0;
 
+static auto& rpc_requests = metrics::get_counter(
+    "mvs_rpc_requests_total", "JSON-RPC requests served.");
+static auto& rpc_failures = metrics::get_counter(
+    "mvs_rpc_failures_total", "JSON-RPC requests answered with an error.");
+static auto& rpc_seconds = metrics::get_histogram(
+    "mvs_rpc_request_seconds", "Time taken to serve a JSON-RPC request.",
+    metrics::latency_buckets());
+
 void HttpServ::reset(HttpMessage& data) noexcept
 {
     state_ = 0;
@@ -56,6 +65,8 @@ void HttpServ::reset(HttpMessage& data) noexcept
 
 void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version)
 {
+    const auto start = asio::steady_clock::now();
+    auto failed = true;
     reset(data);
     StreamBuf buf{ nc.send_mbuf };
     out_.rdbuf(&buf);
@@ -65,8 +76,8 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
 
         Json::Value jv_output;
                 
-        auto retcode = explorer::dispatch_command(data.argc(), const_cast<const char**>(data.argv()),
-            jv_output, node_, rpc_version);
+        auto retcode = explorer::dispatch_command(data.get_command(),
+            data.params(), jv_output, node_, rpc_version);
 
         if (retcode == console_result::failure) { // only orignal command
             if (rpc_version == 1 && !jv_output.isObject() && !jv_output.isArray()) {
@@ -91,6 +102,8 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
                 out_ << jv_root.toStyledString();
             }
         }
+
+        failed = false;
     }
     catch (const libbitcoin::explorer::explorer_exception& e) {
         if (rpc_version == 1) {
@@ -122,6 +135,36 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
         }
     }
     out_.setContentLength();
+
+    rpc_requests.increment();
+    if (failed)
+        rpc_failures.increment();
+    rpc_seconds.observe(std::chrono::duration<double>(
+        asio::steady_clock::now() - start).count());
+}
+
+void HttpServ::metrics_request(mg_connection& nc)
+{
+    // The scheduler keeps its own figures, copy them at scrape time.
+    auto& scheduler = node_.job_scheduler();
+    for (size_t index = 0; index < scheduler::lanes; ++index)
+    {
+        const auto lane = static_cast<scheduler::lane>(index);
+        const auto stats = scheduler.stats(lane);
+        const auto labels = std::string("lane=\"") +
+            scheduler::to_string(lane) + "\"";
+
+        metrics::get_gauge("mvs_scheduler_queued",
+            "Jobs waiting in a scheduler lane.", labels).set(stats.queued);
+        metrics::get_gauge("mvs_scheduler_running",
+            "Jobs running in a scheduler lane.", labels).set(stats.running);
+    }
+
+    StreamBuf buf{ nc.send_mbuf };
+    out_.rdbuf(&buf);
+    out_.reset(200, "OK");
+    out_ << metrics::render();
+    out_.setContentLength();
 }
 
 void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
@@ -180,6 +223,9 @@ void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
     }
     else if ((mg_ncasecmp(msg.uri.p, "/rpc", 4) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/", 5) == 0)) {
         rpc_request(nc, HttpMessage(&msg), 1); //v1 rpc
+    }
+    else if (msg.uri.len == 8 && mg_ncasecmp(msg.uri.p, "/metrics", 8) == 0) {
+        metrics_request(nc);
     } else {
         std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection* ptr) { (void)(ptr); });
         serve_http_static(nc, msg);
@@ -24,18 +24,6 @@ namespace mgbubble {
 
 void HttpMessage::data_to_arg(uint8_t rpc_version) {
 
-    auto vargv_to_argv = [this]() {
-        // convert to char** argv
-        int i = 0;
-        for(auto& iter : this->vargv_){
-            if (i >= max_paramters){
-                break;
-            }
-            this->argv_[i++] = iter.c_str();
-        }
-        argc_ = i;
-    };
-    
     Json::Reader reader;
     Json::Value root;
     const char* begin = body().data();
@@ -52,6 +40,9 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
         throw libbitcoin::explorer::jsonrpc_invalid_params();
     }
 
+    // The params are bound to the command as they are, see dispatch_command.
+    params_ = Json::arrayValue;
+
     if (rpc_version == 1) {
         /* ***************** /rpc **********************
          * application/json
@@ -59,7 +50,7 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
          * ******************************************/
         for (auto& param : root["params"]) {
             if (!param.isObject())
-                vargv_.emplace_back(param.asString());
+                params_.append(param);
         }
     } else {
         /* ***************** /rpc/v2 **********************
@@ -87,30 +78,10 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
 		
         jsonrpc_id_ = root["id"].asInt64();
 
-        // push options
-        for (auto& param : root["params"]) {
-            if (param.isObject()) {
-                for (auto& key : param.getMemberNames()) {
-                    // --option
-                    vargv_.emplace_back("--" + key);
-                    // value
-                    if (!param[key].isNull()) {
-                        vargv_.emplace_back(param[key].asString());
-                    }
-                }
-                break;
-            }
-        }
-
-        // push arguments at last
         for (auto& param : root["params"]) {
-            if (!param.isObject()){
-                vargv_.emplace_back(param.asString());
-            }
+            params_.append(param);
         }
     }
-
-    vargv_to_argv();
 }
 
 void WebsocketMessage::data_to_arg(uint8_t api_version) {
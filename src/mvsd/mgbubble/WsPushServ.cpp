@@ -40,6 +40,13 @@ namespace mgbubble {
 using namespace bc;
 using namespace libbitcoin;
 
+static auto& ws_connections = metrics::get_gauge(
+    "mvs_websocket_connections", "Open websocket connections.");
+static auto& ws_subscribers = metrics::get_gauge(
+    "mvs_websocket_subscribers", "Websocket connections subscribed to transactions.");
+static auto& ws_notifications = metrics::get_counter(
+    "mvs_websocket_notifications_total", "Transaction notifications sent to subscribers.");
+
 void WsPushServ::run() {
     log::info(NAME) << "Websocket Service listen on " << node_.server_settings().websocket_listen;
 
@@ -154,6 +161,7 @@ void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_ha
         }
         if (subscribers.size() != subscribers_.size())
             subscribers_ = subscribers;
+        ws_subscribers.set(subscribers_.size());
     }
 
     /* ---------- may has subscribers ---------- */
@@ -188,6 +196,7 @@ void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_ha
         return;
 
     log::info(NAME) << " ******** notify_transaction: height [" << height << "]  ******** ";
+    ws_notifications.increment(notify_cons.size());
 
     Json::Value root;
     root["event"] = EV_PUBLISH;
@@ -255,12 +264,14 @@ void WsPushServ::refresh_connections()
         swap.emplace(&nc, con);
     }
     map_connections_.swap(swap);
+    ws_connections.set(map_connections_.size());
 }
 
 void WsPushServ::on_ws_handshake_done_handler(struct mg_connection& nc)
 {
     std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection* ptr) { (void)(ptr); });
     map_connections_.emplace(&nc, con);
+    ws_connections.set(map_connections_.size());
 
     std::string version("{\"event\": \"version\", " "\"result\": \"" MVS_VERSION "\"}");
     send_frame(nc, version);
@@ -332,6 +343,7 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                             subscribers_.insert({ week_con, {} });
                         else
                             subscribers_.insert({ week_con, { hash_addr } });
+                        ws_subscribers.set(subscribers_.size());
                         send_response(nc, EV_SUBSCRIBED, channel);
                     }
                 }
@@ -346,6 +358,7 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
                 std::lock_guard<std::mutex> guard(subscribers_lock_);
                 std::weak_ptr<struct mg_connection> week_con(it->second);
                 subscribers_.erase(week_con);
+                ws_subscribers.set(subscribers_.size());
                 send_response(nc, EV_UNSUBSCRIBED, channel);
             }
             else {
@@ -366,7 +379,16 @@ void WsPushServ::on_close_handler(struct mg_connection& nc)
 {
     if (is_websocket(nc))
     {
+        // Drop the subscription with the connection.
+        auto it = map_connections_.find(&nc);
+        if (it != map_connections_.end()) {
+            std::lock_guard<std::mutex> guard(subscribers_lock_);
+            subscribers_.erase(std::weak_ptr<struct mg_connection>(it->second));
+            ws_subscribers.set(subscribers_.size());
+        }
+
         map_connections_.erase(&nc);
+        ws_connections.set(map_connections_.size());
     }
 }
 
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_TEST_BENCH_HPP
+#define MVS_TEST_BENCH_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <metaverse/bitcoin.hpp>
+
+// Helpers shared by the benchmark suites of the test targets, which are only
+// built with BENCHMARK_TESTS defined.
+namespace bench {
+
+inline double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    const auto span = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double>(span).count();
+}
+
+// Distinct bytes for each index, to derive keys and hashes from.
+inline libbitcoin::data_chunk seed(uint32_t index)
+{
+    return libbitcoin::to_chunk(libbitcoin::to_little_endian(index));
+}
+
+// Counts down the jobs of a run, the caller waits for zero.
+class countdown
+{
+public:
+    countdown(size_t count)
+      : count_(count)
+    {
+    }
+
+    void done()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (--count_ == 0)
+            zero_.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        zero_.wait(lock, [this]() { return count_ == 0; });
+    }
+
+private:
+    size_t count_;
+    std::mutex mutex_;
+    std::condition_variable zero_;
+};
+
+} // namespace bench
+
+#endif
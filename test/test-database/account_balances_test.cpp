@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/path.hpp>
+#include <metaverse/blockchain/account_balances.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+// A multisig address, held by two accounts.
+const payment_address shared_address{ bitcoin_short_hash(
+    to_chunk(std::string("shared"))), payment_address::mainnet_p2sh };
+
+chain::transaction coinbase(uint32_t height, uint64_t value)
+{
+    chain::output output;
+    output.value = value;
+    output.script.operations = chain::operation::to_pay_script_hash_pattern(
+        shared_address.hash());
+
+    chain::transaction tx;
+    tx.version = chain::transaction_version::first;
+    tx.locktime = height;
+    tx.inputs.push_back({ { null_hash, max_uint32 }, {}, max_input_sequence });
+    tx.outputs.push_back(output);
+    return tx;
+}
+
+chain::block make_block(const hash_digest& previous, uint32_t height,
+    uint64_t value)
+{
+    chain::block block;
+    block.header.version = 1;
+    block.header.previous_block_hash = previous;
+    block.header.merkle = null_hash;
+    block.header.timestamp = height;
+    block.header.bits = 0;
+    block.header.nonce = height;
+    block.header.mixhash = 0;
+    block.header.number = height;
+    block.header.transaction_count = 1;
+    block.transactions.push_back(coinbase(height, value));
+    return block;
+}
+
+std::vector<chain::account_address> shared_addresses(size_t count)
+{
+    chain::account_address address;
+    address.set_address(shared_address.encoded());
+    return std::vector<chain::account_address>(count, address);
+}
+
+// A store of a genesis block paying the shared address, in a fresh
+// directory of the data path, with balances read from an empty pool.
+class balances_fixture
+{
+public:
+    balances_fixture()
+      : directory_(boost::filesystem::unique_path("balances-test-%%%%-%%%%")),
+        blocks_{ make_block(null_hash, 0, 100) },
+        reads_(0)
+    {
+        const auto data_path = default_data_path() / directory_;
+        boost::filesystem::create_directories(data_path);
+        BOOST_REQUIRE(database::data_base::initialize(data_path,
+            blocks_.back()));
+
+        database::settings configuration;
+        configuration.directory = directory_;
+        store_ = std::make_shared<database::data_base>(configuration);
+        BOOST_REQUIRE(store_->start());
+        balances_ = std::make_shared<account_balances>(*store_);
+    }
+
+    ~balances_fixture()
+    {
+        balances_.reset();
+        store_.reset();
+        boost::filesystem::remove_all(default_data_path() / directory_);
+    }
+
+    // The number of times the addresses were read.
+    size_t reads() const
+    {
+        return reads_;
+    }
+
+    account_balances& balances()
+    {
+        return *balances_;
+    }
+
+    // Store and connect a block paying the shared address.
+    void push(uint64_t value)
+    {
+        const auto height = static_cast<uint32_t>(blocks_.size());
+        blocks_.push_back(make_block(blocks_.back().header.hash(), height,
+            value));
+        store_->push(blocks_.back());
+        balances_->connect(blocks_.back(), height);
+    }
+
+    account_balances::balance get(const std::string& name,
+        uint64_t revision, size_t addresses = 1)
+    {
+        const auto read_addresses = [this, addresses]()
+        {
+            ++reads_;
+            return shared_addresses(addresses);
+        };
+
+        const auto read_pool = []()
+        {
+            return message::transaction_message::ptr_list{};
+        };
+
+        account_balances::balance out;
+        balances_->get(name, revision, read_addresses, blocks_.size() - 1, 0,
+            read_pool, out);
+        return out;
+    }
+
+private:
+    const boost::filesystem::path directory_;
+    std::vector<chain::block> blocks_;
+    std::shared_ptr<database::data_base> store_;
+    std::shared_ptr<account_balances> balances_;
+    size_t reads_;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(account_balances_tests)
+
+BOOST_AUTO_TEST_CASE(account_balances__connect__shared_address__both_owners)
+{
+    balances_fixture fixture;
+    BOOST_REQUIRE_EQUAL(fixture.get("alice", 1).total_received, 100u);
+    BOOST_REQUIRE_EQUAL(fixture.get("bob", 1).total_received, 100u);
+
+    fixture.push(50);
+    BOOST_REQUIRE_EQUAL(fixture.get("alice", 1).total_received, 150u);
+    BOOST_REQUIRE_EQUAL(fixture.get("bob", 1).unspent_balance, 150u);
+}
+
+BOOST_AUTO_TEST_CASE(account_balances__remove__shared_address__co_owner_kept)
+{
+    balances_fixture fixture;
+    fixture.get("alice", 1);
+    fixture.get("bob", 1);
+
+    fixture.balances().remove("alice");
+    fixture.push(50);
+    BOOST_REQUIRE_EQUAL(fixture.get("bob", 1).total_received, 150u);
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(account_balances__get__same_revision__addresses_not_read)
+{
+    balances_fixture fixture;
+    fixture.get("alice", 1);
+    fixture.get("alice", 1);
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 1u);
+
+    fixture.get("alice", 2);
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(account_balances__get__address_stored_twice__counted_once)
+{
+    balances_fixture fixture;
+    BOOST_REQUIRE_EQUAL(fixture.get("alice", 1, 2).total_received, 100u);
+
+    fixture.push(50);
+    BOOST_REQUIRE_EQUAL(fixture.get("alice", 1, 2).total_received, 150u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/account_sessions.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+static const std::string account = "bench";
+static const std::string passphrase = "bench-passphrase";
+
+chain::account_address::list make_addresses(uint32_t count)
+{
+    chain::account_address::list addresses;
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const auto seed = bench::seed(index);
+
+        auto key = passphrase;
+        chain::account_address address;
+        address.set_prv_key(encode_base16(sha256_hash(seed)), key);
+        address.set_address("address" + std::to_string(index));
+        addresses.push_back(address);
+    }
+
+    return addresses;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_account_sessions_bench)
+
+// The signing key lookups done by the transfer helpers, one per candidate
+// address, with and without an unlocked session. A full sends/sec figure
+// needs a running node and is not measured here.
+BOOST_AUTO_TEST_CASE(case_account_sessions_keys_per_second)
+{
+    static const uint32_t count = 1000;
+    const auto addresses = make_addresses(count);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t decrypted = 0;
+    for (const auto& address: addresses)
+    {
+        auto key = passphrase;
+        ec_secret secret;
+        ec_compressed point;
+        if (decode_base16(secret, address.get_prv_key(key)) &&
+            secret_to_public(point, secret))
+            ++decrypted;
+    }
+
+    const auto decrypt = bench::seconds_since(start);
+    BOOST_REQUIRE_EQUAL(decrypted, count);
+
+    account_sessions sessions;
+    auto key = passphrase;
+    start = std::chrono::steady_clock::now();
+    BOOST_REQUIRE_EQUAL(sessions.unlock(account, addresses, key, 60), count);
+    const auto unlock = bench::seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (const auto& address: addresses)
+    {
+        ec_secret secret;
+        ec_compressed point;
+        if (sessions.find(account, address.get_address(), secret, point))
+            ++found;
+    }
+
+    const auto held = bench::seconds_since(start);
+    BOOST_REQUIRE_EQUAL(found, count);
+    BOOST_REQUIRE(sessions.lock(account));
+
+    std::cout << "account keys decrypted: " << count / decrypt
+        << " keys/sec" << std::endl;
+    std::cout << "account unlock of " << count << " keys: " << unlock
+        << " sec" << std::endl;
+    std::cout << "account keys from session: " << count / held
+        << " keys/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/path.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+
+namespace {
+
+short_hash key_hash(uint32_t seed)
+{
+    return bitcoin_short_hash(to_chunk(to_little_endian(seed)));
+}
+
+// The inputs spend a script hash output, so that their address is read from
+// the redeem script.
+data_chunk redeem_script()
+{
+    const chain::script redeem{ chain::operation::to_pay_key_hash_pattern(
+        key_hash(max_uint32)) };
+    return redeem.to_data(false);
+}
+
+chain::output pay(uint32_t seed, uint64_t value)
+{
+    chain::output output;
+    output.value = value;
+    output.script.operations =
+        chain::operation::to_pay_key_hash_pattern(key_hash(seed));
+    return output;
+}
+
+chain::input sign(const chain::output_point& previous)
+{
+    chain::input input;
+    input.previous_output = previous;
+    input.sequence = max_input_sequence;
+    input.script.operations =
+    {
+        { chain::opcode::special, data_chunk(71, 0x30) },
+        { chain::opcode::special, redeem_script() }
+    };
+
+    return input;
+}
+
+chain::transaction coinbase(uint32_t height, uint32_t seed)
+{
+    chain::transaction tx;
+    tx.version = chain::transaction_version::first;
+    tx.locktime = height;
+    tx.inputs.push_back({ { null_hash, max_uint32 }, {}, max_input_sequence });
+    tx.outputs.push_back(pay(seed, 100));
+    return tx;
+}
+
+chain::block make_block(const hash_digest& previous, uint32_t height,
+    const chain::transaction::list& transactions)
+{
+    chain::block block;
+    block.header.version = 1;
+    block.header.previous_block_hash = previous;
+    block.header.merkle = null_hash;
+    block.header.timestamp = height;
+    block.header.bits = 0;
+    block.header.nonce = height;
+    block.header.mixhash = 0;
+    block.header.number = height;
+    block.header.transaction_count = transactions.size();
+    block.transactions = transactions;
+    return block;
+}
+
+// The index rows of the addresses the blocks of the fixture pay or sign with.
+struct snapshot
+{
+    snapshot(data_base& store)
+    {
+        for (uint32_t seed = 0; seed < 16; ++seed)
+            capture(store, { key_hash(seed), payment_address::mainnet_p2kh });
+
+        capture(store, { bitcoin_short_hash(redeem_script()),
+            payment_address::mainnet_p2sh });
+    }
+
+    void capture(data_base& store, const payment_address& address)
+    {
+        history.push_back(store.history.get(address.hash(), 0, 0).size());
+
+        const auto encoded = address.encoded();
+        const auto asset_key = ripemd160_hash(
+            data_chunk(encoded.begin(), encoded.end()));
+        assets.push_back(store.address_assets.get(asset_key, 0, 0).size());
+    }
+
+    std::vector<size_t> history;
+    std::vector<size_t> assets;
+};
+
+// A store of the genesis block, in a fresh directory of the data path where
+// the database settings resolve their directory.
+class chain_fixture
+{
+public:
+    chain_fixture()
+      : directory_(boost::filesystem::unique_path("undo-test-%%%%-%%%%")),
+        genesis_(make_block(null_hash, 0, { coinbase(0, 0) }))
+    {
+        const auto data_path = default_data_path() / directory_;
+        boost::filesystem::create_directories(data_path);
+        BOOST_REQUIRE(data_base::initialize(data_path, genesis_));
+        blocks_.push_back(genesis_);
+    }
+
+    ~chain_fixture()
+    {
+        store_.reset();
+        boost::filesystem::remove_all(default_data_path() / directory_);
+    }
+
+    data_base& open(uint32_t undo_depth)
+    {
+        store_.reset();
+        database::settings configuration;
+        configuration.directory = directory_;
+        configuration.block_undo_depth = undo_depth;
+        store_ = std::make_shared<data_base>(configuration);
+        BOOST_REQUIRE(store_->start());
+        return *store_;
+    }
+
+    void close()
+    {
+        BOOST_REQUIRE(store_->close());
+        store_.reset();
+    }
+
+    uint64_t undo_file_size() const
+    {
+        return boost::filesystem::file_size(
+            default_data_path() / directory_ / "block_undo_table");
+    }
+
+    // Pay a new key and spend the coinbase of the previous block to another.
+    const chain::block& next()
+    {
+        const auto height = static_cast<uint32_t>(blocks_.size());
+        const auto& previous = blocks_.back();
+
+        chain::transaction spend;
+        spend.version = chain::transaction_version::first;
+        spend.locktime = 0;
+        spend.inputs.push_back(sign({ previous.transactions[0].hash(), 0 }));
+        BOOST_REQUIRE(payment_address::extract(spend.inputs[0].script));
+        spend.outputs.push_back(pay(height + 4, 60));
+        spend.outputs.push_back(pay(height, 40));
+
+        blocks_.push_back(make_block(previous.header.hash(), height,
+            { coinbase(height, height), spend }));
+        return blocks_.back();
+    }
+
+    const chain::block& block(size_t height) const
+    {
+        return blocks_[height];
+    }
+
+private:
+    const boost::filesystem::path directory_;
+    const chain::block genesis_;
+    std::vector<chain::block> blocks_;
+    std::shared_ptr<data_base> store_;
+};
+
+void require_equal(const snapshot& left, const snapshot& right)
+{
+    BOOST_REQUIRE(left.history == right.history);
+    BOOST_REQUIRE(left.assets == right.assets);
+}
+
+void require_popped(data_base& store, const chain::block& block)
+{
+    BOOST_REQUIRE(!store.blocks.get(block.header.hash()));
+
+    for (const auto& tx: block.transactions)
+    {
+        BOOST_REQUIRE(!store.transactions.get(tx.hash()));
+
+        if (!tx.is_coinbase())
+            for (const auto& input: tx.inputs)
+                BOOST_REQUIRE(!store.spends.get(input.previous_output).valid);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(block_undo_tests)
+
+BOOST_AUTO_TEST_CASE(block_undo__rows__round_trip)
+{
+    block_undo undo;
+    BOOST_REQUIRE(undo.empty());
+
+    const chain::output_point point{ hash_literal(
+        "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b"),
+        7 };
+    undo.add_transaction(point.hash);
+    undo.add_spend(point);
+    undo.add_history(key_hash(1));
+    undo.add_address_asset(key_hash(2));
+    undo.add_asset(null_hash);
+
+    const auto rows = undo.rows();
+    BOOST_REQUIRE_EQUAL(rows.size(), 5u);
+    BOOST_REQUIRE(rows[0].kind == block_undo::row_kind::transaction);
+    BOOST_REQUIRE(rows[0].hash == point.hash);
+    BOOST_REQUIRE(rows[1].kind == block_undo::row_kind::spend);
+    BOOST_REQUIRE(rows[1].point == point);
+    BOOST_REQUIRE(rows[2].kind == block_undo::row_kind::history);
+    BOOST_REQUIRE(rows[2].key == key_hash(1));
+    BOOST_REQUIRE(rows[3].kind == block_undo::row_kind::address_asset);
+    BOOST_REQUIRE(rows[3].key == key_hash(2));
+    BOOST_REQUIRE(rows[4].kind == block_undo::row_kind::asset);
+    BOOST_REQUIRE(rows[4].hash == null_hash);
+}
+
+BOOST_AUTO_TEST_CASE(data_base__pop__undo_rows__same_as_script_scan)
+{
+    chain_fixture fixture;
+    auto& store = fixture.open(0);
+    const snapshot before(store);
+
+    const auto& block = fixture.next();
+    store.push(block);
+    BOOST_REQUIRE(snapshot(store).history != before.history);
+
+    // The rows stored with the block are replayed.
+    block_undo undo;
+    BOOST_REQUIRE(store.block_undos.get(block.header.hash(), undo));
+    BOOST_REQUIRE(!undo.empty());
+    store.pop();
+    require_popped(store, block);
+    require_equal(snapshot(store), before);
+    BOOST_REQUIRE(!store.block_undos.get(block.header.hash(), undo));
+
+    // Without them the scripts are read again, to the same rows.
+    store.push(block);
+    BOOST_REQUIRE(store.block_undos.remove(block.header.hash()));
+    store.pop();
+    require_popped(store, block);
+    require_equal(snapshot(store), before);
+}
+
+BOOST_AUTO_TEST_CASE(data_base__push__undo_depth__deeper_rows_pruned)
+{
+    static const uint32_t depth = 2;
+    chain_fixture fixture;
+    auto& store = fixture.open(depth);
+
+    for (size_t height = 1; height <= 4; ++height)
+        store.push(fixture.next());
+
+    block_undo undo;
+    for (size_t height = 0; height <= 4; ++height)
+        BOOST_REQUIRE_EQUAL(store.block_undos.get(
+            fixture.block(height).header.hash(), undo), height > 4 - depth);
+
+    // The pruned blocks still pop, by script scan.
+    store.push(fixture.next());
+    const snapshot first(store);
+    store.pop();
+
+    for (size_t height = 4; height >= 1; --height)
+    {
+        store.pop();
+        require_popped(store, fixture.block(height));
+    }
+
+    auto& restarted = fixture.open(0);
+    for (size_t height = 1; height <= 5; ++height)
+        restarted.push(fixture.block(height));
+
+    require_equal(snapshot(restarted), first);
+}
+
+BOOST_AUTO_TEST_CASE(data_base__start__undo_depth__pruned_space_reused)
+{
+    static const uint32_t depth = 2;
+    chain_fixture fixture;
+    fixture.open(depth);
+    fixture.close();
+    const auto empty = fixture.undo_file_size();
+
+    auto& store = fixture.open(depth);
+    for (size_t height = 1; height <= 16; ++height)
+        store.push(fixture.next());
+
+    fixture.close();
+    const auto grown = fixture.undo_file_size();
+    BOOST_REQUIRE_GT(grown, empty);
+
+    // Starting compacts the table to the rows of the top blocks.
+    auto& restarted = fixture.open(depth);
+    block_undo undo;
+    for (size_t height = 0; height <= 16; ++height)
+        BOOST_REQUIRE_EQUAL(restarted.block_undos.get(
+            fixture.block(height).header.hash(), undo), height > 16 - depth);
+
+    fixture.close();
+    BOOST_REQUIRE_LT(fixture.undo_file_size(), grown);
+
+    // The kept rows still pop the top blocks.
+    auto& reopened = fixture.open(depth);
+    reopened.pop();
+    reopened.pop();
+    require_popped(reopened, fixture.block(16));
+    require_popped(reopened, fixture.block(15));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
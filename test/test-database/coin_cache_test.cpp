@@ -0,0 +1,221 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/coin_cache.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+chain::output make_output(uint64_t value)
+{
+    chain::output output;
+    output.value = value;
+    return output;
+}
+
+chain::input make_input(const chain::output_point& previous)
+{
+    chain::input input;
+    input.previous_output = previous;
+    input.sequence = max_uint32;
+    return input;
+}
+
+// The nonce keeps the coinbases of the blocks distinct.
+chain::transaction make_coinbase(uint32_t nonce, size_t outputs)
+{
+    chain::transaction tx;
+    tx.version = 1;
+    tx.locktime = nonce;
+    tx.inputs.push_back(make_input({ null_hash, max_uint32 }));
+    for (size_t index = 0; index < outputs; ++index)
+        tx.outputs.push_back(make_output(50 + index));
+
+    return tx;
+}
+
+chain::transaction make_spend(const chain::output_point& previous,
+    uint64_t value)
+{
+    chain::transaction tx;
+    tx.version = 1;
+    tx.locktime = 0;
+    tx.inputs.push_back(make_input(previous));
+    tx.outputs.push_back(make_output(value));
+    return tx;
+}
+
+chain::block make_block(const chain::transaction::list& transactions)
+{
+    chain::block block;
+    block.transactions = transactions;
+    return block;
+}
+
+bool cached(const coin_cache& cache, const chain::output_point& point)
+{
+    coin_cache::coin coin;
+    return cache.get(coin, point);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(coin_cache_tests)
+
+BOOST_AUTO_TEST_CASE(coin_cache__connect__zero_capacity__disabled)
+{
+    coin_cache cache(0);
+    const auto coinbase = make_coinbase(1, 2);
+    cache.connect(make_block({ coinbase }), 1);
+    BOOST_REQUIRE(!cached(cache, { coinbase.hash(), 0 }));
+    BOOST_REQUIRE_EQUAL(cache.stats().coins, 0u);
+    BOOST_REQUIRE_EQUAL(cache.stats().bytes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(coin_cache__connect__outputs__cached_with_height)
+{
+    coin_cache cache(1000000);
+    const auto coinbase = make_coinbase(1, 2);
+    const auto spend = make_spend({ null_hash, 7 }, 42);
+    cache.connect(make_block({ coinbase, spend }), 10);
+    BOOST_REQUIRE_EQUAL(cache.stats().coins, 3u);
+
+    coin_cache::coin coin;
+    BOOST_REQUIRE(cache.get(coin, { coinbase.hash(), 1 }));
+    BOOST_REQUIRE_EQUAL(coin.output.value, 51u);
+    BOOST_REQUIRE_EQUAL(coin.height, 10u);
+    BOOST_REQUIRE(coin.coinbase);
+
+    BOOST_REQUIRE(cache.get(coin, { spend.hash(), 0 }));
+    BOOST_REQUIRE_EQUAL(coin.output.value, 42u);
+    BOOST_REQUIRE(!coin.coinbase);
+
+    BOOST_REQUIRE(!cached(cache, { coinbase.hash(), 2 }));
+    BOOST_REQUIRE_EQUAL(cache.stats().hits, 2u);
+    BOOST_REQUIRE_EQUAL(cache.stats().misses, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(coin_cache__connect__spends__removed)
+{
+    coin_cache cache(1000000);
+    const auto coinbase = make_coinbase(1, 2);
+    cache.connect(make_block({ coinbase }), 1);
+
+    // One spend in a later block, one of an output of its own block.
+    const auto first = make_spend({ coinbase.hash(), 0 }, 10);
+    const auto second = make_spend({ first.hash(), 0 }, 9);
+    cache.connect(make_block({ make_coinbase(2, 1), first, second }), 2);
+
+    BOOST_REQUIRE(!cached(cache, { coinbase.hash(), 0 }));
+    BOOST_REQUIRE(cached(cache, { coinbase.hash(), 1 }));
+    BOOST_REQUIRE(!cached(cache, { first.hash(), 0 }));
+    BOOST_REQUIRE(cached(cache, { second.hash(), 0 }));
+    BOOST_REQUIRE_EQUAL(cache.stats().coins, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(coin_cache__disconnect__block__outputs_removed_spends_not_restored)
+{
+    coin_cache cache(1000000);
+    const auto coinbase = make_coinbase(1, 1);
+    cache.connect(make_block({ coinbase }), 1);
+    const auto before = cache.stats().bytes;
+
+    const auto spend = make_spend({ coinbase.hash(), 0 }, 10);
+    const auto block = make_block({ make_coinbase(2, 1), spend });
+    cache.connect(block, 2);
+    cache.disconnect(block);
+
+    // The spent coin is left to the database.
+    BOOST_REQUIRE(!cached(cache, { spend.hash(), 0 }));
+    BOOST_REQUIRE(!cached(cache, { coinbase.hash(), 0 }));
+    BOOST_REQUIRE_EQUAL(cache.stats().coins, 0u);
+    BOOST_REQUIRE_EQUAL(cache.stats().bytes, 0u);
+
+    cache.connect(make_block({ coinbase }), 1);
+    BOOST_REQUIRE_EQUAL(cache.stats().bytes, before);
+}
+
+BOOST_AUTO_TEST_CASE(coin_cache__connect__over_capacity__oldest_evicted)
+{
+    coin_cache probe(1000000);
+    probe.connect(make_block({ make_coinbase(0, 1) }), 0);
+    const auto coin_bytes = probe.stats().bytes;
+
+    // Room for four coins.
+    coin_cache cache(4 * coin_bytes);
+    chain::transaction::list coinbases;
+    for (uint32_t height = 0; height < 6; ++height)
+    {
+        coinbases.push_back(make_coinbase(height, 1));
+        cache.connect(make_block({ coinbases.back() }), height);
+        BOOST_REQUIRE_LE(cache.stats().bytes, cache.stats().capacity);
+    }
+
+    BOOST_REQUIRE_EQUAL(cache.stats().coins, 4u);
+    BOOST_REQUIRE(!cached(cache, { coinbases[0].hash(), 0 }));
+    BOOST_REQUIRE(!cached(cache, { coinbases[1].hash(), 0 }));
+    for (size_t index = 2; index < coinbases.size(); ++index)
+        BOOST_REQUIRE(cached(cache, { coinbases[index].hash(), 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(coin_cache__connect__spent_points__skipped_by_eviction)
+{
+    coin_cache probe(1000000);
+    probe.connect(make_block({ make_coinbase(0, 1) }), 0);
+    const auto coin_bytes = probe.stats().bytes;
+
+    coin_cache cache(2 * coin_bytes);
+    const auto oldest = make_coinbase(0, 1);
+    const auto newer = make_coinbase(1, 1);
+    cache.connect(make_block({ oldest }), 0);
+    cache.connect(make_block({ newer }), 1);
+
+    // Spending the oldest leaves its point in the order, the next eviction
+    // must not count it as room made.
+    const auto spend = make_spend({ oldest.hash(), 0 }, 1);
+    cache.connect(make_block({ make_coinbase(2, 1), spend }), 2);
+
+    BOOST_REQUIRE_EQUAL(cache.stats().coins, 2u);
+    BOOST_REQUIRE(!cached(cache, { newer.hash(), 0 }));
+    BOOST_REQUIRE(cached(cache, { spend.hash(), 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(coin_cache__clear__coins_dropped_statistics_kept)
+{
+    coin_cache cache(1000000);
+    const auto coinbase = make_coinbase(1, 1);
+    cache.connect(make_block({ coinbase }), 1);
+    BOOST_REQUIRE(cached(cache, { coinbase.hash(), 0 }));
+
+    cache.clear();
+    BOOST_REQUIRE(!cached(cache, { coinbase.hash(), 0 }));
+    BOOST_REQUIRE_EQUAL(cache.stats().coins, 0u);
+    BOOST_REQUIRE_EQUAL(cache.stats().bytes, 0u);
+    BOOST_REQUIRE_EQUAL(cache.stats().hits, 1u);
+    BOOST_REQUIRE_EQUAL(cache.stats().misses, 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/explorer/extensions/coin_selection.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::explorer::commands;
+
+namespace {
+
+// The input limit of a transfer, as in base_transfer_helper.
+static const size_t max_inputs = 677;
+
+// Etp coins of 0.001 to about 10 etp, from a fixed linear congruential
+// sequence so that every strategy sees the same wallet.
+utxo_list make_coins(size_t count, uint64_t& out_total)
+{
+    utxo_list coins;
+    coins.reserve(count);
+    out_total = 0;
+    uint64_t state = 42;
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+
+        address_asset_record coin;
+        coin.addr = "address" + std::to_string(index % 100);
+        coin.amount = 100000 + (state >> 33) % 1000000000;
+        coin.asset_amount = 0;
+        coin.type = utxo_attach_type::etp;
+        coin.output = { null_hash, index };
+        coin.hd_index = 0;
+        coins.push_back(coin);
+        out_total += coin.amount;
+    }
+
+    return coins;
+}
+
+void run(coin_selection strategy, const std::string& name,
+    const utxo_list& coins, uint64_t total)
+{
+    static const size_t payments = 200;
+
+    size_t inputs = 0;
+    uint64_t change = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t payment = 1; payment <= payments; ++payment)
+    {
+        // Spread the amounts from a small payment to a tenth of the wallet.
+        const auto amount = total / 10 / payments * payment + 12345;
+
+        utxo_list selected;
+        BOOST_REQUIRE(select_coins(strategy, coins, "", amount, 0,
+            max_inputs, selected));
+
+        uint64_t value = 0;
+        for (const auto& coin: selected)
+            value += coin.amount;
+
+        BOOST_REQUIRE_GE(value, amount);
+        inputs += selected.size();
+        change += value - amount;
+    }
+
+    const auto elapsed = bench::seconds_since(start);
+    std::cout << "select coins " << name << ": " << payments / elapsed
+        << " selections/sec, " << double(inputs) / payments
+        << " inputs and " << change / payments << " change on average"
+        << std::endl;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_coin_selection_bench)
+
+BOOST_AUTO_TEST_CASE(case_coin_selection_strategies_over_10k_coins)
+{
+    uint64_t total;
+    const auto coins = make_coins(10000, total);
+
+    run(coin_selection::branch_and_bound, "branch-and-bound", coins, total);
+    run(coin_selection::largest_first, "largest-first", coins, total);
+    run(coin_selection::minimize_inputs, "minimize-inputs", coins, total);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
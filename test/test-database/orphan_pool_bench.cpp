@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/block_detail.hpp>
+#include <metaverse/blockchain/orphan_pool.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+// A chain of empty blocks, each building on the one before it.
+block_detail::list make_chain(const hash_digest& root, size_t count)
+{
+    block_detail::list chain;
+    chain.reserve(count);
+    auto previous = root;
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        chain::block block;
+        block.header.version = 1;
+        block.header.previous_block_hash = previous;
+        block.header.merkle = null_hash;
+        block.header.timestamp = index;
+        block.header.bits = 0;
+        block.header.nonce = index;
+        block.header.mixhash = 0;
+        block.header.number = index;
+        block.header.transaction_count = 0;
+
+        const auto detail = std::make_shared<block_detail>(std::move(block));
+        previous = detail->hash();
+        chain.push_back(detail);
+    }
+
+    return chain;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_orphan_pool_bench)
+
+BOOST_AUTO_TEST_CASE(case_orphan_pool_10k_chained_orphans)
+{
+    static const size_t count = 10000;
+    const auto root = sha256_hash(to_chunk(std::string("root")));
+    const auto chain = make_chain(root, count);
+    orphan_pool pool(count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& block: chain)
+        BOOST_REQUIRE(pool.add(block));
+
+    const auto add = bench::seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    const auto trace = pool.trace(chain.back());
+    const auto traced = bench::seconds_since(start);
+    BOOST_REQUIRE_EQUAL(trace.size(), count);
+    BOOST_REQUIRE(trace.front() == chain.front());
+
+    start = std::chrono::steady_clock::now();
+    const auto descendants = pool.descendants(root);
+    const auto walked = bench::seconds_since(start);
+    BOOST_REQUIRE_EQUAL(descendants.size(), count);
+
+    start = std::chrono::steady_clock::now();
+    const auto unprocessed = pool.unprocessed();
+    const auto listed = bench::seconds_since(start);
+    BOOST_REQUIRE_EQUAL(unprocessed.size(), count);
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& block: chain)
+        pool.remove(block);
+
+    const auto removed = bench::seconds_since(start);
+    BOOST_REQUIRE(pool.descendants(root).empty());
+
+    std::cout << "orphan pool add: " << count / add << " blocks/sec"
+        << std::endl;
+    std::cout << "orphan pool trace of " << count << ": " << traced * 1000
+        << " ms" << std::endl;
+    std::cout << "orphan pool descendants of " << count << ": "
+        << walked * 1000 << " ms" << std::endl;
+    std::cout << "orphan pool unprocessed of " << count << ": "
+        << listed * 1000 << " ms" << std::endl;
+    std::cout << "orphan pool remove: " << count / removed << " blocks/sec"
+        << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(case_orphan_pool_evicts_oldest_at_capacity)
+{
+    static const size_t capacity = 1000;
+    const auto root = sha256_hash(to_chunk(std::string("root")));
+    const auto chain = make_chain(root, 10 * capacity);
+    orphan_pool pool(capacity);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& block: chain)
+        BOOST_REQUIRE(pool.add(block));
+
+    const auto elapsed = bench::seconds_since(start);
+
+    // Only the newest blocks remain, and they still chain to the last one.
+    BOOST_REQUIRE_EQUAL(pool.unprocessed().size(), capacity);
+    BOOST_REQUIRE_EQUAL(pool.trace(chain.back()).size(), capacity);
+    std::cout << "orphan pool add with eviction: " << chain.size() / elapsed
+        << " blocks/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
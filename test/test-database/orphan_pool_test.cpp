@@ -0,0 +1,199 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/block_detail.hpp>
+#include <metaverse/blockchain/orphan_pool.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+block_detail::ptr make_block(const hash_digest& previous, uint32_t nonce)
+{
+    chain::block block;
+    block.header.version = 1;
+    block.header.previous_block_hash = previous;
+    block.header.merkle = null_hash;
+    block.header.timestamp = nonce;
+    block.header.bits = 0;
+    block.header.nonce = nonce;
+    block.header.mixhash = 0;
+    block.header.number = nonce;
+    block.header.transaction_count = 0;
+    return std::make_shared<block_detail>(std::move(block));
+}
+
+size_t position(const block_detail::list& blocks, block_detail::ptr block)
+{
+    return std::distance(blocks.begin(),
+        std::find(blocks.begin(), blocks.end(), block));
+}
+
+// root <- a1 <- a2 <- a3
+//         a1 <- b2 <- b3
+// root <- c1
+// (missing) <- d2
+struct fork_fixture
+{
+    fork_fixture()
+      : pool(100),
+        root(sha256_hash(to_chunk(std::string("root")))),
+        a1(make_block(root, 1)),
+        a2(make_block(a1->hash(), 2)),
+        a3(make_block(a2->hash(), 3)),
+        b2(make_block(a1->hash(), 4)),
+        b3(make_block(b2->hash(), 5)),
+        c1(make_block(root, 6)),
+        d2(make_block(sha256_hash(to_chunk(std::string("missing"))), 7))
+    {
+        // Children arrive before their parents, as orphans do.
+        for (const auto& block: { a3, b3, a2, b2, d2, c1, a1 })
+            BOOST_REQUIRE(pool.add(block));
+    }
+
+    orphan_pool pool;
+    const hash_digest root;
+    const block_detail::ptr a1, a2, a3, b2, b3, c1, d2;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_orphan_pool)
+
+BOOST_FIXTURE_TEST_CASE(case_orphan_pool_rejects_duplicates, fork_fixture)
+{
+    BOOST_CHECK(!pool.add(a2));
+    BOOST_CHECK(!pool.add(make_block(a1->hash(), 2)));
+}
+
+BOOST_FIXTURE_TEST_CASE(case_orphan_pool_trace_follows_parents, fork_fixture)
+{
+    BOOST_CHECK(pool.trace(a3) == block_detail::list({ a1, a2, a3 }));
+    BOOST_CHECK(pool.trace(b3) == block_detail::list({ a1, b2, b3 }));
+    BOOST_CHECK(pool.trace(c1) == block_detail::list({ c1 }));
+    BOOST_CHECK(pool.trace(d2) == block_detail::list({ d2 }));
+
+    // A block outside the pool traces back into it.
+    const auto a4 = make_block(a3->hash(), 8);
+    BOOST_CHECK(pool.trace(a4) == block_detail::list({ a1, a2, a3, a4 }));
+}
+
+BOOST_FIXTURE_TEST_CASE(case_orphan_pool_descendants, fork_fixture)
+{
+    const auto all = pool.descendants(root);
+    BOOST_REQUIRE_EQUAL(all.size(), 6u);
+
+    // Parents come before their children.
+    BOOST_CHECK_LT(position(all, a1), position(all, a2));
+    BOOST_CHECK_LT(position(all, a2), position(all, a3));
+    BOOST_CHECK_LT(position(all, a1), position(all, b2));
+    BOOST_CHECK_LT(position(all, b2), position(all, b3));
+    BOOST_CHECK_LT(position(all, c1), all.size());
+    BOOST_CHECK_EQUAL(position(all, d2), all.size());
+
+    auto branch = pool.descendants(a1->hash());
+    BOOST_CHECK_EQUAL(branch.size(), 4u);
+    BOOST_CHECK(pool.descendants(a3->hash()).empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(case_orphan_pool_remove_splits_chains, fork_fixture)
+{
+    pool.remove(a2);
+
+    BOOST_CHECK(pool.trace(a3) == block_detail::list({ a3 }));
+    BOOST_CHECK(pool.trace(b3) == block_detail::list({ a1, b2, b3 }));
+
+    const auto branch = pool.descendants(a1->hash());
+    BOOST_REQUIRE_EQUAL(branch.size(), 2u);
+    BOOST_CHECK(branch.front() == b2);
+
+    // Removing a different block with the same hash does nothing.
+    pool.remove(make_block(a1->hash(), 4));
+    BOOST_CHECK_EQUAL(pool.descendants(a1->hash()).size(), 2u);
+
+    BOOST_CHECK(pool.add(a2));
+    BOOST_CHECK(pool.trace(a3) == block_detail::list({ a1, a2, a3 }));
+}
+
+BOOST_FIXTURE_TEST_CASE(case_orphan_pool_unprocessed_newest_first,
+    fork_fixture)
+{
+    b3->set_processed();
+    const auto unprocessed = pool.unprocessed();
+    BOOST_CHECK(unprocessed ==
+        block_detail::list({ a1, c1, d2, b2, a2, a3 }));
+}
+
+BOOST_FIXTURE_TEST_CASE(case_orphan_pool_filter, fork_fixture)
+{
+    const auto other = sha256_hash(to_chunk(std::string("other")));
+    const auto message = std::make_shared<message::get_data>(
+        hash_list{ a1->hash(), other, c1->hash() },
+        message::inventory::type_id::block);
+
+    pool.filter(message);
+    BOOST_REQUIRE_EQUAL(message->inventories.size(), 1u);
+    BOOST_CHECK(message->inventories.front().hash == other);
+}
+
+BOOST_AUTO_TEST_CASE(case_orphan_pool_evicts_oldest)
+{
+    orphan_pool pool(3);
+    block_detail::list chain;
+    auto previous = null_hash;
+
+    for (uint32_t nonce = 0; nonce < 5; ++nonce)
+    {
+        chain.push_back(make_block(previous, nonce));
+        previous = chain.back()->hash();
+        BOOST_REQUIRE(pool.add(chain.back()));
+    }
+
+    BOOST_CHECK(pool.trace(chain[4]) ==
+        block_detail::list({ chain[2], chain[3], chain[4] }));
+    BOOST_CHECK(pool.descendants(chain[0]->hash()).empty());
+    BOOST_CHECK_EQUAL(pool.descendants(chain[1]->hash()).size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(case_orphan_pool_evicts_by_bytes)
+{
+    const auto first = make_block(null_hash, 0);
+    const chain::block& block = *first->actual();
+    const auto size = block.serialized_size();
+
+    // Room for two blocks by bytes, though the count allows ten.
+    orphan_pool pool(10, 2 * size + size / 2);
+    const auto second = make_block(first->hash(), 1);
+    const auto third = make_block(second->hash(), 2);
+
+    BOOST_REQUIRE(pool.add(first));
+    BOOST_REQUIRE(pool.add(second));
+    BOOST_REQUIRE(pool.add(third));
+    BOOST_CHECK(pool.unprocessed() == block_detail::list({ third, second }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/path.hpp>
+#include <metaverse/blockchain/block_chain_impl.hpp>
+#include <metaverse/blockchain/settings.hpp>
+#include <metaverse/consensus/miner.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+static const size_t pool_threads = 4;
+
+// A chain holding only the genesis block, in a fresh directory of the data
+// path, where the database settings resolve their directory.
+class genesis_chain
+{
+public:
+    genesis_chain(uint32_t backlog)
+      : directory_(boost::filesystem::unique_path("pool-bench-%%%%-%%%%")),
+        pool_(pool_threads)
+    {
+        const auto data_path = default_data_path() / directory_;
+        boost::filesystem::create_directories(data_path);
+        const auto genesis = consensus::miner::create_genesis_block(false);
+        BOOST_REQUIRE(database::data_base::initialize(data_path, *genesis));
+
+        chain_settings_.transaction_pool_backlog = backlog;
+        database_settings_.directory = directory_;
+        jobs_.start(pool_threads);
+        chain_ = std::make_shared<block_chain_impl>(pool_, jobs_,
+            chain_settings_, database_settings_);
+        BOOST_REQUIRE(chain_->start());
+    }
+
+    ~genesis_chain()
+    {
+        chain_->stop();
+        jobs_.stop();
+        pool_.shutdown();
+        pool_.join();
+        chain_->close();
+        chain_.reset();
+        boost::filesystem::remove_all(default_data_path() / directory_);
+    }
+
+    transaction_pool& pool()
+    {
+        return chain_->pool();
+    }
+
+private:
+    const boost::filesystem::path directory_;
+    blockchain::settings chain_settings_;
+    database::settings database_settings_;
+    threadpool pool_;
+    scheduler jobs_;
+    std::shared_ptr<block_chain_impl> chain_;
+};
+
+// Well formed transactions spending outputs the chain does not have, so each
+// passes the lookup stage and is refused by the pool stage.
+std::vector<transaction_message::ptr> make_transactions(size_t count)
+{
+    std::vector<transaction_message::ptr> transactions;
+    transactions.reserve(count);
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const auto seed = bench::seed(index);
+
+        chain::input input;
+        input.previous_output = { sha256_hash(seed), 0 };
+        input.sequence = max_input_sequence;
+
+        chain::output output;
+        output.value = 1;
+        output.script.operations = chain::operation::to_pay_key_hash_pattern(
+            bitcoin_short_hash(seed));
+
+        chain::transaction tx;
+        tx.version = chain::transaction_version::first;
+        tx.locktime = 0;
+        tx.inputs.push_back(input);
+        tx.outputs.push_back(output);
+        transactions.push_back(std::make_shared<transaction_message>(tx));
+    }
+
+    return transactions;
+}
+
+struct outcome
+{
+    std::atomic<size_t> missing{ 0 };
+    std::atomic<size_t> refused{ 0 };
+    std::atomic<size_t> other{ 0 };
+};
+
+double run(transaction_pool& pool,
+    const std::vector<transaction_message::ptr>& transactions,
+    outcome& out)
+{
+    bench::countdown pending(transactions.size());
+    const auto handler = [&](const code& ec, transaction_message::ptr,
+        const point::indexes&)
+    {
+        if (ec == error::input_not_found)
+            ++out.missing;
+        else if (ec == error::pool_filled)
+            ++out.refused;
+        else
+            ++out.other;
+
+        pending.done();
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& tx: transactions)
+        pool.validate(tx, handler);
+
+    pending.wait();
+    return bench::seconds_since(start);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_pool_validation_bench)
+
+// Funded transactions need mined blocks, so the consensus stage is not
+// reached here. This times the lookup and pool stages and their hand-offs.
+BOOST_AUTO_TEST_CASE(case_pool_validations_per_second)
+{
+    static const size_t count = 20000;
+    const auto transactions = make_transactions(count);
+    genesis_chain chain(count);
+
+    outcome out;
+    const auto elapsed = run(chain.pool(), transactions, out);
+
+    BOOST_REQUIRE_EQUAL(out.missing, count);
+    std::cout << "pool validation with " << pool_threads << " threads: "
+        << count / elapsed << " transactions/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(case_pool_validation_refuses_past_backlog)
+{
+    static const size_t count = 20000;
+    static const uint32_t backlog = 100;
+    const auto transactions = make_transactions(count);
+    genesis_chain chain(backlog);
+
+    outcome out;
+    const auto elapsed = run(chain.pool(), transactions, out);
+
+    // Every transaction is answered, those past the backlog at once.
+    BOOST_REQUIRE_EQUAL(out.other, 0u);
+    BOOST_REQUIRE_EQUAL(out.missing + out.refused, count);
+    BOOST_REQUIRE_GT(out.refused, 0u);
+    std::cout << "pool validation burst of " << count << " with a backlog of "
+        << backlog << ": " << out.refused << " refused in " << elapsed
+        << " sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
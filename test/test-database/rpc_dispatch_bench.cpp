@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include <metaverse/explorer/dispatch.hpp>
+#include <metaverse/explorer/generated.hpp>
+#include <metaverse/explorer/parser.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::explorer;
+
+namespace {
+
+static const size_t calls = 10000;
+
+// {"method":"sendfrom","params":[{"fee":20000,"memo":"bench"},
+//  "account","passphrase","from","to","100000"]}
+Json::Value make_params()
+{
+    Json::Value options;
+    options["fee"] = 20000;
+    options["memo"] = "bench";
+
+    Json::Value params(Json::arrayValue);
+    params.append(options);
+    params.append("account");
+    params.append("passphrase");
+    params.append("MFromAddressAAAAAAAAAAAAAAAAAAAAAA");
+    params.append("MToAddressBBBBBBBBBBBBBBBBBBBBBBBB");
+    params.append("100000");
+    return params;
+}
+
+// The command line the HTTP server used to assemble from the params.
+bool bind_argv(const std::string& method, const Json::Value& params)
+{
+    std::vector<std::string> tokens{ method };
+    for (const auto& param: params)
+    {
+        if (!param.isObject())
+            continue;
+
+        for (const auto& key: param.getMemberNames())
+        {
+            tokens.emplace_back("--" + key);
+            if (!param[key].isNull())
+                tokens.emplace_back(param[key].asString());
+        }
+
+        break;
+    }
+
+    for (const auto& param: params)
+        if (!param.isObject())
+            tokens.emplace_back(param.asString());
+
+    std::vector<const char*> argv;
+    for (const auto& token: tokens)
+        argv.push_back(token.c_str());
+
+    const auto instance = find(method);
+    std::istringstream input;
+    std::string error;
+    parser metadata(*instance);
+    return metadata.parse(error, input, static_cast<int>(argv.size()),
+        argv.data());
+}
+
+// The binding done by dispatch_command for a method and its params.
+bool bind_params(const std::string& method, const Json::Value& params)
+{
+    parser::named_values named;
+    parser::token_values tokens;
+    split_params(params, named, tokens);
+
+    const auto instance = find(method);
+    std::istringstream input;
+    std::string error;
+    parser metadata(*instance);
+    return metadata.parse(error, input, named, tokens);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_rpc_dispatch_bench)
+
+BOOST_AUTO_TEST_CASE(case_rpc_command_lookups_per_second)
+{
+    static const std::vector<std::string> methods
+    {
+        "sendfrom", "getbalance", "listtxs", "getblock", "validate-tx"
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t call = 0; call < calls; ++call)
+        BOOST_REQUIRE(find(methods[call % methods.size()]));
+
+    const auto elapsed = bench::seconds_since(start);
+    std::cout << "rpc command lookup: " << calls / elapsed
+        << " lookups/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(case_rpc_params_bound_per_second)
+{
+    const auto params = make_params();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t call = 0; call < calls; ++call)
+        BOOST_REQUIRE(bind_argv("sendfrom", params));
+
+    const auto argv = bench::seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t call = 0; call < calls; ++call)
+        BOOST_REQUIRE(bind_params("sendfrom", params));
+
+    const auto direct = bench::seconds_since(start);
+    std::cout << "rpc params through argv: " << calls / argv
+        << " calls/sec" << std::endl;
+    std::cout << "rpc params bound directly: " << calls / direct
+        << " calls/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
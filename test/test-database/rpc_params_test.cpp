@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <jsoncpp/json/json.h>
+#include <metaverse/explorer/dispatch.hpp>
+#include <metaverse/explorer/extensions/commands/getnewaddress.hpp>
+#include <metaverse/explorer/extensions/commands/sendfrom.hpp>
+#include <metaverse/explorer/parser.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::explorer;
+using namespace libbitcoin::explorer::commands;
+
+namespace {
+
+Json::Value make_params(const std::vector<std::string>& values)
+{
+    Json::Value params(Json::arrayValue);
+    for (const auto& value: values)
+        params.append(value);
+
+    return params;
+}
+
+// Bind the params to the command as dispatch_command does.
+bool bind_params(const Json::Value& params, parser& metadata)
+{
+    parser::named_values named;
+    parser::token_values tokens;
+    split_params(params, named, tokens);
+
+    std::istringstream input;
+    std::string error;
+    return metadata.parse(error, input, named, tokens);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(rpc_params_tests)
+
+BOOST_AUTO_TEST_CASE(split_params__first_object__options_rest_tokens)
+{
+    Json::Value options(Json::objectValue);
+    options["number"] = 5;
+    Json::Value ignored(Json::objectValue);
+    ignored["number"] = 6;
+
+    auto params = make_params({ "acc", "-n" });
+    params.append(options);
+    params.append("7");
+    params.append(ignored);
+
+    parser::named_values named;
+    parser::token_values tokens;
+    split_params(params, named, tokens);
+
+    BOOST_REQUIRE_EQUAL(named.size(), 1u);
+    BOOST_REQUIRE_EQUAL(named[0].first, "number");
+    BOOST_REQUIRE_EQUAL(named[0].second.size(), 1u);
+    BOOST_REQUIRE_EQUAL(named[0].second[0], "5");
+    BOOST_REQUIRE(tokens == parser::token_values({ "acc", "-n", "7" }));
+}
+
+BOOST_AUTO_TEST_CASE(parse__short_option_token__bound)
+{
+    getnewaddress instance;
+    parser metadata(instance);
+    BOOST_REQUIRE(bind_params(make_params({ "acc", "pwd", "-n", "10" }),
+        metadata));
+    BOOST_REQUIRE_EQUAL(instance.option_.count, 10u);
+}
+
+BOOST_AUTO_TEST_CASE(parse__long_option_tokens_between_arguments__bound)
+{
+    sendfrom instance;
+    parser metadata(instance);
+    const auto params = make_params({ "acc", "--fee", "500", "pwd", "from",
+        "to", "--memo", "hello", "1000" });
+    BOOST_REQUIRE(bind_params(params, metadata));
+    BOOST_REQUIRE_EQUAL(instance.argument_.from, "from");
+    BOOST_REQUIRE_EQUAL(instance.argument_.to, "to");
+    BOOST_REQUIRE_EQUAL(instance.argument_.amount, 1000u);
+    BOOST_REQUIRE_EQUAL(instance.argument_.fee, 500u);
+    BOOST_REQUIRE_EQUAL(instance.argument_.memo, "hello");
+}
+
+BOOST_AUTO_TEST_CASE(parse__help_token__help)
+{
+    getnewaddress instance;
+    parser metadata(instance);
+    BOOST_REQUIRE(bind_params(make_params({ "-h" }), metadata));
+    BOOST_REQUIRE(metadata.help());
+}
+
+BOOST_AUTO_TEST_CASE(parse__options_object__bound_without_tokens)
+{
+    Json::Value options(Json::objectValue);
+    options["number"] = 3;
+    auto params = make_params({ "acc", "pwd" });
+    params.append(options);
+
+    getnewaddress instance;
+    parser metadata(instance);
+    BOOST_REQUIRE(bind_params(params, metadata));
+    BOOST_REQUIRE_EQUAL(instance.option_.count, 3u);
+    BOOST_REQUIRE(!metadata.help());
+}
+
+BOOST_AUTO_TEST_CASE(parse__options_object_switch__help)
+{
+    Json::Value options(Json::objectValue);
+    options["help"] = true;
+    auto params = make_params({});
+    params.append(options);
+
+    getnewaddress instance;
+    parser metadata(instance);
+    BOOST_REQUIRE(bind_params(params, metadata));
+    BOOST_REQUIRE(metadata.help());
+}
+
+BOOST_AUTO_TEST_CASE(parse__unknown_option_token__fails)
+{
+    getnewaddress instance;
+    parser metadata(instance);
+    BOOST_REQUIRE(!bind_params(make_params({ "acc", "pwd", "-z", "1" }),
+        metadata));
+}
+
+BOOST_AUTO_TEST_CASE(parse__too_many_arguments__fails)
+{
+    getnewaddress instance;
+    parser metadata(instance);
+    BOOST_REQUIRE(!bind_params(make_params({ "acc", "pwd", "extra" }),
+        metadata));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/script_verifier.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+typedef script_verifier::check check;
+typedef script_verifier::result result;
+
+static const uint32_t flags = script_context::bip16_enabled |
+    script_context::bip66_enabled;
+
+ec_secret make_secret(uint32_t index)
+{
+    return sha256_hash(bench::seed(index));
+}
+
+// Transactions of pay to key hash inputs, each signed by its own key, with
+// one check per input sharing the signature hashing state of its
+// transaction.
+check::list make_checks(size_t transactions, size_t inputs)
+{
+    check::list checks;
+    checks.reserve(transactions * inputs);
+
+    for (uint32_t tx_index = 0; tx_index < transactions; ++tx_index)
+    {
+        transaction tx;
+        tx.version = 1;
+        tx.locktime = 0;
+        std::vector<script> prevouts;
+        std::vector<ec_secret> secrets;
+        std::vector<ec_compressed> points;
+
+        for (uint32_t index = 0; index < inputs; ++index)
+        {
+            const auto secret = make_secret(tx_index * inputs + index);
+            ec_compressed point;
+            BOOST_REQUIRE(secret_to_public(point, secret));
+
+            script prevout;
+            prevout.operations = operation::to_pay_key_hash_pattern(
+                bitcoin_short_hash(point));
+
+            input in;
+            in.previous_output = { make_secret(~index), tx_index };
+            in.sequence = max_input_sequence;
+            tx.inputs.push_back(in);
+
+            prevouts.push_back(prevout);
+            secrets.push_back(secret);
+            points.push_back(point);
+        }
+
+        output out;
+        out.value = 1;
+        out.script = prevouts.front();
+        tx.outputs.push_back(out);
+
+        // The endorsements do not change the hash of other inputs.
+        const sighash_context unsigned_context(tx);
+        for (uint32_t index = 0; index < inputs; ++index)
+        {
+            endorsement endorse;
+            BOOST_REQUIRE(script::create_endorsement(endorse, secrets[index],
+                prevouts[index], unsigned_context, index,
+                signature_hash_algorithm::all));
+
+            auto& operations = tx.inputs[index].script.operations;
+            operations.push_back({ opcode::special, endorse });
+            operations.push_back({ opcode::special, to_chunk(points[index]) });
+        }
+
+        const auto context = std::make_shared<const sighash_context>(tx);
+        for (uint32_t index = 0; index < inputs; ++index)
+            checks.push_back({ context, prevouts[index], index, flags });
+    }
+
+    return checks;
+}
+
+size_t count(const script_verifier::results& results, result value)
+{
+    return std::count(results.begin(), results.end(), value);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_script_verifier_bench)
+
+BOOST_AUTO_TEST_CASE(case_script_verifier_signatures_per_second)
+{
+    static const size_t threads = 4;
+    const auto checks = make_checks(500, 4);
+
+    // One at a time on the calling thread.
+    auto start = std::chrono::steady_clock::now();
+    size_t valid = 0;
+    for (const auto& check: checks)
+        valid += script_verifier::verify(check) ? 1 : 0;
+
+    const auto serial = bench::seconds_since(start);
+    BOOST_REQUIRE_EQUAL(valid, checks.size());
+
+    // As one batch, the caller and the helpers on the consensus lane.
+    scheduler jobs;
+    jobs.start(threads);
+    script_verifier verifier(jobs, threads);
+
+    start = std::chrono::steady_clock::now();
+    const auto results = verifier.verify(checks);
+    const auto batch = bench::seconds_since(start);
+    jobs.stop();
+
+    BOOST_REQUIRE_EQUAL(count(results, result::valid), checks.size());
+    std::cout << "script checks serial: " << checks.size() / serial
+        << " signatures/sec" << std::endl;
+    std::cout << "script checks batched with " << threads << " helpers: "
+        << checks.size() / batch << " signatures/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(case_script_verifier_fails_fast)
+{
+    auto checks = make_checks(100, 4);
+
+    // The first check's prevout no longer matches its key.
+    checks.front().prevout_script = checks.back().prevout_script;
+
+    scheduler jobs;
+    jobs.start(2);
+    script_verifier verifier(jobs, 2);
+    const auto results = verifier.verify(checks);
+    jobs.stop();
+
+    BOOST_REQUIRE_EQUAL(results.size(), checks.size());
+    BOOST_REQUIRE(results.front() == result::invalid);
+    BOOST_REQUIRE_EQUAL(count(results, result::invalid), 1u);
+    std::cout << "script checks after a failure: "
+        << count(results, result::unchecked) << " of " << checks.size()
+        << " left unchecked" << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
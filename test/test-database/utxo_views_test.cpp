@@ -0,0 +1,339 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/path.hpp>
+#include <metaverse/blockchain/utxo_views.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::blockchain;
+
+namespace {
+
+short_hash key_hash(uint32_t seed)
+{
+    return bitcoin_short_hash(to_chunk(to_little_endian(seed)));
+}
+
+std::string address_of(uint32_t seed)
+{
+    return payment_address(key_hash(seed),
+        payment_address::mainnet_p2kh).encoded();
+}
+
+chain::output pay(uint32_t seed, uint64_t value)
+{
+    chain::output output;
+    output.value = value;
+    output.script.operations =
+        chain::operation::to_pay_key_hash_pattern(key_hash(seed));
+    return output;
+}
+
+chain::transaction coinbase(uint32_t height, uint32_t seed, uint64_t value)
+{
+    chain::transaction tx;
+    tx.version = chain::transaction_version::first;
+    tx.locktime = height;
+    tx.inputs.push_back({ { null_hash, max_uint32 }, {}, max_input_sequence });
+    tx.outputs.push_back(pay(seed, value));
+    return tx;
+}
+
+chain::transaction pay_from(const chain::output_point& previous,
+    uint32_t seed, uint64_t value)
+{
+    chain::transaction tx;
+    tx.version = chain::transaction_version::first;
+    tx.locktime = 0;
+    tx.inputs.push_back({ previous, {}, max_input_sequence });
+    tx.outputs.push_back(pay(seed, value));
+    return tx;
+}
+
+chain::block make_block(const hash_digest& previous, uint32_t height,
+    const chain::transaction::list& transactions)
+{
+    chain::block block;
+    block.header.version = 1;
+    block.header.previous_block_hash = previous;
+    block.header.merkle = null_hash;
+    block.header.timestamp = height;
+    block.header.bits = 0;
+    block.header.nonce = height;
+    block.header.mixhash = 0;
+    block.header.number = height;
+    block.header.transaction_count = transactions.size();
+    block.transactions = transactions;
+    return block;
+}
+
+// A store of a genesis block paying the first key, in a fresh directory of
+// the data path, with views reading the coins the test sets.
+class views_fixture
+{
+public:
+    views_fixture(uint64_t capacity = 1024 * 1024)
+      : directory_(boost::filesystem::unique_path("views-test-%%%%-%%%%")),
+        reads_(0)
+    {
+        blocks_.push_back(make_block(null_hash, 0, { coinbase(0, 0, 100) }));
+
+        const auto data_path = default_data_path() / directory_;
+        boost::filesystem::create_directories(data_path);
+        BOOST_REQUIRE(database::data_base::initialize(data_path,
+            blocks_.back()));
+
+        database::settings configuration;
+        configuration.directory = directory_;
+        store_ = std::make_shared<database::data_base>(configuration);
+        BOOST_REQUIRE(store_->start());
+        views_ = std::make_shared<utxo_views>(*store_, capacity);
+    }
+
+    ~views_fixture()
+    {
+        views_.reset();
+        store_.reset();
+        boost::filesystem::remove_all(default_data_path() / directory_);
+    }
+
+    utxo_views& views()
+    {
+        return *views_;
+    }
+
+    // The number of times the coins were read.
+    size_t reads() const
+    {
+        return reads_;
+    }
+
+    // Store and connect a block of the transactions.
+    const chain::block& push(const chain::transaction::list& transactions)
+    {
+        const auto height = static_cast<uint32_t>(blocks_.size());
+        blocks_.push_back(make_block(blocks_.back().header.hash(), height,
+            transactions));
+        store_->push(blocks_.back());
+        views_->connect(blocks_.back(), height);
+        return blocks_.back();
+    }
+
+    // Remove and disconnect the top block.
+    void pop()
+    {
+        const auto height = blocks_.size() - 1;
+        store_->pop();
+        views_->disconnect(blocks_.back(), height);
+        blocks_.pop_back();
+    }
+
+    // The coins of the address, the read finds those set for it.
+    utxo_views::coin_list get(const std::string& address)
+    {
+        const auto read_coins = [this](const std::string& address)
+        {
+            ++reads_;
+            on_read();
+            return stored[address];
+        };
+
+        utxo_views::coin_list out;
+        views_->get(address, read_coins, out);
+        return out;
+    }
+
+    std::unordered_map<std::string, utxo_views::coin_list> stored;
+    std::function<void()> on_read = []() {};
+
+private:
+    const boost::filesystem::path directory_;
+    std::vector<chain::block> blocks_;
+    std::shared_ptr<database::data_base> store_;
+    std::shared_ptr<utxo_views> views_;
+    size_t reads_;
+};
+
+uint64_t total(const utxo_views::coin_list& coins)
+{
+    uint64_t sum = 0;
+    for (const auto& coin: coins)
+        sum += coin.output.value;
+
+    return sum;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(utxo_views_tests)
+
+BOOST_AUTO_TEST_CASE(utxo_views__get__kept__read_once)
+{
+    views_fixture fixture;
+    const auto tx = coinbase(0, 1, 100);
+    fixture.stored[address_of(1)] = { { { tx.hash(), 0 }, tx.outputs[0], 1,
+        true } };
+
+    BOOST_REQUIRE_EQUAL(total(fixture.get(address_of(1))), 100u);
+    BOOST_REQUIRE_EQUAL(total(fixture.get(address_of(1))), 100u);
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_views__connect__outputs_added_spends_removed)
+{
+    views_fixture fixture;
+    BOOST_REQUIRE(fixture.get(address_of(1)).empty());
+
+    const auto& first = fixture.push({ coinbase(1, 1, 100) });
+    const chain::output_point point{ first.transactions[0].hash(), 0 };
+    const auto coins = fixture.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(coins.size(), 1u);
+    BOOST_REQUIRE(coins[0].point == point);
+    BOOST_REQUIRE_EQUAL(coins[0].height, 1u);
+    BOOST_REQUIRE(coins[0].coinbase);
+
+    fixture.push({ coinbase(2, 2, 100), pay_from(point, 1, 60) });
+    BOOST_REQUIRE_EQUAL(total(fixture.get(address_of(1))), 60u);
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_views__pool__spends_hidden_until_removed)
+{
+    views_fixture fixture;
+    const auto& first = fixture.push({ coinbase(1, 1, 100) });
+    const chain::output_point point{ first.transactions[0].hash(), 0 };
+
+    // The coin is read while a pool transaction spends it to the address.
+    const auto pending = pay_from(point, 1, 60);
+    fixture.views().add_pool(pending);
+    fixture.stored[address_of(1)] =
+    {
+        { point, first.transactions[0].outputs[0], 1, true },
+        { { pending.hash(), 0 }, pending.outputs[0], 0, false }
+    };
+
+    auto coins = fixture.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(coins.size(), 1u);
+    BOOST_REQUIRE_EQUAL(coins[0].height, 0u);
+    BOOST_REQUIRE_EQUAL(coins[0].output.value, 60u);
+
+    fixture.views().remove_pool(pending);
+    coins = fixture.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(coins.size(), 1u);
+    BOOST_REQUIRE(coins[0].point == point);
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_views__pool__confirmed_output_kept)
+{
+    views_fixture fixture;
+    const auto& first = fixture.push({ coinbase(1, 1, 100) });
+    const chain::output_point point{ first.transactions[0].hash(), 0 };
+    fixture.stored[address_of(1)] = { { point,
+        first.transactions[0].outputs[0], 1, true } };
+    fixture.get(address_of(1));
+
+    const auto pending = pay_from(point, 1, 60);
+    fixture.views().add_pool(pending);
+    fixture.push({ coinbase(2, 2, 100), pending });
+    fixture.views().remove_pool(pending);
+
+    const auto coins = fixture.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(coins.size(), 1u);
+    const chain::output_point confirmed{ pending.hash(), 0 };
+    BOOST_REQUIRE(coins[0].point == confirmed);
+    BOOST_REQUIRE_EQUAL(coins[0].height, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_views__disconnect__spent_coin_restored)
+{
+    views_fixture fixture;
+    const auto& first = fixture.push({ coinbase(1, 1, 100) });
+    const chain::output_point point{ first.transactions[0].hash(), 0 };
+    fixture.stored[address_of(1)] = { { point,
+        first.transactions[0].outputs[0], 1, true } };
+    fixture.get(address_of(1));
+
+    fixture.push({ coinbase(2, 2, 100), pay_from(point, 1, 60) });
+    BOOST_REQUIRE_EQUAL(total(fixture.get(address_of(1))), 60u);
+
+    // The prevout is read back from the store.
+    fixture.pop();
+    const auto coins = fixture.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(coins.size(), 1u);
+    BOOST_REQUIRE(coins[0].point == point);
+    BOOST_REQUIRE_EQUAL(coins[0].height, 1u);
+    BOOST_REQUIRE(coins[0].coinbase);
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_views__get__changed_while_reading__read_again)
+{
+    views_fixture fixture;
+    fixture.on_read = [&fixture]()
+    {
+        fixture.views().add_pool(pay_from({ null_hash, 0 }, 2, 10));
+    };
+
+    fixture.get(address_of(1));
+    fixture.on_read = []() {};
+    fixture.get(address_of(1));
+    fixture.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_views__get__over_capacity__least_recent_evicted)
+{
+    views_fixture fixture(0);
+    fixture.get(address_of(1));
+    fixture.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(fixture.reads(), 2u);
+
+    // Room for one address of one large coin.
+    views_fixture small(2000);
+    chain::output large;
+    large.value = 100;
+    large.script.operations = { { chain::opcode::special,
+        data_chunk(1000, 0) } };
+
+    const auto tx = coinbase(0, 1, 100);
+    for (uint32_t seed = 1; seed <= 2; ++seed)
+        small.stored[address_of(seed)] = { { { tx.hash(), seed }, large, 1,
+            false } };
+
+    small.get(address_of(1));
+    small.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(small.reads(), 1u);
+
+    small.get(address_of(2));
+    small.get(address_of(2));
+    small.get(address_of(1));
+    BOOST_REQUIRE_EQUAL(small.reads(), 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <metaverse/bitcoin.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+
+namespace {
+
+// Distinct transactions for merkle roots, their hashes are cached up front
+// so that only the tree is measured.
+transaction::list make_transactions(size_t count)
+{
+    transaction::list transactions(count);
+    for (size_t index = 0; index < count; ++index)
+    {
+        transactions[index].version = 1;
+        transactions[index].locktime = static_cast<uint32_t>(index);
+        transactions[index].hash();
+    }
+
+    return transactions;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_hash_bench)
+
+BOOST_AUTO_TEST_CASE(case_bitcoin_hash_per_second)
+{
+    static const size_t hashes = 1000000;
+    data_chunk node(2 * hash_size, 0x42);
+
+    auto total = null_hash;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < hashes; ++index)
+    {
+        node[0] = static_cast<uint8_t>(index);
+        total = bitcoin_hash(node);
+    }
+
+    const auto seconds = bench::seconds_since(start);
+    BOOST_REQUIRE(total != null_hash);
+    std::cout << "bitcoin_hash (" << sha256_implementation() << "): "
+        << hashes / seconds << " hashes/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(case_bitcoin_hash64_per_second)
+{
+    static const size_t batch = 4096;
+    static const size_t rounds = 250;
+    data_chunk nodes(batch * 2 * hash_size, 0x42);
+    data_chunk digests(batch * hash_size);
+
+    // The batch agrees with one hash at a time.
+    bitcoin_hash64(digests.data(), nodes.data(), batch);
+    const auto first = bitcoin_hash(data_slice(nodes.data(),
+        nodes.data() + 2 * hash_size));
+    BOOST_REQUIRE(std::equal(first.begin(), first.end(), digests.begin()));
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        nodes[0] = static_cast<uint8_t>(round);
+        bitcoin_hash64(digests.data(), nodes.data(), batch);
+    }
+
+    const auto seconds = bench::seconds_since(start);
+    std::cout << "bitcoin_hash64 (" << sha256_implementation() << "): "
+        << batch * rounds / seconds << " hashes/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(case_merkle_roots_per_second)
+{
+    static const size_t rounds = 500;
+    const auto transactions = make_transactions(2000);
+
+    // A single transaction is its own root.
+    const auto single = make_transactions(1);
+    BOOST_REQUIRE(block::generate_merkle_root(single) == single[0].hash());
+
+    auto root = null_hash;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+        root = block::generate_merkle_root(transactions);
+
+    const auto seconds = bench::seconds_since(start);
+    BOOST_REQUIRE(root != null_hash);
+    std::cout << "merkle root of " << transactions.size() << " transactions: "
+        << rounds / seconds << " roots/sec" << std::endl;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
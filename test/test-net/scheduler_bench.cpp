@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef BENCHMARK_TESTS
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <metaverse/bitcoin.hpp>
+#include "../bench.hpp"
+
+using namespace libbitcoin;
+
+namespace {
+
+typedef scheduler::lane lane;
+
+// Keeps a worker busy for about the given time.
+void spin(std::chrono::microseconds span)
+{
+    const auto end = std::chrono::steady_clock::now() + span;
+    while (std::chrono::steady_clock::now() < end);
+}
+
+void report(const scheduler& jobs, lane value)
+{
+    const auto stats = jobs.stats(value);
+    const auto average = stats.completed == 0 ? 0 :
+        stats.total_wait_microseconds / stats.completed;
+
+    std::cout << "  " << scheduler::to_string(value) << ": completed "
+        << stats.completed << ", stolen " << stats.stolen << ", wait avg "
+        << average << "us max " << stats.max_wait_microseconds << "us"
+        << std::endl;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_scheduler_bench)
+
+BOOST_AUTO_TEST_CASE(case_scheduler_jobs_per_second)
+{
+    static const size_t count = 200000;
+    static const size_t threads = 4;
+    scheduler jobs;
+    jobs.start(threads);
+
+    bench::countdown remaining(count);
+    std::atomic<size_t> ran(0);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t index = 0; index < count; ++index)
+        jobs.post(lane::network, [&]()
+        {
+            ++ran;
+            remaining.done();
+        });
+
+    remaining.wait();
+    const auto seconds = bench::seconds_since(start);
+    jobs.stop();
+
+    BOOST_REQUIRE_EQUAL(ran.load(), count);
+    std::cout << "scheduler on " << threads << " workers: " << count / seconds
+        << " jobs/sec" << std::endl;
+    report(jobs, lane::network);
+}
+
+BOOST_AUTO_TEST_CASE(case_scheduler_consensus_wait_under_background_flood)
+{
+    static const size_t flood = 2000;
+    static const size_t urgent = 200;
+    scheduler jobs;
+    jobs.start(4);
+
+    bench::countdown remaining(flood + 2 * urgent);
+
+    // The lower lanes are queued first, each job holding a worker a while.
+    for (size_t index = 0; index < flood; ++index)
+        jobs.post(index % 2 == 0 ? lane::background : lane::rpc, [&]()
+        {
+            spin(std::chrono::microseconds(200));
+            remaining.done();
+        });
+
+    for (size_t index = 0; index < urgent; ++index)
+    {
+        jobs.post(lane::consensus, [&]()
+        {
+            spin(std::chrono::microseconds(50));
+            remaining.done();
+        });
+
+        jobs.post(lane::network, [&]()
+        {
+            spin(std::chrono::microseconds(50));
+            remaining.done();
+        });
+    }
+
+    remaining.wait();
+    jobs.stop();
+
+    const auto consensus = jobs.stats(lane::consensus);
+    const auto background = jobs.stats(lane::background);
+    BOOST_REQUIRE_EQUAL(consensus.completed, urgent);
+
+    // Consensus jobs are taken ahead of the queued background jobs.
+    BOOST_CHECK_LT(consensus.total_wait_microseconds / urgent,
+        background.total_wait_microseconds / background.completed);
+
+    std::cout << "scheduler lanes under a background flood:" << std::endl;
+    report(jobs, lane::consensus);
+    report(jobs, lane::network);
+    report(jobs, lane::rpc);
+    report(jobs, lane::background);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <metaverse/bitcoin.hpp>
+
+using namespace libbitcoin;
+
+namespace {
+
+typedef scheduler::lane lane;
+
+// Holds the jobs that wait on it until it is opened.
+class gate
+{
+public:
+    gate()
+      : open_(false)
+    {
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        opened_.wait(lock, [this]() { return open_; });
+    }
+
+    void open()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        open_ = true;
+        lock.unlock();
+        opened_.notify_all();
+    }
+
+private:
+    bool open_;
+    std::mutex mutex_;
+    std::condition_variable opened_;
+};
+
+// Counts the jobs running at once and the most seen.
+class concurrency
+{
+public:
+    concurrency()
+      : running_(0), most_(0)
+    {
+    }
+
+    void enter()
+    {
+        const auto running = ++running_;
+        auto most = most_.load();
+        while (running > most && !most_.compare_exchange_weak(most, running));
+    }
+
+    void leave()
+    {
+        --running_;
+    }
+
+    size_t most() const
+    {
+        return most_;
+    }
+
+private:
+    std::atomic<size_t> running_;
+    std::atomic<size_t> most_;
+};
+
+// Waits for the condition, false after a generous timeout.
+template <typename Condition>
+bool eventually(Condition condition)
+{
+    const auto end = std::chrono::steady_clock::now() +
+        std::chrono::seconds(10);
+
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > end)
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(scheduler_tests)
+
+BOOST_AUTO_TEST_CASE(scheduler__start__four_threads__lane_limits)
+{
+    scheduler jobs;
+    jobs.start(4);
+    BOOST_REQUIRE_EQUAL(jobs.threads(), 4u);
+    BOOST_REQUIRE_EQUAL(jobs.stats(lane::consensus).limit, 4u);
+    BOOST_REQUIRE_EQUAL(jobs.stats(lane::network).limit, 3u);
+    BOOST_REQUIRE_EQUAL(jobs.stats(lane::storage).limit, 2u);
+    BOOST_REQUIRE_EQUAL(jobs.stats(lane::rpc).limit, 2u);
+    BOOST_REQUIRE_EQUAL(jobs.stats(lane::background).limit, 1u);
+    jobs.stop();
+    BOOST_REQUIRE_EQUAL(jobs.threads(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__start__one_thread__every_lane_may_run)
+{
+    scheduler jobs;
+    jobs.start(1);
+    for (size_t index = 0; index < scheduler::lanes; ++index)
+        BOOST_REQUIRE_EQUAL(jobs.stats(static_cast<lane>(index)).limit, 1u);
+
+    // Nothing is kept back with a single worker, so every lane completes.
+    std::atomic<size_t> ran(0);
+    for (size_t index = 0; index < scheduler::lanes; ++index)
+        jobs.post(static_cast<lane>(index), [&ran]() { ++ran; });
+
+    BOOST_REQUIRE(eventually([&ran]() { return ran == scheduler::lanes; }));
+    jobs.stop();
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__post__not_started__runs_on_caller)
+{
+    scheduler jobs;
+    const auto caller = std::this_thread::get_id();
+    auto ran_on = std::thread::id();
+    jobs.post(lane::rpc, [&ran_on]() { ran_on = std::this_thread::get_id(); });
+    BOOST_REQUIRE(ran_on == caller);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__post__blocked_lane__held_to_limit)
+{
+    static const size_t count = 8;
+    scheduler jobs;
+    jobs.start(4);
+
+    gate hold;
+    concurrency storage;
+    for (size_t index = 0; index < count; ++index)
+        jobs.post(lane::storage, [&]()
+        {
+            storage.enter();
+            hold.wait();
+            storage.leave();
+        });
+
+    BOOST_REQUIRE(eventually([&jobs]()
+    {
+        return jobs.stats(lane::storage).running == 2;
+    }));
+
+    // The other workers are free, but not to the blocked lane.
+    std::atomic<bool> ran(false);
+    jobs.post(lane::rpc, [&ran]() { ran = true; });
+    BOOST_REQUIRE(eventually([&ran]() { return ran.load(); }));
+    BOOST_REQUIRE_EQUAL(jobs.stats(lane::storage).running, 2u);
+
+    hold.open();
+    jobs.stop();
+    BOOST_REQUIRE_EQUAL(storage.most(), 2u);
+    BOOST_REQUIRE_EQUAL(jobs.stats(lane::storage).completed, count);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__post__lower_lanes_blocked__consensus_keeps_worker)
+{
+    static const size_t count = 16;
+    scheduler jobs;
+    jobs.start(4);
+
+    // Block every lane below consensus, more jobs than workers.
+    gate hold;
+    concurrency shared;
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto value = static_cast<lane>(1 + index % (scheduler::lanes - 1));
+        jobs.post(value, [&]()
+        {
+            shared.enter();
+            hold.wait();
+            shared.leave();
+        });
+    }
+
+    BOOST_REQUIRE(eventually([&shared]() { return shared.most() == 3; }));
+
+    // The worker kept back runs consensus jobs while the others are held.
+    std::atomic<size_t> verified(0);
+    for (size_t index = 0; index < count; ++index)
+        jobs.post(lane::consensus, [&verified]() { ++verified; });
+
+    BOOST_REQUIRE(eventually([&verified]() { return verified == count; }));
+    BOOST_REQUIRE_EQUAL(shared.most(), 3u);
+
+    hold.open();
+    jobs.stop();
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__stop__queued_jobs__all_run)
+{
+    static const size_t count = 1000;
+    scheduler jobs;
+    jobs.start(2);
+
+    std::atomic<size_t> ran(0);
+    for (size_t index = 0; index < count; ++index)
+        jobs.post(static_cast<lane>(index % scheduler::lanes),
+            [&ran]() { ++ran; });
+
+    jobs.stop();
+    BOOST_REQUIRE_EQUAL(ran.load(), count);
+
+    // The scheduler can be started again.
+    jobs.start(2);
+    jobs.post(lane::background, [&ran]() { ++ran; });
+    jobs.stop();
+    BOOST_REQUIRE_EQUAL(ran.load(), count + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
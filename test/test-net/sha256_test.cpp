@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/math/sha256_engine.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+
+namespace {
+
+struct known_answer
+{
+    std::string message;
+    std::string digest;
+};
+
+// FIPS 180-2 examples, the last two are 448 and 896 bits.
+static const std::vector<known_answer> known_answers
+{
+    {
+        "",
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"
+    },
+    {
+        "abc",
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+    },
+    {
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+    },
+    {
+        "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+        "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+        "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1"
+    }
+};
+
+std::string hash(const sha256::engine& instance, const std::string& message,
+    size_t chunk)
+{
+    sha256::context context(instance);
+    const auto data = reinterpret_cast<const uint8_t*>(message.data());
+
+    for (size_t offset = 0; offset < message.size(); offset += chunk)
+        context.update(data + offset,
+            std::min(chunk, message.size() - offset));
+
+    hash_digest digest;
+    context.finalize(digest.data());
+    return encode_base16(digest);
+}
+
+data_chunk random_nodes(size_t count, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    data_chunk nodes(count * 2 * hash_size);
+    for (auto& byte: nodes)
+        byte = static_cast<uint8_t>(generator());
+
+    return nodes;
+}
+
+// The merkle tree as it was built before the hashing was batched.
+hash_digest serial_merkle_root(const transaction::list& transactions)
+{
+    hash_list merkle;
+    for (const auto& tx: transactions)
+        merkle.push_back(tx.hash());
+
+    if (merkle.empty())
+        return null_hash;
+
+    while (merkle.size() > 1)
+    {
+        if (merkle.size() % 2 != 0)
+            merkle.push_back(merkle.back());
+
+        hash_list next;
+        for (size_t index = 0; index < merkle.size(); index += 2)
+        {
+            data_chunk pair(merkle[index].begin(), merkle[index].end());
+            extend_data(pair, merkle[index + 1]);
+            next.push_back(bitcoin_hash(pair));
+        }
+
+        merkle = next;
+    }
+
+    return merkle.front();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_sha256)
+
+BOOST_AUTO_TEST_CASE(case_sha256_known_answers_per_engine)
+{
+    for (const auto& instance: sha256::supported())
+    {
+        BOOST_TEST_MESSAGE("sha256 engine " << instance.name);
+
+        // Whole, byte at a time and in chunks that straddle the blocks.
+        for (const auto& vector: known_answers)
+            for (const auto chunk: { size_t(1000), size_t(1), size_t(7),
+                size_t(63), size_t(65) })
+                BOOST_CHECK_EQUAL(hash(instance, vector.message, chunk),
+                    vector.digest);
+
+        BOOST_CHECK_EQUAL(hash(instance, std::string(1000000, 'a'), 4096),
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(case_sha256_selected_engine_matches_known_answers)
+{
+    for (const auto& vector: known_answers)
+        BOOST_CHECK_EQUAL(encode_base16(sha256_hash(to_chunk(vector.message))),
+            vector.digest);
+}
+
+BOOST_AUTO_TEST_CASE(case_double64_matches_bitcoin_hash_per_engine)
+{
+    for (const auto& instance: sha256::supported())
+    {
+        BOOST_TEST_MESSAGE("sha256 engine " << instance.name);
+
+        // Every batch size up to two full 8 lane groups and a tail.
+        for (size_t count = 1; count <= 17; ++count)
+        {
+            const auto nodes = random_nodes(count, count);
+            data_chunk digests(count * hash_size);
+            sha256::double64(instance, digests.data(), nodes.data(), count);
+
+            for (size_t index = 0; index < count; ++index)
+            {
+                const auto node = nodes.data() + index * 2 * hash_size;
+                const auto expected = bitcoin_hash(
+                    data_slice(node, node + 2 * hash_size));
+                const auto digest = digests.data() + index * hash_size;
+                BOOST_CHECK_MESSAGE(std::equal(expected.begin(),
+                    expected.end(), digest), instance.name << " count "
+                    << count << " lane " << index);
+            }
+
+            // Reducing a level in place gives the same digests.
+            auto level = nodes;
+            sha256::double64(instance, level.data(), level.data(), count);
+            BOOST_CHECK(std::equal(digests.begin(), digests.end(),
+                level.begin()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(case_merkle_root_matches_serial_tree)
+{
+    for (size_t count = 1; count <= 33; ++count)
+    {
+        transaction::list transactions(count);
+        for (size_t index = 0; index < count; ++index)
+        {
+            transactions[index].version = 1;
+            transactions[index].locktime = static_cast<uint32_t>(index);
+        }
+
+        BOOST_CHECK_MESSAGE(block::generate_merkle_root(transactions) ==
+            serial_merkle_root(transactions), "transactions " << count);
+    }
+
+    BOOST_CHECK(block::generate_merkle_root({}) == null_hash);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
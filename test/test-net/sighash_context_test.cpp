@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/chain/script/sighash_context.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+
+namespace {
+
+static const uint8_t sighash_types[] =
+{
+    signature_hash_algorithm::all,
+    signature_hash_algorithm::none,
+    signature_hash_algorithm::single,
+    signature_hash_algorithm::all | signature_hash_algorithm::anyone_can_pay,
+    signature_hash_algorithm::none | signature_hash_algorithm::anyone_can_pay,
+    signature_hash_algorithm::single | signature_hash_algorithm::anyone_can_pay
+};
+
+script pay_script(uint32_t index)
+{
+    script out;
+    out.operations = operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(to_chunk(to_little_endian(index))));
+    return out;
+}
+
+// Inputs carry distinct scripts, as after some of them have been signed.
+transaction make_transaction(size_t inputs, size_t outputs)
+{
+    transaction tx;
+    tx.version = 1;
+    tx.locktime = 99;
+
+    for (uint32_t index = 0; index < inputs; ++index)
+    {
+        input in;
+        in.previous_output = { sha256_hash(to_chunk(to_little_endian(index))),
+            index };
+        in.script = pay_script(index + 100);
+        in.sequence = max_input_sequence - index;
+        tx.inputs.push_back(in);
+    }
+
+    for (uint32_t index = 0; index < outputs; ++index)
+    {
+        output out;
+        out.value = 1000 * (index + 1);
+        out.script = pay_script(index);
+        tx.outputs.push_back(out);
+    }
+
+    return tx;
+}
+
+void check_all(const transaction& tx, const sighash_context& context)
+{
+    for (uint32_t index = 0; index < tx.inputs.size(); ++index)
+    {
+        const auto code = pay_script(index + 200);
+
+        for (const auto type: sighash_types)
+            BOOST_CHECK_MESSAGE(context.signature_hash(index, code, type) ==
+                script::generate_signature_hash(tx, index, code, type),
+                "input " << index << " type " << int(type));
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_sighash_context)
+
+BOOST_AUTO_TEST_CASE(case_sighash_context_matches_generate_signature_hash)
+{
+    const auto tx = make_transaction(5, 7);
+    const sighash_context context(tx);
+    check_all(tx, context);
+}
+
+// Single on an input without a matching output takes the one hash path.
+BOOST_AUTO_TEST_CASE(case_sighash_context_single_past_outputs)
+{
+    const auto tx = make_transaction(6, 2);
+    const sighash_context context(tx);
+    check_all(tx, context);
+}
+
+BOOST_AUTO_TEST_CASE(case_sighash_context_tracks_signed_input_scripts)
+{
+    auto tx = make_transaction(4, 4);
+    const sighash_context context(tx);
+    check_all(tx, context);
+
+    // Signing replaces input scripts after the context is built.
+    for (uint32_t index = 0; index < tx.inputs.size(); ++index)
+    {
+        tx.inputs[index].script = pay_script(index + 300);
+        check_all(tx, context);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(case_sighash_context_serialized)
+{
+    const auto tx = make_transaction(3, 3);
+    const sighash_context context(tx);
+    BOOST_CHECK(context.serialized() == tx.to_data());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
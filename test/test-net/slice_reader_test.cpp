@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/slice_reader.hpp>
+
+using namespace libbitcoin;
+
+namespace {
+
+// One value of every kind the reader decodes, in order.
+data_chunk make_fields()
+{
+    data_chunk data(128);
+    auto serial = make_serializer(data.begin());
+    serial.write_byte(0x42);
+    serial.write_2_bytes_little_endian(0x1234);
+    serial.write_4_bytes_little_endian(0x12345678);
+    serial.write_8_bytes_little_endian(0x0123456789abcdef);
+    serial.write_2_bytes_big_endian(0x1234);
+    serial.write_4_bytes_big_endian(0x12345678);
+    serial.write_8_bytes_big_endian(0x0123456789abcdef);
+    serial.write_variable_uint_little_endian(0xfd);
+    serial.write_variable_uint_little_endian(0x10000);
+    serial.write_variable_uint_little_endian(0x100000000);
+    serial.write_hash(bitcoin_hash(to_chunk(std::string("hash"))));
+    serial.write_string("metaverse");
+    data.resize(std::distance(data.begin(), serial.iterator()));
+    return data;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(suit_slice_reader)
+
+BOOST_AUTO_TEST_CASE(case_slice_reader_matches_istream_reader)
+{
+    const auto data = make_fields();
+    slice_reader slice(data);
+    data_source stream(data);
+    istream_reader source(stream);
+
+    BOOST_CHECK_EQUAL(slice.read_byte(), source.read_byte());
+    BOOST_CHECK_EQUAL(slice.read_2_bytes_little_endian(),
+        source.read_2_bytes_little_endian());
+    BOOST_CHECK_EQUAL(slice.read_4_bytes_little_endian(),
+        source.read_4_bytes_little_endian());
+    BOOST_CHECK_EQUAL(slice.read_8_bytes_little_endian(),
+        source.read_8_bytes_little_endian());
+    BOOST_CHECK_EQUAL(slice.read_2_bytes_big_endian(),
+        source.read_2_bytes_big_endian());
+    BOOST_CHECK_EQUAL(slice.read_4_bytes_big_endian(),
+        source.read_4_bytes_big_endian());
+    BOOST_CHECK_EQUAL(slice.read_8_bytes_big_endian(),
+        source.read_8_bytes_big_endian());
+
+    for (auto value = 0; value < 3; ++value)
+        BOOST_CHECK_EQUAL(slice.read_variable_uint_little_endian(),
+            source.read_variable_uint_little_endian());
+
+    BOOST_CHECK(slice.read_hash() == source.read_hash());
+    BOOST_CHECK_EQUAL(slice.read_string(), source.read_string());
+    BOOST_CHECK(slice);
+    BOOST_CHECK(slice.is_exhausted());
+    BOOST_CHECK_EQUAL(slice.position(), data.size());
+    BOOST_CHECK_EQUAL(slice.remaining(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(case_slice_reader_overrun_invalidates)
+{
+    const data_chunk data{ 0x01, 0x02, 0x03 };
+    slice_reader slice(data);
+
+    BOOST_CHECK_EQUAL(slice.read_2_bytes_little_endian(), 0x0201);
+    BOOST_CHECK_EQUAL(slice.read_4_bytes_little_endian(), 0u);
+    BOOST_CHECK(!slice);
+
+    // Reads after an overrun return zeroed values.
+    BOOST_CHECK_EQUAL(slice.read_byte(), 0u);
+    BOOST_CHECK(slice.read_hash() == null_hash);
+    BOOST_CHECK(!slice);
+}
+
+BOOST_AUTO_TEST_CASE(case_slice_reader_oversized_length_invalidates)
+{
+    // A string claiming more bytes than the range holds.
+    const data_chunk data{ 0xfd, 0xff, 0xff, 'a', 'b' };
+    slice_reader slice(data);
+
+    BOOST_CHECK(slice.read_string().empty());
+    BOOST_CHECK(!slice);
+}
+
+BOOST_AUTO_TEST_CASE(case_slice_reader_checksum_covers_the_range)
+{
+    const auto data = make_fields();
+    const auto expected = bitcoin_checksum(data);
+
+    // Fully consumed, partly consumed and not consumed at all.
+    slice_reader whole(data, true);
+    whole.read_data_to_eof();
+    BOOST_CHECK_EQUAL(whole.checksum(), expected);
+
+    slice_reader part(data, true);
+    part.read_8_bytes_little_endian();
+    part.read_byte();
+    BOOST_CHECK_EQUAL(part.checksum(), expected);
+
+    slice_reader none(data, true);
+    BOOST_CHECK_EQUAL(none.checksum(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(case_slice_reader_parses_transaction)
+{
+    chain::transaction tx;
+    tx.version = 1;
+    tx.locktime = 7;
+    chain::input input;
+    input.previous_output = { bitcoin_hash(to_chunk(std::string("prev"))), 3 };
+    input.script.operations = chain::operation::to_pay_key_hash_pattern(
+        bitcoin_short_hash(to_chunk(std::string("key"))));
+    input.sequence = max_input_sequence;
+    tx.inputs.push_back(input);
+    chain::output output;
+    output.value = 100000;
+    output.script = input.script;
+    tx.outputs.push_back(output);
+
+    const auto data = tx.to_data();
+    slice_reader slice(data);
+    chain::transaction parsed;
+    BOOST_REQUIRE(parsed.from_data(slice));
+    BOOST_CHECK(parsed.to_data() == data);
+    BOOST_CHECK(parsed.hash() == tx.hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()